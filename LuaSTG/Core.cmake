@@ -47,6 +47,14 @@ set(Core_SRC
     Core/Graphics/Common/FreeTypeGlyphManager.cpp
     Core/Graphics/Common/TextRenderer.hpp
     Core/Graphics/Common/TextRenderer.cpp
+    Core/Graphics/Common/TextLayout.hpp
+    Core/Graphics/Common/TextLayout.cpp
+    Core/Graphics/Common/RenderCommandList.hpp
+    Core/Graphics/Common/RenderCommandList.cpp
+    Core/Graphics/Common/RecordingRenderer.hpp
+    Core/Graphics/Common/RecordingRenderer.cpp
+    Core/Graphics/Common/BakedTexture.hpp
+    Core/Graphics/Common/BakedTexture.cpp
 
     Core/Graphics/Direct3D11/Constants.hpp
     Core/Graphics/Direct3D11/Buffer.hpp
@@ -70,6 +78,10 @@ set(Core_SRC
 
     Core/Graphics/WindowsImageComponent/WindowsImageComponentImage.cpp
 
+    Core/FramePacer.hpp
+    Core/FramePacer.cpp
+    Core/FrameTelemetry.hpp
+    Core/FrameTelemetry.cpp
     Core/ApplicationModel.hpp
     Core/ApplicationModel_Win32.hpp
     Core/ApplicationModel_Win32.cpp
@@ -126,3 +138,20 @@ target_link_libraries(Core PUBLIC
     Core.FileSystem
     win32
 )
+
+# Core Test
+
+set(test_name "Core.Test")
+
+add_executable(${test_name})
+luastg_target_common_options(${test_name})
+luastg_target_more_warning(${test_name})
+target_compile_features(${test_name} PRIVATE cxx_std_23)
+target_sources(${test_name} PRIVATE
+    Core/test/FramePacer.cpp
+    Core/test/FrameTelemetry.cpp
+    Core/test/RenderCommandList.cpp
+)
+target_link_libraries(${test_name} PRIVATE options_compile_utf8 Core GTest::gtest_main)
+
+set_target_properties(${test_name} PROPERTIES FOLDER engine/test)
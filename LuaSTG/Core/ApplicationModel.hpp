@@ -4,6 +4,7 @@
 #include "Core/Graphics/SwapChain.hpp"
 #include "Core/Graphics/Renderer.hpp"
 #include "core/ReferenceCounted.hpp"
+#include "Core/FrameTelemetry.hpp"
 
 namespace core
 {
@@ -18,6 +19,8 @@ namespace core
         virtual double getAvgFPS() = 0;
         virtual double getMinFPS() = 0;
         virtual double getMaxFPS() = 0;
+        // 上一次等待实际醒来的时间比目标时间晚了多少秒，没有等待时为 0
+        virtual double getSleepOvershoot() = 0;
     };
 
     struct IApplicationEventListener
@@ -58,9 +61,17 @@ namespace core
         virtual FrameStatistics getFrameStatistics() = 0;
         // [工作线程]
         virtual FrameRenderStatistics getFrameRenderStatistics() = 0;
+        // [工作线程] 最近若干帧的帧时序记录
+        virtual FrameTelemetry* getFrameTelemetry() = 0;
+        // [工作线程] 流水线渲染时，callback 会录制到渲染命令中，在渲染线程上按顺序执行；否则立即执行
+        virtual void executeOnRenderThread(void (*callback)(void* userdata, Graphics::IRenderer* renderer), void* userdata) = 0;
+        // [工作线程] 等待渲染线程空闲并提交已经录制的渲染命令，之后可以在当前线程直接访问设备上下文和交换链
+        virtual void synchronizeRenderThread() = 0;
 
         // [主线程|工作线程]
         virtual void requestExit() = 0;
+        // [主线程|工作线程] 无窗口快进模式：只调用 onUpdate，不渲染、不等待
+        virtual bool isHeadless() = 0;
         // [主线程]
         virtual bool run() = 0;
 
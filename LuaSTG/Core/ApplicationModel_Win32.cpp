@@ -67,6 +67,7 @@ namespace core
 		}
 		else
 		{
+			sleep_overshoot_ = (double)(curr_.QuadPart - last_ - wait_) / (double)freq_;
 			udateData(curr_.QuadPart);
 			return true;
 		}
@@ -83,14 +84,23 @@ namespace core
 			total_frame_ += 1;
 			total_time_ += 1.0 / indexFPS(0);
 			last_ = curr_.QuadPart;
+			sleep_overshoot_ = 0.0;
 			return indexFPS(0);
 		}
 
 		// 在启用了高精度计时器的情况下，可以用 Sleep 等待，不需要占用太多 CPU
 		LONGLONG const sleep_ms = (((wait_ - (curr_.QuadPart - last_)) - _2ms_) * 1000ll) / freq_;
+		sleep_overshoot_ = 0.0;
 		if (sleep_ms > 0)
 		{
 			Sleep((DWORD)sleep_ms);
+			// Sleep 醒来太晚时，轮询等待无法补救；没有 Sleep（这一帧本身就来晚了）时不算
+			QueryPerformanceCounter(&curr_);
+			LONGLONG const overshoot = curr_.QuadPart - last_ - wait_;
+			if (overshoot > 0)
+			{
+				sleep_overshoot_ = (double)overshoot / (double)freq_;
+			}
 		}
 
 		// 轮询等待
@@ -139,6 +149,10 @@ namespace core
 	{
 		return fps_max_;
 	}
+	double FrameRateController::getSleepOvershoot()
+	{
+		return sleep_overshoot_;
+	}
 
 	FrameRateController::FrameRateController(uint32_t target_FPS)
 	{
@@ -198,6 +212,7 @@ namespace core
 				// 立即推进 1 帧
 				frame_count_ += 1;
 			}
+			sleep_overshoot_ = 0.0;
 		}
 		else
 		{
@@ -220,6 +235,7 @@ namespace core
 			}
 			// 推进 1 帧
 			frame_count_ += 1;
+			sleep_overshoot_ = (double)(cur_pc_ - target_pc_) / (double)clock_freq_;
 		}
 		// 刷新数值
 		int64_t const delta_pc_ = cur_pc_ - last_pc_;
@@ -255,6 +271,7 @@ namespace core
 	double TimeStampFrameRateController::getAvgFPS() { return getFPS(); }
 	double TimeStampFrameRateController::getMinFPS() { return getFPS(); }
 	double TimeStampFrameRateController::getMaxFPS() { return getFPS(); }
+	double TimeStampFrameRateController::getSleepOvershoot() { return sleep_overshoot_; }
 
 	TimeStampFrameRateController::TimeStampFrameRateController(uint32_t target_FPS)
 	{
@@ -413,6 +430,114 @@ namespace core
 			FrameMark;
 		}
 	}
+	DWORD WINAPI ApplicationModel_Win32::win32_thread_render_entry(LPVOID lpThreadParameter)
+	{
+		static_cast<ApplicationModel_Win32*>(lpThreadParameter)->renderWorker();
+		return 0;
+	}
+	void ApplicationModel_Win32::renderWorker()
+	{
+		SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_HIGHEST);
+
+		// 回放、呈现循环
+		while (true)
+		{
+			if (WAIT_OBJECT_0 != WaitForSingleObjectEx(win32_event_render_submit.Get(), INFINITE, FALSE))
+			{
+				gHRLastError;
+				i18n_core_system_call_report_error("WaitForSingleObjectEx");
+				break;
+			}
+			if (m_render_exit)
+			{
+				break;
+			}
+
+			// 回放
+			{
+				tracy_zone_scoped_with_name("OnReplay");
+				std::ignore = m_render_submit_list->replay(*m_renderer);
+			}
+
+			// 呈现
+			if (m_render_submit_present)
+			{
+				tracy_zone_scoped_with_name("OnPresent");
+				m_swapchain->present();
+				m_render_input_latency.store((double)(winQPC() - m_render_submit_update_begin) / (double)winQPF(), std::memory_order_relaxed);
+				TracyD3D11Collect(m_device->GetTracyContext());
+			}
+
+			// 等待交换链，避免渲染线程领先 GPU 太多
+			{
+				tracy_zone_scoped_with_name("OnWaitFrameLatency");
+				m_swapchain->waitFrameLatency();
+			}
+
+			SetEvent(win32_event_render_idle.Get());
+		}
+
+		// 无论如何都不能让工作线程永远等下去
+		SetEvent(win32_event_render_idle.Get());
+	}
+	void ApplicationModel_Win32::waitRenderThread()
+	{
+		// 等待期间，DXGI 可能会在渲染线程上向窗口发送消息，所以仍然要处理发送到本线程的消息
+		// 处理消息时可能再次进入这里，此时不能再等待，否则渲染线程和工作线程会互相等待
+		if (m_render_waiting)
+		{
+			return;
+		}
+		if (win32_thread_render.IsValid())
+		{
+			m_render_waiting = true;
+			HANDLE const win32_events[1] = { win32_event_render_idle.Get() };
+			for (;;)
+			{
+				DWORD const result = MsgWaitForMultipleObjectsEx(1, win32_events, INFINITE, QS_SENDMESSAGE, 0);
+				if (result == (WAIT_OBJECT_0 + 1))
+				{
+					MSG msg{};
+					PeekMessageW(&msg, NULL, 0, 0, PM_NOREMOVE | PM_QS_SENDMESSAGE);
+					continue;
+				}
+				if (result == WAIT_FAILED)
+				{
+					gHRLastError;
+					i18n_core_system_call_report_error("MsgWaitForMultipleObjectsEx");
+				}
+				break;
+			}
+			m_render_waiting = false;
+		}
+		// 渲染线程已经空闲，现在才把等待期间收到的窗口事件交给交换链
+		// 交换链处理事件时可能触发新的窗口事件，它们会排在队列末尾，由这个循环继续处理
+		while (!m_pending_window_events.empty())
+		{
+			WindowEvent const event = m_pending_window_events.front();
+			m_pending_window_events.erase(m_pending_window_events.begin());
+			applyWindowEvent(event);
+		}
+	}
+	void ApplicationModel_Win32::queueWindowEvent(WindowEvent const& event)
+	{
+		// 不论是否在等待中都先排队，嵌套的事件不能直接交给交换链，否则会和渲染线程的回放、呈现冲突
+		m_pending_window_events.push_back(event);
+		waitRenderThread();
+	}
+	void ApplicationModel_Win32::applyWindowEvent(WindowEvent const& event)
+	{
+		Graphics::IWindowEventListener* const listener = m_swapchain.get();
+		switch (event.type)
+		{
+		case WindowEvent::Type::Create: listener->onWindowCreate(); break;
+		case WindowEvent::Type::Destroy: listener->onWindowDestroy(); break;
+		case WindowEvent::Type::Active: listener->onWindowActive(); break;
+		case WindowEvent::Type::Inactive: listener->onWindowInactive(); break;
+		case WindowEvent::Type::Size: listener->onWindowSize(event.size); break;
+		case WindowEvent::Type::FullscreenStateChange: listener->onWindowFullscreenStateChange(event.fullscreen_state); break;
+		}
+	}
 	
 	bool ApplicationModel_Win32::runSingleThread()
 	{
@@ -576,13 +701,131 @@ namespace core
 		wait_worker();
 		return true;
 	}
+	bool ApplicationModel_Win32::runHeadless()
+	{
+		uint64_t frame{};
+		double elapsed{};
+		{
+			ScopeTimer et(elapsed);
+			// 窗口不可见，但是仍然要处理消息
+			MSG msg{};
+			while (!m_exit_flag)
+			{
+				while (PeekMessageW(&msg, NULL, 0, 0, PM_REMOVE))
+				{
+					if (msg.message == WM_QUIT)
+					{
+						m_exit_flag = true; // 应该结束循环
+					}
+					else
+					{
+						TranslateMessage(&msg);
+						DispatchMessageW(&msg);
+					}
+				}
+				if (m_exit_flag)
+				{
+					break;
+				}
+
+				// 只更新，不渲染、不呈现、不等待
+				size_t const i = (m_framestate_index + 1) % 2;
+				FrameStatistics& d = m_framestate[i];
+				d = {};
+				{
+					tracy_zone_scoped_with_name("OnUpdate");
+					ScopeTimer t(d.update_time);
+					std::ignore = m_listener->onUpdate();
+				}
+				d.total_time = d.update_time;
+				m_p_frame_rate_controller->update();
+				m_framestate_index = i;
+				FrameMark;
+
+				frame += 1;
+				if (m_headless_frame_limit > 0 && frame >= m_headless_frame_limit)
+				{
+					m_exit_flag = true;
+				}
+			}
+		}
+		spdlog::info("[core] Headless mode finished, {} frames in {:.3f}s ({:.1f} FPS)", frame, elapsed, elapsed > 0.0 ? double(frame) / elapsed : 0.0);
+		return true;
+	}
+	bool ApplicationModel_Win32::runPipelined()
+	{
+		// 工作线程仍然会直接上传纹理等，立即上下文需要打开多线程保护
+		win32::com_ptr<ID3D11Multithread> d3d11_multithread;
+		if (FAILED(m_device->GetD3D11DeviceContext()->QueryInterface(IID_PPV_ARGS(d3d11_multithread.put()))))
+		{
+			spdlog::warn("[core] ID3D11Multithread not available, pipelined rendering disabled");
+			return runSingleThread();
+		}
+		d3d11_multithread->SetMultithreadProtected(TRUE);
+
+		// 创建渲染线程使用的事件
+		win32_event_render_submit.Attach(CreateEventExW(NULL, NULL, 0, EVENT_ALL_ACCESS));
+		win32_event_render_idle.Attach(CreateEventExW(NULL, NULL, CREATE_EVENT_MANUAL_RESET | CREATE_EVENT_INITIAL_SET, EVENT_ALL_ACCESS));
+		if (!win32_event_render_submit.IsValid() || !win32_event_render_idle.IsValid())
+		{
+			gHRLastError;
+			i18n_core_system_call_report_error("CreateEventExW");
+			return false;
+		}
+
+		// 从现在开始，渲染调用都录制到命令列表中
+		m_recording_renderer.attach(new Graphics::Common::RecordingRenderer(*m_renderer, [](void* userdata)
+		{
+			static_cast<ApplicationModel_Win32*>(userdata)->waitRenderThread();
+		}, this));
+		m_command_list_index = 0;
+		m_recording_renderer->setCommandList(&m_command_lists[m_command_list_index]);
+
+		// 创建渲染线程
+		m_render_exit = false;
+		win32_thread_render.Attach(CreateThread(NULL, 0, &win32_thread_render_entry, this, 0, NULL));
+		if (!win32_thread_render.IsValid())
+		{
+			gHRLastError;
+			i18n_core_system_call_report_error("CreateThread");
+			m_recording_renderer.reset();
+			return false;
+		}
+		spdlog::info("[core] Pipelined rendering enabled");
+
+		bool const result = runSingleThread();
+
+		// 让渲染线程退出
+		waitRenderThread();
+		m_render_exit = true;
+		SetEvent(win32_event_render_submit.Get());
+		WaitForSingleObjectEx(win32_thread_render.Get(), INFINITE, FALSE);
+		win32_thread_render.Close();
+		spdlog::info("[core] Pipelined rendering finished, {} synchronization points", m_recording_renderer->getSynchronizeCount());
+
+		// 之后的渲染调用直接提交到设备
+		for (auto& list : m_command_lists)
+		{
+			list.clear();
+		}
+		m_recording_renderer.reset();
+		return result;
+	}
 	void ApplicationModel_Win32::runFrame()
 	{
+		if (m_recording_renderer)
+		{
+			runFramePipelined();
+			return;
+		}
+		flushFrameTelemetry();
 		size_t const i = (m_framestate_index + 1) % 2;
 		FrameStatistics& d = m_framestate[i];
 		ScopeTimer gt(d.total_time);
 		size_t const next_frame_query_index = (m_frame_query_index + 1) % m_frame_query_list.size();
 		FrameQuery& frame_query = m_frame_query_list[next_frame_query_index];
+		int64_t const update_begin = winQPC(); // 输入在更新开始时轮询
+		double input_latency = 0.0;
 		
 		bool update_result = false;
 
@@ -616,17 +859,96 @@ namespace core
 			tracy_zone_scoped_with_name("OnPresent");
 			ScopeTimer t(d.present_time);
 			m_swapchain->present();
+			input_latency = (double)(winQPC() - update_begin) / (double)winQPF();
 			TracyD3D11Collect(m_device->GetTracyContext());
 		}
 
 		// 等待下一帧
+		double frame_interval = 0.0;
 		{
 			tracy_zone_scoped_with_name("OnWait");
 			ScopeTimer t(d.wait_time);
-			m_swapchain->waitFrameLatency();
-			m_p_frame_rate_controller->update();
+			m_swapchain->waitFrameLatency();
+			frame_interval = m_p_frame_rate_controller->update();
+		}
+
+		samplePresentStatistics();
+		recordFrameTelemetry(d, frame_interval, input_latency);
+		m_framestate_index = i;
+		m_frame_query_index = next_frame_query_index;
+		FrameMark;
+	}
+	void ApplicationModel_Win32::runFramePipelined()
+	{
+		// 与 runFrame 的区别：render_time 是录制渲染命令的时间，present_time 是等待渲染线程空闲的时间
+		flushFrameTelemetry();
+		size_t const i = (m_framestate_index + 1) % 2;
+		FrameStatistics& d = m_framestate[i];
+		ScopeTimer gt(d.total_time);
+		size_t const next_frame_query_index = (m_frame_query_index + 1) % m_frame_query_list.size();
+		FrameQuery& frame_query = m_frame_query_list[next_frame_query_index];
+		auto& command_list = m_command_lists[m_command_list_index];
+		int64_t const update_begin = winQPC(); // 输入在更新开始时轮询
+
+		bool update_result = false;
+
+		// 更新
+		{
+			tracy_zone_scoped_with_name("OnUpdate");
+			ScopeTimer t(d.update_time);
+			update_result = m_listener->onUpdate();
+		}
+
+		bool render_result = false;
+
+		// 录制
+		if (update_result)
+		{
+			tracy_zone_scoped_with_name("OnRecord");
+			ScopeTimer t(d.render_time);
+			command_list.callback([](void* userdata, Graphics::IRenderer*)
+			{
+				static_cast<FrameQuery*>(userdata)->begin();
+			}, &frame_query);
+			command_list.callback([](void* userdata, Graphics::IRenderer*)
+			{
+				auto const swapchain = static_cast<Graphics::SwapChain_D3D11*>(userdata);
+				swapchain->applyRenderAttachment();
+				swapchain->clearRenderAttachment();
+			}, *m_swapchain);
+			render_result = m_listener->onRender();
+			command_list.callback([](void* userdata, Graphics::IRenderer*)
+			{
+				static_cast<FrameQuery*>(userdata)->end();
+			}, &frame_query);
+		}
+
+		// 提交给渲染线程，上一帧的命令列表已经回放完，可以用来录制下一帧
+		{
+			tracy_zone_scoped_with_name("OnSubmit");
+			ScopeTimer t(d.present_time);
+			waitRenderThread();
+			samplePresentStatistics(); // 渲染线程空闲，不会和呈现同时访问交换链
+			m_render_submit_list = &command_list;
+			m_render_submit_present = render_result;
+			m_render_submit_update_begin = update_begin;
+			ResetEvent(win32_event_render_idle.Get());
+			SetEvent(win32_event_render_submit.Get());
 		}
+		m_command_list_index = (m_command_list_index + 1) % std::size(m_command_lists);
+		m_command_lists[m_command_list_index].clear();
+		m_recording_renderer->setCommandList(&m_command_lists[m_command_list_index]);
 
+		// 等待下一帧，交换链的帧延迟由渲染线程等待
+		double frame_interval = 0.0;
+		{
+			tracy_zone_scoped_with_name("OnWait");
+			ScopeTimer t(d.wait_time);
+			frame_interval = m_p_frame_rate_controller->update();
+		}
+
+		// 这一帧还没有呈现，输入延迟使用渲染线程最近一次呈现的结果
+		recordFrameTelemetry(d, frame_interval, m_render_input_latency.load(std::memory_order_relaxed));
 		m_framestate_index = i;
 		m_frame_query_index = next_frame_query_index;
 		FrameMark;
@@ -643,6 +965,94 @@ namespace core
 		statistics.render_time = frame_query.getTime();
 		return statistics;
 	}
+	void ApplicationModel_Win32::recordFrameTelemetry(FrameStatistics const& d, double const frame_interval, double const input_latency)
+	{
+		// 总时间要等 runFrame 结束才知道，先暂存，下一帧开始时再写入
+		auto& record = m_frame_telemetry_pending;
+		record.frame = m_p_frame_rate_controller->getTotalFrame();
+		record.update_time = d.update_time;
+		record.render_time = d.render_time;
+		record.present_time = d.present_time;
+		record.wait_time = d.wait_time;
+		record.sleep_overshoot = m_p_frame_rate_controller->getSleepOvershoot();
+		record.input_latency = input_latency;
+		record.missed_vblank = 0;
+		if (m_present_missed_vblank_valid)
+		{
+			record.missed_vblank = m_present_missed_vblank;
+		}
+		else
+		{
+			// 按目标帧率估算：帧间隔超过 1.5 个周期，就认为错过了垂直同步
+			double const target_interval = 1.0 / double(std::max<uint32_t>(1, m_p_frame_rate_controller->getTargetFPS()));
+			if (frame_interval > target_interval * 1.5)
+			{
+				record.missed_vblank = static_cast<uint32_t>(std::lround(frame_interval / target_interval)) - 1;
+			}
+		}
+		m_frame_telemetry_has_pending = true;
+	}
+	void ApplicationModel_Win32::samplePresentStatistics()
+	{
+		// 和上一次统计比较；窗口模式下的传统交换链等情况拿不到统计，改用估算
+		m_present_missed_vblank_valid = false;
+		DXGI_FRAME_STATISTICS statistics{};
+		auto const swap_chain = m_swapchain->GetDXGISwapChain1();
+		if (!swap_chain || FAILED(swap_chain->GetFrameStatistics(&statistics)))
+		{
+			m_present_statistics_valid = false;
+			return;
+		}
+		FramePresentStatistics const current{
+			.present_count = statistics.PresentCount,
+			.present_refresh_count = statistics.PresentRefreshCount,
+			.sync_refresh_count = statistics.SyncRefreshCount,
+			.sync_qpc_time = statistics.SyncQPCTime.QuadPart,
+		};
+		if (m_present_statistics_valid)
+		{
+			double const target_interval = 1.0 / double(std::max<uint32_t>(1, m_p_frame_rate_controller->getTargetFPS()));
+			m_present_missed_vblank_valid = computeMissedVBlank(m_present_statistics, current, target_interval, winQPF(), m_present_missed_vblank);
+		}
+		m_present_statistics = current;
+		m_present_statistics_valid = true;
+	}
+	void ApplicationModel_Win32::flushFrameTelemetry()
+	{
+		if (!m_frame_telemetry_has_pending)
+		{
+			return;
+		}
+		m_frame_telemetry_pending.total_time = m_framestate[m_framestate_index].total_time;
+		m_frame_telemetry.push(m_frame_telemetry_pending);
+		m_frame_telemetry_has_pending = false;
+	}
+	void ApplicationModel_Win32::executeOnRenderThread(void (*callback)(void* userdata, Graphics::IRenderer* renderer), void* userdata)
+	{
+		assert(callback);
+		if (m_recording_renderer)
+		{
+			m_recording_renderer->getCommandList()->callback(callback, userdata);
+		}
+		else
+		{
+			callback(userdata, *m_renderer);
+		}
+	}
+	void ApplicationModel_Win32::synchronizeRenderThread()
+	{
+		if (m_recording_renderer)
+		{
+			std::ignore = m_recording_renderer->synchronize();
+		}
+	}
+
+	void ApplicationModel_Win32::onWindowCreate() { queueWindowEvent({ .type = WindowEvent::Type::Create }); }
+	void ApplicationModel_Win32::onWindowDestroy() { queueWindowEvent({ .type = WindowEvent::Type::Destroy }); }
+	void ApplicationModel_Win32::onWindowActive() { queueWindowEvent({ .type = WindowEvent::Type::Active }); }
+	void ApplicationModel_Win32::onWindowInactive() { queueWindowEvent({ .type = WindowEvent::Type::Inactive }); }
+	void ApplicationModel_Win32::onWindowSize(Vector2U size) { queueWindowEvent({ .type = WindowEvent::Type::Size, .size = size }); }
+	void ApplicationModel_Win32::onWindowFullscreenStateChange(bool state) { queueWindowEvent({ .type = WindowEvent::Type::FullscreenStateChange, .fullscreen_state = state }); }
 
 	void ApplicationModel_Win32::requestExit()
 	{
@@ -651,6 +1061,14 @@ namespace core
 	}
 	bool ApplicationModel_Win32::run()
 	{
+		if (m_headless)
+		{
+			return runHeadless();
+		}
+		if (m_pipelined)
+		{
+			return runPipelined();
+		}
 		return runSingleThread();
 	}
 
@@ -661,22 +1079,43 @@ namespace core
 		spdlog::info("[core] System: {}", Platform::WindowsVersion::GetName());
 		spdlog::info("[core] Kernel: {}", Platform::WindowsVersion::GetKernelVersionString());
 		spdlog::info("[core] CPU: {}", Platform::ProcessorInfo::name());
-		if (m_steady_frame_rate_controller.available()) {
+		auto const& simulation = core::ConfigurationLoader::getInstance().getSimulation();
+		m_headless = simulation.isHeadless();
+		m_headless_frame_limit = simulation.getFrameLimit();
+		auto const& timing = core::ConfigurationLoader::getInstance().getTiming();
+		if (m_headless) {
+			spdlog::info("[core] Headless mode enabled, frame limit: {}", m_headless_frame_limit);
+			m_p_frame_rate_controller = &m_headless_frame_rate_controller;
+		}
+		else if (timing.getFramePacer() == ConfigurationLoader::Timing::FramePacer::hybrid) {
+			spdlog::info("[core] Enable HybridFrameRateController, max catch-up frames: {}", timing.getMaxCatchUpFrames());
+			m_hybrid_frame_rate_controller.getPacer().setMaxCatchUpFrames(timing.getMaxCatchUpFrames());
+			m_p_frame_rate_controller = &m_hybrid_frame_rate_controller;
+		}
+		else if (m_steady_frame_rate_controller.available()) {
 			spdlog::info("[core] High Resolution Waitable Timer available, enable SteadyFrameRateController");
 			m_p_frame_rate_controller = &m_steady_frame_rate_controller;
 		}
 		else {
 			m_p_frame_rate_controller = &m_frame_rate_controller;
 		}
+		m_pipelined = !m_headless && core::ConfigurationLoader::getInstance().getGraphicsSystem().isPipelinedRendering();
 		get_system_memory_status();
 		if (!Graphics::Window_Win32::create(m_window.put()))
 			throw std::runtime_error("Graphics::Window_Win32::create");
 		m_window->implSetApplicationModel(this);
+		if (m_pipelined) {
+			// 窗口事件先通知到这里，等渲染线程空闲后再转发给交换链
+			m_window->addEventListener(this);
+		}
 		auto const& gpu = core::ConfigurationLoader::getInstance().getGraphicsSystem().getPreferredDeviceName();
 		if (!Graphics::Direct3D11::Device::create(gpu, m_device.put()))
 			throw std::runtime_error("Graphics::Direct3D11::Device::create");
-		if (!Graphics::SwapChain_D3D11::create(*m_window, *m_device, m_swapchain.put()))
-			throw std::runtime_error("Graphics::SwapChain_D3D11::create");
+		if (!Graphics::SwapChain_D3D11::create(*m_window, *m_device, m_swapchain.put()))
+			throw std::runtime_error("Graphics::SwapChain_D3D11::create");
+		if (m_pipelined) {
+			m_window->removeEventListener(m_swapchain.get());
+		}
 		if (!Graphics::Renderer_D3D11::create(*m_device, m_renderer.put()))
 			throw std::runtime_error("Graphics::Renderer_D3D11::create");
 		m_frame_query_list.reserve(2);
@@ -686,7 +1125,9 @@ namespace core
 	}
 	ApplicationModel_Win32::~ApplicationModel_Win32()
 	{
-		std::ignore = 0;
+		if (m_pipelined) {
+			m_window->removeEventListener(this);
+		}
 	}
 
 	bool IApplicationModel::create(IApplicationEventListener* p_app, IApplicationModel** pp_model)
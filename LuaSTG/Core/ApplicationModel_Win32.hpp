@@ -5,6 +5,8 @@
 #include "Core/Graphics/Direct3D11/Device.hpp"
 #include "Core/Graphics/SwapChain_D3D11.hpp"
 #include "Core/Graphics/Renderer_D3D11.hpp"
+#include "Core/Graphics/Common/RecordingRenderer.hpp"
+#include "Core/FramePacer.hpp"
 
 namespace core
 {
@@ -23,6 +25,7 @@ namespace core
 		double fps_min_{};
 		double fps_max_{};
 		size_t fps_index_{};
+		double sleep_overshoot_{};
 	private:
 		double indexFPS(size_t idx);
 	public:
@@ -38,6 +41,7 @@ namespace core
 		double getAvgFPS();
 		double getMinFPS();
 		double getMaxFPS();
+		double getSleepOvershoot();
 	public:
 		FrameRateController(uint32_t target_FPS = 60);
 		~FrameRateController();
@@ -54,6 +58,7 @@ namespace core
 		int64_t begin_pc_{ 0 };
 		int64_t last_pc_{ 0 };
 		int64_t frame_count_{ 0 };
+		double sleep_overshoot_{ 0.0 };
 	public:
 		bool arrive();
 		double update();
@@ -66,6 +71,7 @@ namespace core
 		double getAvgFPS();
 		double getMinFPS();
 		double getMaxFPS();
+		double getSleepOvershoot();
 	public:
 		TimeStampFrameRateController(uint32_t target_FPS = 60);
 		~TimeStampFrameRateController();
@@ -92,6 +98,7 @@ namespace core
 		size_t m_time_history_index{};
 		double m_last_avg_fps{};
 		double m_update_avg_fps_timer{};
+		double m_sleep_overshoot{};
 	private:
 		double updateTime()
 		{
@@ -148,6 +155,7 @@ namespace core
 			if (std::abs(current_time.QuadPart - (m_target_time.QuadPart + m_target_delta.QuadPart)) >= (m_target_delta.QuadPart * 10))
 			{
 				m_target_time.QuadPart = current_time.QuadPart;
+				m_sleep_overshoot = 0.0;
 				return updateTime(); // 立即放弃等待，尽快追上
 			}
 
@@ -166,6 +174,12 @@ namespace core
 				return updateTime();
 			}
 
+			// 醒来的时间，用更精确的时间戳测量
+			GetSystemTimePreciseAsFileTime(&file_time);
+			current_time.LowPart = file_time.dwLowDateTime;
+			current_time.HighPart = static_cast<LONG>(file_time.dwHighDateTime);
+			m_sleep_overshoot = std::max(0.0, double(current_time.QuadPart - m_target_time.QuadPart) / 10000000.0);
+
 			return updateTime();
 		}
 	public:
@@ -191,6 +205,7 @@ namespace core
 		double getAvgFPS() { return m_last_avg_fps; }
 		double getMinFPS() { return m_last_min_fps; }
 		double getMaxFPS() { return m_last_max_fps; }
+		double getSleepOvershoot() { return m_sleep_overshoot; }
 	public:
 		bool available() { return !!m_event; }
 	public:
@@ -204,6 +219,78 @@ namespace core
 		~SteadyFrameRateController() = default;
 	};
 
+	// 基于可移植的 FramePacer，睡眠和忙等待的余量根据实测的睡眠误差调整
+	class HybridFrameRateController : public IFrameRateController
+	{
+	private:
+		SteadyFramePacerClock m_clock;
+		FramePacer m_pacer{ &m_clock };
+		uint32_t m_target_frame_rate{};
+		double m_last_fps{};
+		double m_last_max_fps{};
+		double m_last_min_fps{};
+		uint64_t m_total_frame{};
+		double m_total_time{};
+		std::array<double, 60> m_time_history{};
+		size_t m_time_history_index{};
+		double m_last_avg_fps{};
+	public:
+		double update()
+		{
+			double const delta_s = std::chrono::duration<double>(m_pacer.wait()).count();
+			m_last_fps = delta_s > 0.0 ? 1.0 / delta_s : 0.0;
+			m_total_frame += 1;
+			m_total_time += delta_s;
+			m_time_history[m_time_history_index] = delta_s;
+			m_time_history_index = (m_time_history_index + 1) % m_time_history.size();
+
+			size_t const count = std::min<size_t>(m_total_frame, m_time_history.size());
+			double total_s{};
+			double min_s{ std::numeric_limits<double>::max() };
+			double max_s{};
+			for (size_t i = 0; i < count; i += 1) {
+				double const v = m_time_history[(m_time_history_index + m_time_history.size() - 1 - i) % m_time_history.size()];
+				total_s += v;
+				min_s = std::min(min_s, v);
+				max_s = std::max(max_s, v);
+			}
+			m_last_avg_fps = total_s > 0.0 ? double(count) / total_s : 0.0;
+			m_last_min_fps = max_s > 0.0 ? 1.0 / max_s : 0.0;
+			m_last_max_fps = min_s > 0.0 ? 1.0 / min_s : 0.0;
+			return delta_s;
+		}
+	public:
+		uint32_t getTargetFPS() { return m_target_frame_rate; }
+		void setTargetFPS(uint32_t target_frame_rate)
+		{
+			target_frame_rate = std::max<uint32_t>(1, target_frame_rate); // 保护措施
+			if (target_frame_rate == m_target_frame_rate) {
+				return;
+			}
+			m_target_frame_rate = target_frame_rate;
+			m_pacer.setFrameInterval(std::chrono::nanoseconds(1000000000ll / target_frame_rate));
+		}
+		double getFPS() { return m_last_fps; }
+		uint64_t getTotalFrame() { return m_total_frame; }
+		double getTotalTime() { return m_total_time; }
+		double getAvgFPS() { return m_last_avg_fps; }
+		double getMinFPS() { return m_last_min_fps; }
+		double getMaxFPS() { return m_last_max_fps; }
+		double getSleepOvershoot() { return std::chrono::duration<double>(m_pacer.getLastSleepError()).count(); }
+	public:
+		FramePacer& getPacer() { return m_pacer; }
+	public:
+		HybridFrameRateController()
+		{
+			timeBeginPeriod(1); // std::this_thread::sleep_for 依赖系统计时器精度
+			setTargetFPS(60);
+		}
+		~HybridFrameRateController()
+		{
+			timeEndPeriod(1);
+		}
+	};
+
 	class FrameQuery : public Graphics::IDeviceEventListener
 	{
 	private:
@@ -355,7 +442,36 @@ namespace core
 		}
 	};
 
-	class ApplicationModel_Win32 : public implement::ReferenceCounted<IApplicationModel>
+	// 无窗口快进模式使用的虚拟时钟，不等待，每帧固定前进 1/FPS 秒
+	class HeadlessFrameRateController : public IFrameRateController
+	{
+	private:
+		uint32_t m_target_frame_rate{ 60 };
+		uint64_t m_total_frame{};
+		double m_total_time{};
+	public:
+		double update()
+		{
+			double const delta_s = 1.0 / double(m_target_frame_rate);
+			m_total_frame += 1;
+			m_total_time += delta_s;
+			return delta_s;
+		}
+	public:
+		uint32_t getTargetFPS() { return m_target_frame_rate; }
+		void setTargetFPS(uint32_t target_frame_rate) { m_target_frame_rate = std::max<uint32_t>(1, target_frame_rate); }
+		double getFPS() { return double(m_target_frame_rate); }
+		uint64_t getTotalFrame() { return m_total_frame; }
+		double getTotalTime() { return m_total_time; }
+		double getAvgFPS() { return getFPS(); }
+		double getMinFPS() { return getFPS(); }
+		double getMaxFPS() { return getFPS(); }
+		double getSleepOvershoot() { return 0.0; }
+	};
+
+	class ApplicationModel_Win32
+		: public implement::ReferenceCounted<IApplicationModel>
+		, public Graphics::IWindowEventListener
 	{
 	private:
 		// 多个线程共享
@@ -372,17 +488,75 @@ namespace core
 		IFrameRateController* m_p_frame_rate_controller{};
 		FrameRateController m_frame_rate_controller;
 		SteadyFrameRateController m_steady_frame_rate_controller;
+		HybridFrameRateController m_hybrid_frame_rate_controller;
+		HeadlessFrameRateController m_headless_frame_rate_controller;
+		bool m_headless{};
+		uint64_t m_headless_frame_limit{};
 		IApplicationEventListener* m_listener{ nullptr };
 		size_t m_framestate_index{ 0 };
 		FrameStatistics m_framestate[2]{};
 		std::vector<FrameQuery> m_frame_query_list;
 		size_t m_frame_query_index{};
+		FrameTelemetry m_frame_telemetry;
+		FrameTelemetryRecord m_frame_telemetry_pending;
+		bool m_frame_telemetry_has_pending{};
+		FramePresentStatistics m_present_statistics;
+		bool m_present_statistics_valid{};
+		uint32_t m_present_missed_vblank{};
+		bool m_present_missed_vblank_valid{};
+
+		// 流水线渲染：工作线程录制渲染命令，渲染线程回放、呈现，同时工作线程开始更新下一帧
+
+		bool m_pipelined{};
+		SmartReference<Graphics::Common::RecordingRenderer> m_recording_renderer;
+		Graphics::Common::RenderCommandList m_command_lists[2];
+		size_t m_command_list_index{};
+		Microsoft::WRL::Wrappers::Event win32_event_render_submit;
+		Microsoft::WRL::Wrappers::Event win32_event_render_idle;
+		Microsoft::WRL::Wrappers::ThreadHandle win32_thread_render;
+		Graphics::Common::RenderCommandList* m_render_submit_list{};
+		int64_t m_render_submit_update_begin{};
+		std::atomic<double> m_render_input_latency{};
+		bool m_render_submit_present{};
+		bool m_render_exit{};
+		bool m_render_waiting{};
+
+		// 交换链不直接监听窗口事件，由这里转发，保证处理时渲染线程空闲
+		struct WindowEvent
+		{
+			enum class Type : uint8_t { Create, Destroy, Active, Inactive, Size, FullscreenStateChange };
+			Type type{};
+			Vector2U size{};
+			bool fullscreen_state{};
+		};
+		std::vector<WindowEvent> m_pending_window_events;
 
 		static DWORD WINAPI win32_thread_worker_entry(LPVOID lpThreadParameter);
 		void worker();
+		static DWORD WINAPI win32_thread_render_entry(LPVOID lpThreadParameter);
+		void renderWorker();
+		void waitRenderThread();
+		void queueWindowEvent(WindowEvent const& event);
+		void applyWindowEvent(WindowEvent const& event);
+		void runFramePipelined();
+		void recordFrameTelemetry(FrameStatistics const& d, double frame_interval, double input_latency);
+		void flushFrameTelemetry();
+		void samplePresentStatistics();
 
 		bool runSingleThread();
 		bool runDoubleThread();
+		bool runHeadless();
+		bool runPipelined();
+
+		// IWindowEventListener
+		// 窗口事件会修改交换链，必须等渲染线程空闲
+
+		void onWindowCreate() override;
+		void onWindowDestroy() override;
+		void onWindowActive() override;
+		void onWindowInactive() override;
+		void onWindowSize(Vector2U size) override;
+		void onWindowFullscreenStateChange(bool state) override;
 
 	public:
 		// 内部公开
@@ -394,15 +568,19 @@ namespace core
 
 		Graphics::IWindow* getWindow() { return *m_window; }
 		void requestExit();
+		bool isHeadless() { return m_headless; }
 
 		// 仅限工作线程
 
 		IFrameRateController* getFrameRateController() { return m_p_frame_rate_controller; };
 		Graphics::IDevice* getDevice() { return *m_device; }
 		Graphics::ISwapChain* getSwapChain() { return *m_swapchain; }
-		Graphics::IRenderer* getRenderer() { return *m_renderer; }
+		Graphics::IRenderer* getRenderer() { return m_recording_renderer ? static_cast<Graphics::IRenderer*>(*m_recording_renderer) : *m_renderer; }
 		FrameStatistics getFrameStatistics();
 		FrameRenderStatistics getFrameRenderStatistics();
+		FrameTelemetry* getFrameTelemetry() { return &m_frame_telemetry; }
+		void executeOnRenderThread(void (*callback)(void* userdata, Graphics::IRenderer* renderer), void* userdata);
+		void synchronizeRenderThread();
 
 		// 仅限主线程
 
@@ -0,0 +1,113 @@
+#include "Core/FramePacer.hpp"
+#include <cassert>
+#include <cmath>
+#include <algorithm>
+#include <thread>
+
+namespace core
+{
+	// SteadyFramePacerClock
+
+	std::chrono::nanoseconds SteadyFramePacerClock::now()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch());
+	}
+	void SteadyFramePacerClock::sleep(std::chrono::nanoseconds const duration)
+	{
+		std::this_thread::sleep_for(duration);
+	}
+	void SteadyFramePacerClock::relax()
+	{
+		std::this_thread::yield();
+	}
+
+	// FramePacer
+
+	FramePacer::Duration FramePacer::wait()
+	{
+		auto now = m_clock->now();
+		if (!m_started)
+		{
+			m_started = true;
+			m_target = now;
+			m_last = now;
+		}
+		m_target += m_interval;
+		m_last_sleep_error = Duration::zero();
+
+		if (now >= m_target)
+		{
+			// 已经落后，不等待
+			auto const behind_frames = static_cast<uint64_t>((now - m_target) / m_interval);
+			if (behind_frames >= m_max_catch_up_frames)
+			{
+				// 放弃追赶，以当前时间为新的基准
+				m_dropped_frames += behind_frames;
+				m_target = now;
+			}
+			m_last_overshoot = Duration::zero();
+		}
+		else
+		{
+			// 睡眠到目标时间之前的余量
+			auto const remaining = m_target - now;
+			if (remaining > m_spin_margin)
+			{
+				auto const request = remaining - m_spin_margin;
+				m_clock->sleep(request);
+				auto const wake = m_clock->now();
+				m_last_sleep_error = (wake - now) - request;
+				updateSpinMargin(m_last_sleep_error);
+				now = wake;
+			}
+			// 忙等待剩下的时间
+			while (now < m_target)
+			{
+				m_clock->relax();
+				now = m_clock->now();
+			}
+			m_last_overshoot = now - m_target;
+		}
+
+		auto const delta = now - m_last;
+		m_last = now;
+		return delta;
+	}
+
+	void FramePacer::setFrameInterval(Duration const interval) noexcept
+	{
+		assert(interval > Duration::zero());
+		m_interval = std::max(interval, Duration(1));
+		m_started = false;
+	}
+	void FramePacer::setSpinMarginRange(Duration const min_margin, Duration const max_margin) noexcept
+	{
+		assert(min_margin <= max_margin);
+		m_min_spin_margin = std::max(min_margin, Duration::zero());
+		m_max_spin_margin = std::max(max_margin, m_min_spin_margin);
+		m_spin_margin = std::clamp(m_spin_margin, m_min_spin_margin, m_max_spin_margin);
+	}
+	FramePacer::Duration FramePacer::getSleepErrorMean() const noexcept
+	{
+		return Duration(static_cast<int64_t>(m_sleep_error_mean));
+	}
+
+	void FramePacer::updateSpinMargin(Duration const sleep_error) noexcept
+	{
+		// 指数加权的均值和方差，最开始的几次直接取平均，尽快收敛
+		double const error = static_cast<double>(sleep_error.count());
+		m_sleep_count += 1;
+		double const alpha = std::max(1.0 / static_cast<double>(m_sleep_count), 1.0 / 16.0);
+		double const diff = error - m_sleep_error_mean;
+		m_sleep_error_mean += alpha * diff;
+		m_sleep_error_variance = (1.0 - alpha) * (m_sleep_error_variance + alpha * diff * diff);
+
+		double const margin = m_sleep_error_mean + 3.0 * std::sqrt(m_sleep_error_variance);
+		m_spin_margin = std::clamp(Duration(static_cast<int64_t>(margin)), m_min_spin_margin, m_max_spin_margin);
+	}
+
+	FramePacer::FramePacer(IFramePacerClock* const clock) : m_clock(clock)
+	{
+		assert(clock);
+	}
+}
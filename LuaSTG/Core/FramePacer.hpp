@@ -0,0 +1,82 @@
+#pragma once
+#include <cstdint>
+#include <chrono>
+
+namespace core
+{
+	// 帧节拍器使用的时钟，测试时可以替换为虚拟时钟
+	struct IFramePacerClock
+	{
+		// 单调递增的当前时间
+		virtual std::chrono::nanoseconds now() = 0;
+		// 粗略的睡眠，允许醒来得比预期晚
+		virtual void sleep(std::chrono::nanoseconds duration) = 0;
+		// 忙等待的每一轮调用，用于让出流水线或者时间片
+		virtual void relax() = 0;
+	};
+
+	// 基于 std::chrono::steady_clock 和 std::this_thread 的时钟
+	class SteadyFramePacerClock final : public IFramePacerClock
+	{
+	public:
+		std::chrono::nanoseconds now() override;
+		void sleep(std::chrono::nanoseconds duration) override;
+		void relax() override;
+	};
+
+	// 可移植的帧节拍器：先睡眠到目标时间之前的一段余量，剩下的时间忙等待
+	// 余量根据实测的睡眠误差（均值 + 3 倍标准差）自适应调整，睡眠越准，忙等待占用的 CPU 越少
+	// 落后于目标时间时：落后不超过 max_catch_up_frames 帧则保持原来的时间表，用之后的帧追上；否则丢弃落后的帧，以当前时间为新的基准
+	class FramePacer
+	{
+	public:
+		using Duration = std::chrono::nanoseconds;
+
+		static constexpr Duration default_spin_margin{ std::chrono::microseconds(2000) };
+		static constexpr Duration default_min_spin_margin{ std::chrono::microseconds(200) };
+		static constexpr Duration default_max_spin_margin{ std::chrono::microseconds(4000) };
+
+		// 等待到下一帧的目标时间，返回和上一帧之间的实际间隔
+		Duration wait();
+		// 下一次 wait 以当前时间为基准重新开始
+		void reset() noexcept { m_started = false; }
+
+		void setFrameInterval(Duration interval) noexcept;
+		[[nodiscard]] Duration getFrameInterval() const noexcept { return m_interval; }
+		void setMaxCatchUpFrames(uint32_t frames) noexcept { m_max_catch_up_frames = frames; }
+		[[nodiscard]] uint32_t getMaxCatchUpFrames() const noexcept { return m_max_catch_up_frames; }
+		void setSpinMarginRange(Duration min_margin, Duration max_margin) noexcept;
+
+		// 当前的忙等待余量
+		[[nodiscard]] Duration getSpinMargin() const noexcept { return m_spin_margin; }
+		// 上一帧实际醒来的时间比目标时间晚了多少，没有等待时为 0
+		[[nodiscard]] Duration getLastOvershoot() const noexcept { return m_last_overshoot; }
+		// 上一帧的睡眠实际比请求的多睡了多久，即忙等待之前的误差，没有睡眠时为 0
+		[[nodiscard]] Duration getLastSleepError() const noexcept { return m_last_sleep_error; }
+		// 实测的睡眠误差（实际睡眠时间减去请求的睡眠时间）的平均值
+		[[nodiscard]] Duration getSleepErrorMean() const noexcept;
+		// 因为落后太多而丢弃的帧数
+		[[nodiscard]] uint64_t getDroppedFrames() const noexcept { return m_dropped_frames; }
+
+		explicit FramePacer(IFramePacerClock* clock);
+
+	private:
+		void updateSpinMargin(Duration sleep_error) noexcept;
+
+		IFramePacerClock* m_clock{};
+		Duration m_interval{ std::chrono::nanoseconds(1000000000 / 60) };
+		Duration m_target{}; // 下一帧的目标时间
+		Duration m_last{}; // 上一帧实际的时间
+		Duration m_spin_margin{ default_spin_margin };
+		Duration m_min_spin_margin{ default_min_spin_margin };
+		Duration m_max_spin_margin{ default_max_spin_margin };
+		Duration m_last_overshoot{};
+		Duration m_last_sleep_error{};
+		double m_sleep_error_mean{}; // 纳秒
+		double m_sleep_error_variance{}; // 纳秒的平方
+		uint64_t m_sleep_count{};
+		uint64_t m_dropped_frames{};
+		uint32_t m_max_catch_up_frames{};
+		bool m_started{};
+	};
+}
@@ -0,0 +1,171 @@
+#include "Core/FrameTelemetry.hpp"
+#include <cassert>
+#include <cmath>
+#include <algorithm>
+#include <iterator>
+#include <fstream>
+#include "spdlog/spdlog.h"
+
+namespace core
+{
+	namespace
+	{
+		// 最近邻秩法，values 会被排序
+		FrameTelemetryPercentile computePercentile(std::vector<double>& values)
+		{
+			FrameTelemetryPercentile result;
+			if (values.empty())
+			{
+				return result;
+			}
+			std::sort(values.begin(), values.end());
+			auto const rank = [&values](double const p) -> double
+			{
+				size_t const n = values.size();
+				size_t const index = static_cast<size_t>(std::ceil(p * static_cast<double>(n)));
+				return values[std::clamp<size_t>(index, 1, n) - 1];
+			};
+			result.p50 = rank(0.50);
+			result.p95 = rank(0.95);
+			result.p99 = rank(0.99);
+			result.max = values.back();
+			return result;
+		}
+	}
+
+	bool computeMissedVBlank(FramePresentStatistics const& previous, FramePresentStatistics const& current,
+		double const target_interval, int64_t const qpc_frequency, uint32_t& missed)
+	{
+		// 计数是无符号的，差值自然处理回绕；计数倒退时差值会非常大
+		constexpr uint32_t max_delta = 0x10000;
+		uint32_t const sync_refreshes = current.sync_refresh_count - previous.sync_refresh_count;
+		uint32_t const present_refreshes = current.present_refresh_count - previous.present_refresh_count;
+		uint32_t const presents = current.present_count - previous.present_count;
+		int64_t const sync_time = current.sync_qpc_time - previous.sync_qpc_time;
+		if (sync_refreshes == 0 || sync_refreshes > max_delta || present_refreshes > max_delta || presents > max_delta
+			|| sync_time <= 0 || qpc_frequency <= 0)
+		{
+			return false;
+		}
+		double const refresh_period = static_cast<double>(sync_time) / static_cast<double>(qpc_frequency) / static_cast<double>(sync_refreshes);
+		auto const refreshes_per_frame = static_cast<uint32_t>(std::max(1l, std::lround(target_interval / refresh_period)));
+		uint64_t const expected = static_cast<uint64_t>(presents) * refreshes_per_frame;
+		missed = (present_refreshes > expected) ? static_cast<uint32_t>(present_refreshes - expected) : 0;
+		return true;
+	}
+
+	void FrameTelemetry::push(FrameTelemetryRecord const& record)
+	{
+		if (!m_enable || m_records.empty())
+		{
+			return;
+		}
+		m_records[m_next] = record;
+		m_next = (m_next + 1) % m_records.size();
+		m_size = std::min(m_size + 1, m_records.size());
+	}
+	void FrameTelemetry::clear() noexcept
+	{
+		m_next = 0;
+		m_size = 0;
+	}
+
+	FrameTelemetryRecord const& FrameTelemetry::at(size_t const index) const noexcept
+	{
+		assert(index < m_size);
+		return m_records[(m_next + m_records.size() - m_size + index) % m_records.size()];
+	}
+	FrameTelemetryRecord FrameTelemetry::last() const noexcept
+	{
+		if (m_size == 0)
+		{
+			return {};
+		}
+		return at(m_size - 1);
+	}
+
+	FrameTelemetrySummary FrameTelemetry::summarize(size_t count) const
+	{
+		if (count == 0 || count > m_size)
+		{
+			count = m_size;
+		}
+		size_t const first = m_size - count;
+
+		FrameTelemetrySummary summary;
+		summary.frame_count = count;
+		std::vector<double> values;
+		values.reserve(count);
+		auto const collect = [&](double FrameTelemetryRecord::* field) -> FrameTelemetryPercentile
+		{
+			values.clear();
+			for (size_t i = first; i < m_size; i += 1)
+			{
+				values.push_back(at(i).*field);
+			}
+			return computePercentile(values);
+		};
+		summary.total_time = collect(&FrameTelemetryRecord::total_time);
+		summary.update_time = collect(&FrameTelemetryRecord::update_time);
+		summary.render_time = collect(&FrameTelemetryRecord::render_time);
+		summary.present_time = collect(&FrameTelemetryRecord::present_time);
+		summary.wait_time = collect(&FrameTelemetryRecord::wait_time);
+		summary.sleep_overshoot = collect(&FrameTelemetryRecord::sleep_overshoot);
+		summary.input_latency = collect(&FrameTelemetryRecord::input_latency);
+		for (size_t i = first; i < m_size; i += 1)
+		{
+			auto const missed = at(i).missed_vblank;
+			summary.missed_vblank += missed;
+			summary.missed_frame_count += (missed > 0) ? 1 : 0;
+		}
+		return summary;
+	}
+
+	std::string FrameTelemetry::toCSV(size_t count) const
+	{
+		if (count == 0 || count > m_size)
+		{
+			count = m_size;
+		}
+		std::string csv;
+		csv.reserve(64 + count * 96);
+		csv.append("frame,total_ms,update_ms,render_ms,present_ms,wait_ms,sleep_overshoot_ms,input_latency_ms,missed_vblank\n");
+		for (size_t i = m_size - count; i < m_size; i += 1)
+		{
+			auto const& r = at(i);
+			fmt::format_to(std::back_inserter(csv), "{},{:.4f},{:.4f},{:.4f},{:.4f},{:.4f},{:.4f},{:.4f},{}\n",
+				r.frame,
+				r.total_time * 1000.0,
+				r.update_time * 1000.0,
+				r.render_time * 1000.0,
+				r.present_time * 1000.0,
+				r.wait_time * 1000.0,
+				r.sleep_overshoot * 1000.0,
+				r.input_latency * 1000.0,
+				r.missed_vblank);
+		}
+		return csv;
+	}
+	bool FrameTelemetry::writeCSV(std::filesystem::path const& path, size_t const count) const
+	{
+		std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!file.is_open())
+		{
+			spdlog::error("[core] Failed to open frame telemetry file");
+			return false;
+		}
+		auto const csv = toCSV(count);
+		file.write(csv.data(), static_cast<std::streamsize>(csv.size()));
+		if (!file.good())
+		{
+			spdlog::error("[core] Failed to write frame telemetry file");
+			return false;
+		}
+		return true;
+	}
+
+	FrameTelemetry::FrameTelemetry(size_t const capacity)
+		: m_records(std::max<size_t>(1, capacity))
+	{
+	}
+}
@@ -0,0 +1,93 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <string>
+#include <filesystem>
+
+namespace core
+{
+	// 单帧的帧时序记录，时间单位都是秒
+	struct FrameTelemetryRecord
+	{
+		uint64_t frame{};
+		double total_time{};
+		double update_time{};
+		double render_time{};
+		double present_time{}; // 呈现（流水线渲染时为等待渲染线程空闲）的时间
+		double wait_time{};
+		double sleep_overshoot{}; // 帧率控制器实际醒来的时间比目标时间晚了多少
+		double input_latency{}; // 从开始更新（轮询输入）到呈现完成
+		uint32_t missed_vblank{}; // 错过的垂直同步次数，交换链没有呈现统计时按目标帧率估算
+	};
+
+	// 交换链的呈现统计，对应 DXGI_FRAME_STATISTICS
+	struct FramePresentStatistics
+	{
+		uint32_t present_count{};
+		uint32_t present_refresh_count{};
+		uint32_t sync_refresh_count{};
+		int64_t sync_qpc_time{};
+	};
+
+	// 由前后两次呈现统计计算错过的垂直同步次数：
+	// 刷新周期为两次统计之间 SyncQPCTime 的差除以 SyncRefreshCount 的差，每帧应该占用 target_interval 对应的刷新次数（至少 1 次），
+	// 新显示的帧实际占用的刷新次数（PresentRefreshCount 的差）超出的部分就是错过的次数
+	// 统计不连续（交换链重建后计数重新开始、两次统计之间没有刷新）时返回 false，此时应该改用估算
+	bool computeMissedVBlank(FramePresentStatistics const& previous, FramePresentStatistics const& current,
+		double target_interval, int64_t qpc_frequency, uint32_t& missed);
+
+	struct FrameTelemetryPercentile
+	{
+		double p50{};
+		double p95{};
+		double p99{};
+		double max{};
+	};
+
+	struct FrameTelemetrySummary
+	{
+		size_t frame_count{};
+		FrameTelemetryPercentile total_time;
+		FrameTelemetryPercentile update_time;
+		FrameTelemetryPercentile render_time;
+		FrameTelemetryPercentile present_time;
+		FrameTelemetryPercentile wait_time;
+		FrameTelemetryPercentile sleep_overshoot;
+		FrameTelemetryPercentile input_latency;
+		uint64_t missed_vblank{}; // 错过的垂直同步总数
+		size_t missed_frame_count{}; // 错过垂直同步的帧数
+	};
+
+	// 帧时序环形缓冲区，保存最近 capacity 帧的记录，用来定位玩家机器上的卡顿
+	class FrameTelemetry
+	{
+	public:
+		static constexpr size_t default_capacity{ 3600 }; // 60 FPS 下约 1 分钟
+
+		void push(FrameTelemetryRecord const& record);
+		void clear() noexcept;
+		void setEnable(bool enable) noexcept { m_enable = enable; }
+		[[nodiscard]] bool isEnable() const noexcept { return m_enable; }
+
+		[[nodiscard]] size_t size() const noexcept { return m_size; }
+		[[nodiscard]] size_t capacity() const noexcept { return m_records.size(); }
+		// index 为 0 表示最旧的记录
+		[[nodiscard]] FrameTelemetryRecord const& at(size_t index) const noexcept;
+		// 最新的记录，没有记录时返回空记录
+		[[nodiscard]] FrameTelemetryRecord last() const noexcept;
+
+		// 统计最近 count 帧，count 为 0 表示全部
+		[[nodiscard]] FrameTelemetrySummary summarize(size_t count = 0) const;
+		// 导出最近 count 帧为 CSV，count 为 0 表示全部
+		[[nodiscard]] std::string toCSV(size_t count = 0) const;
+		bool writeCSV(std::filesystem::path const& path, size_t count = 0) const;
+
+		explicit FrameTelemetry(size_t capacity = default_capacity);
+
+	private:
+		std::vector<FrameTelemetryRecord> m_records;
+		size_t m_next{};
+		size_t m_size{};
+		bool m_enable{ true };
+	};
+}
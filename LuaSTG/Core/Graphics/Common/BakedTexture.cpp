@@ -0,0 +1,62 @@
+#include "Core/Graphics/Common/BakedTexture.hpp"
+#include "core/FileSystem.hpp"
+#include "core/SmartReference.hpp"
+#include <cstdint>
+#include <cstring>
+
+namespace {
+	using std::string_view_literals::operator ""sv;
+
+	// 参考 DDSTextureLoader 的 DDS_HEADER，偏移量不包含开头的 "DDS " 标识
+	constexpr size_t dds_magic_size = 4;
+	constexpr size_t dds_header_size = 124;
+	constexpr size_t dds_header_mip_map_count_offset = 24;
+
+	uint32_t readUInt32(core::IData* const data, size_t const offset) {
+		uint32_t value{};
+		std::memcpy(&value, static_cast<uint8_t const*>(data->data()) + offset, sizeof(value));
+		return value;
+	}
+}
+
+namespace core::Graphics::Common {
+	std::string getBakedTexturePath(std::string_view const path) {
+		std::string baked(path);
+		baked.append(".dds"sv);
+		return baked;
+	}
+
+	bool isDdsFile(IData* const data) {
+		if (data == nullptr || data->size() < dds_magic_size + dds_header_size) {
+			return false;
+		}
+		return std::memcmp(data->data(), "DDS ", dds_magic_size) == 0
+			&& readUInt32(data, dds_magic_size) == dds_header_size; // DDS_HEADER::dwSize
+	}
+
+	bool dropDdsMipmaps(IData* const data) {
+		if (!isDdsFile(data)) {
+			return false;
+		}
+		uint32_t const mip_map_count = 1;
+		std::memcpy(static_cast<uint8_t*>(data->data()) + dds_magic_size + dds_header_mip_map_count_offset, &mip_map_count, sizeof(mip_map_count));
+		return true;
+	}
+
+	bool readBakedTexture(std::string_view const path, bool const mipmap, IData** const output) {
+		if (path.ends_with(".dds"sv)) {
+			return false;
+		}
+		// 直接读取，文件不存在时读取失败即可，不需要先检查
+		SmartReference<IData> data;
+		if (!FileSystemManager::readFile(getBakedTexturePath(path), data.put()) || !isDdsFile(data.get())) {
+			return false;
+		}
+		// 预压缩纹理总是包含完整的 mipmap 链
+		if (!mipmap) {
+			dropDdsMipmaps(data.get());
+		}
+		*output = data.detach();
+		return true;
+	}
+}
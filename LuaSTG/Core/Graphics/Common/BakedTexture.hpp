@@ -0,0 +1,19 @@
+#pragma once
+#include "core/Data.hpp"
+#include <string>
+#include <string_view>
+
+namespace core::Graphics::Common {
+	// texture-compressor 把预压缩的纹理保存在原文件旁边，文件名为 "<path>.dds"
+	std::string getBakedTexturePath(std::string_view path);
+
+	// 检查 DDS 文件头："DDS " 标识以及完整的 DDS_HEADER
+	bool isDdsFile(IData* data);
+
+	// 只保留第一级 mipmap（修改 DDS_HEADER::dwMipMapCount），文件头无效时不修改并返回 false
+	bool dropDdsMipmaps(IData* data);
+
+	// 读取 path 对应的预压缩纹理，mipmap 为 false 时只保留第一级
+	// path 本身是 DDS、预压缩纹理不存在或者无效时返回 false，调用者应该读取 path
+	bool readBakedTexture(std::string_view path, bool mipmap, IData** output);
+}
@@ -29,17 +29,18 @@ namespace {
 
 		[[nodiscard]] uint32_t width() const noexcept { return m_bitmap->width; }
 		[[nodiscard]] uint32_t height() const noexcept { return m_bitmap->rows; }
-		[[nodiscard]] uint32_t pixel(uint32_t const x, uint32_t const y) const noexcept {
+		// 覆盖率
+		[[nodiscard]] uint8_t pixel(uint32_t const x, uint32_t const y) const noexcept {
 			// FT_Bitmap::pitch 是有符号的，也许有负数的可能性？
 			if (m_bitmap->pixel_mode == FT_PIXEL_MODE_GRAY) {
 				auto const line = static_cast<uint8_t const*>(m_bitmap->buffer) + (static_cast<ptrdiff_t>(y) * static_cast<ptrdiff_t>(m_bitmap->pitch));
-				return (line[x] << 24) | 0x00FFFFFF;
+				return line[x];
 			}
 			if (m_bitmap->pixel_mode == FT_PIXEL_MODE_MONO) {
 				auto const line = static_cast<uint8_t const*>(m_bitmap->buffer) + (static_cast<ptrdiff_t>(y) * static_cast<ptrdiff_t>(m_bitmap->pitch));
 				auto const block = line[x / 8];
 				auto const flag = (1 << (7 - (x % 8))) & block; // 最左边的像素在最高位
-				return flag ? 0xFFFFFFFF : 0x00FFFFFF;
+				return flag ? 0xFF : 0x00;
 			}
 			return 0;
 		}
@@ -48,6 +49,17 @@ namespace {
 		FT_Bitmap const* m_bitmap{};
 	};
 
+	// 复制成紧凑排列的覆盖率
+	void copyCoverage(FT_Bitmap const& bitmap, std::vector<uint8_t>& output) {
+		FreeTypeBitmapAccessor const accessor(bitmap);
+		output.resize(static_cast<size_t>(accessor.width()) * accessor.height());
+		for (uint32_t y = 0; y < accessor.height(); y += 1) {
+			for (uint32_t x = 0; x < accessor.width(); x += 1) {
+				output[static_cast<size_t>(y) * accessor.width() + x] = accessor.pixel(x, y);
+			}
+		}
+	}
+
 	class FreeTypeLibrarySingleton {
 	public:
 		FreeTypeLibrarySingleton() {
@@ -82,8 +94,108 @@ namespace {
 }
 
 namespace core::Graphics::Common {
-	Image2D::Image2D() {
-		std::memset(data, 0, sizeof(data));
+	Image2D::Image2D() : data(texture_size * texture_size) {
+	}
+
+	GlyphPacker::GlyphPacker(uint32_t const width, uint32_t const height) : m_width(width), m_height(height), m_bottom(1) {
+		m_skyline.push_back(Node{ .x = 1, .y = 1, .width = width - 1 });
+	}
+	bool GlyphPacker::fit(size_t index, uint32_t const width, uint32_t const height, uint32_t& y) const {
+		if (m_skyline[index].x + width > m_width) {
+			return false;
+		}
+		y = 0;
+		uint32_t width_left = width;
+		for (;;) {
+			y = std::max(y, m_skyline[index].y);
+			if (y + height > m_height) {
+				return false;
+			}
+			if (m_skyline[index].width >= width_left) {
+				return true;
+			}
+			width_left -= m_skyline[index].width;
+			index += 1;
+		}
+	}
+	bool GlyphPacker::insert(uint32_t const width, uint32_t const height, uint32_t& x, uint32_t& y) {
+		// 左下优先：最低的顶边，相同时选更窄的段
+		size_t best_index = SIZE_MAX;
+		uint32_t best_top = UINT32_MAX;
+		uint32_t best_width = UINT32_MAX;
+		for (size_t i = 0; i < m_skyline.size(); i += 1) {
+			uint32_t top{};
+			if (fit(i, width, height, top)) {
+				if (top + height < best_top || (top + height == best_top && m_skyline[i].width < best_width)) {
+					best_index = i;
+					best_top = top + height;
+					best_width = m_skyline[i].width;
+					x = m_skyline[i].x;
+					y = top;
+				}
+			}
+		}
+		if (best_index == SIZE_MAX) {
+			return false;
+		}
+
+		m_skyline.insert(m_skyline.begin() + static_cast<ptrdiff_t>(best_index), Node{ .x = x, .y = y + height, .width = width });
+		// 被新节点盖住的部分
+		for (size_t i = best_index + 1; i < m_skyline.size();) {
+			auto const& previous = m_skyline[i - 1];
+			auto& node = m_skyline[i];
+			uint32_t const previous_right = previous.x + previous.width;
+			if (node.x >= previous_right) {
+				break;
+			}
+			uint32_t const shrink = previous_right - node.x;
+			if (node.width <= shrink) {
+				m_skyline.erase(m_skyline.begin() + static_cast<ptrdiff_t>(i));
+				continue;
+			}
+			node.x += shrink;
+			node.width -= shrink;
+			break;
+		}
+		// 合并同一高度的相邻节点
+		for (size_t i = 0; i + 1 < m_skyline.size();) {
+			if (m_skyline[i].y == m_skyline[i + 1].y) {
+				m_skyline[i].width += m_skyline[i + 1].width;
+				m_skyline.erase(m_skyline.begin() + static_cast<ptrdiff_t>(i + 1));
+			}
+			else {
+				i += 1;
+			}
+		}
+		m_bottom = std::max(m_bottom, y + height);
+		return true;
+	}
+
+	void GlyphCache2D::markDirty(RectU const& rect) {
+		auto const area = [](RectU const& r) -> uint64_t {
+			return static_cast<uint64_t>(r.b.x - r.a.x) * static_cast<uint64_t>(r.b.y - r.a.y);
+		};
+		auto const merge = [](RectU const& l, RectU const& r) -> RectU {
+			return RectU(std::min(l.a.x, r.a.x), std::min(l.a.y, r.a.y), std::max(l.b.x, r.b.x), std::max(l.b.y, r.b.y));
+		};
+		// 相邻的字形大多是挨着放的，合并后没有多少多余的面积就合并
+		if (!dirty.empty()) {
+			auto& last = dirty.back();
+			auto const merged = merge(last, rect);
+			if (area(merged) <= (area(last) + area(rect)) * 5 / 4) {
+				last = merged;
+				return;
+			}
+		}
+		dirty.push_back(rect);
+		if (dirty.size() > max_dirty_rect_count) {
+			RectU all = dirty.front();
+			for (auto const& r : dirty) {
+				all = merge(all, r);
+			}
+			dirty.clear();
+			dirty.push_back(all);
+		}
 	}
 }
 namespace core::Graphics::Common {
@@ -95,10 +207,8 @@ namespace core::Graphics::Common {
 	void FreeTypeGlyphManager::onDeviceDestroy() {
 		// 全标记为脏
 		for (auto& t : m_tex) {
-			t.dirty_l = 0;
-			t.dirty_t = 0;
-			t.dirty_r = t.image.width;
-			t.dirty_b = t.pen_bottom + 1; // 多一个像素的边缘
+			t.dirty.clear();
+			t.dirty.push_back(RectU(0, 0, t.image.width, t.packer.getBottom()));
 		}
 	}
 
@@ -141,19 +251,23 @@ namespace core::Graphics::Common {
 	}
 	bool FreeTypeGlyphManager::flush() {
 		for (auto& t : m_tex) {
-			if (t.dirty_l != GlyphCache2D::invalid_rect_value) {
-				if (!t.texture->uploadPixelData(
-					RectU(t.dirty_l, t.dirty_t, t.dirty_r, t.dirty_b),
-					&t.image.pixel(t.dirty_l, t.dirty_t),
-					t.image.pitch
-				)) {
+			for (auto const& rect : t.dirty) {
+				// 覆盖率展开成白色 + alpha
+				uint32_t const width = rect.b.x - rect.a.x;
+				uint32_t const height = rect.b.y - rect.a.y;
+				m_upload_buffer.resize(static_cast<size_t>(width) * height);
+				for (uint32_t y = 0; y < height; y += 1) {
+					uint8_t const* const src = &t.image.pixel(rect.a.x, rect.a.y + y);
+					Color4B* const dst = m_upload_buffer.data() + static_cast<size_t>(y) * width;
+					for (uint32_t x = 0; x < width; x += 1) {
+						dst[x] = Color4B((static_cast<uint32_t>(src[x]) << 24) | 0x00FFFFFF);
+					}
+				}
+				if (!t.texture->uploadPixelData(rect, m_upload_buffer.data(), width * static_cast<uint32_t>(sizeof(Color4B)))) {
 					return false;
 				}
-				t.dirty_l = GlyphCache2D::invalid_rect_value;
-				t.dirty_t = GlyphCache2D::invalid_rect_value;
-				t.dirty_r = GlyphCache2D::invalid_rect_value;
-				t.dirty_b = GlyphCache2D::invalid_rect_value;
 			}
+			t.dirty.clear();
 		}
 		return true;
 	}
@@ -176,6 +290,81 @@ namespace core::Graphics::Common {
 		return false;
 	}
 
+	void FreeTypeGlyphManager::prefetchString(StringView const str) {
+		std::vector<uint32_t> codepoints;
+		char32_t codepoint{};
+		utf::utf8reader reader(str.data(), str.size());
+		while (reader(codepoint)) {
+			if (codepoint != U'\n' && !m_map.contains(codepoint)) {
+				codepoints.push_back(codepoint);
+			}
+		}
+		if (codepoints.empty()) {
+			return;
+		}
+		if (!m_rasterizer) {
+			try {
+				m_rasterizer = std::make_unique<FreeTypeGlyphRasterizer>(m_font_source);
+			}
+			catch (std::exception const& e) {
+				// 开不了线程就当场光栅化
+				spdlog::error("[core] [FreeTypeGlyphManager] failed to start the glyph rasterizer thread: {}", e.what());
+				cacheString(str);
+				return;
+			}
+		}
+		m_rasterizer->request(codepoints);
+	}
+
+	void FreeTypeGlyphManager::collect(uint32_t const max_texture_count, void (* const before_compact)(void* userdata), void* const userdata) {
+		integrateRasterizedGlyphs();
+		auto const frame = m_frame;
+		m_frame += 1;
+		if (m_tex.size() <= std::max(max_texture_count, 1u)) {
+			return;
+		}
+
+		// 按最后使用的时间排序，最近用过的优先保留，直到剩下的能装进 max_texture_count 张纹理的八成
+		std::vector<GlyphCacheInfo*> glyphs;
+		glyphs.reserve(m_map.size());
+		for (auto& [codepoint, info] : m_map) {
+			glyphs.push_back(&info);
+		}
+		std::sort(glyphs.begin(), glyphs.end(), [](GlyphCacheInfo const* const l, GlyphCacheInfo const* const r) {
+			return l->last_used > r->last_used;
+		});
+		uint64_t const budget = static_cast<uint64_t>(std::max(max_texture_count, 1u)) * Image2D::texture_size * Image2D::texture_size * 4 / 5;
+		uint64_t used = 0;
+		size_t keep = 0;
+		for (; keep < glyphs.size(); keep += 1) {
+			auto const* const info = glyphs[keep];
+			uint64_t const area = static_cast<uint64_t>(info->size.x + 1.0f) * static_cast<uint64_t>(info->size.y + 1.0f);
+			// 上一帧用过的字形一定保留，放不下就暂时超出限制
+			if (used + area > budget && info->last_used < frame) {
+				break;
+			}
+			used += area;
+		}
+		if (keep == glyphs.size()) {
+			// 全都是上一帧用过的字形，整理也不会变少，暂时超出限制，等它们不再使用
+			return;
+		}
+		for (size_t i = keep; i < glyphs.size(); i += 1) {
+			m_map.erase(glyphs[i]->codepoint);
+		}
+		if (before_compact) {
+			before_compact(userdata);
+		}
+		glyphs.clear();
+		for (auto& [codepoint, info] : m_map) {
+			glyphs.push_back(&info);
+		}
+		// 失败时保持原样，被淘汰的字形只是占着位置，留下的字形位置不变，之前取得的 GlyphInfo 仍然有效
+		if (compact(glyphs)) {
+			m_version += 1;
+		}
+	}
+
 	// FreeTypeGlyphManager
 
 	FreeTypeGlyphManager::FreeTypeGlyphManager(IDevice* const p_device, TrueTypeFontInfo const* const p_arr_info, size_t const info_count)
@@ -191,6 +380,7 @@ namespace core::Graphics::Common {
 	}
 	FreeTypeGlyphManager::~FreeTypeGlyphManager() {
 		m_device->removeEventListener(this);
+		m_rasterizer.reset();
 		closeFonts();
 	}
 
@@ -232,6 +422,7 @@ namespace core::Graphics::Common {
 				if (FT_Err_Ok != FT_New_Face(FT_LIBRARY, path.data(), (FT_Long)fonts[i].font_face, &data.ft_face)) {
 					return;
 				}
+				data.path = path;
 				setupFontFace();
 			};
 			auto openFromBuffer = [&]() {
@@ -291,6 +482,18 @@ namespace core::Graphics::Common {
 				m_common_info.ft_ascender = std::max(m_common_info.ft_ascender, f.ft_ascender);
 				m_common_info.ft_descender = std::min(m_common_info.ft_descender, f.ft_descender);
 			}
+			// 后台光栅化线程用
+			m_font_source.clear();
+			for (size_t i = 0; i < count; i++) {
+				m_font_source.push_back(FreeTypeFontSource{
+					.buffer = m_font[i].buffer,
+					.path = m_font[i].path,
+					.face_index = (FT_Long)fonts[i].font_face,
+					.pixel_width = (FT_UInt)fonts[i].font_size.x,
+					.pixel_height = (FT_UInt)fonts[i].font_size.y,
+					.is_fallback = m_font[i].is_fallback != 0,
+				});
+			}
 			return true;
 		}
 		else {
@@ -320,94 +523,124 @@ namespace core::Graphics::Common {
 		}
 		return false;
 	}
-	bool FreeTypeGlyphManager::writeBitmapToCache(GlyphCacheInfo& info, FT_Bitmap const& bitmap) {
+	bool FreeTypeGlyphManager::allocateGlyph(uint32_t const width, uint32_t const height, uint32_t& texture_index, uint32_t& x, uint32_t& y) {
+		// 右下各留出 1 像素透明边缘
+		for (size_t i = 0; i < m_tex.size(); i += 1) {
+			if (m_tex[i].packer.insert(width + 1, height + 1, x, y)) {
+				texture_index = static_cast<uint32_t>(i);
+				return true;
+			}
+		}
+		// 该添新丁了
+		if (!addTexture()) {
+			return false;
+		}
+		texture_index = static_cast<uint32_t>(m_tex.size() - 1);
+		return m_tex.back().packer.insert(width + 1, height + 1, x, y);
+	}
+	bool FreeTypeGlyphManager::writeCoverageToCache(GlyphCacheInfo& info, uint8_t const* const coverage, uint32_t const width, uint32_t const height) {
 		// 太大的不要，滚
-		if (bitmap.width > (Image2D::texture_size - 2) || bitmap.rows > (Image2D::texture_size - 2)) {
+		if (width > (Image2D::texture_size - 2) || height > (Image2D::texture_size - 2)) {
 			assert(false); return false;
 		}
+		// 空白字形不占位置
+		if (width == 0 || height == 0) {
+			info.texture_index = 0;
+			info.texture_rect = RectF();
+			return true;
+		}
 		// 搞到一个位置
-		GlyphCache2D* pt = nullptr;
-		do {
-			for (auto& t : m_tex) {
-				// 初始化，留出 1 像素左上边缘
-				if (t.pen_x == 0 || t.pen_y == 0) {
-					t.pen_x = 1;
-					t.pen_y = 1;
-				}
-				// 这行能塞下吗，留出 1 像素右下边缘
-				if ((t.pen_x + bitmap.width) < (t.image.width - 1) && (t.pen_y + bitmap.rows) < (t.image.height - 1)) {
-					pt = &t;
-					break;
-				}
-				// 换行，留出 1 像素行边缘
-				uint32_t const new_pen_x = 1;
-				uint32_t const new_pen_y = std::max(t.pen_y, t.pen_bottom + 1);
-				// 这行能塞下吗，留出 1 像素右下边缘
-				if ((new_pen_x + bitmap.width) < (t.image.width - 1) && (new_pen_y + bitmap.rows) < (t.image.height - 1)) {
-					t.pen_x = new_pen_x;
-					t.pen_y = new_pen_y;
-					pt = &t;
-					break;
+		uint32_t texture_index{};
+		uint32_t x{};
+		uint32_t y{};
+		if (!allocateGlyph(width, height, texture_index, x, y)) {
+			return false;
+		}
+		GlyphCache2D& t = m_tex[texture_index];
+		// 写入字形数据
+		info.texture_index = texture_index;
+		info.x = x;
+		info.y = y;
+		info.texture_rect.a.x = (float)x / (float)t.image.width;
+		info.texture_rect.a.y = (float)y / (float)t.image.height;
+		info.texture_rect.b.x = (float)(x + width) / (float)t.image.width;
+		info.texture_rect.b.y = (float)(y + height) / (float)t.image.height;
+		// 写入覆盖率，页面是清零的，透明边缘不用写
+		for (uint32_t j = 0; j < height; j += 1) {
+			std::memcpy(&t.image.pixel(x, y + j), coverage + static_cast<size_t>(j) * width, width);
+		}
+		// 更新脏区域，带上 1 像素的边缘
+		t.markDirty(RectU(x - 1, y - 1, x + width + 1, y + height + 1));
+		return true;
+	}
+	bool FreeTypeGlyphManager::compact(std::vector<GlyphCacheInfo*> const& glyphs) {
+		// 高的先放，天际线更平整
+		std::vector<GlyphCacheInfo*> order(glyphs);
+		std::sort(order.begin(), order.end(), [](GlyphCacheInfo const* const l, GlyphCacheInfo const* const r) {
+			return l->size.y > r->size.y;
+		});
+
+		// 在新的页面上重新装箱，纹理对象尽量复用
+		std::vector<GlyphCache2D> pages(1);
+		std::vector<GlyphCacheInfo> placed(order.size());
+		for (size_t k = 0; k < order.size(); k += 1) {
+			auto const& info = *order[k];
+			auto& result = placed[k];
+			result = info;
+			uint32_t const width = static_cast<uint32_t>(info.size.x);
+			uint32_t const height = static_cast<uint32_t>(info.size.y);
+			if (width == 0 || height == 0) {
+				continue;
+			}
+			if (!pages.back().packer.insert(width + 1, height + 1, result.x, result.y)) {
+				pages.emplace_back();
+				if (!pages.back().packer.insert(width + 1, height + 1, result.x, result.y)) {
+					assert(false); return false;
 				}
 			}
-			if (pt) {
-				break;
+			result.texture_index = static_cast<uint32_t>(pages.size() - 1);
+			auto& page = pages.back();
+			auto& source = m_tex[info.texture_index].image;
+			for (uint32_t j = 0; j < height; j += 1) {
+				std::memcpy(&page.image.pixel(result.x, result.y + j), &source.pixel(info.x, info.y + j), width);
 			}
-			else {
-				// 该添新丁了
-				if (!addTexture()) {
-					return false;
-				}
+			result.texture_rect.a.x = (float)result.x / (float)page.image.width;
+			result.texture_rect.a.y = (float)result.y / (float)page.image.height;
+			result.texture_rect.b.x = (float)(result.x + width) / (float)page.image.width;
+			result.texture_rect.b.y = (float)(result.y + height) / (float)page.image.height;
+		}
+		for (size_t i = 0; i < pages.size(); i += 1) {
+			if (i < m_tex.size()) {
+				pages[i].texture = m_tex[i].texture;
 			}
-		}
-		while (!pt);
-		GlyphCache2D& t = *pt;
-		// 写入字形数据
-		info.texture_index = (uint32_t)(pt - m_tex.data());
-		info.texture_rect.a.x = (float)t.pen_x / (float)t.image.width;
-		info.texture_rect.a.y = (float)t.pen_y / (float)t.image.height;
-		info.texture_rect.b.x = (float)(t.pen_x + bitmap.width) / (float)t.image.width;
-		info.texture_rect.b.y = (float)(t.pen_y + bitmap.rows) / (float)t.image.height;
-		// 写入 bitmap 数据，同时写入 1 像素宽的透明边缘，写的有点乱，主要是为了最大化减少 CPU Cache Miss
-		FreeTypeBitmapAccessor const accessor(bitmap);
-		for (int x = 0; x < (int)(accessor.width() + 2); x += 1) // 上 1 像素宽的边，宽度是 bitmap 的宽度再加 2 像素
-		{
-			t.image.pixel(t.pen_x - 1 + x, t.pen_y - 1) = Color4B(0x00FFFFFF);
-		}
-		for (int y = 0; y < (int)accessor.height(); y += 1) {
-			t.image.pixel(t.pen_x - 1, t.pen_y + y) = Color4B(0x00FFFFFF); // 左 1 像素宽的边
-			for (int x = 0; x < (int)accessor.width(); x += 1) {
-				t.image.pixel(t.pen_x + x, t.pen_y + y) = accessor.pixel(x, y);
+			else if (!m_device->createTexture(Vector2U(pages[i].image.width, pages[i].image.height), pages[i].texture.put())) {
+				return false;
 			}
-			t.image.pixel(t.pen_x + accessor.width(), t.pen_y + y) = Color4B(0x00FFFFFF); // 右 1 像素宽的边
-		}
-		for (int x = 0; x < (int)(accessor.width() + 2); x += 1) // 下 1 像素宽的边，宽度是 bitmap 的宽度再加 2 像素
-		{
-			t.image.pixel(t.pen_x - 1 + x, t.pen_y + accessor.height()) = Color4B(0x00FFFFFF);
+			pages[i].markDirty(RectU(0, 0, pages[i].image.width, pages[i].packer.getBottom()));
 		}
-		// 更新脏区域
-		if (t.dirty_l == GlyphCache2D::invalid_rect_value) {
-			t.dirty_l = t.pen_x - 1;
-			t.dirty_t = t.pen_y - 1;
-			t.dirty_r = t.pen_x + bitmap.width + 1;
-			t.dirty_b = t.pen_y + bitmap.rows + 1;
+
+		size_t const before = m_tex.size();
+		m_tex = std::move(pages);
+		for (size_t k = 0; k < order.size(); k += 1) {
+			*order[k] = placed[k];
 		}
-		else {
-			t.dirty_l = std::min(t.dirty_l, t.pen_x - 1);
-			t.dirty_t = std::min(t.dirty_t, t.pen_y - 1);
-			t.dirty_r = std::max(t.dirty_r, t.pen_x + bitmap.width + 1);
-			t.dirty_b = std::max(t.dirty_b, t.pen_y + bitmap.rows + 1);
-		}
-		// 更新缓存
-		t.pen_x += bitmap.width + 1;
-		t.pen_bottom = std::max(t.pen_bottom, t.pen_y + bitmap.rows);
+		spdlog::info("[core] [FreeTypeGlyphManager] glyph cache compacted: {} glyphs, {} -> {} textures", order.size(), before, m_tex.size());
 		return true;
 	}
 	GlyphCacheInfo* FreeTypeGlyphManager::getGlyphCacheInfo(uint32_t const codepoint) {
 		auto const it = m_map.find(codepoint);
 		if (it != m_map.end()) {
+			it->second.last_used = m_frame;
 			return &it->second;
 		}
+		// 也许后台线程已经光栅化好了
+		if (m_rasterizer && m_rasterizer->hasFinished()) {
+			integrateRasterizedGlyphs();
+			if (auto const found = m_map.find(codepoint); found != m_map.end()) {
+				found->second.last_used = m_frame;
+				return &found->second;
+			}
+		}
 		if (renderCache(codepoint)) {
 			return &m_map[codepoint];
 		}
@@ -421,20 +654,157 @@ namespace core::Graphics::Common {
 			// 加载文字到字形槽并渲染
 			FT_Load_Glyph(face, index, FT_LOAD_RENDER); // 需要处理错误吗？
 			FT_GlyphSlot const& glyph = face->glyph;
-			FT_Bitmap const& bitmap = glyph->bitmap;
 			// 写入对应属性
 			GlyphCacheInfo cache = {};
 			cache.size = Vector2F(static_cast<float>(glyph->bitmap.width), static_cast<float>(glyph->bitmap.rows));
 			cache.position = Vector2F(static_cast<float>(glyph->bitmap_left), static_cast<float>(glyph->bitmap_top));
 			cache.advance = Vector2F(static_cast<float>(glyph->advance.x) / 64.f, static_cast<float>(glyph->advance.y) / 64.f);
 			cache.codepoint = codepoint;
-			if (!writeBitmapToCache(cache, bitmap)) {
+			cache.last_used = m_frame;
+			copyCoverage(glyph->bitmap, m_coverage_buffer);
+			if (!writeCoverageToCache(cache, m_coverage_buffer.data(), glyph->bitmap.width, glyph->bitmap.rows)) {
 				return false;
 			}
 			m_map.emplace(codepoint, cache);
+			return true;
 		}
 		return false;
 	}
+	void FreeTypeGlyphManager::integrateRasterizedGlyphs() {
+		if (!m_rasterizer || !m_rasterizer->hasFinished()) {
+			return;
+		}
+		m_rasterizer->takeFinished(m_rasterized);
+		for (auto const& glyph : m_rasterized) {
+			// 等不及的时候已经当场光栅化过了
+			if (m_map.contains(glyph.codepoint)) {
+				continue;
+			}
+			GlyphCacheInfo cache = {};
+			cache.size = Vector2F(static_cast<float>(glyph.width), static_cast<float>(glyph.height));
+			cache.position = glyph.position;
+			cache.advance = glyph.advance;
+			cache.codepoint = glyph.codepoint;
+			cache.last_used = m_frame;
+			if (writeCoverageToCache(cache, glyph.coverage.data(), glyph.width, glyph.height)) {
+				m_map.emplace(glyph.codepoint, cache);
+			}
+		}
+		m_rasterized.clear();
+	}
+}
+namespace core::Graphics::Common {
+	FreeTypeGlyphRasterizer::FreeTypeGlyphRasterizer(std::vector<FreeTypeFontSource> const& sources)
+		: m_sources(sources)
+		, m_thread(&FreeTypeGlyphRasterizer::worker, this) {
+	}
+	FreeTypeGlyphRasterizer::~FreeTypeGlyphRasterizer() {
+		{
+			std::lock_guard lock(m_mutex);
+			m_exit = true;
+		}
+		m_condition.notify_all();
+		if (m_thread.joinable()) {
+			m_thread.join();
+		}
+	}
+
+	void FreeTypeGlyphRasterizer::request(std::vector<uint32_t> const& codepoints) {
+		bool notify = false;
+		{
+			std::lock_guard lock(m_mutex);
+			for (auto const codepoint : codepoints) {
+				if (m_requested.insert(codepoint).second) {
+					m_queue.push_back(codepoint);
+					notify = true;
+				}
+			}
+		}
+		if (notify) {
+			m_condition.notify_one();
+		}
+	}
+	void FreeTypeGlyphRasterizer::takeFinished(std::vector<RasterizedGlyph>& output) {
+		std::lock_guard lock(m_mutex);
+		for (auto& glyph : m_finished) {
+			m_requested.erase(glyph.codepoint);
+			output.emplace_back(std::move(glyph));
+		}
+		m_finished.clear();
+		m_finished_count.store(0, std::memory_order_release);
+	}
+
+	void FreeTypeGlyphRasterizer::worker() {
+		FT_Library library{};
+		if (FT_Err_Ok != FT_Init_FreeType(&library)) {
+			spdlog::error("[core] [FreeTypeGlyphRasterizer] FT_Init_FreeType failed, glyphs will be rasterized on demand");
+			return;
+		}
+		std::vector<std::pair<FT_Face, bool>> faces;
+		for (auto const& source : m_sources) {
+			FT_Face face{};
+			FT_Error const error = source.buffer
+				? FT_New_Memory_Face(library, static_cast<FT_Byte const*>(source.buffer->data()), static_cast<FT_Long>(source.buffer->size()), source.face_index, &face)
+				: FT_New_Face(library, source.path.c_str(), source.face_index, &face);
+			if (error != FT_Err_Ok) {
+				continue;
+			}
+			if (FT_Err_Ok != FT_Set_Pixel_Sizes(face, source.pixel_width, source.pixel_height)) {
+				FT_Done_Face(face);
+				continue;
+			}
+			faces.emplace_back(face, source.is_fallback);
+		}
+
+		for (;;) {
+			uint32_t codepoint{};
+			{
+				std::unique_lock lock(m_mutex);
+				m_condition.wait(lock, [this] { return m_exit || !m_queue.empty(); });
+				if (m_exit) {
+					break;
+				}
+				codepoint = m_queue.front();
+				m_queue.pop_front();
+			}
+
+			// 和 findGlyph、renderCache 一致
+			RasterizedGlyph result;
+			result.codepoint = codepoint;
+			bool found = false;
+			for (auto const& [face, is_fallback] : faces) {
+				FT_UInt const index = FT_Get_Char_Index(face, codepoint);
+				if (index == 0 && !is_fallback) {
+					continue;
+				}
+				if (FT_Err_Ok == FT_Load_Glyph(face, index, FT_LOAD_RENDER)) {
+					FT_GlyphSlot const& glyph = face->glyph;
+					result.width = glyph->bitmap.width;
+					result.height = glyph->bitmap.rows;
+					result.position = Vector2F(static_cast<float>(glyph->bitmap_left), static_cast<float>(glyph->bitmap_top));
+					result.advance = Vector2F(static_cast<float>(glyph->advance.x) / 64.f, static_cast<float>(glyph->advance.y) / 64.f);
+					copyCoverage(glyph->bitmap, result.coverage);
+					found = true;
+				}
+				break;
+			}
+
+			std::lock_guard lock(m_mutex);
+			if (found) {
+				m_finished.emplace_back(std::move(result));
+				m_finished_count.store(m_finished.size(), std::memory_order_release);
+			}
+			else {
+				// 没有这个字，主线程需要的时候会自己发现
+				m_requested.erase(codepoint);
+			}
+		}
+
+		for (auto const& [face, is_fallback] : faces) {
+			FT_Done_Face(face);
+		}
+		FT_Done_FreeType(library);
+	}
 }
 namespace core::Graphics {
 	bool IGlyphManager::create(IDevice* const p_device, TrueTypeFontInfo const* const p_arr_info, size_t const info_count, IGlyphManager** const output) {
@@ -6,32 +6,63 @@
 #include "ft2build.h"
 #include FT_FREETYPE_H
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+
 namespace core::Graphics::Common {
+	// 单通道覆盖率，展开成 BGRA 的工作留到上传纹理的时候
 	struct Image2D {
 		static constexpr uint32_t texture_size{ 1024 };
 		uint32_t width{ texture_size };
 		uint32_t height{ texture_size };
-		uint32_t pitch{ texture_size * sizeof(Color4B) };
-		Color4B data[texture_size * texture_size];
+		std::vector<uint8_t> data;
 
-		Color4B& pixel(uint32_t const x, uint32_t const y) {
+		uint8_t& pixel(uint32_t const x, uint32_t const y) {
 			return data[y * texture_size + x];
 		}
 
 		Image2D();
 	};
 
+	// 天际线装箱，字形的高度都差不多，空间利用率和 MaxRects 相近，但是快得多
+	// 每个字形右下各留出 1 像素透明边缘，装箱区域从 (1, 1) 开始，所以左上边缘由邻居或纹理边界提供
+	class GlyphPacker {
+	public:
+		GlyphPacker(uint32_t width, uint32_t height);
+
+		bool insert(uint32_t width, uint32_t height, uint32_t& x, uint32_t& y);
+		// 已使用区域的最下边，设备丢失后只需要重新上传这一部分
+		uint32_t getBottom() const noexcept { return m_bottom; }
+
+	private:
+		struct Node {
+			uint32_t x{};
+			uint32_t y{};
+			uint32_t width{};
+		};
+
+		bool fit(size_t index, uint32_t width, uint32_t height, uint32_t& y) const;
+
+		uint32_t m_width{};
+		uint32_t m_height{};
+		uint32_t m_bottom{};
+		std::vector<Node> m_skyline;
+	};
+
 	struct GlyphCache2D {
-		static constexpr uint32_t invalid_rect_value{ 0x7FFFFFFF };
+		// 脏矩形太多时合并成一个
+		static constexpr size_t max_dirty_rect_count{ 16 };
 		Image2D image;
 		SmartReference<ITexture2D> texture;
-		uint32_t pen_x{};
-		uint32_t pen_y{};
-		uint32_t pen_bottom{};
-		uint32_t dirty_l{ invalid_rect_value };
-		uint32_t dirty_t{ invalid_rect_value };
-		uint32_t dirty_r{ invalid_rect_value };
-		uint32_t dirty_b{ invalid_rect_value };
+		GlyphPacker packer{ Image2D::texture_size, Image2D::texture_size };
+		std::vector<RectU> dirty;
+
+		void markDirty(RectU const& rect);
 	};
 
 	struct GlyphCacheInfo {
@@ -43,10 +74,14 @@ namespace core::Graphics::Common {
 		Vector2F advance;           // 前进量
 		// 私有
 		uint32_t codepoint = 0;     // 当前的字符
+		uint32_t x = 0;             // 字形在纹理上的像素坐标
+		uint32_t y = 0;
+		uint64_t last_used = 0;     // 最后一次使用时的帧序号，用于 LRU 淘汰
 	};
 
 	struct FreeTypeFontData {
 		SmartReference<IData> buffer;
+		std::string path; // 没有读进内存时的字体文件路径
 		FT_Face ft_face{};
 		float ft_line_height{};
 		float ft_ascender{};
@@ -54,6 +89,58 @@ namespace core::Graphics::Common {
 		uint32_t is_fallback{};
 	};
 
+	// 打开字体需要的全部信息，后台线程用它打开自己的 FT_Face
+	struct FreeTypeFontSource {
+		SmartReference<IData> buffer; // 为空时从 path 打开
+		std::string path;
+		FT_Long face_index{};
+		FT_UInt pixel_width{};
+		FT_UInt pixel_height{};
+		bool is_fallback{};
+	};
+
+	// 光栅化完成，等待主线程写入纹理的字形
+	struct RasterizedGlyph {
+		uint32_t codepoint{};
+		uint32_t width{};
+		uint32_t height{};
+		Vector2F position;
+		Vector2F advance;
+		std::vector<uint8_t> coverage; // width * height
+	};
+
+	// 在后台线程预先光栅化字形
+	// FT_Library 和 FT_Face 都不能跨线程共享，后台线程有自己的一份，只读地共享字体文件数据
+	class FreeTypeGlyphRasterizer {
+	public:
+		explicit FreeTypeGlyphRasterizer(std::vector<FreeTypeFontSource> const& sources);
+		FreeTypeGlyphRasterizer(FreeTypeGlyphRasterizer const&) = delete;
+		FreeTypeGlyphRasterizer(FreeTypeGlyphRasterizer&&) = delete;
+		~FreeTypeGlyphRasterizer();
+
+		FreeTypeGlyphRasterizer& operator=(FreeTypeGlyphRasterizer const&) = delete;
+		FreeTypeGlyphRasterizer& operator=(FreeTypeGlyphRasterizer&&) = delete;
+
+		// 已经在排队的字符会被忽略
+		void request(std::vector<uint32_t> const& codepoints);
+		bool hasFinished() const noexcept { return m_finished_count.load(std::memory_order_acquire) != 0; }
+		// 取走所有光栅化完成的字形，追加到 output
+		void takeFinished(std::vector<RasterizedGlyph>& output);
+
+	private:
+		void worker();
+
+		std::vector<FreeTypeFontSource> const& m_sources;
+		std::mutex m_mutex;
+		std::condition_variable m_condition;
+		std::deque<uint32_t> m_queue;
+		std::unordered_set<uint32_t> m_requested; // 排队中和正在光栅化的
+		std::vector<RasterizedGlyph> m_finished;
+		std::atomic<size_t> m_finished_count{};
+		bool m_exit{};
+		std::thread m_thread;
+	};
+
 	struct FreeTypeFontCommonInfo {
 		float ft_line_height{};
 		float ft_ascender{};
@@ -83,6 +170,11 @@ namespace core::Graphics::Common {
 		bool flush() override;
 
 		bool getGlyph(uint32_t codepoint, GlyphInfo* p_ref_info, bool no_render) override;
+		void prefetchString(StringView str) override;
+
+		void collect(uint32_t max_texture_count, void (*before_compact)(void* userdata), void* userdata) override;
+		uint64_t getVersion() override { return m_version; }
+		uint64_t getFrame() override { return m_frame; }
 
 		// FreeTypeGlyphManager
 
@@ -99,14 +191,25 @@ namespace core::Graphics::Common {
 		bool openFonts(TrueTypeFontInfo const* fonts, size_t count);
 		bool addTexture();
 		bool findGlyph(FT_ULong code, FT_Face& face, FT_UInt& index) const;
-		bool writeBitmapToCache(GlyphCacheInfo& info, FT_Bitmap const& bitmap);
+		bool allocateGlyph(uint32_t width, uint32_t height, uint32_t& texture_index, uint32_t& x, uint32_t& y);
+		bool writeCoverageToCache(GlyphCacheInfo& info, uint8_t const* coverage, uint32_t width, uint32_t height);
+		bool compact(std::vector<GlyphCacheInfo*> const& glyphs);
 		GlyphCacheInfo* getGlyphCacheInfo(uint32_t codepoint);
 		bool renderCache(uint32_t codepoint);
+		void integrateRasterizedGlyphs();
 
 		SmartReference<IDevice> m_device;
 		FreeTypeFontCommonInfo m_common_info;
 		std::vector<FreeTypeFontData> m_font;
+		std::vector<FreeTypeFontSource> m_font_source;
 		std::vector<GlyphCache2D> m_tex;
 		std::unordered_map<uint32_t, GlyphCacheInfo> m_map;
+		std::vector<Color4B> m_upload_buffer;
+		uint64_t m_frame{ 1 };
+		uint64_t m_version{ 1 };
+		std::vector<uint8_t> m_coverage_buffer;
+		std::vector<RasterizedGlyph> m_rasterized;
+		// 第一次预取时才创建，引用了 m_font_source，所以声明在它后面，先于它析构
+		std::unique_ptr<FreeTypeGlyphRasterizer> m_rasterizer;
 	};
 }
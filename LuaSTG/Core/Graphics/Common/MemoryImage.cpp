@@ -1,5 +1,6 @@
 #include "core/Graphics/Common/MemoryImage.hpp"
 #include "core/SmartReference.hpp"
+#include <algorithm>
 
 namespace core {
 	Vector2U Image::getSize() const noexcept {
@@ -8,15 +9,18 @@ namespace core {
 	Color4B Image::getPixel(Vector2U const position) const noexcept {
 		assert(position.x < m_size.x);
 		assert(position.y < m_size.y);
-		auto const index = position.y * m_size.y + position.x;
+		auto const index = position.y * m_size.x + position.x;
 		return m_pixels[index];
 	}
 	void Image::setPixel(Vector2U const position, Color4B const color) noexcept {
 		assert(position.x < m_size.x);
 		assert(position.y < m_size.y);
-		auto const index = position.y * m_size.y + position.x;
+		auto const index = position.y * m_size.x + position.x;
 		m_pixels[index] = color;
 	}
+	Color4B const* Image::getPixelData() const noexcept {
+		return m_pixels.data();
+	}
 	bool Image::clone(IImage** const output_image) const {
 		if (output_image == nullptr) {
 			assert(false);
@@ -36,6 +40,66 @@ namespace core {
 		return false;
 	}
 
+	bool Image::createMipmap(IImage** const output_image) const {
+		if (output_image == nullptr || m_pixels.empty()) {
+			assert(false);
+			return false;
+		}
+		try {
+			SmartReference<Image> image;
+			image.attach(new Image());
+			Vector2U const size(std::max(1u, m_size.x / 2), std::max(1u, m_size.y / 2));
+			if (!image->setSize(size)) {
+				return false;
+			}
+			for (uint32_t y = 0; y < size.y; y += 1) {
+				uint32_t const y0 = std::min(y * 2, m_size.y - 1);
+				uint32_t const y1 = std::min(y * 2 + 1, m_size.y - 1);
+				for (uint32_t x = 0; x < size.x; x += 1) {
+					uint32_t const x0 = std::min(x * 2, m_size.x - 1);
+					uint32_t const x1 = std::min(x * 2 + 1, m_size.x - 1);
+					Color4B const samples[4]{
+						m_pixels[y0 * m_size.x + x0],
+						m_pixels[y0 * m_size.x + x1],
+						m_pixels[y1 * m_size.x + x0],
+						m_pixels[y1 * m_size.x + x1],
+					};
+					uint32_t a{}, r{}, g{}, b{}, wr{}, wg{}, wb{};
+					for (auto const& s : samples) {
+						a += s.a;
+						r += s.r;
+						g += s.g;
+						b += s.b;
+						wr += s.r * s.a;
+						wg += s.g * s.a;
+						wb += s.b * s.a;
+					}
+					auto& out = image->m_pixels[y * size.x + x];
+					if (a == 0) {
+						out = Color4B(
+							static_cast<uint8_t>((r + 2) / 4),
+							static_cast<uint8_t>((g + 2) / 4),
+							static_cast<uint8_t>((b + 2) / 4),
+							0);
+					}
+					else {
+						out = Color4B(
+							static_cast<uint8_t>((wr + a / 2) / a),
+							static_cast<uint8_t>((wg + a / 2) / a),
+							static_cast<uint8_t>((wb + a / 2) / a),
+							static_cast<uint8_t>((a + 2) / 4));
+					}
+				}
+			}
+			*output_image = image.detach();
+			return true;
+		}
+		catch (std::exception const&) {
+			// TODO: logging
+		}
+		return false;
+	}
+
 	bool Image::setSize(Vector2U const size) {
 		if (size.x == 0 || size.y == 0) {
 			assert(false);
@@ -76,6 +140,25 @@ namespace core {
 		}
 		return false;
 	}
+	bool IImage::loadFromData(IData* const data, IImage** const output_image) {
+		if (data == nullptr || output_image == nullptr) {
+			assert(false);
+			return false;
+		}
+		try {
+			SmartReference<Image> image;
+			image.attach(new Image());
+			if (!image->loadFromData(data)) {
+				return false;
+			}
+			*output_image = image.detach();
+			return true;
+		}
+		catch (std::exception const&) {
+			// TODO: logging
+		}
+		return false;
+	}
 	bool IImage::loadFromFile(std::string_view const path, IImage** const output_image) {
 		if (output_image == nullptr) {
 			assert(false);
@@ -11,7 +11,9 @@ namespace core {
 		[[nodiscard]] Vector2U getSize() const noexcept override;
 		[[nodiscard]] Color4B getPixel(Vector2U position) const noexcept override;
 		void setPixel(Vector2U position, Color4B color) noexcept override;
+		[[nodiscard]] Color4B const* getPixelData() const noexcept override;
 		[[nodiscard]] bool clone(IImage** output_image) const override;
+		[[nodiscard]] bool createMipmap(IImage** output_image) const override;
 		[[nodiscard]] bool saveToFile(std::string_view path) const override;
 
 		// Image
@@ -26,6 +28,7 @@ namespace core {
 
 		[[nodiscard]] bool setSize(Vector2U size);
 		[[nodiscard]] bool loadFromFile(std::string_view path);
+		[[nodiscard]] bool loadFromData(IData* data);
 
 	private:
 		std::vector<Color4B> m_pixels;
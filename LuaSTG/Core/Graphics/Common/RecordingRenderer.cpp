@@ -0,0 +1,165 @@
+#include "Core/Graphics/Common/RecordingRenderer.hpp"
+#include <cassert>
+#include <tuple>
+
+namespace core::Graphics::Common {
+	bool RecordingRenderer::beginBatch() {
+		assert(m_list);
+		m_list->beginBatch();
+		m_batch_scope = true;
+		return true;
+	}
+	bool RecordingRenderer::endBatch() {
+		assert(m_list);
+		m_list->endBatch();
+		m_batch_scope = false;
+		return true;
+	}
+	bool RecordingRenderer::isBatchScope() {
+		return m_batch_scope;
+	}
+	bool RecordingRenderer::flush() {
+		assert(m_list);
+		m_list->flush();
+		return true;
+	}
+
+	void RecordingRenderer::clearRenderTarget(Color4B const& color) {
+		assert(m_list);
+		m_list->clearRenderTarget(color);
+	}
+	void RecordingRenderer::clearDepthBuffer(float const zvalue) {
+		assert(m_list);
+		m_list->clearDepthBuffer(zvalue);
+	}
+	void RecordingRenderer::setRenderAttachment(IRenderTarget* const p_rt, IDepthStencilBuffer* const p_ds) {
+		assert(m_list);
+		m_list->setRenderAttachment(p_rt, p_ds);
+	}
+
+	void RecordingRenderer::setOrtho(BoxF const& box) {
+		assert(m_list);
+		m_list->setOrtho(box);
+	}
+	void RecordingRenderer::setPerspective(Vector3F const& eye, Vector3F const& lookat, Vector3F const& headup, float const fov, float const aspect, float const znear, float const zfar) {
+		assert(m_list);
+		m_list->setPerspective(eye, lookat, headup, fov, aspect, znear, zfar);
+	}
+
+	BoxF RecordingRenderer::getViewport() {
+		// 视口可能由 setViewportAndScissorRect 根据当前渲染目标决定，只有真正的渲染器知道
+		return synchronize()->getViewport();
+	}
+	void RecordingRenderer::setViewport(BoxF const& box) {
+		assert(m_list);
+		m_list->setViewport(box);
+	}
+	void RecordingRenderer::setScissorRect(RectF const& rect) {
+		assert(m_list);
+		m_list->setScissorRect(rect);
+	}
+	void RecordingRenderer::setViewportAndScissorRect() {
+		assert(m_list);
+		m_list->setViewportAndScissorRect();
+	}
+
+	void RecordingRenderer::setVertexColorBlendState(VertexColorBlendState const state) {
+		assert(m_list);
+		m_list->setVertexColorBlendState(state);
+	}
+	void RecordingRenderer::setFogState(FogState const state, Color4B const& color, float const density_or_znear, float const zfar) {
+		assert(m_list);
+		m_list->setFogState(state, color, density_or_znear, zfar);
+	}
+	void RecordingRenderer::setDepthState(DepthState const state) {
+		assert(m_list);
+		m_list->setDepthState(state);
+	}
+	void RecordingRenderer::setBlendState(BlendState const state) {
+		assert(m_list);
+		m_list->setBlendState(state);
+	}
+	void RecordingRenderer::setTexture(ITexture2D* const texture) {
+		assert(m_list);
+		m_list->setTexture(texture);
+	}
+
+	bool RecordingRenderer::drawTriangle(DrawVertex const& v1, DrawVertex const& v2, DrawVertex const& v3) {
+		assert(m_list);
+		m_list->drawTriangle(v1, v2, v3);
+		return true;
+	}
+	bool RecordingRenderer::drawTriangle(DrawVertex const* const pvert) {
+		return drawTriangle(pvert[0], pvert[1], pvert[2]);
+	}
+	bool RecordingRenderer::drawQuad(DrawVertex const& v1, DrawVertex const& v2, DrawVertex const& v3, DrawVertex const& v4) {
+		assert(m_list);
+		m_list->drawQuad(v1, v2, v3, v4);
+		return true;
+	}
+	bool RecordingRenderer::drawQuad(DrawVertex const* const pvert) {
+		return drawQuad(pvert[0], pvert[1], pvert[2], pvert[3]);
+	}
+	bool RecordingRenderer::drawRaw(DrawVertex const* const pvert, uint16_t const nvert, DrawIndex const* const pidx, uint16_t const nidx) {
+		assert(m_list);
+		m_list->drawRaw(pvert, nvert, pidx, nidx);
+		return true;
+	}
+	bool RecordingRenderer::drawRequest(uint16_t const nvert, uint16_t const nidx, DrawVertex** const ppvert, DrawIndex** const ppidx, uint16_t* const idxoffset) {
+		assert(m_list);
+		m_list->drawRequest(nvert, nidx, ppvert, ppidx);
+		*idxoffset = 0; // 回放时由 drawRaw 加上偏移
+		return true;
+	}
+
+	bool RecordingRenderer::createPostEffectShader(StringView const path, IPostEffectShader** const pp_effect) {
+		return m_target->createPostEffectShader(path, pp_effect);
+	}
+	bool RecordingRenderer::createPostEffectShaderFromSource(StringView const source, IPostEffectShader** const pp_effect) {
+		return m_target->createPostEffectShaderFromSource(source, pp_effect);
+	}
+	bool RecordingRenderer::drawPostEffect(
+		IPostEffectShader* const p_effect,
+		BlendState const blend,
+		ITexture2D* const p_tex, SamplerState const rtsv,
+		Vector4F const* const cv, size_t const cv_n,
+		ITexture2D* const* const p_tex_arr, SamplerState const* const sv, size_t const tv_sv_n)
+	{
+		// 后处理着色器的参数在主线程上修改，只能立即执行
+		return synchronize()->drawPostEffect(p_effect, blend, p_tex, rtsv, cv, cv_n, p_tex_arr, sv, tv_sv_n);
+	}
+	bool RecordingRenderer::drawPostEffect(IPostEffectShader* const p_effect, BlendState const blend) {
+		return synchronize()->drawPostEffect(p_effect, blend);
+	}
+
+	bool RecordingRenderer::createModel(StringView const path, IModel** const pp_model) {
+		return m_target->createModel(path, pp_model);
+	}
+	bool RecordingRenderer::drawModel(IModel* const p_model) {
+		// 模型的变换在主线程上修改，只能立即执行
+		return synchronize()->drawModel(p_model);
+	}
+
+	ISamplerState* RecordingRenderer::getKnownSamplerState(SamplerState const state) {
+		return m_target->getKnownSamplerState(state);
+	}
+
+	IRenderer* RecordingRenderer::synchronize() {
+		assert(m_list);
+		if (m_wait) {
+			m_wait(m_wait_userdata);
+		}
+		if (!m_list->empty()) {
+			std::ignore = m_list->replay(m_target.get());
+			m_list->clear();
+		}
+		m_synchronize_count += 1;
+		return m_target.get();
+	}
+
+	RecordingRenderer::RecordingRenderer(IRenderer* const target, WaitCallback const wait, void* const userdata)
+		: m_target(target), m_wait(wait), m_wait_userdata(userdata) {
+		assert(target);
+	}
+	RecordingRenderer::~RecordingRenderer() = default;
+}
@@ -0,0 +1,93 @@
+#pragma once
+#include "core/SmartReference.hpp"
+#include "core/implement/ReferenceCounted.hpp"
+#include "Core/Graphics/Renderer.hpp"
+#include "Core/Graphics/Common/RenderCommandList.hpp"
+
+namespace core::Graphics::Common {
+	// 录制渲染器：把渲染调用录制到命令列表中，由渲染线程回放到真正的渲染器上
+	// 依赖当前设备状态或者对象可变状态的调用（后处理、模型、查询视口）无法延迟执行，
+	// 会先等待渲染线程空闲，然后在当前线程回放已经录制的命令并直接执行，即同步点
+	class RecordingRenderer final
+		: public implement::ReferenceCounted<IRenderer, IRenderCommandRecorder>
+	{
+	public:
+		// 等待渲染线程回放完所有已经提交的命令
+		using WaitCallback = void(*)(void* userdata);
+
+		// IRenderer
+
+		bool beginBatch() override;
+		bool endBatch() override;
+		bool isBatchScope() override;
+		bool flush() override;
+
+		void clearRenderTarget(Color4B const& color) override;
+		void clearDepthBuffer(float zvalue) override;
+		void setRenderAttachment(IRenderTarget* p_rt, IDepthStencilBuffer* p_ds) override;
+
+		void setOrtho(BoxF const& box) override;
+		void setPerspective(Vector3F const& eye, Vector3F const& lookat, Vector3F const& headup, float fov, float aspect, float znear, float zfar) override;
+
+		BoxF getViewport() override;
+		void setViewport(BoxF const& box) override;
+		void setScissorRect(RectF const& rect) override;
+		void setViewportAndScissorRect() override;
+
+		void setVertexColorBlendState(VertexColorBlendState state) override;
+		void setFogState(FogState state, Color4B const& color, float density_or_znear, float zfar) override;
+		void setDepthState(DepthState state) override;
+		void setBlendState(BlendState state) override;
+		void setTexture(ITexture2D* texture) override;
+
+		bool drawTriangle(DrawVertex const& v1, DrawVertex const& v2, DrawVertex const& v3) override;
+		bool drawTriangle(DrawVertex const* pvert) override;
+		bool drawQuad(DrawVertex const& v1, DrawVertex const& v2, DrawVertex const& v3, DrawVertex const& v4) override;
+		bool drawQuad(DrawVertex const* pvert) override;
+		bool drawRaw(DrawVertex const* pvert, uint16_t nvert, DrawIndex const* pidx, uint16_t nidx) override;
+		bool drawRequest(uint16_t nvert, uint16_t nidx, DrawVertex** ppvert, DrawIndex** ppidx, uint16_t* idxoffset) override;
+
+		bool createPostEffectShader(StringView path, IPostEffectShader** pp_effect) override;
+		bool createPostEffectShaderFromSource(StringView source, IPostEffectShader** pp_effect) override;
+		bool drawPostEffect(
+			IPostEffectShader* p_effect,
+			BlendState blend,
+			ITexture2D* p_tex, SamplerState rtsv,
+			Vector4F const* cv, size_t cv_n,
+			ITexture2D* const* p_tex_arr, SamplerState const* sv, size_t tv_sv_n) override;
+		bool drawPostEffect(IPostEffectShader* p_effect, BlendState blend) override;
+
+		bool createModel(StringView path, IModel** pp_model) override;
+		bool drawModel(IModel* p_model) override;
+
+		ISamplerState* getKnownSamplerState(SamplerState state) override;
+
+		// IRenderCommandRecorder
+
+		IRenderer* synchronize() override;
+
+		// RecordingRenderer
+
+		// 之后的渲染调用录制到 list 中，list 由调用方管理
+		void setCommandList(RenderCommandList* list) noexcept { m_list = list; }
+		[[nodiscard]] RenderCommandList* getCommandList() const noexcept { return m_list; }
+		// 同步点的累计次数，同步点过多说明流水线渲染的效果不好
+		[[nodiscard]] uint64_t getSynchronizeCount() const noexcept { return m_synchronize_count; }
+
+		RecordingRenderer(IRenderer* target, WaitCallback wait, void* userdata);
+		RecordingRenderer(RecordingRenderer const&) = delete;
+		RecordingRenderer(RecordingRenderer&&) = delete;
+		~RecordingRenderer();
+
+		RecordingRenderer& operator=(RecordingRenderer const&) = delete;
+		RecordingRenderer& operator=(RecordingRenderer&&) = delete;
+
+	private:
+		SmartReference<IRenderer> m_target;
+		RenderCommandList* m_list{};
+		WaitCallback m_wait{};
+		void* m_wait_userdata{};
+		uint64_t m_synchronize_count{};
+		bool m_batch_scope{};
+	};
+}
@@ -0,0 +1,383 @@
+#include "Core/Graphics/Common/RenderCommandList.hpp"
+#include <cassert>
+#include <cstring>
+#include <algorithm>
+#include <type_traits>
+
+namespace {
+	using core::Graphics::IRenderer;
+	using core::Graphics::IRenderTarget;
+	using core::Graphics::IDepthStencilBuffer;
+	using core::Graphics::ITexture2D;
+	using core::Graphics::Common::RenderCommandList;
+
+	struct RenderAttachmentPayload {
+		IRenderTarget* render_target;
+		IDepthStencilBuffer* depth_stencil_buffer;
+	};
+	struct PerspectivePayload {
+		core::Vector3F eye;
+		core::Vector3F lookat;
+		core::Vector3F headup;
+		float fov;
+		float aspect;
+		float znear;
+		float zfar;
+	};
+	struct FogPayload {
+		IRenderer::FogState state;
+		core::Color4B color;
+		float density_or_znear;
+		float zfar;
+	};
+	struct PrimitivePayload {
+		IRenderer::DrawVertex const* vertex;
+		uint32_t count; // 连续的三角形或四边形数量，顶点紧密排列
+	};
+	struct RawPayload {
+		IRenderer::DrawVertex const* vertex;
+		IRenderer::DrawIndex const* index;
+		uint16_t vertex_count;
+		uint16_t index_count;
+	};
+	struct CallbackPayload {
+		RenderCommandList::Callback function;
+		void* userdata;
+	};
+
+	template<typename T>
+	T read(std::vector<uint8_t> const& data, size_t& offset) {
+		static_assert(std::is_trivially_copyable_v<T>);
+		assert(data.size() - offset >= sizeof(T));
+		T value;
+		std::memcpy(&value, data.data() + offset, sizeof(T));
+		offset += sizeof(T);
+		return value;
+	}
+}
+
+namespace core::Graphics::Common {
+	enum class RenderCommandList::CommandType : uint8_t {
+		BeginBatch,
+		EndBatch,
+		Flush,
+		ClearRenderTarget,
+		ClearDepthBuffer,
+		SetRenderAttachment,
+		SetOrtho,
+		SetPerspective,
+		SetViewport,
+		SetScissorRect,
+		SetViewportAndScissorRect,
+		SetVertexColorBlendState,
+		SetFogState,
+		SetDepthState,
+		SetBlendState,
+		SetTexture,
+		DrawTriangle,
+		DrawQuad,
+		DrawRaw,
+		Callback,
+	};
+
+	// ChunkedBuffer
+
+	template<typename T>
+	T* RenderCommandList::ChunkedBuffer<T>::allocate(size_t const count) {
+		constexpr size_t chunk_size{ 16384 };
+		while (m_current < m_chunks.size()) {
+			auto& chunk = m_chunks[m_current];
+			if (chunk.capacity - chunk.size >= count) {
+				T* const data = chunk.data.get() + chunk.size;
+				chunk.size += count;
+				return data;
+			}
+			m_current += 1;
+		}
+		auto& chunk = m_chunks.emplace_back();
+		chunk.capacity = std::max(count, chunk_size);
+		chunk.data = std::make_unique<T[]>(chunk.capacity);
+		chunk.size = count;
+		m_current = m_chunks.size() - 1;
+		return chunk.data.get();
+	}
+	template<typename T>
+	void RenderCommandList::ChunkedBuffer<T>::clear() noexcept {
+		for (auto& chunk : m_chunks) {
+			chunk.size = 0;
+		}
+		m_current = 0;
+	}
+	template<typename T>
+	size_t RenderCommandList::ChunkedBuffer<T>::size() const noexcept {
+		size_t size{};
+		for (auto const& chunk : m_chunks) {
+			size += chunk.size;
+		}
+		return size;
+	}
+	template<typename T>
+	size_t RenderCommandList::ChunkedBuffer<T>::capacity() const noexcept {
+		size_t capacity{};
+		for (auto const& chunk : m_chunks) {
+			capacity += chunk.capacity;
+		}
+		return capacity;
+	}
+
+	// RenderCommandList
+
+	void RenderCommandList::beginBatch() {
+		write(CommandType::BeginBatch);
+	}
+	void RenderCommandList::endBatch() {
+		write(CommandType::EndBatch);
+	}
+	void RenderCommandList::flush() {
+		write(CommandType::Flush);
+	}
+
+	void RenderCommandList::clearRenderTarget(Color4B const& color) {
+		write(CommandType::ClearRenderTarget, color);
+	}
+	void RenderCommandList::clearDepthBuffer(float const zvalue) {
+		write(CommandType::ClearDepthBuffer, zvalue);
+	}
+	void RenderCommandList::setRenderAttachment(IRenderTarget* const p_rt, IDepthStencilBuffer* const p_ds) {
+		retain(p_rt);
+		retain(p_ds);
+		write(CommandType::SetRenderAttachment, RenderAttachmentPayload{ p_rt, p_ds });
+	}
+
+	void RenderCommandList::setOrtho(BoxF const& box) {
+		write(CommandType::SetOrtho, box);
+	}
+	void RenderCommandList::setPerspective(Vector3F const& eye, Vector3F const& lookat, Vector3F const& headup, float const fov, float const aspect, float const znear, float const zfar) {
+		write(CommandType::SetPerspective, PerspectivePayload{ eye, lookat, headup, fov, aspect, znear, zfar });
+	}
+
+	void RenderCommandList::setViewport(BoxF const& box) {
+		write(CommandType::SetViewport, box);
+	}
+	void RenderCommandList::setScissorRect(RectF const& rect) {
+		write(CommandType::SetScissorRect, rect);
+	}
+	void RenderCommandList::setViewportAndScissorRect() {
+		write(CommandType::SetViewportAndScissorRect);
+	}
+
+	void RenderCommandList::setVertexColorBlendState(IRenderer::VertexColorBlendState const state) {
+		write(CommandType::SetVertexColorBlendState, state);
+	}
+	void RenderCommandList::setFogState(IRenderer::FogState const state, Color4B const& color, float const density_or_znear, float const zfar) {
+		write(CommandType::SetFogState, FogPayload{ state, color, density_or_znear, zfar });
+	}
+	void RenderCommandList::setDepthState(IRenderer::DepthState const state) {
+		write(CommandType::SetDepthState, state);
+	}
+	void RenderCommandList::setBlendState(IRenderer::BlendState const state) {
+		write(CommandType::SetBlendState, state);
+	}
+	void RenderCommandList::setTexture(ITexture2D* const texture) {
+		// 精灵等对象每次绘制前都会设置纹理，和上一条设置纹理的命令之间只有绘制命令时可以省略
+		if (m_texture_scope && texture == m_last_texture) {
+			return;
+		}
+		if (texture != m_last_texture) {
+			retain(texture);
+			m_last_texture = texture;
+		}
+		write(CommandType::SetTexture, texture);
+		m_texture_scope = true;
+	}
+
+	void RenderCommandList::drawTriangle(DrawVertex const& v1, DrawVertex const& v2, DrawVertex const& v3) {
+		DrawVertex const vertex[3]{ v1, v2, v3 };
+		drawPrimitive(CommandType::DrawTriangle, vertex, 3);
+	}
+	void RenderCommandList::drawQuad(DrawVertex const& v1, DrawVertex const& v2, DrawVertex const& v3, DrawVertex const& v4) {
+		DrawVertex const vertex[4]{ v1, v2, v3, v4 };
+		drawPrimitive(CommandType::DrawQuad, vertex, 4);
+	}
+	void RenderCommandList::drawRaw(DrawVertex const* const pvert, uint16_t const nvert, DrawIndex const* const pidx, uint16_t const nidx) {
+		DrawVertex* vertex{};
+		DrawIndex* index{};
+		drawRequest(nvert, nidx, &vertex, &index);
+		std::memcpy(vertex, pvert, sizeof(DrawVertex) * nvert);
+		std::memcpy(index, pidx, sizeof(DrawIndex) * nidx);
+	}
+	void RenderCommandList::drawRequest(uint16_t const nvert, uint16_t const nidx, DrawVertex** const ppvert, DrawIndex** const ppidx) {
+		assert(ppvert && ppidx);
+		auto const vertex = m_vertex_buffer.allocate(nvert);
+		auto const index = m_index_buffer.allocate(nidx);
+		write(CommandType::DrawRaw, RawPayload{ vertex, index, nvert, nidx });
+		*ppvert = vertex;
+		*ppidx = index;
+	}
+
+	void RenderCommandList::callback(Callback const function, void* const userdata) {
+		assert(function);
+		write(CommandType::Callback, CallbackPayload{ function, userdata });
+	}
+
+	bool RenderCommandList::replay(IRenderer* const renderer) const {
+		assert(renderer);
+		bool result = true;
+		size_t offset = 0;
+		while (offset < m_commands.size()) {
+			auto const type = static_cast<CommandType>(m_commands[offset]);
+			offset += 1;
+			switch (type) {
+			case CommandType::BeginBatch:
+				result = renderer->beginBatch() && result;
+				break;
+			case CommandType::EndBatch:
+				result = renderer->endBatch() && result;
+				break;
+			case CommandType::Flush:
+				result = renderer->flush() && result;
+				break;
+			case CommandType::ClearRenderTarget:
+				renderer->clearRenderTarget(read<Color4B>(m_commands, offset));
+				break;
+			case CommandType::ClearDepthBuffer:
+				renderer->clearDepthBuffer(read<float>(m_commands, offset));
+				break;
+			case CommandType::SetRenderAttachment: {
+				auto const payload = read<RenderAttachmentPayload>(m_commands, offset);
+				renderer->setRenderAttachment(payload.render_target, payload.depth_stencil_buffer);
+				break;
+			}
+			case CommandType::SetOrtho:
+				renderer->setOrtho(read<BoxF>(m_commands, offset));
+				break;
+			case CommandType::SetPerspective: {
+				auto const payload = read<PerspectivePayload>(m_commands, offset);
+				renderer->setPerspective(payload.eye, payload.lookat, payload.headup, payload.fov, payload.aspect, payload.znear, payload.zfar);
+				break;
+			}
+			case CommandType::SetViewport:
+				renderer->setViewport(read<BoxF>(m_commands, offset));
+				break;
+			case CommandType::SetScissorRect:
+				renderer->setScissorRect(read<RectF>(m_commands, offset));
+				break;
+			case CommandType::SetViewportAndScissorRect:
+				renderer->setViewportAndScissorRect();
+				break;
+			case CommandType::SetVertexColorBlendState:
+				renderer->setVertexColorBlendState(read<IRenderer::VertexColorBlendState>(m_commands, offset));
+				break;
+			case CommandType::SetFogState: {
+				auto const payload = read<FogPayload>(m_commands, offset);
+				renderer->setFogState(payload.state, payload.color, payload.density_or_znear, payload.zfar);
+				break;
+			}
+			case CommandType::SetDepthState:
+				renderer->setDepthState(read<IRenderer::DepthState>(m_commands, offset));
+				break;
+			case CommandType::SetBlendState:
+				renderer->setBlendState(read<IRenderer::BlendState>(m_commands, offset));
+				break;
+			case CommandType::SetTexture:
+				renderer->setTexture(read<ITexture2D*>(m_commands, offset));
+				break;
+			case CommandType::DrawTriangle: {
+				auto const payload = read<PrimitivePayload>(m_commands, offset);
+				for (uint32_t i = 0; i < payload.count; i += 1) {
+					result = renderer->drawTriangle(payload.vertex + i * 3) && result;
+				}
+				break;
+			}
+			case CommandType::DrawQuad: {
+				auto const payload = read<PrimitivePayload>(m_commands, offset);
+				for (uint32_t i = 0; i < payload.count; i += 1) {
+					result = renderer->drawQuad(payload.vertex + i * 4) && result;
+				}
+				break;
+			}
+			case CommandType::DrawRaw: {
+				auto const payload = read<RawPayload>(m_commands, offset);
+				result = renderer->drawRaw(payload.vertex, payload.vertex_count, payload.index, payload.index_count) && result;
+				break;
+			}
+			case CommandType::Callback: {
+				auto const payload = read<CallbackPayload>(m_commands, offset);
+				payload.function(payload.userdata, renderer);
+				break;
+			}
+			default:
+				assert(false); return false;
+			}
+		}
+		return result;
+	}
+	void RenderCommandList::clear() {
+		for (auto const object : m_references) {
+			object->release();
+		}
+		m_references.clear();
+		m_commands.clear();
+		m_vertex_buffer.clear();
+		m_index_buffer.clear();
+		m_command_count = 0;
+		m_last_command_offset = SIZE_MAX;
+		m_last_texture = nullptr;
+		m_texture_scope = false;
+	}
+
+	size_t RenderCommandList::getVertexCount() const noexcept {
+		return m_vertex_buffer.size();
+	}
+	size_t RenderCommandList::getIndexCount() const noexcept {
+		return m_index_buffer.size();
+	}
+	size_t RenderCommandList::getMemoryUsage() const noexcept {
+		return m_commands.capacity()
+			+ sizeof(DrawVertex) * m_vertex_buffer.capacity()
+			+ sizeof(DrawIndex) * m_index_buffer.capacity()
+			+ sizeof(IReferenceCounted*) * m_references.capacity();
+	}
+
+	RenderCommandList::~RenderCommandList() {
+		clear();
+	}
+
+	void RenderCommandList::write(CommandType const type) {
+		if (type != CommandType::SetTexture && type != CommandType::DrawTriangle && type != CommandType::DrawQuad && type != CommandType::DrawRaw) {
+			m_texture_scope = false;
+		}
+		m_last_command_offset = m_commands.size();
+		m_commands.push_back(static_cast<uint8_t>(type));
+		m_command_count += 1;
+	}
+	template<typename T>
+	void RenderCommandList::write(CommandType const type, T const& payload) {
+		static_assert(std::is_trivially_copyable_v<T>);
+		write(type);
+		auto const offset = m_commands.size();
+		m_commands.resize(offset + sizeof(T));
+		std::memcpy(m_commands.data() + offset, &payload, sizeof(T));
+	}
+	void RenderCommandList::drawPrimitive(CommandType const type, DrawVertex const* const vertex, uint32_t const vertex_count) {
+		auto const data = m_vertex_buffer.allocate(vertex_count);
+		std::memcpy(data, vertex, sizeof(DrawVertex) * vertex_count);
+		// 连续绘制的三角形或四边形，顶点也是连续分配的，合并成一条命令
+		if (m_last_command_offset != SIZE_MAX && static_cast<CommandType>(m_commands[m_last_command_offset]) == type) {
+			size_t offset = m_last_command_offset + 1;
+			auto payload = read<PrimitivePayload>(m_commands, offset);
+			if (payload.vertex + payload.count * vertex_count == data) {
+				payload.count += 1;
+				std::memcpy(m_commands.data() + m_last_command_offset + 1, &payload, sizeof(payload));
+				return;
+			}
+		}
+		write(type, PrimitivePayload{ data, 1 });
+	}
+	void RenderCommandList::retain(IReferenceCounted* const object) {
+		if (object != nullptr) {
+			object->retain();
+			m_references.push_back(object);
+		}
+	}
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <memory>
+#include "Core/Graphics/Renderer.hpp"
+
+namespace core::Graphics::Common {
+	// 渲染命令列表：按顺序录制 IRenderer 的调用，之后（通常在另一个线程）回放到真正的渲染器上
+	// 命令和参数连续存放在字节缓冲区中；顶点和索引存放在分块的缓冲区中，分配出去的地址在 clear 之前不会失效
+	// 命令引用的纹理、渲染目标等对象会被持有，直到 clear
+	// 不依赖具体的图形 API，可以用任意 IRenderer 实现回放
+	class RenderCommandList {
+	public:
+		using DrawVertex = IRenderer::DrawVertex;
+		using DrawIndex = IRenderer::DrawIndex;
+		// 回放到这条命令时调用，用于执行渲染器以外的操作，例如设置交换链的渲染目标
+		using Callback = void(*)(void* userdata, IRenderer* renderer);
+
+		void beginBatch();
+		void endBatch();
+		void flush();
+
+		void clearRenderTarget(Color4B const& color);
+		void clearDepthBuffer(float zvalue);
+		void setRenderAttachment(IRenderTarget* p_rt, IDepthStencilBuffer* p_ds);
+
+		void setOrtho(BoxF const& box);
+		void setPerspective(Vector3F const& eye, Vector3F const& lookat, Vector3F const& headup, float fov, float aspect, float znear, float zfar);
+
+		void setViewport(BoxF const& box);
+		void setScissorRect(RectF const& rect);
+		void setViewportAndScissorRect();
+
+		void setVertexColorBlendState(IRenderer::VertexColorBlendState state);
+		void setFogState(IRenderer::FogState state, Color4B const& color, float density_or_znear, float zfar);
+		void setDepthState(IRenderer::DepthState state);
+		void setBlendState(IRenderer::BlendState state);
+		void setTexture(ITexture2D* texture);
+
+		void drawTriangle(DrawVertex const& v1, DrawVertex const& v2, DrawVertex const& v3);
+		void drawQuad(DrawVertex const& v1, DrawVertex const& v2, DrawVertex const& v3, DrawVertex const& v4);
+		void drawRaw(DrawVertex const* pvert, uint16_t nvert, DrawIndex const* pidx, uint16_t nidx);
+		// 分配顶点和索引空间，由调用方填写，索引从 0 开始（回放时按 drawRaw 处理）
+		void drawRequest(uint16_t nvert, uint16_t nidx, DrawVertex** ppvert, DrawIndex** ppidx);
+
+		void callback(Callback function, void* userdata);
+
+		// 按录制顺序回放所有命令，任意一条命令失败时返回 false，但仍然会回放剩下的命令
+		bool replay(IRenderer* renderer) const;
+		void clear();
+
+		[[nodiscard]] bool empty() const noexcept { return m_command_count == 0; }
+		[[nodiscard]] size_t getCommandCount() const noexcept { return m_command_count; }
+		[[nodiscard]] size_t getVertexCount() const noexcept;
+		[[nodiscard]] size_t getIndexCount() const noexcept;
+		[[nodiscard]] size_t getMemoryUsage() const noexcept;
+
+		RenderCommandList() = default;
+		RenderCommandList(RenderCommandList const&) = delete;
+		RenderCommandList(RenderCommandList&&) = delete;
+		~RenderCommandList();
+
+		RenderCommandList& operator=(RenderCommandList const&) = delete;
+		RenderCommandList& operator=(RenderCommandList&&) = delete;
+
+	private:
+		enum class CommandType : uint8_t;
+
+		template<typename T>
+		class ChunkedBuffer {
+		public:
+			T* allocate(size_t count);
+			void clear() noexcept;
+			[[nodiscard]] size_t size() const noexcept;
+			[[nodiscard]] size_t capacity() const noexcept;
+		private:
+			struct Chunk {
+				std::unique_ptr<T[]> data;
+				size_t capacity{};
+				size_t size{};
+			};
+			std::vector<Chunk> m_chunks;
+			size_t m_current{};
+		};
+
+		void write(CommandType type);
+		template<typename T>
+		void write(CommandType type, T const& payload);
+		void drawPrimitive(CommandType type, DrawVertex const* vertex, uint32_t vertex_count);
+		void retain(IReferenceCounted* object);
+
+		std::vector<uint8_t> m_commands;
+		ChunkedBuffer<DrawVertex> m_vertex_buffer;
+		ChunkedBuffer<DrawIndex> m_index_buffer;
+		std::vector<IReferenceCounted*> m_references;
+		size_t m_command_count{};
+		size_t m_last_command_offset{ SIZE_MAX };
+		ITexture2D* m_last_texture{};
+		bool m_texture_scope{}; // 上一条设置纹理的命令之后只有绘制命令
+	};
+}
@@ -138,6 +138,100 @@ namespace core::Graphics::Common {
 		m_renderer->drawQuad(vert);
 	}
 
+	bool Sprite::drawInstances(SpriteInstance const* const instances, size_t const count) {
+		using namespace DirectX;
+
+		if (count == 0) {
+			return true;
+		}
+		m_renderer->setTexture(m_texture.get());
+
+		XMVECTOR const rect_l = XMVectorReplicate(m_pos_rc.a.x);
+		XMVECTOR const rect_t = XMVectorReplicate(m_pos_rc.a.y);
+		XMVECTOR const rect_r = XMVectorReplicate(m_pos_rc.b.x);
+		XMVECTOR const rect_b = XMVectorReplicate(m_pos_rc.b.y);
+
+		for (size_t first = 0; first < count; first += max_batch_instance_count) {
+			size_t const batch_count = std::min(max_batch_instance_count, count - first);
+			IRenderer::DrawVertex* p_vertex{};
+			IRenderer::DrawIndex* p_index{};
+			uint16_t index_offset{};
+			if (!m_renderer->drawRequest(static_cast<uint16_t>(batch_count * 4), static_cast<uint16_t>(batch_count * 6), &p_vertex, &p_index, &index_offset)) {
+				return false;
+			}
+
+			// 每次变换 4 个实例，不足 4 个的用 0 补齐
+
+			for (size_t i = 0; i < batch_count; i += 4) {
+				auto const p_instance = instances + first + i;
+				size_t const lane_count = std::min<size_t>(4, batch_count - i);
+
+				alignas(16) float x[4]{};
+				alignas(16) float y[4]{};
+				alignas(16) float r[4]{};
+				alignas(16) float sx[4]{};
+				alignas(16) float sy[4]{};
+				for (size_t k = 0; k < lane_count; k += 1) {
+					x[k] = p_instance[k].x;
+					y[k] = p_instance[k].y;
+					r[k] = p_instance[k].rotation;
+					sx[k] = p_instance[k].hscale;
+					sy[k] = p_instance[k].vscale;
+				}
+
+				XMVECTOR const vx = XMLoadFloat4A(reinterpret_cast<XMFLOAT4A const*>(x));
+				XMVECTOR const vy = XMLoadFloat4A(reinterpret_cast<XMFLOAT4A const*>(y));
+				XMVECTOR sin_v, cos_v;
+				XMVectorSinCos(&sin_v, &cos_v, XMLoadFloat4A(reinterpret_cast<XMFLOAT4A const*>(r)));
+				XMVECTOR const vsx = XMLoadFloat4A(reinterpret_cast<XMFLOAT4A const*>(sx));
+				XMVECTOR const vsy = XMLoadFloat4A(reinterpret_cast<XMFLOAT4A const*>(sy));
+
+				// 缩放，然后旋转：x' = x * cos - y * sin, y' = x * sin + y * cos
+
+				XMVECTOR const l = XMVectorMultiply(rect_l, vsx);
+				XMVECTOR const rr = XMVectorMultiply(rect_r, vsx);
+				XMVECTOR const t = XMVectorMultiply(rect_t, vsy);
+				XMVECTOR const b = XMVectorMultiply(rect_b, vsy);
+
+				XMVECTOR const l_cos = XMVectorMultiplyAdd(l, cos_v, vx);
+				XMVECTOR const l_sin = XMVectorMultiplyAdd(l, sin_v, vy);
+				XMVECTOR const r_cos = XMVectorMultiplyAdd(rr, cos_v, vx);
+				XMVECTOR const r_sin = XMVectorMultiplyAdd(rr, sin_v, vy);
+
+				alignas(16) float px[4][4];
+				alignas(16) float py[4][4];
+				XMStoreFloat4A(reinterpret_cast<XMFLOAT4A*>(px[0]), XMVectorNegativeMultiplySubtract(t, sin_v, l_cos));
+				XMStoreFloat4A(reinterpret_cast<XMFLOAT4A*>(py[0]), XMVectorMultiplyAdd(t, cos_v, l_sin));
+				XMStoreFloat4A(reinterpret_cast<XMFLOAT4A*>(px[1]), XMVectorNegativeMultiplySubtract(t, sin_v, r_cos));
+				XMStoreFloat4A(reinterpret_cast<XMFLOAT4A*>(py[1]), XMVectorMultiplyAdd(t, cos_v, r_sin));
+				XMStoreFloat4A(reinterpret_cast<XMFLOAT4A*>(px[2]), XMVectorNegativeMultiplySubtract(b, sin_v, r_cos));
+				XMStoreFloat4A(reinterpret_cast<XMFLOAT4A*>(py[2]), XMVectorMultiplyAdd(b, cos_v, r_sin));
+				XMStoreFloat4A(reinterpret_cast<XMFLOAT4A*>(px[3]), XMVectorNegativeMultiplySubtract(b, sin_v, l_cos));
+				XMStoreFloat4A(reinterpret_cast<XMFLOAT4A*>(py[3]), XMVectorMultiplyAdd(b, cos_v, l_sin));
+
+				for (size_t k = 0; k < lane_count; k += 1) {
+					uint32_t const color = p_instance[k].color;
+					auto const p = p_vertex + (i + k) * 4;
+					p[0] = IRenderer::DrawVertex(px[0][k], py[0][k], m_z, m_uv.a.x, m_uv.a.y, color);
+					p[1] = IRenderer::DrawVertex(px[1][k], py[1][k], m_z, m_uv.b.x, m_uv.a.y, color);
+					p[2] = IRenderer::DrawVertex(px[2][k], py[2][k], m_z, m_uv.b.x, m_uv.b.y, color);
+					p[3] = IRenderer::DrawVertex(px[3][k], py[3][k], m_z, m_uv.a.x, m_uv.b.y, color);
+				}
+			}
+
+			for (size_t i = 0; i < batch_count; i += 1) {
+				auto const base = static_cast<IRenderer::DrawIndex>(index_offset + i * 4);
+				p_index[i * 6 + 0] = base;
+				p_index[i * 6 + 1] = base + 1;
+				p_index[i * 6 + 2] = base + 2;
+				p_index[i * 6 + 3] = base;
+				p_index[i * 6 + 4] = base + 2;
+				p_index[i * 6 + 5] = base + 3;
+			}
+		}
+		return true;
+	}
+
 	bool Sprite::clone(ISprite** const pp_sprite) {
 		auto const right = new Sprite(m_renderer.get(), m_texture.get());
 		right->m_rect = m_rect;
@@ -52,6 +52,8 @@ namespace core::Graphics::Common {
 		void draw(Vector2F const& pos, Vector2F const& scale) override;
 		void draw(Vector2F const& pos, Vector2F const& scale, float rotation) override;
 
+		bool drawInstances(SpriteInstance const* instances, size_t count) override;
+
 		bool clone(ISprite** pp_sprite) override;
 
 		// Sprite
@@ -66,6 +68,9 @@ namespace core::Graphics::Common {
 		void updateRect();
 
 	private:
+		// 一次 drawRequest 最多提交的实例数量，远小于渲染器的顶点缓冲区
+		static constexpr size_t max_batch_instance_count{ 1024 };
+
 		SmartReference<IRenderer> m_renderer;
 		SmartReference<ITexture2D> m_texture;
 		RectF m_rect;
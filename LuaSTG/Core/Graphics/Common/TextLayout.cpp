@@ -0,0 +1,198 @@
+#include "Core/Graphics/Common/TextLayout.hpp"
+#include "utility/utf.hpp"
+
+namespace core::Graphics::Common {
+
+	void TextLayout::setText(StringView const str) {
+		if (m_text != str) {
+			m_text.assign(str.data(), str.size());
+			m_dirty = true;
+		}
+	}
+	void TextLayout::setGlyphManager(IGlyphManager* const p_mgr) {
+		if (m_glyph_mgr.get() != p_mgr) {
+			m_glyph_mgr = p_mgr;
+			m_dirty = true;
+		}
+	}
+	void TextLayout::setScale(Vector2F const& scale) {
+		if (m_scale != scale) {
+			m_scale = scale;
+			m_dirty = true;
+		}
+	}
+
+	RectF TextLayout::getBoundary() {
+		update();
+		return m_boundary;
+	}
+	Vector2F TextLayout::getAdvance() {
+		update();
+		return m_advance;
+	}
+	bool TextLayout::draw(IRenderer* const p_renderer, Vector2F const& start, float const z, Color4B const color) {
+		if (!p_renderer || !update()) {
+			return false;
+		}
+
+		// 每帧重新标记一次字形的使用，以免被当成不常用的字形淘汰
+		if (m_frame != m_glyph_mgr->getFrame()) {
+			for (auto const codepoint : m_codepoints) {
+				m_glyph_mgr->cacheGlyph(codepoint);
+			}
+			m_frame = m_glyph_mgr->getFrame();
+		}
+		// 设备丢失后字形纹理需要重新上传
+		if (!m_glyph_mgr->flush()) {
+			return false;
+		}
+
+		uint32_t const vertex_color = color.color();
+		for (uint32_t page = 0; page < static_cast<uint32_t>(m_pages.size()); page += 1) {
+			auto const& vertices = m_pages[page];
+			if (vertices.empty()) {
+				continue;
+			}
+			auto const p_texture = m_glyph_mgr->getTexture(page);
+			if (!p_texture) {
+				assert(false); return false;
+			}
+			p_renderer->setTexture(p_texture);
+
+			for (size_t first = 0; first < vertices.size(); first += max_batch_glyph_count * 4) {
+				size_t const vertex_count = std::min(max_batch_glyph_count * 4, vertices.size() - first);
+				size_t const glyph_count = vertex_count / 4;
+				IRenderer::DrawVertex* p_vertex{};
+				IRenderer::DrawIndex* p_index{};
+				uint16_t index_offset{};
+				if (!p_renderer->drawRequest(static_cast<uint16_t>(vertex_count), static_cast<uint16_t>(glyph_count * 6), &p_vertex, &p_index, &index_offset)) {
+					return false;
+				}
+				for (size_t i = 0; i < vertex_count; i += 1) {
+					auto const& source = vertices[first + i];
+					p_vertex[i] = IRenderer::DrawVertex(source.x + start.x, source.y + start.y, z, source.u, source.v, vertex_color);
+				}
+				for (size_t i = 0; i < glyph_count; i += 1) {
+					auto const base = static_cast<IRenderer::DrawIndex>(index_offset + i * 4);
+					p_index[i * 6 + 0] = base;
+					p_index[i * 6 + 1] = base + 1;
+					p_index[i * 6 + 2] = base + 2;
+					p_index[i * 6 + 3] = base;
+					p_index[i * 6 + 4] = base + 2;
+					p_index[i * 6 + 5] = base + 3;
+				}
+			}
+		}
+		return true;
+	}
+
+	TextLayout::TextLayout() = default;
+	TextLayout::~TextLayout() = default;
+
+	bool TextLayout::update() {
+		if (!m_glyph_mgr) {
+			m_pages.clear();
+			m_codepoints.clear();
+			m_boundary = RectF();
+			m_advance = Vector2F();
+			return false;
+		}
+		if (!m_dirty && m_version == m_glyph_mgr->getVersion()) {
+			return true;
+		}
+
+		// 首先，缓存所有字形
+		if (!m_glyph_mgr->cacheString(m_text)) {
+			// 找不到的就忽略
+		}
+		if (!m_glyph_mgr->flush()) {
+			return false;
+		}
+
+		for (auto& vertices : m_pages) {
+			vertices.clear();
+		}
+		m_codepoints.clear();
+
+		// 和 TextRenderer 的排版规则一致
+		GlyphInfo glyph_info = {};
+		Vector2F start_pos;
+		RectF rect(Vector2F(FLT_MAX, -FLT_MAX), Vector2F(-FLT_MAX, FLT_MAX));
+		bool is_updated = false;
+		float const line_height = m_glyph_mgr->getLineHeight();
+
+		char32_t code_ = 0;
+		utf::utf8reader reader_(m_text.data(), m_text.size());
+		while (reader_(code_)) {
+			// 换行处理
+			if (code_ == U'\n') {
+				start_pos.x = 0.0f;
+				start_pos.y -= line_height;
+				continue;
+			}
+			if (!m_glyph_mgr->getGlyph(code_, &glyph_info, true)) {
+				continue;
+			}
+			m_codepoints.push_back(code_);
+
+			// 更新包围盒
+			float const left = start_pos.x + glyph_info.position.x;
+			float const top = start_pos.y + glyph_info.position.y;
+			float const right = left + glyph_info.size.x;
+			float const bottom = top - glyph_info.size.y;
+			rect.a.x = std::min(rect.a.x, left);
+			rect.a.y = std::max(rect.a.y, top);
+			rect.b.x = std::max(rect.b.x, right);
+			rect.b.y = std::min(rect.b.y, bottom);
+			is_updated = true;
+
+			// 生成顶点，空格不用画
+			if (code_ != U' ') {
+				if (glyph_info.texture_index >= m_pages.size()) {
+					m_pages.resize(glyph_info.texture_index + 1);
+				}
+				auto& vertices = m_pages[glyph_info.texture_index];
+				float const x0 = left * m_scale.x;
+				float const y0 = top * m_scale.y;
+				float const x1 = right * m_scale.x;
+				float const y1 = bottom * m_scale.y;
+				auto const& uv = glyph_info.texture_rect;
+				vertices.emplace_back(x0, y0, 0.0f, uv.a.x, uv.a.y);
+				vertices.emplace_back(x1, y0, 0.0f, uv.b.x, uv.a.y);
+				vertices.emplace_back(x1, y1, 0.0f, uv.b.x, uv.b.y);
+				vertices.emplace_back(x0, y1, 0.0f, uv.a.x, uv.b.y);
+			}
+
+			// 前进
+			start_pos += glyph_info.advance;
+		}
+
+		if (is_updated) {
+			m_boundary = RectF(rect.a.x * m_scale.x, rect.a.y * m_scale.y, rect.b.x * m_scale.x, rect.b.y * m_scale.y);
+			m_advance = Vector2F(start_pos.x * m_scale.x, start_pos.y * m_scale.y);
+		}
+		else {
+			m_boundary = RectF();
+			m_advance = Vector2F();
+		}
+
+		std::sort(m_codepoints.begin(), m_codepoints.end());
+		m_codepoints.erase(std::unique(m_codepoints.begin(), m_codepoints.end()), m_codepoints.end());
+		m_version = m_glyph_mgr->getVersion();
+		m_frame = m_glyph_mgr->getFrame();
+		m_dirty = false;
+		return true;
+	}
+
+}
+namespace core::Graphics {
+	bool ITextLayout::create(ITextLayout** const output) {
+		try {
+			*output = new Common::TextLayout();
+			return true;
+		} catch (...) {
+			*output = nullptr;
+			return false;
+		}
+	}
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include "core/SmartReference.hpp"
+#include "core/implement/ReferenceCounted.hpp"
+#include "Core/Graphics/Font.hpp"
+
+namespace core::Graphics::Common
+{
+	class TextLayout final
+		: public implement::ReferenceCounted<ITextLayout>
+	{
+	public:
+		// ITextLayout
+
+		void setText(StringView str) override;
+		StringView getText() override { return m_text; }
+		void setGlyphManager(IGlyphManager* p_mgr) override;
+		IGlyphManager* getGlyphManager() override { return m_glyph_mgr.get(); }
+		void setScale(Vector2F const& scale) override;
+		Vector2F getScale() override { return m_scale; }
+
+		RectF getBoundary() override;
+		Vector2F getAdvance() override;
+		bool draw(IRenderer* p_renderer, Vector2F const& start, float z, Color4B color) override;
+
+		// TextLayout
+
+		TextLayout();
+		TextLayout(TextLayout const&) = delete;
+		TextLayout(TextLayout&&) = delete;
+		~TextLayout();
+
+		TextLayout& operator=(TextLayout const&) = delete;
+		TextLayout& operator=(TextLayout&&) = delete;
+
+	private:
+		// 一次 drawRequest 最多提交的字形数量，远小于渲染器的顶点缓冲区
+		static constexpr size_t max_batch_glyph_count{ 1024 };
+
+		bool update();
+
+		std::string m_text;
+		SmartReference<IGlyphManager> m_glyph_mgr;
+		Vector2F m_scale{ 1.0f, 1.0f };
+
+		// 排版结果，顶点以起点为原点，按纹理分组
+		std::vector<std::vector<IRenderer::DrawVertex>> m_pages;
+		std::vector<uint32_t> m_codepoints; // 去重，用于每帧标记一次字形的使用
+		RectF m_boundary;
+		Vector2F m_advance;
+		uint64_t m_version{};
+		uint64_t m_frame{};
+		bool m_dirty{ true };
+	};
+}
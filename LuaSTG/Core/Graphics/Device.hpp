@@ -4,6 +4,7 @@
 #include "core/ReferenceCounted.hpp"
 #include "core/Data.hpp"
 #include "core/ImmutableString.hpp"
+#include "Core/Graphics/Image.hpp"
 
 #define LUASTG_ENABLE_DIRECT2D
 
@@ -161,6 +162,11 @@ namespace core::Graphics
 
 		virtual bool createTextureFromFile(StringView path, bool mipmap, ITexture2D** pp_texture) = 0;
 		virtual bool createTextureFromData(IData* data, bool mipmap, ITexture2D** pp_texture) = 0;
+		// levels are straight alpha images decoded from the file at path (or from source when path is empty),
+		// each one half the size of the previous one built by IImage::createMipmap.
+		// After device lost the texture decodes the file (or source) again and builds the mipmaps the same way,
+		// source is only kept when path is empty
+		virtual bool createTextureFromImage(StringView path, IData* source, IImage* const* levels, uint32_t level_count, ITexture2D** pp_texture) = 0;
 		virtual bool createTexture(Vector2U size, ITexture2D** pp_texture) = 0;
 
 		virtual bool createRenderTarget(Vector2U size, IRenderTarget** pp_rt) = 0;
@@ -145,6 +145,7 @@ namespace core::Graphics::Direct3D11 {
 
 		bool createTextureFromFile(StringView path, bool mipmap, ITexture2D** pp_texture) override;
 		bool createTextureFromData(IData* data, bool mipmap, ITexture2D** pp_texture) override;
+		bool createTextureFromImage(StringView path, IData* source, IImage* const* levels, uint32_t level_count, ITexture2D** pp_texture) override;
 		bool createTexture(Vector2U size, ITexture2D** pp_texture) override;
 
 		bool createRenderTarget(Vector2U size, IRenderTarget** pp_rt);
@@ -30,8 +30,9 @@ namespace core::Graphics::Direct3D11 {
 		m_vertex_color_blend_state = vertex_color_blend_state;
 		m_blend_state = blend_state;
 	}
-	void MeshRenderer::draw(IRenderer* const renderer) {
+	void MeshRenderer::draw(IRenderer* renderer) {
 		assert(renderer);
+		renderer = getImmediateRenderer(renderer); // 下面直接使用设备上下文
 
 		renderer->setVertexColorBlendState(m_vertex_color_blend_state);
 		renderer->setTexture(m_texture.get());
@@ -1,5 +1,6 @@
 #include "Core/Graphics/Direct3D11/Texture2D.hpp"
 #include "Core/Graphics/Direct3D11/Device.hpp"
+#include "Core/Graphics/Common/BakedTexture.hpp"
 #include "core/FileSystem.hpp"
 #include "Core/i18n.hpp"
 #include "utf8.hpp"
@@ -13,6 +14,7 @@ namespace core::Graphics::Direct3D11 {
 	void Texture2D::onDeviceCreate() {
 		if (m_initialized) {
 			createResource();
+			releaseSourceLevels();
 		}
 	}
 	void Texture2D::onDeviceDestroy() {
@@ -100,6 +102,31 @@ namespace core::Graphics::Direct3D11 {
 		m_device->addEventListener(this);
 		return true;
 	}
+	bool Texture2D::initialize(Device* const device, StringView const path, IData* const source, IImage* const* const levels, uint32_t const level_count) {
+		assert(device);
+		assert(levels && level_count > 0);
+		m_device = device;
+		// The file can be read again after device lost, the encoded bytes are only kept when there is no file
+		m_source_path = path;
+		if (path.empty()) {
+			m_source_data = source;
+		}
+		m_decode_source = !m_source_path.empty() || m_source_data;
+		m_source_levels.reserve(level_count);
+		for (uint32_t i = 0; i < level_count; i += 1) {
+			assert(levels[i]);
+			m_source_levels.emplace_back(levels[i]);
+		}
+		m_mipmap = level_count > 1;
+		bool const result = createResource();
+		releaseSourceLevels();
+		if (!result) {
+			return false;
+		}
+		m_initialized = true;
+		m_device->addEventListener(this);
+		return true;
+	}
 	bool Texture2D::initialize(Device* const device, Vector2U const size, bool const is_render_target) {
 		assert(device);
 		assert(size.x > 0 && size.y > 0);
@@ -170,13 +197,68 @@ namespace core::Graphics::Direct3D11 {
 			}
 			M_D3D_SET_DEBUG_NAME(m_view.Get(), "Texture2D_D3D11::d3d11_srv");
 		}
+		else if (m_decode_source || !m_source_levels.empty()) {
+			if (m_source_levels.empty() && !decodeSourceLevels()) {
+				return false;
+			}
+			auto const size = m_source_levels[0]->getSize();
+			auto const level_count = static_cast<uint32_t>(m_source_levels.size());
+			std::vector<D3D11_SUBRESOURCE_DATA> subres_data(level_count);
+			for (uint32_t i = 0; i < level_count; i += 1) {
+				auto const level_size = m_source_levels[i]->getSize();
+				subres_data[i] = D3D11_SUBRESOURCE_DATA{
+					.pSysMem = m_source_levels[i]->getPixelData(),
+					.SysMemPitch = 4 * level_size.x, // BGRA
+					.SysMemSlicePitch = 4 * level_size.x * level_size.y,
+				};
+			}
+			D3D11_TEXTURE2D_DESC tex2d_desc = {
+				.Width = size.x,
+				.Height = size.y,
+				.MipLevels = level_count,
+				.ArraySize = 1,
+				.Format = DXGI_FORMAT_B8G8R8A8_UNORM,
+				.SampleDesc = {
+					.Count = 1,
+					.Quality = 0,
+				},
+				.Usage = D3D11_USAGE_IMMUTABLE,
+				.BindFlags = D3D11_BIND_SHADER_RESOURCE,
+				.CPUAccessFlags = 0,
+				.MiscFlags = 0,
+			};
+			hr = gHR = d3d11_device->CreateTexture2D(&tex2d_desc, subres_data.data(), &m_texture);
+			if (FAILED(hr)) {
+				i18n_core_system_call_report_error("ID3D11Device::CreateTexture2D");
+				return false;
+			}
+			M_D3D_SET_DEBUG_NAME(m_texture.Get(), "Texture2D_D3D11::d3d11_texture2d");
+
+			D3D11_SHADER_RESOURCE_VIEW_DESC view_desc = {
+				.Format = tex2d_desc.Format,
+				.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D,
+				.Texture2D = {
+					.MostDetailedMip = 0,
+					.MipLevels = level_count,
+				},
+			};
+			hr = gHR = d3d11_device->CreateShaderResourceView(m_texture.Get(), &view_desc, &m_view);
+			if (FAILED(hr)) {
+				i18n_core_system_call_report_error("ID3D11Device::CreateShaderResourceView");
+				return false;
+			}
+			M_D3D_SET_DEBUG_NAME(m_view.Get(), "Texture2D_D3D11::d3d11_srv");
+
+			m_size = size;
+		}
 		else if (m_source_data || !m_source_path.empty()) {
 			SmartReference<IData> src;
 			if (m_source_data) {
 				src = m_source_data;
 			}
 			else {
-				if (!FileSystemManager::readFile(m_source_path, src.put())) {
+				// Prefer the texture baked by texture-compressor next to the original
+				if (!Common::readBakedTexture(m_source_path, m_mipmap, src.put()) && !FileSystemManager::readFile(m_source_path, src.put())) {
 					spdlog::error("[core] 无法加载文件 '{}'", m_source_path);
 					return false;
 				}
@@ -282,6 +364,43 @@ namespace core::Graphics::Direct3D11 {
 
 		return true;
 	}
+	bool Texture2D::decodeSourceLevels() {
+		SmartReference<IData> src;
+		if (m_source_data) {
+			src = m_source_data;
+		}
+		else if (!FileSystemManager::readFile(m_source_path, src.put())) {
+			spdlog::error("[core] 无法加载文件 '{}'", m_source_path);
+			return false;
+		}
+		SmartReference<IImage> image;
+		if (!IImage::loadFromData(src.get(), image.put())) {
+			spdlog::error("[core] 无法解码图片 '{}'", m_source_path);
+			return false;
+		}
+		m_source_levels.emplace_back(image);
+		// Same mipmap generator as the levels of the first upload, so the texture looks the same after device lost
+		while (m_mipmap) {
+			auto const size = m_source_levels.back()->getSize();
+			if (size.x <= 1 && size.y <= 1) {
+				break;
+			}
+			SmartReference<IImage> level;
+			if (!m_source_levels.back()->createMipmap(level.put())) {
+				m_source_levels.clear();
+				return false;
+			}
+			m_source_levels.emplace_back(level);
+		}
+		return true;
+	}
+	void Texture2D::releaseSourceLevels() {
+		// Decoded pixels are only needed for the upload, they are decoded again after device lost
+		if (m_decode_source) {
+			m_source_levels.clear();
+			m_source_levels.shrink_to_fit();
+		}
+	}
 }
 namespace core::Graphics::Direct3D11 {
 	bool Device::createTextureFromFile(StringView const path, bool const mipmap, ITexture2D** const pp_texture) {
@@ -307,6 +426,19 @@ namespace core::Graphics::Direct3D11 {
 		*pp_texture = buffer.detach();
 		return true;
 	}
+	bool Device::createTextureFromImage(StringView const path, IData* const source, IImage* const* const levels, uint32_t const level_count, ITexture2D** const pp_texture) {
+		*pp_texture = nullptr;
+		if (!levels || level_count == 0) {
+			return false;
+		}
+		SmartReference<Texture2D> buffer;
+		buffer.attach(new Texture2D);
+		if (!buffer->initialize(this, path, source, levels, level_count)) {
+			return false;
+		}
+		*pp_texture = buffer.detach();
+		return true;
+	}
 	bool Device::createTexture(Vector2U const size, ITexture2D** const pp_texture) {
 		*pp_texture = nullptr;
 		SmartReference<Texture2D> buffer;
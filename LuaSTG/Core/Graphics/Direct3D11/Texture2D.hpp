@@ -48,14 +48,19 @@ namespace core::Graphics::Direct3D11 {
 
 		bool initialize(Device* device, StringView path, bool mipmap);
 		bool initialize(Device* device, IData* data, bool mipmap);
+		bool initialize(Device* device, StringView path, IData* source, IImage* const* levels, uint32_t level_count);
 		bool initialize(Device* device, Vector2U size, bool is_render_target);
 		bool createResource();
 
 	private:
+		bool decodeSourceLevels();
+		void releaseSourceLevels();
+
 		SmartReference<Device> m_device;
 		SmartReference<ISamplerState> m_sampler;
 		SmartReference<IData> m_data;
 		SmartReference<IData> m_source_data;
+		std::vector<SmartReference<IImage>> m_source_levels;
 		std::string m_source_path;
 		Microsoft::WRL::ComPtr<ID3D11Texture2D> m_texture;
 		Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> m_view;
@@ -64,6 +69,7 @@ namespace core::Graphics::Direct3D11 {
 		bool m_pre_mul_alpha{ false };
 		bool m_mipmap{ false };
 		bool m_is_render_target{ false };
+		bool m_decode_source{ false }; // levels are decoded from the source on the CPU, again after device lost
 		bool m_initialized{ false };
 	};
 }
@@ -37,6 +37,18 @@ namespace core::Graphics
 		virtual bool flush() = 0;
 
 		virtual bool getGlyph(uint32_t codepoint, GlyphInfo* p_ref_info, bool no_render) = 0;
+		// 在后台线程光栅化还没有缓存的字形，完成后由之后的调用写入纹理，不会阻塞
+		// 结果出来之前就要用到的字形仍然会当场光栅化
+		virtual void prefetchString(StringView str) = 0;
+
+		// 每帧调用一次，整理纹理时不能有引用字形纹理的绘制还在排队
+		// 纹理数量超过 max_texture_count 时淘汰最久未使用的字形并整理纹理，之前取得的 GlyphInfo 全部失效
+		// 真正要整理纹理之前会先调用 before_compact（可以为空），调用者可以在这里等待排队的绘制完成
+		virtual void collect(uint32_t max_texture_count, void (*before_compact)(void* userdata), void* userdata) = 0;
+		// collect 重新排列了字形纹理后改变，缓存了 GlyphInfo 的对象据此判断是否需要重建
+		virtual uint64_t getVersion() = 0;
+		// collect 的调用次数，即当前帧序号
+		virtual uint64_t getFrame() = 0;
 
 		static bool create(IDevice* p_device, TrueTypeFontInfo const* p_arr_info, size_t info_count, IGlyphManager** output);
 	};
@@ -65,6 +77,26 @@ namespace core::Graphics
 
 		static bool create(IRenderer* p_renderer, ITextRenderer** output);
 	};
+
+	// 排版结果保留下来的文本，文本、字体、缩放不变时，绘制只是复制顶点
+	struct ITextLayout : public IReferenceCounted
+	{
+		virtual void setText(StringView str) = 0;
+		virtual StringView getText() = 0;
+		virtual void setGlyphManager(IGlyphManager* p_mgr) = 0;
+		virtual IGlyphManager* getGlyphManager() = 0;
+		virtual void setScale(Vector2F const& scale) = 0;
+		virtual Vector2F getScale() = 0;
+
+		// 精确包围盒，以起点为原点，y 轴朝上（受到 setScale 影响）
+		virtual RectF getBoundary() = 0;
+		// 绘制后笔触的前进量（受到 setScale 影响）
+		virtual Vector2F getAdvance() = 0;
+		// 绘制文字，y 轴朝上，和 ITextRenderer::drawText 的结果一致
+		virtual bool draw(IRenderer* p_renderer, Vector2F const& start, float z, Color4B color) = 0;
+
+		static bool create(ITextLayout** output);
+	};
 }
 
 namespace core {
@@ -77,4 +109,9 @@ namespace core {
 	// ns:URL
 	// https://www.luastg-sub.com/core.ITextRenderer
 	template<> constexpr InterfaceId getInterfaceId<Graphics::ITextRenderer>() { return UUID::parse("23c381e5-4769-5caf-9623-5f050c0f9aba"); }
+
+	// UUID v5
+	// ns:URL
+	// https://www.luastg-sub.com/core.ITextLayout
+	template<> constexpr InterfaceId getInterfaceId<Graphics::ITextLayout>() { return UUID::parse("4c5e5524-815f-5632-915d-0e14df3dfce3"); }
 }
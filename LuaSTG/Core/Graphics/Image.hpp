@@ -2,17 +2,26 @@
 #include "core/ReferenceCounted.hpp"
 #include "core/Vector2.hpp"
 #include "core/Color.hpp"
+#include "core/Data.hpp"
 
 namespace core {
 	struct CORE_NO_VIRTUAL_TABLE IImage : IReferenceCounted {
 		[[nodiscard]] virtual Vector2U getSize() const noexcept = 0;
 		[[nodiscard]] virtual Color4B getPixel(Vector2U position) const noexcept = 0;
 		virtual void setPixel(Vector2U position, Color4B color) noexcept = 0;
+		// Straight alpha BGRA pixels, row by row, getSize().x pixels per row
+		[[nodiscard]] virtual Color4B const* getPixelData() const noexcept = 0;
 		[[nodiscard]] virtual bool clone(IImage** output_image) const = 0;
+		// Next mipmap level, half the size (at least 1x1), color is weighted by alpha
+		// so fully transparent pixels don't darken the edges of the smaller levels
+		[[nodiscard]] virtual bool createMipmap(IImage** output_image) const = 0;
 		[[nodiscard]] virtual bool saveToFile(std::string_view path) const = 0;
 
 		[[nodiscard]] static bool create(Vector2U size, IImage** output_image);
 		[[nodiscard]] static bool loadFromFile(std::string_view path, IImage** output_image);
+		// Decodes QOI or any format of the Windows Imaging Component (PNG, JPEG, BMP, GIF, TIFF...),
+		// does not need the graphics device and can be called from any thread
+		[[nodiscard]] static bool loadFromData(IData* data, IImage** output_image);
 	};
 
 	// UUID v5
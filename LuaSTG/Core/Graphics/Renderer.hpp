@@ -177,6 +177,13 @@ namespace core::Graphics
 
 		static bool create(IDevice* p_device, IRenderer** pp_renderer);
 	};
+
+	// 录制渲染器：渲染调用不会立即提交到设备，而是录制下来，稍后在渲染线程回放
+	struct IRenderCommandRecorder : public IReferenceCounted
+	{
+		// 立即在当前线程提交已经录制的渲染命令，返回的渲染器可以直接访问设备，直到下一次录制渲染命令
+		virtual IRenderer* synchronize() = 0;
+	};
 }
 
 namespace core {
@@ -194,4 +201,26 @@ namespace core {
 	// ns:URL
 	// https://www.luastg-sub.com/core.IRenderer
 	template<> constexpr InterfaceId getInterfaceId<Graphics::IRenderer>() { return UUID::parse("0ebdb9dc-847f-5827-bf0a-a902494b84bc"); }
+
+	// UUID v5
+	// ns:URL
+	// https://www.luastg-sub.com/core.IRenderCommandRecorder
+	template<> constexpr InterfaceId getInterfaceId<Graphics::IRenderCommandRecorder>() { return UUID::parse("84a4445f-54e8-5037-8452-b8dc8bd05978"); }
+}
+
+namespace core::Graphics
+{
+	// 需要直接访问设备上下文的代码（例如 ImGui、网格渲染器）应该通过这个方法获取渲染器
+	// 如果渲染器正在录制命令，会先提交已经录制的命令
+	inline IRenderer* getImmediateRenderer(IRenderer* const renderer)
+	{
+		IRenderCommandRecorder* recorder{};
+		if (renderer == nullptr || !renderer->queryInterface(&recorder))
+		{
+			return renderer;
+		}
+		auto const immediate_renderer = recorder->synchronize();
+		recorder->release();
+		return immediate_renderer;
+	}
 }
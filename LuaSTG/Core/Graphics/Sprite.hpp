@@ -4,6 +4,17 @@
 
 namespace core::Graphics
 {
+	// 批量绘制的单个实例
+	struct SpriteInstance
+	{
+		float x;
+		float y;
+		float rotation; // 弧度
+		float hscale;
+		float vscale;
+		uint32_t color; // 替代精灵的四个顶点颜色
+	};
+
 	struct ISprite : IReferenceCounted
 	{
 		virtual ITexture2D* getTexture() = 0;
@@ -33,6 +44,9 @@ namespace core::Graphics
 		/* TODO: remove */ virtual void draw(Vector2F const& pos, Vector2F const& scale) = 0;
 		/* TODO: remove */ virtual void draw(Vector2F const& pos, Vector2F const& scale, float rotation) = 0;
 
+		// 一次提交多个实例，和逐个调用 draw(pos, scale, rotation) 的结果相同
+		virtual bool drawInstances(SpriteInstance const* instances, size_t count) = 0;
+
 		virtual bool clone(ISprite** pp_sprite) = 0;
 
 		static bool create(IRenderer* p_renderer, ITexture2D* p_texture, ISprite** pp_sprite);
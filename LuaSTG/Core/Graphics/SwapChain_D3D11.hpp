@@ -163,6 +163,7 @@ namespace core::Graphics
 		void setVSync(bool enable);
 		inline bool getVSync() { return m_swap_chain_vsync; }
 		bool present();
+		inline IDXGISwapChain1* GetDXGISwapChain1() { return dxgi_swapchain.Get(); }
 
 		bool saveSnapshotToFile(StringView path);
 
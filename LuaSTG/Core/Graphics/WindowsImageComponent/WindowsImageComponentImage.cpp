@@ -1,10 +1,104 @@
 #include "core/Graphics/Common/MemoryImage.hpp"
+#include "core/FileSystem.hpp"
+#include "core/SmartReference.hpp"
+#include "qoi.h"
+
+namespace {
+	constexpr uint32_t max_image_size{ 16384 }; // D3D11_REQ_TEXTURE2D_U_OR_V_DIMENSION
+
+	class ScopeCoInitialize {
+	public:
+		ScopeCoInitialize() : m_result(CoInitializeEx(nullptr, COINIT_MULTITHREADED)) {}
+		~ScopeCoInitialize() { if (SUCCEEDED(m_result)) CoUninitialize(); }
+
+		// RPC_E_CHANGED_MODE: already initialized as STA by someone else, still usable
+		[[nodiscard]] explicit operator bool() const noexcept { return SUCCEEDED(m_result) || m_result == RPC_E_CHANGED_MODE; }
+
+	private:
+		HRESULT m_result{};
+	};
+
+	bool isQoi(core::IData* const data) {
+		return data->size() >= 4 && std::memcmp(data->data(), "qoif", 4) == 0;
+	}
+}
 
 namespace core {
 	bool Image::saveToFile(std::string_view const path) const {
 		return false;
 	}
 	bool Image::loadFromFile(std::string_view const path) {
-		return false;
+		SmartReference<IData> data;
+		if (!FileSystemManager::readFile(path, data.put())) {
+			return false;
+		}
+		return loadFromData(data.get());
+	}
+	bool Image::loadFromData(IData* const data) {
+		if (data == nullptr || data->size() == 0 || data->size() > UINT32_MAX) {
+			return false;
+		}
+
+		if (isQoi(data)) {
+			qoi_desc desc{};
+			auto const pixels = static_cast<uint8_t*>(qoi_decode(data->data(), static_cast<int>(data->size()), &desc, 4));
+			if (pixels == nullptr) {
+				return false;
+			}
+			bool result = false;
+			if (desc.width > 0 && desc.width <= max_image_size && desc.height > 0 && desc.height <= max_image_size
+				&& setSize(Vector2U(desc.width, desc.height))) {
+				for (size_t i = 0; i < m_pixels.size(); i += 1) {
+					auto const rgba = pixels + i * 4;
+					m_pixels[i] = Color4B(rgba[0], rgba[1], rgba[2], rgba[3]);
+				}
+				result = true;
+			}
+			std::free(pixels);
+			return result;
+		}
+
+		// Worker threads may not have initialized COM yet
+		thread_local ScopeCoInitialize const init;
+		if (!init) {
+			return false;
+		}
+		thread_local Microsoft::WRL::ComPtr<IWICImagingFactory> factory;
+		if (!factory && FAILED(CoCreateInstance(CLSID_WICImagingFactory, nullptr, CLSCTX_INPROC_SERVER, IID_PPV_ARGS(&factory)))) {
+			return false;
+		}
+
+		Microsoft::WRL::ComPtr<IWICStream> stream;
+		if (FAILED(factory->CreateStream(&stream))) {
+			return false;
+		}
+		if (FAILED(stream->InitializeFromMemory(static_cast<BYTE*>(data->data()), static_cast<DWORD>(data->size())))) {
+			return false;
+		}
+		Microsoft::WRL::ComPtr<IWICBitmapDecoder> decoder;
+		if (FAILED(factory->CreateDecoderFromStream(stream.Get(), nullptr, WICDecodeMetadataCacheOnDemand, &decoder))) {
+			return false; // not an image format WIC knows, DDS for example
+		}
+		Microsoft::WRL::ComPtr<IWICBitmapFrameDecode> frame;
+		if (FAILED(decoder->GetFrame(0, &frame))) {
+			return false;
+		}
+		UINT width{}, height{};
+		if (FAILED(frame->GetSize(&width, &height))
+			|| width == 0 || width > max_image_size || height == 0 || height > max_image_size) {
+			return false;
+		}
+		Microsoft::WRL::ComPtr<IWICBitmapSource> source;
+		if (FAILED(WICConvertBitmapSource(GUID_WICPixelFormat32bppBGRA, frame.Get(), &source))) {
+			return false;
+		}
+		if (!setSize(Vector2U(width, height))) {
+			return false;
+		}
+		UINT const stride = width * sizeof(Color4B);
+		if (FAILED(source->CopyPixels(nullptr, stride, stride * height, reinterpret_cast<BYTE*>(m_pixels.data())))) {
+			return false;
+		}
+		return true;
 	}
 }
@@ -0,0 +1,211 @@
+#include <chrono>
+#include <functional>
+#include "Core/FramePacer.hpp"
+#include "gtest/gtest.h"
+
+using std::chrono_literals::operator ""ms;
+using std::chrono_literals::operator ""us;
+using std::chrono_literals::operator ""ns;
+
+namespace {
+	using Duration = core::FramePacer::Duration;
+
+	// Time only moves when the pacer sleeps or spins, or when the test simulates work
+	class VirtualClock final : public core::IFramePacerClock {
+	public:
+		std::chrono::nanoseconds now() override { return m_now; }
+		void sleep(std::chrono::nanoseconds const duration) override {
+			m_sleep_count += 1;
+			m_now += duration + (sleep_error ? sleep_error(m_sleep_count) : Duration::zero());
+		}
+		void relax() override {
+			m_relax_count += 1;
+			m_now += relax_step;
+		}
+
+		void advance(Duration const duration) { m_now += duration; }
+		[[nodiscard]] uint64_t getSleepCount() const noexcept { return m_sleep_count; }
+		[[nodiscard]] uint64_t getRelaxCount() const noexcept { return m_relax_count; }
+
+		// How much later than requested the n-th sleep wakes up
+		std::function<Duration(uint64_t)> sleep_error;
+		Duration relax_step{ 1us };
+
+	private:
+		Duration m_now{ 1000ms };
+		uint64_t m_sleep_count{};
+		uint64_t m_relax_count{};
+	};
+
+	constexpr Duration interval{ 10ms };
+}
+
+TEST(FramePacer, wait_keeps_frame_interval) {
+	VirtualClock clock;
+	clock.sleep_error = [](uint64_t) { return 300us; };
+	core::FramePacer pacer(&clock);
+	pacer.setFrameInterval(interval);
+	pacer.wait();
+	auto const begin = clock.now();
+	for (int i = 1; i <= 100; i += 1) {
+		clock.advance(3ms); // work
+		auto const delta = pacer.wait();
+		EXPECT_GE(delta, interval);
+		EXPECT_LT(delta, interval + clock.relax_step);
+		EXPECT_GE(clock.now(), begin + interval * i);
+		EXPECT_LT(clock.now(), begin + interval * i + clock.relax_step);
+		EXPECT_LT(pacer.getLastOvershoot(), clock.relax_step);
+	}
+	EXPECT_EQ(pacer.getDroppedFrames(), 0u);
+}
+
+TEST(FramePacer, margin_adapts_to_constant_sleep_error) {
+	VirtualClock clock;
+	clock.sleep_error = [](uint64_t) { return 500us; };
+	core::FramePacer pacer(&clock);
+	pacer.setFrameInterval(interval);
+	EXPECT_EQ(pacer.getSpinMargin(), core::FramePacer::default_spin_margin);
+	for (int i = 0; i < 50; i += 1) {
+		pacer.wait();
+	}
+	// No variance, the margin is the mean error itself
+	EXPECT_EQ(pacer.getSleepErrorMean(), 500us);
+	EXPECT_EQ(pacer.getSpinMargin(), 500us);
+	// Sleeping is accurate up to the margin, so spinning only covers the sleep error
+	auto const relax_count = clock.getRelaxCount();
+	pacer.wait();
+	EXPECT_LE(clock.getRelaxCount() - relax_count, 1u);
+}
+
+TEST(FramePacer, margin_covers_three_standard_deviations) {
+	VirtualClock clock;
+	// Mean 1ms, standard deviation 200us
+	clock.sleep_error = [](uint64_t const n) { return n % 2 == 0 ? 800us : 1200us; };
+	core::FramePacer pacer(&clock);
+	pacer.setFrameInterval(interval);
+	for (int i = 0; i < 500; i += 1) {
+		pacer.wait();
+	}
+	EXPECT_NEAR(static_cast<double>(pacer.getSleepErrorMean().count()), 1e6, 20e3);
+	// The weighted variance runs a little below the true one
+	auto const margin = static_cast<double>(pacer.getSpinMargin().count());
+	EXPECT_NEAR(margin, 1e6 + 3 * 200e3, 40e3);
+	// Every frame still lands on its target, the late sleeps never overshoot
+	for (int i = 0; i < 20; i += 1) {
+		pacer.wait();
+		EXPECT_LT(pacer.getLastOvershoot(), clock.relax_step);
+	}
+}
+
+TEST(FramePacer, last_sleep_error) {
+	VirtualClock clock;
+	clock.sleep_error = [](uint64_t) { return 300us; };
+	core::FramePacer pacer(&clock);
+	pacer.setFrameInterval(interval);
+	pacer.wait();
+	// The error is measured before spinning, the overshoot after
+	EXPECT_EQ(pacer.getLastSleepError(), 300us);
+	EXPECT_LT(pacer.getLastOvershoot(), clock.relax_step);
+	// Too little time left to sleep
+	clock.advance(interval - pacer.getSpinMargin() / 2);
+	pacer.wait();
+	EXPECT_EQ(pacer.getLastSleepError(), Duration::zero());
+	// Behind, no wait at all
+	clock.advance(interval * 2);
+	pacer.wait();
+	EXPECT_EQ(pacer.getLastSleepError(), Duration::zero());
+}
+
+TEST(FramePacer, margin_is_clamped) {
+	{
+		VirtualClock clock;
+		clock.sleep_error = [](uint64_t) { return 6ms; };
+		core::FramePacer pacer(&clock);
+		pacer.setFrameInterval(interval);
+		for (int i = 0; i < 20; i += 1) {
+			pacer.wait();
+		}
+		EXPECT_EQ(pacer.getSpinMargin(), core::FramePacer::default_max_spin_margin);
+		EXPECT_EQ(pacer.getSpinMargin(), 4ms);
+	}
+	{
+		VirtualClock clock;
+		clock.sleep_error = [](uint64_t) { return 0ns; };
+		core::FramePacer pacer(&clock);
+		pacer.setFrameInterval(interval);
+		for (int i = 0; i < 20; i += 1) {
+			pacer.wait();
+		}
+		EXPECT_EQ(pacer.getSpinMargin(), core::FramePacer::default_min_spin_margin);
+		EXPECT_EQ(pacer.getSpinMargin(), 200us);
+	}
+	{
+		// Changing the range clamps the current margin right away
+		VirtualClock clock;
+		core::FramePacer pacer(&clock);
+		pacer.setSpinMarginRange(100us, 1ms);
+		EXPECT_EQ(pacer.getSpinMargin(), 1ms);
+	}
+}
+
+TEST(FramePacer, catch_up_keeps_schedule) {
+	VirtualClock clock;
+	core::FramePacer pacer(&clock);
+	pacer.setFrameInterval(interval);
+	pacer.setMaxCatchUpFrames(3);
+	pacer.wait();
+	auto const begin = clock.now();
+	// A long frame, 2 frames behind the next target
+	clock.advance(interval * 3 + interval / 2);
+	auto const sleep_count = clock.getSleepCount();
+	auto const relax_count = clock.getRelaxCount();
+	pacer.wait();
+	pacer.wait();
+	pacer.wait();
+	// The following frames run without waiting until the schedule is met again
+	EXPECT_EQ(clock.getSleepCount(), sleep_count);
+	EXPECT_EQ(clock.getRelaxCount(), relax_count);
+	EXPECT_EQ(pacer.getLastOvershoot(), Duration::zero());
+	pacer.wait();
+	EXPECT_GE(clock.now(), begin + interval * 4);
+	EXPECT_LT(clock.now(), begin + interval * 4 + clock.relax_step);
+	EXPECT_EQ(pacer.getDroppedFrames(), 0u);
+}
+
+TEST(FramePacer, drop_when_too_far_behind) {
+	VirtualClock clock;
+	core::FramePacer pacer(&clock);
+	pacer.setFrameInterval(interval);
+	pacer.setMaxCatchUpFrames(2);
+	pacer.wait();
+	clock.advance(interval * 3 + interval / 2);
+	auto const stall_end = clock.now();
+	pacer.wait();
+	EXPECT_EQ(pacer.getDroppedFrames(), 2u);
+	EXPECT_EQ(clock.now(), stall_end);
+	// The schedule starts over from the end of the stall
+	pacer.wait();
+	EXPECT_GE(clock.now(), stall_end + interval);
+	EXPECT_LT(clock.now(), stall_end + interval + clock.relax_step);
+
+	// The count accumulates
+	clock.advance(interval * 6);
+	pacer.wait();
+	EXPECT_EQ(pacer.getDroppedFrames(), 2u + 5u);
+}
+
+TEST(FramePacer, no_catch_up) {
+	VirtualClock clock;
+	core::FramePacer pacer(&clock);
+	pacer.setFrameInterval(interval);
+	pacer.setMaxCatchUpFrames(0);
+	pacer.wait();
+	// Late by less than a frame: nothing is dropped, but the schedule starts over
+	clock.advance(interval + interval / 2);
+	auto const late = clock.now();
+	pacer.wait();
+	EXPECT_EQ(pacer.getDroppedFrames(), 0u);
+	pacer.wait();
+	EXPECT_GE(clock.now(), late + interval);
+	EXPECT_LT(clock.now(), late + interval + clock.relax_step);
+}
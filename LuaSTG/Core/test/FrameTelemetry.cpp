@@ -0,0 +1,158 @@
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include "Core/FrameTelemetry.hpp"
+#include "gtest/gtest.h"
+
+using std::string_view_literals::operator ""sv;
+
+namespace {
+	core::FrameTelemetryRecord makeRecord(uint64_t const frame, double const total_time, uint32_t const missed_vblank = 0) {
+		core::FrameTelemetryRecord record;
+		record.frame = frame;
+		record.total_time = total_time;
+		record.missed_vblank = missed_vblank;
+		return record;
+	}
+
+	// 60 Hz display, QPC at 10 MHz
+	constexpr int64_t qpc_frequency{ 10000000 };
+	constexpr int64_t refresh_ticks{ qpc_frequency / 60 };
+
+	core::FramePresentStatistics makeStatistics(uint32_t const presents, uint32_t const present_refresh, uint32_t const sync_refresh) {
+		return core::FramePresentStatistics{
+			.present_count = presents,
+			.present_refresh_count = present_refresh,
+			.sync_refresh_count = sync_refresh,
+			.sync_qpc_time = static_cast<int64_t>(sync_refresh) * refresh_ticks,
+		};
+	}
+}
+
+TEST(FrameTelemetry, ring_keeps_latest_records) {
+	core::FrameTelemetry telemetry(4);
+	EXPECT_EQ(telemetry.capacity(), 4u);
+	EXPECT_EQ(telemetry.size(), 0u);
+	EXPECT_EQ(telemetry.last().frame, 0u);
+	for (uint64_t i = 1; i <= 6; i += 1) {
+		telemetry.push(makeRecord(i, 0.0));
+	}
+	EXPECT_EQ(telemetry.size(), 4u);
+	// Oldest first, the first two records were overwritten
+	for (size_t i = 0; i < telemetry.size(); i += 1) {
+		EXPECT_EQ(telemetry.at(i).frame, 3 + i);
+	}
+	EXPECT_EQ(telemetry.last().frame, 6u);
+
+	telemetry.clear();
+	EXPECT_EQ(telemetry.size(), 0u);
+	telemetry.push(makeRecord(7, 0.0));
+	EXPECT_EQ(telemetry.size(), 1u);
+	EXPECT_EQ(telemetry.at(0).frame, 7u);
+}
+
+TEST(FrameTelemetry, disabled_ignores_records) {
+	core::FrameTelemetry telemetry(4);
+	telemetry.setEnable(false);
+	telemetry.push(makeRecord(1, 0.0));
+	EXPECT_EQ(telemetry.size(), 0u);
+	telemetry.setEnable(true);
+	telemetry.push(makeRecord(2, 0.0));
+	EXPECT_EQ(telemetry.size(), 1u);
+}
+
+TEST(FrameTelemetry, nearest_rank_percentiles) {
+	core::FrameTelemetry telemetry(200);
+	// Pushed out of order, values 1..100
+	for (uint64_t i = 0; i < 100; i += 1) {
+		telemetry.push(makeRecord(i, static_cast<double>((i * 37) % 100 + 1), i % 10 == 0 ? 2 : 0));
+	}
+	auto const summary = telemetry.summarize();
+	EXPECT_EQ(summary.frame_count, 100u);
+	// Nearest rank: the ceil(p * n)-th smallest value
+	EXPECT_EQ(summary.total_time.p50, 50.0);
+	EXPECT_EQ(summary.total_time.p95, 95.0);
+	EXPECT_EQ(summary.total_time.p99, 99.0);
+	EXPECT_EQ(summary.total_time.max, 100.0);
+	EXPECT_EQ(summary.missed_vblank, 20u);
+	EXPECT_EQ(summary.missed_frame_count, 10u);
+}
+
+TEST(FrameTelemetry, summarize_latest_frames) {
+	core::FrameTelemetry telemetry(8);
+	for (uint64_t i = 1; i <= 10; i += 1) {
+		telemetry.push(makeRecord(i, static_cast<double>(i)));
+	}
+	// Records 8, 9, 10
+	auto const summary = telemetry.summarize(3);
+	EXPECT_EQ(summary.frame_count, 3u);
+	EXPECT_EQ(summary.total_time.p50, 9.0);
+	EXPECT_EQ(summary.total_time.max, 10.0);
+	// More than stored means all of them
+	EXPECT_EQ(telemetry.summarize(100).frame_count, 8u);
+	// A single value is every percentile
+	core::FrameTelemetry single(4);
+	single.push(makeRecord(1, 3.0));
+	auto const one = single.summarize();
+	EXPECT_EQ(one.total_time.p50, 3.0);
+	EXPECT_EQ(one.total_time.p99, 3.0);
+	EXPECT_EQ(core::FrameTelemetry(4).summarize().frame_count, 0u);
+}
+
+TEST(FrameTelemetry, csv) {
+	core::FrameTelemetry telemetry(2);
+	core::FrameTelemetryRecord record;
+	record.frame = 42;
+	record.total_time = 0.016;
+	record.update_time = 0.001;
+	record.render_time = 0.002;
+	record.present_time = 0.0005;
+	record.wait_time = 0.0125;
+	record.sleep_overshoot = 0.00025;
+	record.input_latency = 0.02;
+	record.missed_vblank = 1;
+	telemetry.push(makeRecord(41, 0.0));
+	telemetry.push(record);
+	auto const csv = telemetry.toCSV(1);
+	EXPECT_EQ(csv,
+		"frame,total_ms,update_ms,render_ms,present_ms,wait_ms,sleep_overshoot_ms,input_latency_ms,missed_vblank\n"
+		"42,16.0000,1.0000,2.0000,0.5000,12.5000,0.2500,20.0000,1\n"sv);
+	// Header and one line per record
+	auto const all = telemetry.toCSV();
+	EXPECT_EQ(std::count(all.begin(), all.end(), '\n'), 3);
+	EXPECT_TRUE(all.find("\n41,") != std::string::npos);
+}
+
+TEST(FrameTelemetry, missed_vblank_from_present_statistics) {
+	uint32_t missed{};
+	// Every refresh shows a new frame
+	EXPECT_TRUE(core::computeMissedVBlank(makeStatistics(10, 100, 101), makeStatistics(11, 101, 102), 1.0 / 60.0, qpc_frequency, missed));
+	EXPECT_EQ(missed, 0u);
+	// One frame stayed on screen for 3 refreshes
+	EXPECT_TRUE(core::computeMissedVBlank(makeStatistics(10, 100, 101), makeStatistics(11, 103, 104), 1.0 / 60.0, qpc_frequency, missed));
+	EXPECT_EQ(missed, 2u);
+	// No new frame displayed yet, reported once it is
+	EXPECT_TRUE(core::computeMissedVBlank(makeStatistics(10, 100, 101), makeStatistics(10, 100, 103), 1.0 / 60.0, qpc_frequency, missed));
+	EXPECT_EQ(missed, 0u);
+	// 30 FPS on the 60 Hz display, 2 refreshes per frame are expected
+	EXPECT_TRUE(core::computeMissedVBlank(makeStatistics(10, 100, 101), makeStatistics(11, 102, 103), 1.0 / 30.0, qpc_frequency, missed));
+	EXPECT_EQ(missed, 0u);
+	EXPECT_TRUE(core::computeMissedVBlank(makeStatistics(10, 100, 101), makeStatistics(11, 104, 105), 1.0 / 30.0, qpc_frequency, missed));
+	EXPECT_EQ(missed, 2u);
+	// Counters wrap around
+	auto before_wrap = makeStatistics(UINT32_MAX, UINT32_MAX, UINT32_MAX);
+	auto after_wrap = makeStatistics(0, 1, 1);
+	before_wrap.sync_qpc_time = 1000 * refresh_ticks;
+	after_wrap.sync_qpc_time = 1002 * refresh_ticks;
+	EXPECT_TRUE(core::computeMissedVBlank(before_wrap, after_wrap, 1.0 / 60.0, qpc_frequency, missed));
+	EXPECT_EQ(missed, 1u);
+}
+
+TEST(FrameTelemetry, missed_vblank_rejects_disjoint_statistics) {
+	uint32_t missed{};
+	// No refresh between the two samples
+	EXPECT_FALSE(core::computeMissedVBlank(makeStatistics(10, 100, 101), makeStatistics(10, 100, 101), 1.0 / 60.0, qpc_frequency, missed));
+	// Counters restarted, e.g. the swap chain was recreated
+	EXPECT_FALSE(core::computeMissedVBlank(makeStatistics(1000, 5000, 5001), makeStatistics(1, 3, 4), 1.0 / 60.0, qpc_frequency, missed));
+}
@@ -0,0 +1,292 @@
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Core/Graphics/Common/RenderCommandList.hpp"
+#include "core/implement/ReferenceCounted.hpp"
+#include "gtest/gtest.h"
+
+using core::Graphics::IRenderer;
+using core::Graphics::ITexture2D;
+using core::Graphics::IRenderTarget;
+using core::Graphics::IDepthStencilBuffer;
+using core::Graphics::Common::RenderCommandList;
+using DrawVertex = IRenderer::DrawVertex;
+using DrawIndex = IRenderer::DrawIndex;
+
+namespace {
+	// Counts references, so the test can check what the list holds
+	class MockTexture final : public core::implement::NoOperationReferenceCounted<ITexture2D> {
+	public:
+		int32_t retain() override { return ++m_count; }
+		int32_t release() override { return --m_count; }
+		[[nodiscard]] int32_t getCount() const noexcept { return m_count; }
+
+		void* getNativeHandle() const noexcept override { return nullptr; }
+		bool isDynamic() const noexcept override { return false; }
+		bool isPremultipliedAlpha() const noexcept override { return false; }
+		void setPremultipliedAlpha(bool) override {}
+		core::Vector2U getSize() const noexcept override { return { 1, 1 }; }
+		bool setSize(core::Vector2U) override { return false; }
+		bool uploadPixelData(core::RectU, void const*, uint32_t) override { return false; }
+		void setPixelData(core::IData*) override {}
+		bool saveToFile(core::StringView) override { return false; }
+		void setSamplerState(core::Graphics::ISamplerState*) override {}
+		core::Graphics::ISamplerState* getSamplerState() const noexcept override { return nullptr; }
+
+	private:
+		int32_t m_count{ 1 };
+	};
+
+	class MockRenderTarget final : public core::implement::NoOperationReferenceCounted<IRenderTarget> {
+	public:
+		int32_t retain() override { return ++m_count; }
+		int32_t release() override { return --m_count; }
+		[[nodiscard]] int32_t getCount() const noexcept { return m_count; }
+
+		void* getNativeHandle() const noexcept override { return nullptr; }
+		void* getNativeBitmapHandle() const noexcept override { return nullptr; }
+		bool setSize(core::Vector2U) override { return false; }
+		ITexture2D* getTexture() const noexcept override { return nullptr; }
+
+	private:
+		int32_t m_count{ 1 };
+	};
+
+	// Writes every call it receives as a line of text, draws keep their vertices and indices
+	class MockRenderer final : public core::implement::NoOperationReferenceCounted<IRenderer> {
+	public:
+		struct Draw {
+			std::vector<DrawVertex> vertex;
+			std::vector<DrawIndex> index;
+		};
+
+		std::vector<std::string> calls;
+		std::vector<Draw> draws;
+
+		bool beginBatch() override { calls.emplace_back("beginBatch"); return true; }
+		bool endBatch() override { calls.emplace_back("endBatch"); return true; }
+		bool isBatchScope() override { return false; }
+		bool flush() override { calls.emplace_back("flush"); return true; }
+
+		void clearRenderTarget(core::Color4B const&) override { calls.emplace_back("clearRenderTarget"); }
+		void clearDepthBuffer(float) override { calls.emplace_back("clearDepthBuffer"); }
+		void setRenderAttachment(IRenderTarget* p_rt, IDepthStencilBuffer*) override {
+			calls.emplace_back(p_rt ? "setRenderAttachment" : "setRenderAttachment null");
+		}
+
+		void setOrtho(core::BoxF const&) override { calls.emplace_back("setOrtho"); }
+		void setPerspective(core::Vector3F const&, core::Vector3F const&, core::Vector3F const&, float, float, float, float) override { calls.emplace_back("setPerspective"); }
+
+		core::BoxF getViewport() override { return {}; }
+		void setViewport(core::BoxF const&) override { calls.emplace_back("setViewport"); }
+		void setScissorRect(core::RectF const&) override { calls.emplace_back("setScissorRect"); }
+		void setViewportAndScissorRect() override { calls.emplace_back("setViewportAndScissorRect"); }
+
+		void setVertexColorBlendState(VertexColorBlendState) override { calls.emplace_back("setVertexColorBlendState"); }
+		void setFogState(FogState, core::Color4B const&, float, float) override { calls.emplace_back("setFogState"); }
+		void setDepthState(DepthState) override { calls.emplace_back("setDepthState"); }
+		void setBlendState(BlendState state) override { calls.emplace_back("setBlendState " + std::to_string(static_cast<int>(state))); }
+		void setTexture(ITexture2D* texture) override { calls.emplace_back("setTexture " + std::to_string(reinterpret_cast<uintptr_t>(texture))); }
+
+		bool drawTriangle(DrawVertex const& v1, DrawVertex const& v2, DrawVertex const& v3) override {
+			DrawVertex const vertex[3]{ v1, v2, v3 };
+			return drawTriangle(vertex);
+		}
+		bool drawTriangle(DrawVertex const* pvert) override {
+			calls.emplace_back("drawTriangle");
+			draws.push_back(Draw{ { pvert, pvert + 3 }, {} });
+			return true;
+		}
+		bool drawQuad(DrawVertex const& v1, DrawVertex const& v2, DrawVertex const& v3, DrawVertex const& v4) override {
+			DrawVertex const vertex[4]{ v1, v2, v3, v4 };
+			return drawQuad(vertex);
+		}
+		bool drawQuad(DrawVertex const* pvert) override {
+			calls.emplace_back("drawQuad");
+			draws.push_back(Draw{ { pvert, pvert + 4 }, {} });
+			return true;
+		}
+		bool drawRaw(DrawVertex const* pvert, uint16_t nvert, DrawIndex const* pidx, uint16_t nidx) override {
+			calls.emplace_back("drawRaw");
+			draws.push_back(Draw{ { pvert, pvert + nvert }, { pidx, pidx + nidx } });
+			return true;
+		}
+		bool drawRequest(uint16_t, uint16_t, DrawVertex**, DrawIndex**, uint16_t*) override { return false; }
+
+		bool createPostEffectShader(core::StringView, core::Graphics::IPostEffectShader**) override { return false; }
+		bool createPostEffectShaderFromSource(core::StringView, core::Graphics::IPostEffectShader**) override { return false; }
+		bool drawPostEffect(core::Graphics::IPostEffectShader*, BlendState, ITexture2D*, SamplerState, core::Vector4F const*, size_t, ITexture2D* const*, SamplerState const*, size_t) override { return false; }
+		bool drawPostEffect(core::Graphics::IPostEffectShader*, BlendState) override { return false; }
+
+		bool createModel(core::StringView, core::Graphics::IModel**) override { return false; }
+		bool drawModel(core::Graphics::IModel*) override { return false; }
+
+		core::Graphics::ISamplerState* getKnownSamplerState(SamplerState) override { return nullptr; }
+	};
+
+	DrawVertex makeVertex(float const value) {
+		return DrawVertex(value, value + 0.5f, value / 4.0f, value / 8.0f);
+	}
+
+	std::string textureCall(ITexture2D* texture) {
+		return "setTexture " + std::to_string(reinterpret_cast<uintptr_t>(texture));
+	}
+
+	bool equals(DrawVertex const& a, DrawVertex const& b) {
+		return a.x == b.x && a.y == b.y && a.z == b.z && a.u == b.u && a.v == b.v && a.color == b.color;
+	}
+}
+
+TEST(RenderCommandList, merge_quads_and_triangles) {
+	RenderCommandList list;
+	list.beginBatch();
+	for (int i = 0; i < 3; i += 1) {
+		auto const base = static_cast<float>(i * 4);
+		list.drawQuad(makeVertex(base), makeVertex(base + 1), makeVertex(base + 2), makeVertex(base + 3));
+	}
+	for (int i = 0; i < 2; i += 1) {
+		auto const base = static_cast<float>(100 + i * 3);
+		list.drawTriangle(makeVertex(base), makeVertex(base + 1), makeVertex(base + 2));
+	}
+	list.drawQuad(makeVertex(200), makeVertex(201), makeVertex(202), makeVertex(203));
+	list.endBatch();
+	// beginBatch, 3 quads, 2 triangles, 1 quad, endBatch
+	EXPECT_EQ(list.getCommandCount(), 5u);
+	EXPECT_EQ(list.getVertexCount(), 3u * 4 + 2u * 3 + 4);
+
+	MockRenderer renderer;
+	ASSERT_TRUE(list.replay(&renderer));
+	std::vector<std::string> const expected{
+		"beginBatch", "drawQuad", "drawQuad", "drawQuad", "drawTriangle", "drawTriangle", "drawQuad", "endBatch",
+	};
+	EXPECT_EQ(renderer.calls, expected);
+	ASSERT_EQ(renderer.draws.size(), 6u);
+	for (int i = 0; i < 3; i += 1) {
+		for (int j = 0; j < 4; j += 1) {
+			EXPECT_TRUE(equals(renderer.draws[i].vertex[j], makeVertex(static_cast<float>(i * 4 + j))));
+		}
+	}
+	for (int i = 0; i < 2; i += 1) {
+		for (int j = 0; j < 3; j += 1) {
+			EXPECT_TRUE(equals(renderer.draws[3 + i].vertex[j], makeVertex(static_cast<float>(100 + i * 3 + j))));
+		}
+	}
+	EXPECT_TRUE(equals(renderer.draws[5].vertex[3], makeVertex(203)));
+}
+
+TEST(RenderCommandList, state_change_breaks_merge) {
+	RenderCommandList list;
+	list.drawQuad(makeVertex(0), makeVertex(1), makeVertex(2), makeVertex(3));
+	list.setBlendState(IRenderer::BlendState::Add);
+	list.drawQuad(makeVertex(4), makeVertex(5), makeVertex(6), makeVertex(7));
+	EXPECT_EQ(list.getCommandCount(), 3u);
+
+	MockRenderer renderer;
+	ASSERT_TRUE(list.replay(&renderer));
+	std::vector<std::string> const expected{
+		"drawQuad", "setBlendState " + std::to_string(static_cast<int>(IRenderer::BlendState::Add)), "drawQuad",
+	};
+	EXPECT_EQ(renderer.calls, expected);
+}
+
+TEST(RenderCommandList, redundant_set_texture) {
+	MockTexture a;
+	MockTexture b;
+	RenderCommandList list;
+	// Only draws in between: the second setTexture is dropped and the quads merge
+	list.setTexture(&a);
+	list.drawQuad(makeVertex(0), makeVertex(1), makeVertex(2), makeVertex(3));
+	list.setTexture(&a);
+	list.drawQuad(makeVertex(4), makeVertex(5), makeVertex(6), makeVertex(7));
+	EXPECT_EQ(list.getCommandCount(), 2u);
+	// A state change in between: setTexture is recorded again, the renderer may have reset its texture
+	list.setBlendState(IRenderer::BlendState::Alpha);
+	list.setTexture(&a);
+	list.drawQuad(makeVertex(8), makeVertex(9), makeVertex(10), makeVertex(11));
+	// A different texture is always recorded
+	list.setTexture(&b);
+	list.drawQuad(makeVertex(12), makeVertex(13), makeVertex(14), makeVertex(15));
+	list.setTexture(&a);
+	EXPECT_EQ(list.getCommandCount(), 8u);
+
+	MockRenderer renderer;
+	ASSERT_TRUE(list.replay(&renderer));
+	std::vector<std::string> const expected{
+		textureCall(&a), "drawQuad", "drawQuad",
+		"setBlendState " + std::to_string(static_cast<int>(IRenderer::BlendState::Alpha)),
+		textureCall(&a), "drawQuad",
+		textureCall(&b), "drawQuad",
+		textureCall(&a),
+	};
+	EXPECT_EQ(renderer.calls, expected);
+}
+
+TEST(RenderCommandList, draw_request) {
+	RenderCommandList list;
+	// Something before it, so the indices are not at the start of the buffer
+	list.drawRaw(std::vector<DrawVertex>(3, makeVertex(7)).data(), 3, std::vector<DrawIndex>{ 0, 1, 2 }.data(), 3);
+
+	DrawVertex* vertex{};
+	DrawIndex* index{};
+	list.drawRequest(4, 6, &vertex, &index);
+	ASSERT_NE(vertex, nullptr);
+	ASSERT_NE(index, nullptr);
+	for (int i = 0; i < 4; i += 1) {
+		vertex[i] = makeVertex(static_cast<float>(i));
+	}
+	DrawIndex const quad_index[6]{ 0, 1, 2, 0, 2, 3 };
+	std::copy(std::begin(quad_index), std::end(quad_index), index);
+	EXPECT_EQ(list.getVertexCount(), 7u);
+	EXPECT_EQ(list.getIndexCount(), 9u);
+
+	MockRenderer renderer;
+	ASSERT_TRUE(list.replay(&renderer));
+	std::vector<std::string> const expected{ "drawRaw", "drawRaw" };
+	EXPECT_EQ(renderer.calls, expected);
+	ASSERT_EQ(renderer.draws.size(), 2u);
+	auto const& draw = renderer.draws[1];
+	ASSERT_EQ(draw.vertex.size(), 4u);
+	for (int i = 0; i < 4; i += 1) {
+		EXPECT_TRUE(equals(draw.vertex[i], makeVertex(static_cast<float>(i))));
+	}
+	// Indices start from 0 and are replayed as they were written
+	EXPECT_EQ(draw.index, std::vector<DrawIndex>(std::begin(quad_index), std::end(quad_index)));
+}
+
+TEST(RenderCommandList, clear_releases_references) {
+	MockTexture a;
+	MockTexture b;
+	MockRenderTarget rt;
+	{
+		RenderCommandList list;
+		list.setRenderAttachment(&rt, nullptr);
+		list.setTexture(&a);
+		list.drawQuad(makeVertex(0), makeVertex(1), makeVertex(2), makeVertex(3));
+		list.setBlendState(IRenderer::BlendState::Alpha);
+		list.setTexture(&a); // same texture, not retained again
+		list.setTexture(&b);
+		list.setTexture(&a);
+		EXPECT_EQ(rt.getCount(), 2);
+		EXPECT_EQ(a.getCount(), 3);
+		EXPECT_EQ(b.getCount(), 2);
+
+		// Replay does not change anything
+		MockRenderer renderer;
+		ASSERT_TRUE(list.replay(&renderer));
+		EXPECT_EQ(a.getCount(), 3);
+
+		list.clear();
+		EXPECT_TRUE(list.empty());
+		EXPECT_EQ(list.getVertexCount(), 0u);
+		EXPECT_EQ(rt.getCount(), 1);
+		EXPECT_EQ(a.getCount(), 1);
+		EXPECT_EQ(b.getCount(), 1);
+
+		// After clear the texture is recorded (and retained) again
+		list.setTexture(&a);
+		EXPECT_EQ(list.getCommandCount(), 1u);
+		EXPECT_EQ(a.getCount(), 2);
+	}
+	// The destructor clears too
+	EXPECT_EQ(a.getCount(), 1);
+}
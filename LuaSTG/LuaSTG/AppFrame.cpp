@@ -6,6 +6,7 @@
 #include "Debugger/ImGuiExtension.h"
 #include "DiscordRPC/DiscordRPC.hpp"
 #include "LuaBinding/LuaAppFrame.hpp"
+#include "LuaBinding/LuaScriptPrecompiler.hpp"
 #include "utf8.hpp"
 #include "core/Configuration.hpp"
 
@@ -269,6 +270,8 @@ void AppFrame::Shutdown()noexcept
 	m_GameObjectPool = nullptr;
 	spdlog::info("[luastg] Object pool Cleared");
 
+	LuaScriptPrecompiler::getInstance().stop();
+
 	if (L)
 	{
 		lua_close(L);
@@ -308,7 +311,11 @@ void AppFrame::Run()noexcept
 
 	m_pAppModel->getFrameRateController()->setTargetFPS(m_target_fps);
 	m_last_video_update_time = 0.0;
+	std::ignore = OpenStateDigest();
+	std::ignore = OpenInputJournal();
 	m_pAppModel->run();
+	CloseInputJournal();
+	CloseStateDigest();
 
 	m_pAppModel->getSwapChain()->removeEventListener(this);
 	m_pAppModel->getWindow()->removeEventListener(this);
@@ -425,6 +432,8 @@ bool AppFrame::onUpdate()
 	if (result) {
 		tracy_zone_scoped_with_name("OnUpdate-LuaCallback");
 		m_ResourceMgr.UpdateAsyncResourceLoading();
+		m_ResourceMgr.UpdateTextureAtlas();
+		m_ResourceMgr.UpdateTTFGlyphCache();
 		// Executing frame function
 		imgui::cancelSetCursor();
 		m_GameObjectPool->DebugNextFrame();
@@ -445,6 +454,7 @@ bool AppFrame::onUpdate()
 		}
 		m_last_video_update_time = video_update_time;
 		m_ResourceMgr.UpdateVideo(video_delta_time);
+		WriteStateDigest();
 	}
 
 	// check again after FrameFunc
@@ -105,6 +105,14 @@ namespace luastg {
 		void UpdateInput();
 		void ResetKeyboardInput();
 		void ResetMouseInput();
+		// 输入日志：录制或回放每帧轮询得到的键盘和鼠标状态，未配置路径时什么也不做
+		bool OpenInputJournal();
+		void UpdateInputJournal();
+		void CloseInputJournal();
+		// 回放时下一次更新将读取的帧序号，没有回放时返回 false
+		bool GetInputReplayFrame(uint64_t& frame) const noexcept;
+		// 回放跳转到第 frame 帧，和对象池快照恢复配合使用：恢复快照后跳转到拍摄快照时记下的帧序号
+		bool SeekInputReplay(uint64_t frame);
 
 		//检查按键是否按下
 		bool GetKeyState(int VKCode)noexcept;
@@ -125,6 +133,14 @@ namespace luastg {
 		bool GetMouseState_legacy(int button) noexcept;
 		bool GetMouseState(int button) noexcept;
 
+	public: // 无窗口快进模式
+
+		bool IsHeadless() { return m_pAppModel && m_pAppModel->isHeadless(); }
+		// 每帧输出一行对象池状态摘要，未配置输出路径时什么也不做
+		bool OpenStateDigest();
+		void WriteStateDigest();
+		void CloseStateDigest();
+
 	public: // 脚本调用接口，含义参见API文档
 
 		void SetTitle(const char* v) noexcept;
@@ -6,13 +6,16 @@ namespace luastg
 {
 	bool AppFrame::SetDisplayModeWindow(core::Vector2U window_size, bool vsync)
 	{
+		GetAppModel()->synchronizeRenderThread();
 		auto* window = GetAppModel()->getWindow();
 		auto* swapchain = GetAppModel()->getSwapChain();
 
 		swapchain->setVSync(vsync);
 		bool const result = swapchain->setCanvasSize(window_size);
 
-		window->setWindowMode(window_size);
+		if (!IsHeadless()) {
+			window->setWindowMode(window_size);
+		}
 
 		return result;
 	}
@@ -20,14 +23,17 @@ namespace luastg
 	// TODO: 废弃
 	bool AppFrame::SetDisplayModeExclusiveFullscreen(core::Vector2U window_size, bool vsync, core::Rational)
 	{
+		GetAppModel()->synchronizeRenderThread();
 		auto* window = GetAppModel()->getWindow();
 		auto* swapchain = GetAppModel()->getSwapChain();
 
 		swapchain->setVSync(vsync);
 		bool const result = swapchain->setCanvasSize(window_size);
 
-		window->setWindowMode(window_size);
-		window->setFullScreenMode();
+		if (!IsHeadless()) {
+			window->setWindowMode(window_size);
+			window->setFullScreenMode();
+		}
 
 		return result;
 	}
@@ -45,7 +51,10 @@ namespace luastg
 			auto const& win = core::ConfigurationLoader::getInstance().getWindow();
 			auto* p_window = m_pAppModel->getWindow();
 			p_window->setCursor(win.isCursorVisible() ? core::Graphics::WindowCursor::Arrow : core::Graphics::WindowCursor::None);
-			p_window->setWindowMode(core::Vector2U(gs.getWidth(), gs.getHeight()));
+			// 无窗口快进模式下窗口保持隐藏
+			if (!IsHeadless()) {
+				p_window->setWindowMode(core::Vector2U(gs.getWidth(), gs.getHeight()));
+			}
 		}
 		return true;
 	}
@@ -61,7 +70,7 @@ namespace luastg
 		if (!p_swapchain->setWindowMode(canvas_size)) {
 			return false;
 		}
-		if (gs.isFullscreen()) {
+		if (gs.isFullscreen() && !IsHeadless()) {
 			p_window->setFullScreenMode();
 		}
 		return true;
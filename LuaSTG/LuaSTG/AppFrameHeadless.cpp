@@ -0,0 +1,47 @@
+#include "AppFrame.h"
+#include "core/Configuration.hpp"
+#include <fstream>
+
+namespace {
+	std::ofstream g_StateDigestFile;
+	uint64_t g_StateDigestFrame{};
+}
+
+namespace luastg {
+	bool AppFrame::OpenStateDigest() {
+		auto const& simulation = core::ConfigurationLoader::getInstance().getSimulation();
+		if (!simulation.hasDigestPath()) {
+			return true;
+		}
+		std::filesystem::path path;
+		if (!core::ConfigurationLoader::resolveFilePathWithPredefinedVariables(simulation.getDigestPath(), path, true)) {
+			spdlog::error("[luastg] Invalid state digest path '{}'", simulation.getDigestPath());
+			return false;
+		}
+		g_StateDigestFile.open(path, std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!g_StateDigestFile.is_open()) {
+			spdlog::error("[luastg] Failed to open state digest file '{}'", simulation.getDigestPath());
+			return false;
+		}
+		g_StateDigestFrame = 0;
+		spdlog::info("[luastg] Writing state digest to '{}'", simulation.getDigestPath());
+		return true;
+	}
+	void AppFrame::WriteStateDigest() {
+		if (!g_StateDigestFile.is_open()) {
+			return;
+		}
+		// 一帧一行：帧序号 摘要 对象数量
+		auto const digest = m_GameObjectPool->computeStateDigest();
+		char buffer[64]{};
+		auto const result = fmt::format_to_n(buffer, std::size(buffer) - 1, "{} {:016x} {}\n", g_StateDigestFrame, digest.hash, digest.object_count);
+		g_StateDigestFile.write(buffer, result.out - buffer);
+		g_StateDigestFrame += 1;
+	}
+	void AppFrame::CloseStateDigest() {
+		if (g_StateDigestFile.is_open()) {
+			g_StateDigestFile.close();
+			spdlog::info("[luastg] State digest written, {} frames", g_StateDigestFrame);
+		}
+	}
+}
@@ -1,4 +1,6 @@
 #include "AppFrame.h"
+#include "core/Configuration.hpp"
+#include "Utility/InputJournal.hpp"
 
 #define WIN32_LEAN_AND_MEAN
 #define NOMINMAX
@@ -11,6 +13,24 @@ namespace
     Platform::Keyboard g_Keyboard;
     Platform::Keyboard::State g_KeyboardState;
 
+    // 输入日志中一帧的布局，保留字段必须清零，相同的输入才会得到相同的字节
+    struct InputJournalFrame
+    {
+        Platform::Keyboard::State Keyboard;
+        uint8_t MouseButtons;
+        uint8_t MousePositionMode;
+        uint8_t _Padding[2];
+        int32_t MouseX;
+        int32_t MouseY;
+        int32_t MouseWheel;
+    };
+    static_assert(std::is_trivially_copyable_v<InputJournalFrame>);
+
+    constexpr uint32_t g_InputJournalKeyframeInterval{ 600 };
+    luastg::InputJournalWriter g_InputRecorder;
+    luastg::InputJournalReader g_InputPlayer;
+    bool g_InputReplayDesync{ false };
+
     struct InputEventListener : public core::Graphics::IWindowEventListener {
         NativeWindowMessageResult onNativeWindowMessage(void* window, uint32_t message, uintptr_t arg1, intptr_t arg2) {
             switch (message) {
@@ -68,17 +88,176 @@ namespace luastg
     }
     void AppFrame::UpdateInput()
     {
-        g_Keyboard.GetState(g_KeyboardState, true);
-        if (Mouse)
+        if (IsHeadless())
         {
-            MouseState = Mouse->GetState();
-            Mouse->ResetScrollWheelValue();
+            // 无窗口快进模式下不读取真实的输入设备
+            g_KeyboardState.Reset();
+            ZeroMemory(&MouseState, sizeof(MouseState));
         }
         else
         {
-            ZeroMemory(&MouseState, sizeof(MouseState));
+            g_Keyboard.GetState(g_KeyboardState, true);
+            if (Mouse)
+            {
+                MouseState = Mouse->GetState();
+                Mouse->ResetScrollWheelValue();
+            }
+            else
+            {
+                ZeroMemory(&MouseState, sizeof(MouseState));
+            }
+        }
+        UpdateInputJournal();
+    }
+
+    static InputJournalFrame SaveInputJournalFrame()
+    {
+        InputJournalFrame frame{};
+        frame.Keyboard = g_KeyboardState;
+        ZeroMemory(frame.Keyboard._Padding, sizeof(frame.Keyboard._Padding));
+        frame.MouseButtons = static_cast<uint8_t>(
+            (MouseState.leftButton ? 0x01 : 0)
+            | (MouseState.middleButton ? 0x02 : 0)
+            | (MouseState.rightButton ? 0x04 : 0)
+            | (MouseState.xButton1 ? 0x08 : 0)
+            | (MouseState.xButton2 ? 0x10 : 0));
+        frame.MousePositionMode = static_cast<uint8_t>(MouseState.positionMode);
+        frame.MouseX = MouseState.x;
+        frame.MouseY = MouseState.y;
+        frame.MouseWheel = MouseState.scrollWheelValue;
+        return frame;
+    }
+    static void LoadInputJournalFrame(InputJournalFrame const& frame)
+    {
+        g_KeyboardState = frame.Keyboard;
+        ZeroMemory(&MouseState, sizeof(MouseState));
+        MouseState.leftButton = (frame.MouseButtons & 0x01) != 0;
+        MouseState.middleButton = (frame.MouseButtons & 0x02) != 0;
+        MouseState.rightButton = (frame.MouseButtons & 0x04) != 0;
+        MouseState.xButton1 = (frame.MouseButtons & 0x08) != 0;
+        MouseState.xButton2 = (frame.MouseButtons & 0x10) != 0;
+        MouseState.positionMode = static_cast<DirectX::Mouse::Mode>(frame.MousePositionMode);
+        MouseState.x = frame.MouseX;
+        MouseState.y = frame.MouseY;
+        MouseState.scrollWheelValue = frame.MouseWheel;
+    }
+
+    bool AppFrame::OpenInputJournal()
+    {
+        auto const& simulation = core::ConfigurationLoader::getInstance().getSimulation();
+        if (simulation.hasInputReplayPath())
+        {
+            std::filesystem::path path;
+            if (!core::ConfigurationLoader::resolveFilePathWithPredefinedVariables(simulation.getInputReplayPath(), path))
+            {
+                spdlog::error("[luastg] Invalid input replay path '{}'", simulation.getInputReplayPath());
+                return false;
+            }
+            if (!g_InputPlayer.open(path) || g_InputPlayer.getFrameSize() != sizeof(InputJournalFrame))
+            {
+                g_InputPlayer.close();
+                spdlog::error("[luastg] Failed to open input journal '{}'", simulation.getInputReplayPath());
+                return false;
+            }
+            g_InputReplayDesync = false;
+            spdlog::info("[luastg] Replaying input journal '{}', {} frames, {} keyframes",
+                simulation.getInputReplayPath(), g_InputPlayer.getFrameCount(), g_InputPlayer.getKeyframes().size());
         }
+        if (simulation.hasInputRecordPath())
+        {
+            // 可以和回放同时使用，此时记录的是回放出来的输入
+            std::filesystem::path path;
+            if (!core::ConfigurationLoader::resolveFilePathWithPredefinedVariables(simulation.getInputRecordPath(), path, true))
+            {
+                spdlog::error("[luastg] Invalid input record path '{}'", simulation.getInputRecordPath());
+                return false;
+            }
+            if (!g_InputRecorder.open(path, sizeof(InputJournalFrame), g_InputJournalKeyframeInterval))
+            {
+                spdlog::error("[luastg] Failed to open input journal '{}'", simulation.getInputRecordPath());
+                return false;
+            }
+            spdlog::info("[luastg] Recording input journal to '{}'", simulation.getInputRecordPath());
+        }
+        return true;
     }
+    void AppFrame::UpdateInputJournal()
+    {
+        if (g_InputPlayer.isOpen())
+        {
+            InputJournalFrame frame{};
+            InputJournalReader::Keyframe const* keyframe{};
+            if (g_InputPlayer.read(std::span(reinterpret_cast<uint8_t*>(&frame), sizeof(frame)), &keyframe))
+            {
+                // 关键帧记录了录制时这一帧开始前的对象池状态摘要
+                if (keyframe && !g_InputReplayDesync)
+                {
+                    auto const digest = m_GameObjectPool->computeStateDigest();
+                    if (digest.hash != keyframe->state_hash)
+                    {
+                        g_InputReplayDesync = true;
+                        spdlog::error("[luastg] Input replay desynchronized at frame {}, state digest {:016x}, expected {:016x}",
+                            keyframe->frame, digest.hash, keyframe->state_hash);
+                    }
+                }
+                LoadInputJournalFrame(frame);
+            }
+            else
+            {
+                spdlog::info("[luastg] Input replay finished, {} frames", g_InputPlayer.getFrameCount());
+                g_InputPlayer.close();
+                if (IsHeadless())
+                {
+                    m_pAppModel->requestExit();
+                }
+            }
+        }
+        if (g_InputRecorder.isOpen())
+        {
+            auto const frame = SaveInputJournalFrame();
+            // 摘要只在关键帧上需要，其他帧不计算
+            uint64_t const state_hash = g_InputRecorder.isNextKeyframe() ? m_GameObjectPool->computeStateDigest().hash : 0;
+            if (!g_InputRecorder.write(std::span(reinterpret_cast<uint8_t const*>(&frame), sizeof(frame)), state_hash))
+            {
+                spdlog::error("[luastg] Failed to write input journal, recording stopped");
+                g_InputRecorder.close();
+            }
+        }
+    }
+    bool AppFrame::GetInputReplayFrame(uint64_t& frame) const noexcept
+    {
+        if (!g_InputPlayer.isOpen())
+        {
+            return false;
+        }
+        frame = g_InputPlayer.getFrameIndex();
+        return true;
+    }
+    bool AppFrame::SeekInputReplay(uint64_t const frame)
+    {
+        if (!g_InputPlayer.isOpen())
+        {
+            return false;
+        }
+        if (!g_InputPlayer.seek(frame))
+        {
+            spdlog::error("[luastg] Failed to seek input replay to frame {}, {} frames in total", frame, g_InputPlayer.getFrameCount());
+            return false;
+        }
+        // 世界状态已经由脚本恢复，之后的关键帧重新检查
+        g_InputReplayDesync = false;
+        return true;
+    }
+    void AppFrame::CloseInputJournal()
+    {
+        if (g_InputRecorder.isOpen())
+        {
+            spdlog::info("[luastg] Input journal written, {} frames", g_InputRecorder.getFrameCount());
+            g_InputRecorder.close();
+        }
+        g_InputPlayer.close();
+    }
+
     void AppFrame::ResetKeyboardInput()
     {
         g_KeyboardState.Reset();
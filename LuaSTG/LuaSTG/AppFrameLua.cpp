@@ -2,6 +2,7 @@
 #include "GameResource/ResourcePassword.hpp"
 #include "LuaBinding/LuaAppFrame.hpp"
 #include "LuaBinding/LuaCustomLoader.hpp"
+#include "LuaBinding/LuaScriptPrecompiler.hpp"
 #include "LuaBinding/LuaWrapper.hpp"
 extern "C" {
 #include "lua_cjson.h"
@@ -23,6 +24,7 @@ extern "C" {
 
 #include "core/Logger.hpp"
 #include "core/CommandLineArguments.hpp"
+#include "core/Configuration.hpp"
 #include "core/FileSystem.hpp"
 #include "utf8.hpp"
 #include "lua/plus.hpp"
@@ -304,7 +306,9 @@ namespace luastg
 			luaL_error(SL, "can't load file '%s'", path);
 			return;
 		}
-		if (0 != luaL_loadbuffer(SL, (char const*)src->data(), src->size(), luaL_checkstring(SL, 1)))
+		char const* const chunk_name = luaL_checkstring(SL, 1);
+		if (!LuaScriptPrecompiler::getInstance().load(SL, chunk_name, src.get())
+			&& 0 != luaL_loadbuffer(SL, (char const*)src->data(), src->size(), chunk_name))
 		{
 			const char* tDetail = lua_tostring(SL, -1);
 			spdlog::error("[luajit] Failed to compile '{}': {}", path, tDetail);
@@ -320,6 +324,11 @@ namespace luastg
 		// Mounting file system
 		core::FileSystemManager::addFileSystem("luastg", IEmbeddedFileSystem::getInstance());
 
+		// Compiling scripts of mounted file systems in background
+		if (auto const& script_config = core::ConfigurationLoader::getInstance().getScript(); script_config.isPrecompile()) {
+			LuaScriptPrecompiler::getInstance().start(script_config.getPrecompileWorkerCount());
+		}
+
 		// Loading Lua virtual machine
 		spdlog::info("[luajit] {}", LUAJIT_VERSION);
 		L = luaL_newstate();
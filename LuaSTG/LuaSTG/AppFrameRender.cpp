@@ -21,6 +21,7 @@ namespace luastg {
 	}
 
 	void AppFrame::SnapShot(const char* path) noexcept {
+		GetAppModel()->synchronizeRenderThread();
 		if (!GetAppModel()->getSwapChain()->saveSnapshotToFile(path)) {
 			spdlog::error("[luastg] SnapShot: 保存截图到文件'{}'失败", path);
 			return;
@@ -32,6 +33,7 @@ namespace luastg {
 			spdlog::error("[luastg] SaveTexture: 找不到纹理资源'{}'", tex_name);
 			return;
 		}
+		GetAppModel()->synchronizeRenderThread();
 		if (!resTex->GetTexture()->saveToFile(path)) {
 			spdlog::error("[luastg] SaveTexture: 保存纹理'{}'到文件'{}'失败", tex_name, path);
 			return;
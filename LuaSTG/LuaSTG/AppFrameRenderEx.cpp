@@ -1,11 +1,23 @@
 #include "AppFrame.h"
 
+namespace
+{
+    // 流水线渲染时，要等渲染线程回放到这里才能设置交换链的渲染目标
+    void applySwapChainRenderAttachment(core::IApplicationModel* const model)
+    {
+        model->executeOnRenderThread([](void* const userdata, core::Graphics::IRenderer*)
+        {
+            static_cast<core::Graphics::ISwapChain*>(userdata)->applyRenderAttachment();
+        }, model->getSwapChain());
+    }
+}
+
 namespace luastg
 {
     bool AppFrame::BeginRenderTargetStack()
     {
         m_stRenderTargetStack.clear();
-        GetAppModel()->getSwapChain()->applyRenderAttachment();
+        applySwapChainRenderAttachment(GetAppModel());
         return true;
     }
     bool AppFrame::EndRenderTargetStack()
@@ -15,7 +27,7 @@ namespace luastg
         {
             spdlog::error("[luastg] 渲染结束时 RenderTarget 栈不为空，可能缺少对 lstg.PopRenderTarget 的调用");
             m_stRenderTargetStack.clear();
-            GetAppModel()->getSwapChain()->applyRenderAttachment();
+            applySwapChainRenderAttachment(GetAppModel());
         }
         return true;
     }
@@ -67,7 +79,7 @@ namespace luastg
         }
         else
         {
-            GetAppModel()->getSwapChain()->applyRenderAttachment();
+            applySwapChainRenderAttachment(GetAppModel());
         }
 
         return true;
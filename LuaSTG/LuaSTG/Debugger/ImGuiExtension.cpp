@@ -573,12 +573,43 @@ namespace {
 
 						ImPlot::PlotLine("Render", arr_gpu_render_time.data(), (int)record_range);
 
-						plotInfLinesStyled("##Current Time", &arr_index, 1, ImPlotInfLinesFlags_None, ImVec4(0.2f, 0.2f, 0.2f, 1.0f));
+						plotInfLinesStyled("##Current Time", &arr_index, 1, ImPlotInfLinesFlags_None, ImVec4(0.2f, 0.2f, 0.2f, 1.0f));
 
 						ImPlot::EndPlot();
 					}
 				}
 
+				// frame pacing
+
+				if (ImGui::CollapsingHeader("Frame Pacing")) {
+					auto* telemetry = LAPP.GetAppModel()->getFrameTelemetry();
+					auto const summary = telemetry->summarize();
+
+					ImGui::Text("Frames : %zu / %zu", telemetry->size(), telemetry->capacity());
+					ImGui::Text("Missed VBlank: %llu (%zu frames)", (unsigned long long)summary.missed_vblank, summary.missed_frame_count);
+					auto const show_percentile = [](char const* name, core::FrameTelemetryPercentile const& value) {
+						ImGui::Text("%-16s p50 %7.3fms  p95 %7.3fms  p99 %7.3fms  max %7.3fms", name,
+							value.p50 * 1000.0, value.p95 * 1000.0, value.p99 * 1000.0, value.max * 1000.0);
+					};
+					show_percentile("Total", summary.total_time);
+					show_percentile("Update", summary.update_time);
+					show_percentile("Render", summary.render_time);
+					show_percentile("Present", summary.present_time);
+					show_percentile("Wait", summary.wait_time);
+					show_percentile("Sleep Overshoot", summary.sleep_overshoot);
+					show_percentile("Input Latency", summary.input_latency);
+
+					static char csv_path[256] = "frame_telemetry.csv";
+					ImGui::InputText("CSV Path", csv_path, std::size(csv_path));
+					if (ImGui::Button("Export CSV")) {
+						std::ignore = telemetry->writeCSV(utf8::to_wstring(csv_path));
+					}
+					ImGui::SameLine();
+					if (ImGui::Button("Clear##Frame Pacing")) {
+						telemetry->clear();
+					}
+				}
+
 				// memory
 
 				if (ImGui::CollapsingHeader("Memory Usage")) {
@@ -1002,9 +1033,11 @@ namespace imgui {
 	}
 	void drawEngine() {
 		if (g_imgui_initialized && g_imgui_impl_dx11_initialized) {
-			LAPP.GetAppModel()->getRenderer()->endBatch();
+			// ImGui 直接使用设备上下文，流水线渲染时需要先提交已经录制的命令
+			auto const renderer = core::Graphics::getImmediateRenderer(LAPP.GetAppModel()->getRenderer());
+			renderer->endBatch();
 			ImGui_ImplDX11_RenderDrawData(ImGui::GetDrawData());
-			LAPP.GetAppModel()->getRenderer()->beginBatch(); // restore
+			renderer->beginBatch(); // restore
 		}
 	}
 
@@ -1,18 +1,24 @@
 #include "luastg_config_generated.h"
 #include "Debugger/Logger.hpp"
+#include <exception>
+#include <tuple>
 #include "spdlog/spdlog.h"
 #include "spdlog/sinks/basic_file_sink.h"
 #include "spdlog/sinks/wincolor_sink.h"
 #include "spdlog/sinks/msvc_sink.h"
 #include "Platform/HResultChecker.hpp"
 #include "core/Configuration.hpp"
+#include "core/spdlog/AsyncLogSink.hpp"
 #include "utf8.hpp"
 #include "win32/base.hpp"
 
 namespace {
 	std::filesystem::path rolling_file_root;
+	std::shared_ptr<core::AsyncLogSink> async_sink;
 	bool openWin32Console();
 	void closeWin32Console();
+	void installCrashHandler();
+	void uninstallCrashHandler();
 	std::string generateRollingFileName() {
 	#if (defined LUASTG_COMPATIBILITY_MODE_WINDOWS7_SP1) || (defined LUASTG_COMPATIBILITY_MODE_WINDOWS10_PRE_1809)
 		std::time_t const t{ std::time(nullptr) };
@@ -66,6 +72,14 @@ namespace {
 			return (spdlog::level::critical);
 		}
 	}
+	core::AsyncLogSink::OverflowPolicy mapOverflowPolicy(core::ConfigurationLoader::Logging::Async::OverflowPolicy const policy) {
+		switch (policy) {
+		default:  // NOLINT(clang-diagnostic-covered-switch-default)
+			return (core::AsyncLogSink::OverflowPolicy::block);
+		case core::ConfigurationLoader::Logging::Async::OverflowPolicy::drop:
+			return (core::AsyncLogSink::OverflowPolicy::drop);
+		}
+	}
 	void writeMessage(std::string_view const message) {
 		spdlog::error("[luastg] {}", message);
 	}
@@ -128,12 +142,26 @@ namespace luastg {
 			sinks.emplace_back(sink);
 		}
 
-		auto const logger = std::make_shared<spdlog::logger>("luastg", sinks.begin(), sinks.end());
+		std::shared_ptr<spdlog::logger> logger;
+		if (auto const& logging_async = config.getAsync(); logging_async.isEnable()) {
+			// 由后台线程写入和刷新，调用者只复制消息，刷新策略由 AsyncLogSink 决定
+			async_sink = std::make_shared<core::AsyncLogSink>(
+				std::move(sinks),
+				logging_async.getQueueSize(),
+				mapOverflowPolicy(logging_async.getOverflowPolicy()),
+				std::chrono::milliseconds(logging_async.getFlushInterval())
+			);
+			logger = std::make_shared<spdlog::logger>("luastg", async_sink);
+			installCrashHandler();
+		}
+		else {
+			logger = std::make_shared<spdlog::logger>("luastg", sinks.begin(), sinks.end());
+			logger->flush_on(spdlog::level::info);
+		}
 		logger->set_level(spdlog::level::trace);
 		//logger->set_pattern("[%Y-%m-%d %H:%M:%S] [%L] %v");
 		//logger->set_pattern("%^[%Y-%m-%d %H:%M:%S] [%L]%$ %v");
 		//logger->set_pattern("%^[%Y-%m-%d %H:%M:%S] [%L] [%n]%$ %v");
-		logger->flush_on(spdlog::level::info);
 
 		spdlog::set_default_logger(logger);
 
@@ -149,6 +177,12 @@ namespace luastg {
 
 		Platform::HResultChecker::SetPrintCallback();
 
+		if (async_sink) {
+			uninstallCrashHandler();
+			async_sink->shutdown();
+			async_sink.reset();
+		}
+
 		spdlog::drop_all();
 		spdlog::shutdown();
 
@@ -211,4 +245,38 @@ namespace {
 			FreeConsole();
 		}
 	}
+
+	// 崩溃时后台线程来不及写完队列中的日志，在这里等待它写完
+	constexpr std::chrono::milliseconds crash_flush_timeout{ 2000 };
+	LPTOP_LEVEL_EXCEPTION_FILTER g_previous_exception_filter{};
+	std::terminate_handler g_previous_terminate_handler{};
+	void flushOnCrash() {
+		if (async_sink) {
+			std::ignore = async_sink->waitFlush(crash_flush_timeout);
+		}
+	}
+	LONG WINAPI unhandledExceptionFilter(EXCEPTION_POINTERS* const exception_pointers) {
+		flushOnCrash();
+		if (g_previous_exception_filter) {
+			return g_previous_exception_filter(exception_pointers);
+		}
+		return EXCEPTION_CONTINUE_SEARCH;
+	}
+	void terminateHandler() {
+		flushOnCrash();
+		if (g_previous_terminate_handler) {
+			g_previous_terminate_handler();
+		}
+		std::abort();
+	}
+	void installCrashHandler() {
+		g_previous_exception_filter = SetUnhandledExceptionFilter(&unhandledExceptionFilter);
+		g_previous_terminate_handler = std::set_terminate(&terminateHandler);
+	}
+	void uninstallCrashHandler() {
+		SetUnhandledExceptionFilter(g_previous_exception_filter);
+		std::set_terminate(g_previous_terminate_handler);
+		g_previous_exception_filter = nullptr;
+		g_previous_terminate_handler = nullptr;
+	}
 }
@@ -87,6 +87,13 @@ namespace luastg {
 		}
 		clearCallbacks(this);
 	}
+	std::span<IGameObjectCallbacks* const> GameObject::getCallbacks() const noexcept {
+		if (isDirectCallbacks(this)) {
+			// 只有一个回调函数集时，指针直接存放在 callbacks 字段里
+			return { reinterpret_cast<IGameObjectCallbacks* const*>(&callbacks), 1 };
+		}
+		return { callbacks, callbacks_count };
+	}
 
 #define FOR_EACH_CALLBACKS(S) \
 	if (isDirectCallbacks(this)) { reinterpret_cast<IGameObjectCallbacks*>(callbacks)-> S return; } \
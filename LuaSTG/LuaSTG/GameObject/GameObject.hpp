@@ -2,6 +2,7 @@
 #include "GameResource/ResourceBase.hpp"
 #include "GameResource/ResourceParticle.hpp"
 #include <memory_resource>
+#include <span>
 
 #define LGOBJ_CC_INIT 1
 #define LGOBJ_CC_DEL 2
@@ -179,6 +180,7 @@ namespace luastg {
 		void addCallbacks(IGameObjectCallbacks* c);
 		void removeCallbacks(IGameObjectCallbacks* c);
 		void removeAllCallbacks();
+		[[nodiscard]] std::span<IGameObjectCallbacks* const> getCallbacks() const noexcept;
 		void dispatchOnQueueToDestroy(std::string_view reason);
 		void dispatchOnUpdate();
 		void dispatchOnLateUpdate();
@@ -69,6 +69,7 @@ namespace luastg
 	void GameObjectPool::ResetPool() noexcept
 	{
 		// 回收已分配的对象和更新链表
+		CallbackScope const callback_scope(this);
 		dispatchOnBeforeBatchDestroy();
 		for (auto p = m_update_list.first(); p != nullptr;) {
 			p = freeWithCallbacks(p);
@@ -88,11 +89,13 @@ namespace luastg
 		m_LockObjectB = nullptr;
 		m_superpause = 0;
 		m_nextsuperpause = 0;
+		invalidateSpatialGrid();
 		// 清理内存
 		m_memory_resource.release();
 	}
 	void GameObjectPool::updateMovementsLegacy() {
 		tracy_zone_scoped_with_name("LOBJMGR.ObjFrame");
+		CallbackScope const callback_scope(this);
 		dispatchOnBeforeBatchUpdate();
 		auto const super_pause_time = UpdateSuperPause(); // 更新超级暂停
 		for (auto p = m_update_list.first(); p != nullptr; p = p->update_list_next) {
@@ -109,11 +112,14 @@ namespace luastg
 			#endif // USING_MULTI_GAME_WORLD
 			}
 			p->Update();
+			// 后面对象的回调可能会查询，移动后马上更新网格
+			updateSpatialGrid(p);
 		}
 		dispatchOnAfterBatchUpdate();
 	}
 	void GameObjectPool::updateMovements() {
 		tracy_zone_scoped_with_name("LOBJMGR.ObjFrame(New)");
+		CallbackScope const callback_scope(this);
 
 		dispatchOnBeforeBatchUpdate();
 
@@ -140,6 +146,7 @@ namespace luastg
 				continue;
 			}
 			p->UpdateV2();
+			updateSpatialGrid(p);
 		}
 	}
 	void GameObjectPool::render() {
@@ -184,6 +191,7 @@ namespace luastg
 	}
 	void GameObjectPool::updateNextLegacy() {
 		tracy_zone_scoped_with_name("LOBJMGR.AfterFrame");
+		CallbackScope const callback_scope(this);
 		dispatchOnBeforeBatchDestroy();
 		auto const super_pause_time = GetSuperPauseTime();
 		for (auto p = m_update_list.first(); p != nullptr;) {
@@ -202,6 +210,7 @@ namespace luastg
 	}
 	void GameObjectPool::updateNext() {
 		tracy_zone_scoped_with_name("LOBJMGR.AfterFrame(New)");
+		CallbackScope const callback_scope(this);
 		dispatchOnBeforeBatchDestroy();
 		auto const super_pause_time = UpdateSuperPause(); // 更新超级暂停
 		for (auto p = m_update_list.first(); p != nullptr;) {
@@ -220,6 +229,7 @@ namespace luastg
 	}
 	void GameObjectPool::detectOutOfWorldBoundLegacy() {
 		tracy_zone_scoped_with_name("LOBJMGR.BoundCheck");
+		CallbackScope const callback_scope(this);
 
 		dispatchOnBeforeBatchOutOfWorldBoundCheck();
 #ifdef USING_MULTI_GAME_WORLD
@@ -252,6 +262,7 @@ namespace luastg
 	}
 	void GameObjectPool::detectOutOfWorldBound() {
 		tracy_zone_scoped_with_name("LOBJMGR.BoundCheck(New)");
+		CallbackScope const callback_scope(this);
 
 		dispatchOnBeforeBatchOutOfWorldBoundCheck();
 
@@ -398,18 +409,22 @@ namespace luastg
 		m_render_list.erase(p);
 		assert(p != m_LockObjectA && p != m_LockObjectB);
 		m_detect_lists[p->group].remove(p);
+		removeFromSpatialGrids(p);
 		p->unique_id = m_iUid % GameObject::max_unique_id; // GameObject::max_unique_id is reserved
 		++m_iUid;
 		m_update_list.add(p);
 		m_render_list.insert(p);
 		m_detect_lists[p->group].add(p);
+		addToSpatialGrids(p);
 	}
 
 	void GameObjectPool::setGroup(GameObject* const object, size_t const group) {
 		assert(object != m_LockObjectA && object != m_LockObjectB);
 		m_detect_lists[object->group].remove(object);
+		m_spatial_grids[static_cast<size_t>(object->group)].remove(object);
 		object->group = static_cast<int32_t>(group);
 		m_detect_lists[object->group].add(object);
+		m_spatial_grids[static_cast<size_t>(object->group)].insert(object);
 	}
 	void GameObjectPool::setLayer(GameObject* const object, double const layer) {
 		assert(!m_is_rendering);
@@ -437,6 +452,7 @@ namespace luastg
 		m_update_list.add(p);
 		m_render_list.insert(p);
 		m_detect_lists[p->group].add(p);
+		addToSpatialGrids(p);
 		m_statistics[m_statistics_index].object_alloc += 1;
 		if (callbacks != nullptr) {
 			p->addCallbacks(callbacks);
@@ -452,6 +468,7 @@ namespace luastg
 		auto const next = m_update_list.remove(object);
 		m_render_list.erase(object);
 		m_detect_lists[object->group].remove(object);
+		removeFromSpatialGrids(object);
 	#ifdef USING_MULTI_GAME_WORLD
 		if (m_pCurrentObject == object) {
 			m_pCurrentObject = nullptr;
@@ -471,6 +488,153 @@ namespace luastg
 		return has_callback_destroy || has_callback_legacy_kill;
 	}
 
+	void GameObjectPool::collectObjects(int64_t const group, std::vector<GameObject*>& output) {
+		output.clear();
+		forEachObjectInList(group, [&output](GameObject* const p) {
+			output.push_back(p);
+		});
+	}
+	void GameObjectPool::collectObjects(GameObjectFilter const& filter, std::vector<GameObject*>& output) {
+		switch (filter.shape) {
+		case GameObjectFilter::Shape::Rect:
+			queryRect(filter.group, filter.l, filter.r, filter.b, filter.t, output);
+			break;
+		case GameObjectFilter::Shape::Circle:
+			queryCircle(filter.group, filter.x, filter.y, filter.radius, output);
+			break;
+		default:
+			output.clear();
+			forEachObjectInList(filter.group, [&output](GameObject* const p) {
+				if (p->status == GameObjectStatus::Active) {
+					output.push_back(p);
+				}
+			});
+			break;
+		}
+	#ifdef USING_MULTI_GAME_WORLD
+		if (filter.world != 0) {
+			std::erase_if(output, [&filter](GameObject const* const p) {
+				return !CheckWorld(static_cast<int32_t>(filter.world), static_cast<int32_t>(p->world));
+			});
+		}
+	#endif // USING_MULTI_GAME_WORLD
+	}
+	size_t GameObjectPool::queueToFreeObjects(std::vector<GameObject*> const& objects, std::string_view const reason) {
+		// 和 detectOutOfWorldBound 一样：先标记所有对象，再按顺序调用回调
+
+		struct QueueToDestroyResult {
+			uint64_t uid{};
+			GameObject* game_object{};
+		};
+
+		std::pmr::vector<QueueToDestroyResult> cache{ &m_memory_resource };
+		size_t count{};
+		for (auto const p : objects) {
+			if (p->status != GameObjectStatus::Active) {
+				continue;
+			}
+			p->status = GameObjectStatus::Dead;
+			count += 1;
+			if (p->features.has_callback_destroy) {
+				cache.push_back(QueueToDestroyResult{
+					.uid = p->unique_id,
+					.game_object = p,
+				});
+			}
+		}
+
+		if (!cache.empty()) {
+			CallbackScope const callback_scope(this);
+			dispatchOnBeforeBatchQueueToDestroy();
+			for (auto const& [uid, game_object] : cache) {
+				if (game_object->unique_id != uid) {
+					assert(false); continue; // 理论上不太可能发生
+				}
+			#ifdef USING_MULTI_GAME_WORLD
+				m_pCurrentObject = game_object;
+			#endif // USING_MULTI_GAME_WORLD
+				game_object->dispatchOnQueueToDestroy(reason);
+			#ifdef USING_MULTI_GAME_WORLD
+				m_pCurrentObject = nullptr;
+			#endif // USING_MULTI_GAME_WORLD
+			}
+			dispatchOnAfterBatchQueueToDestroy();
+		}
+		return count;
+	}
+	size_t GameObjectPool::queueToFreeObjectsLegacyKillMode(std::vector<GameObject*> const& objects, std::vector<GameObject*>& output) {
+		output.clear();
+		size_t count{};
+		for (auto const p : objects) {
+			if (p->status != GameObjectStatus::Active) {
+				continue;
+			}
+			p->status = GameObjectStatus::Killed;
+			count += 1;
+			if (p->features.has_callback_legacy_kill) {
+				output.push_back(p);
+			}
+		}
+		return count;
+	}
+	size_t GameObjectPool::setObjectProperties(std::vector<GameObject*> const& objects, GameObjectProperties const& properties) {
+		bool const update_collision = properties.a.has_value() || properties.b.has_value();
+		size_t count{};
+		for (auto const p : objects) {
+			if (p->status != GameObjectStatus::Active) {
+				continue;
+			}
+			if (properties.vx) p->vx = *properties.vx;
+			if (properties.vy) p->vy = *properties.vy;
+			if (properties.ax) p->ax = *properties.ax;
+			if (properties.ay) p->ay = *properties.ay;
+			if (properties.a) p->a = *properties.a;
+			if (properties.b) p->b = *properties.b;
+			if (properties.colli) p->colli = *properties.colli;
+			if (update_collision) {
+				p->UpdateCollisionCircleRadius();
+			}
+			count += 1;
+		}
+		return count;
+	}
+	GameObjectPool::StateDigest GameObjectPool::computeStateDigest() {
+		// FNV-1a，浮点数按位参与计算，任何细微的差异都会体现出来
+		StateDigest digest{ .hash = 0xcbf29ce484222325ull };
+		auto const write = [&digest]<typename T>(T const value) {
+			static_assert(std::is_trivially_copyable_v<T>);
+			auto const bytes = reinterpret_cast<uint8_t const*>(&value);
+			for (size_t i = 0; i < sizeof(T); i += 1) {
+				digest.hash ^= bytes[i];
+				digest.hash *= 0x100000001b3ull;
+			}
+		};
+		write(m_iUid);
+		write(m_superpause);
+		for (auto p = m_update_list.first(); p != nullptr; p = p->update_list_next) {
+			write(static_cast<uint64_t>(p->id));
+			write(static_cast<uint64_t>(p->unique_id));
+			write(p->status);
+			write(p->group);
+			write(p->layer);
+			write(p->x);
+			write(p->y);
+			write(p->vx);
+			write(p->vy);
+			write(p->ax);
+			write(p->ay);
+			write(p->a);
+			write(p->b);
+			write(p->rot);
+			write(p->omega);
+			write(p->hscale);
+			write(p->vscale);
+			write(p->timer);
+			write(static_cast<uint8_t>((p->colli ? 1u : 0u) | (p->bound ? 2u : 0u) | (p->rect ? 4u : 0u) | (p->hide ? 8u : 0u)));
+			digest.object_count += 1;
+		}
+		return digest;
+	}
 	void GameObjectPool::DrawCollider()
 	{
 #if (defined LDEVVERSION)
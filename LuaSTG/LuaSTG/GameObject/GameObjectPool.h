@@ -1,11 +1,14 @@
 #pragma once
 #include "GameObject/GameObject.hpp"
+#include "GameObject/GameObjectSpatialGrid.hpp"
 #include "core/FixedObjectPool.hpp"
 #include <deque>
 #include <list>
 #include <memory_resource>
 #include <ranges>
 #include <algorithm>
+#include <optional>
+#include <memory>
 
 // 对象池信息
 #define LOBJPOOL_SIZE   32768 // 最大对象数 //32768(full) //16384(half)
@@ -147,8 +150,117 @@ namespace luastg
 		virtual void onBeforeBatchIntersectDetect() = 0;
 		// 对象管理器批量进行相交检测之后
 		virtual void onAfterBatchIntersectDetect() = 0;
+		// 对象管理器批量标记删除对象之前
+		virtual void onBeforeBatchQueueToDestroy() = 0;
+		// 对象管理器批量标记删除对象之后
+		virtual void onAfterBatchQueueToDestroy() = 0;
 	};
 
+	// 批量操作的筛选条件
+	struct GameObjectFilter {
+		enum class Shape : uint8_t {
+			None,
+			Rect,
+			Circle,
+		};
+
+		int64_t group{ -1 }; // 含义和 GameObjectPool::collectObjects 一致
+		int64_t world{}; // 启用多 world 时，只选择 world 与之相交的对象，为 0 时不筛选
+		Shape shape{ Shape::None };
+		double l{}, r{}, b{}, t{}; // Shape::Rect
+		double x{}, y{}, radius{}; // Shape::Circle
+	};
+
+	// 批量设置的属性，没有值的属性保持不变
+	struct GameObjectProperties {
+		std::optional<double> vx;
+		std::optional<double> vy;
+		std::optional<double> ax;
+		std::optional<double> ay;
+		std::optional<double> a;
+		std::optional<double> b;
+		std::optional<bool> colli;
+	};
+
+	// 对象池快照：所有已分配对象的属性、回调函数集、渲染资源，以及链表、空闲索引、uid、超级暂停等状态
+	// 对象按索引分块保存，拍摄时如果某个块和基准快照的对应块完全相同，则直接共享，不复制
+	// 否则只保存每个对象和关键块（基准快照对应块所基于的完整块）中同一个对象不同的 8 字节字，
+	// timer、坐标这些每帧都在变化的属性只占很少的空间；增量超过完整块的一半时重新保存完整块
+	// 不包含粒子系统实例的内部状态，恢复后需要重新创建的粒子池会从头开始发射
+	class GameObjectPoolSnapshot {
+	public:
+		static constexpr size_t chunk_size{ 256 };
+		static constexpr size_t chunk_count{ (LOBJPOOL_SIZE + chunk_size - 1) / chunk_size };
+
+		[[nodiscard]] bool empty() const noexcept { return !m_valid; }
+		[[nodiscard]] size_t getObjectCount() const noexcept { return m_object_count; }
+		// 和基准快照共享的块数量
+		[[nodiscard]] size_t getSharedChunkCount() const noexcept { return m_shared_chunk_count; }
+		// 以增量保存的块数量
+		[[nodiscard]] size_t getDeltaChunkCount() const noexcept { return m_delta_chunk_count; }
+		// 这个快照独占的内存大小（字节），不包括共享的块
+		[[nodiscard]] size_t getMemoryUsage() const noexcept { return m_memory_usage; }
+
+	private:
+		friend class GameObjectPool;
+
+		static constexpr size_t object_word_count{ sizeof(GameObject) / sizeof(uint64_t) };
+		static_assert(sizeof(GameObject) % sizeof(uint64_t) == 0 && object_word_count <= 64); // Delta::changed_words
+
+		struct Record {
+			GameObject object; // callbacks、callbacks_count、callbacks_capacity 不使用，回调函数集保存在 Chunk::callbacks 中
+			uint32_t callbacks_offset;
+			uint32_t callbacks_count;
+		};
+		struct Delta {
+			uint32_t key_record; // 关键块中同一个对象的记录的下标
+			uint32_t words_offset; // 不同的字在 Chunk::words 中的起始位置
+			uint64_t changed_words; // 第 i 位表示 GameObject 的第 i 个 8 字节字和关键块中的记录不同
+			uint32_t callbacks_offset;
+			uint32_t callbacks_count;
+		};
+		struct Chunk {
+			// 为空时是完整块，records 包含块中所有对象；
+			// 否则是增量块，关键块中的对象保存在 deltas 中，records 只包含关键块中没有的对象
+			std::shared_ptr<Chunk const> key;
+			std::vector<Record> records; // 按 id 排序
+			std::vector<Delta> deltas; // 按 id 排序
+			std::vector<uint64_t> words;
+			std::vector<IGameObjectCallbacks*> callbacks; // 块中所有对象的回调函数集，按 id 排序
+			std::vector<IResourceBase*> resources; // 持有引用的渲染资源
+
+			Chunk() = default;
+			Chunk(Chunk const&) = delete;
+			Chunk& operator=(Chunk const&) = delete;
+			~Chunk();
+
+			// 还原出块中所有对象的完整记录，按 id 排序
+			void decode(std::vector<Record>& output) const;
+		};
+
+		std::array<std::shared_ptr<Chunk const>, chunk_count> m_chunks;
+		std::vector<uint16_t> m_free_indices;
+		GameObjectUpdateLinkedList m_update_list;
+		std::array<GameObjectDetectLinkedList, LOBJPOOL_GROUPN> m_detect_lists;
+		uint64_t m_uid{};
+		int64_t m_superpause{};
+		int64_t m_next_superpause{};
+		double m_bound_left{};
+		double m_bound_right{};
+		double m_bound_top{};
+		double m_bound_bottom{};
+	#ifdef USING_MULTI_GAME_WORLD
+		int32_t m_world{};
+		std::array<int32_t, 4> m_worlds{};
+	#endif // USING_MULTI_GAME_WORLD
+		size_t m_object_count{};
+		size_t m_shared_chunk_count{};
+		size_t m_delta_chunk_count{};
+		size_t m_memory_usage{};
+		bool m_valid{ false };
+	};
+	static_assert(LOBJPOOL_SIZE <= UINT16_MAX + 1);
+
 	//游戏对象池
 	class GameObjectPool
 	{
@@ -194,10 +306,42 @@ namespace luastg
 
 		bool m_is_rendering{ false };
 		bool m_is_detecting_intersect{ false };
+		uint32_t m_callback_depth{ 0 }; // 正在遍历链表并调用对象回调的层数，这时链表不能被整个替换
+
+		struct CallbackScope {
+			GameObjectPool* pool;
+			explicit CallbackScope(GameObjectPool* const p) noexcept : pool(p) { pool->m_callback_depth += 1; }
+			CallbackScope(CallbackScope const&) = delete;
+			CallbackScope& operator=(CallbackScope const&) = delete;
+			~CallbackScope() { pool->m_callback_depth -= 1; }
+		};
 
 		FrameStatistics m_statistics[2]{};
 		size_t m_statistics_index{ 0 };
 
+		// 空间查询，每个碰撞组一个网格，最后一个对应整个更新链表
+		std::array<GameObjectSpatialGrid, LOBJPOOL_GROUPN + 1> m_spatial_grids;
+		std::vector<GameObject*> m_spatial_objects;
+		std::vector<GameObjectSpatialGrid::Entry> m_spatial_results;
+		double m_spatial_cell_size{ 64.0 };
+
+		GameObjectSpatialGrid const& getSpatialGrid(int64_t group);
+		// 和链表的 add、remove 配对调用，网格中的顺序和链表一致
+		void addToSpatialGrids(GameObject* const object) {
+			m_spatial_grids[LOBJPOOL_GROUPN].insert(object);
+			m_spatial_grids[static_cast<size_t>(object->group)].insert(object);
+		}
+		void removeFromSpatialGrids(GameObject* const object) {
+			m_spatial_grids[LOBJPOOL_GROUPN].remove(object);
+			m_spatial_grids[static_cast<size_t>(object->group)].remove(object);
+		}
+
+		// 拍摄、恢复快照时的临时缓冲区
+		std::vector<GameObjectPoolSnapshot::Record> m_snapshot_records;
+		std::vector<GameObjectPoolSnapshot::Record> m_snapshot_base_records;
+		std::vector<IGameObjectCallbacks*> m_snapshot_callbacks;
+		std::vector<uint64_t> m_snapshot_unique_ids; // 按 id 索引，unique_id + 1，0 表示快照中没有这个对象
+
 		struct IntersectionDetectionResult {
 			uint64_t uid1{};
 			uint64_t uid2{};
@@ -215,6 +359,21 @@ namespace luastg
 			return object->isInRect(m_BoundLeft, m_BoundRight, m_BoundBottom, m_BoundTop);
 		}
 
+		// 按链表顺序遍历对象，group 不是有效的碰撞组时遍历整个更新链表
+		template<typename Function>
+		void forEachObjectInList(int64_t const group, Function&& function) {
+			if (group < 0 || group >= LOBJPOOL_GROUPN) {
+				for (auto p = m_update_list.first(); p != nullptr; p = p->update_list_next) {
+					function(p);
+				}
+			}
+			else {
+				for (auto p = m_detect_lists[static_cast<size_t>(group)].first(); p != nullptr; p = p->detect_list_next) {
+					function(p);
+				}
+			}
+		}
+
 	public:
 		void addCallbacks(IGameObjectManagerCallbacks* const callbacks) {
 			for (auto const c : m_callbacks) {
@@ -293,6 +452,16 @@ namespace luastg
 				c->onAfterBatchIntersectDetect();
 			}
 		}
+		void dispatchOnBeforeBatchQueueToDestroy() {
+			for (auto const c : m_callbacks) {
+				c->onBeforeBatchQueueToDestroy();
+			}
+		}
+		void dispatchOnAfterBatchQueueToDestroy() {
+			for (auto const c : m_callbacks) {
+				c->onAfterBatchQueueToDestroy();
+			}
+		}
 		void DebugNextFrame();
 		FrameStatistics DebugGetFrameStatistics();
 
@@ -376,6 +545,7 @@ namespace luastg
 		[[nodiscard]] bool isLockedByDetectIntersection(GameObject const* const object) const noexcept { return object == m_LockObjectA || object == m_LockObjectB; }
 		[[nodiscard]] bool isRendering() const noexcept { return m_is_rendering; }
 		[[nodiscard]] bool isDetectingIntersect() const noexcept { return m_is_detecting_intersect; }
+		[[nodiscard]] bool isDispatchingCallbacks() const noexcept { return m_callback_depth > 0; }
 
 		GameObject* getUpdateListFirst() { return m_update_list.first(); }
 		GameObject* getUpdateListNext(size_t const id) { return getUpdateListNext(m_ObjectPool.object(id)); }
@@ -397,6 +567,60 @@ namespace luastg
 			return object->detect_list_next;
 		}
 
+		// 按链表顺序收集对象，和 lstg.ObjList 一致：group 不是有效的碰撞组时遍历整个更新链表
+		void collectObjects(int64_t group, std::vector<GameObject*>& output);
+
+		// 空间查询：只考虑活跃对象的坐标，不考虑碰撞体的大小，group 的含义和 collectObjects 一致
+		// 网格在第一次查询时构建，之后随对象增删、移动增量更新
+		// 绕过属性直接修改坐标（比如 FFI）后需要调用 invalidateSpatialGrid，下一次查询时重新构建
+
+		void invalidateSpatialGrid() noexcept {
+			for (auto& grid : m_spatial_grids) {
+				grid.clear();
+			}
+		}
+		// 对象坐标改变后调用
+		void updateSpatialGrid(GameObject* const object) {
+			m_spatial_grids[LOBJPOOL_GROUPN].update(object);
+			m_spatial_grids[static_cast<size_t>(object->group)].update(object);
+		}
+		void setSpatialGridCellSize(double size);
+		[[nodiscard]] double getSpatialGridCellSize() const noexcept { return m_spatial_cell_size; }
+		// 与 (x, y) 距离不超过 radius 的对象，按链表顺序
+		void queryCircle(int64_t group, double x, double y, double radius, std::vector<GameObject*>& output);
+		// 在矩形内的对象，按链表顺序
+		void queryRect(int64_t group, double l, double r, double b, double t, std::vector<GameObject*>& output);
+		// 离 (x, y) 最近的 k 个对象，可以限制最大距离，按距离排序，距离相同时按链表顺序
+		void queryNearest(int64_t group, double x, double y, size_t k, double max_distance, std::vector<GameObject*>& output);
+		// 与线段距离不超过 half_width 的对象，按在线段上的投影位置排序（从起点开始），相同时按链表顺序
+		void querySegment(int64_t group, double x1, double y1, double x2, double y2, double half_width, std::vector<GameObject*>& output);
+		// 按顺序把对象标记为删除状态，然后按同样的顺序调用 del 回调并传入 reason，返回被标记的对象数量
+		size_t queueToFreeObjects(std::vector<GameObject*> const& objects, std::string_view reason);
+
+		// 批量操作：先选出所有对象、全部标记完，再按链表顺序调用回调，和 detectOutOfWorldBound 的顺序保证一致
+
+		// 按筛选条件收集活跃对象，按链表顺序
+		void collectObjects(GameObjectFilter const& filter, std::vector<GameObject*>& output);
+		// 按顺序把对象标记为 kill 状态，有 kill 回调的对象按顺序写入 output，回调由调用方负责调用，返回被标记的对象数量
+		size_t queueToFreeObjectsLegacyKillMode(std::vector<GameObject*> const& objects, std::vector<GameObject*>& output);
+		// 批量设置属性，返回修改的对象数量
+		size_t setObjectProperties(std::vector<GameObject*> const& objects, GameObjectProperties const& properties);
+
+		// 对象池状态摘要，按更新链表顺序计算，用于快进验证回放、排查不同步
+		struct StateDigest {
+			uint64_t hash{};
+			size_t object_count{};
+		};
+		[[nodiscard]] StateDigest computeStateDigest();
+
+		// 快照和恢复：不能在渲染、相交检测的过程中调用，恢复也不能在对象回调的过程中调用（返回 false）
+		// 恢复时，快照中不存在的对象会被回收（触发 onDestroy），快照中存在但已被回收的对象会在原来的索引上复活（不触发 onCreate）
+		// 调用方负责恢复对象以外的状态，比如 Lua 侧的对象表
+
+		// 拍摄快照，base 不为空时和它共享没有变化的块，其他块以增量保存
+		bool takeSnapshot(GameObjectPoolSnapshot& snapshot, GameObjectPoolSnapshot const* base = nullptr);
+		bool restoreSnapshot(GameObjectPoolSnapshot const& snapshot);
+
 #ifdef USING_MULTI_GAME_WORLD
 	private:
 		// 用于多world
@@ -0,0 +1,291 @@
+#include "GameObject/GameObjectPool.h"
+#include <bit>
+#include <cstring>
+
+namespace {
+	// 和 GameObject::ChangeResource 一样设置渲染资源，但不修改碰撞体，碰撞体已经从快照中恢复
+	void restoreResource(luastg::GameObject* const object, luastg::IResourceBase* const resource) {
+		if (resource->GetType() == luastg::ResourceType::Particle) {
+			if (!static_cast<luastg::IResourceParticle*>(resource)->CreateInstance(&object->ps)) {
+				object->ps = nullptr;
+				spdlog::error("[luastg] ResParticle: 无法分配粒子池，内存不足");
+				return;
+			}
+			object->ps->SetActive(false);
+			object->ps->SetCenter(core::Vector2F(static_cast<float>(object->x), static_cast<float>(object->y)));
+			object->ps->SetRotation(static_cast<float>(object->rot));
+			object->ps->SetActive(true);
+		}
+		object->res = resource;
+		object->res->retain();
+	}
+}
+
+namespace luastg {
+	// GameObjectPoolSnapshot
+
+	GameObjectPoolSnapshot::Chunk::~Chunk() {
+		for (auto const resource : resources) {
+			resource->release();
+		}
+	}
+	void GameObjectPoolSnapshot::Chunk::decode(std::vector<Record>& output) const {
+		if (!key) {
+			output.assign(records.begin(), records.end());
+			return;
+		}
+		output.clear();
+		output.reserve(records.size() + deltas.size());
+		auto it = records.begin();
+		uint64_t object_words[object_word_count]{};
+		for (auto const& delta : deltas) {
+			auto const& key_record = key->records[delta.key_record];
+			for (; it != records.end() && it->object.id < key_record.object.id; ++it) {
+				output.push_back(*it);
+			}
+			std::memcpy(object_words, static_cast<void const*>(&key_record.object), sizeof(GameObject));
+			size_t word = delta.words_offset;
+			for (uint64_t changed = delta.changed_words; changed != 0; changed &= changed - 1) {
+				object_words[std::countr_zero(changed)] = words[word];
+				word += 1;
+			}
+			auto& record = output.emplace_back();
+			std::memcpy(static_cast<void*>(&record.object), object_words, sizeof(GameObject));
+			record.callbacks_offset = delta.callbacks_offset;
+			record.callbacks_count = delta.callbacks_count;
+		}
+		output.insert(output.end(), it, records.end());
+	}
+
+	// GameObjectPool
+
+	bool GameObjectPool::takeSnapshot(GameObjectPoolSnapshot& snapshot, GameObjectPoolSnapshot const* base) {
+		using Record = GameObjectPoolSnapshot::Record;
+		using Chunk = GameObjectPoolSnapshot::Chunk;
+		if (m_is_rendering || m_is_detecting_intersect) {
+			return false;
+		}
+		if (base != nullptr && base->empty()) {
+			base = nullptr;
+		}
+		auto const is_same_chunk = [this](Chunk const& chunk) {
+			if (chunk.callbacks != m_snapshot_callbacks) {
+				return false;
+			}
+			chunk.decode(m_snapshot_base_records);
+			if (m_snapshot_base_records.size() != m_snapshot_records.size()) {
+				return false;
+			}
+			return std::memcmp(static_cast<void const*>(m_snapshot_base_records.data()), static_cast<void const*>(m_snapshot_records.data()),
+				sizeof(Record) * m_snapshot_records.size()) == 0;
+		};
+		// 以 key 为关键块编码增量块，增量太大（超过完整块的一半）时返回空
+		auto const encode_delta = [this](std::shared_ptr<Chunk const> const& key) -> std::shared_ptr<Chunk> {
+			auto data = std::make_shared<Chunk>();
+			size_t k = 0;
+			uint64_t current_words[GameObjectPoolSnapshot::object_word_count]{};
+			uint64_t key_words[GameObjectPoolSnapshot::object_word_count]{};
+			for (auto const& record : m_snapshot_records) {
+				for (; k < key->records.size() && key->records[k].object.id < record.object.id; k += 1) {
+				}
+				if (k == key->records.size() || key->records[k].object.id != record.object.id || key->records[k].object.unique_id != record.object.unique_id) {
+					data->records.push_back(record);
+					continue;
+				}
+				std::memcpy(current_words, static_cast<void const*>(&record.object), sizeof(GameObject));
+				std::memcpy(key_words, static_cast<void const*>(&key->records[k].object), sizeof(GameObject));
+				auto& delta = data->deltas.emplace_back();
+				delta.key_record = static_cast<uint32_t>(k);
+				delta.words_offset = static_cast<uint32_t>(data->words.size());
+				delta.changed_words = 0;
+				delta.callbacks_offset = record.callbacks_offset;
+				delta.callbacks_count = record.callbacks_count;
+				for (size_t i = 0; i < GameObjectPoolSnapshot::object_word_count; i += 1) {
+					if (current_words[i] != key_words[i]) {
+						delta.changed_words |= uint64_t{ 1 } << i;
+						data->words.push_back(current_words[i]);
+					}
+				}
+			}
+			size_t const delta_size = sizeof(Record) * data->records.size() + sizeof(GameObjectPoolSnapshot::Delta) * data->deltas.size() + sizeof(uint64_t) * data->words.size();
+			if (delta_size * 2 > sizeof(Record) * m_snapshot_records.size()) {
+				return nullptr;
+			}
+			data->key = key;
+			return data;
+		};
+		snapshot.m_object_count = 0;
+		snapshot.m_shared_chunk_count = 0;
+		snapshot.m_delta_chunk_count = 0;
+		snapshot.m_memory_usage = sizeof(uint16_t) * m_ObjectPool.freeCount();
+
+		for (size_t chunk = 0; chunk < GameObjectPoolSnapshot::chunk_count; chunk += 1) {
+			m_snapshot_records.clear();
+			m_snapshot_callbacks.clear();
+			size_t const first = chunk * GameObjectPoolSnapshot::chunk_size;
+			size_t const last = std::min(first + GameObjectPoolSnapshot::chunk_size, static_cast<size_t>(LOBJPOOL_SIZE));
+			for (size_t id = first; id < last; id += 1) {
+				auto const p = m_ObjectPool.object(id);
+				if (p == nullptr) {
+					continue;
+				}
+				auto const callbacks = p->getCallbacks();
+				auto& record = m_snapshot_records.emplace_back();
+				std::memcpy(static_cast<void*>(&record.object), static_cast<void const*>(p), sizeof(GameObject));
+				record.object.callbacks = nullptr;
+				record.object.callbacks_count = 0;
+				record.object.callbacks_capacity = 0;
+				record.object.ps = nullptr;
+				record.callbacks_offset = static_cast<uint32_t>(m_snapshot_callbacks.size());
+				record.callbacks_count = static_cast<uint32_t>(callbacks.size());
+				m_snapshot_callbacks.insert(m_snapshot_callbacks.end(), callbacks.begin(), callbacks.end());
+			}
+			snapshot.m_object_count += m_snapshot_records.size();
+
+			if (m_snapshot_records.empty()) {
+				snapshot.m_chunks[chunk] = nullptr;
+				continue;
+			}
+			std::shared_ptr<Chunk> data;
+			if (base != nullptr) {
+				auto const& base_chunk = base->m_chunks[chunk];
+				if (base_chunk && is_same_chunk(*base_chunk)) {
+					snapshot.m_chunks[chunk] = base_chunk;
+					snapshot.m_shared_chunk_count += 1;
+					continue;
+				}
+				if (base_chunk) {
+					// 增量块总是基于完整块，不形成链
+					data = encode_delta(base_chunk->key ? base_chunk->key : base_chunk);
+				}
+			}
+			if (data) {
+				snapshot.m_delta_chunk_count += 1;
+			}
+			else {
+				data = std::make_shared<Chunk>();
+				data->records = m_snapshot_records;
+			}
+			data->callbacks = m_snapshot_callbacks;
+			for (auto const& record : m_snapshot_records) {
+				if (record.object.res != nullptr) {
+					record.object.res->retain();
+					data->resources.push_back(record.object.res);
+				}
+			}
+			snapshot.m_memory_usage += sizeof(Record) * data->records.size()
+				+ sizeof(GameObjectPoolSnapshot::Delta) * data->deltas.size()
+				+ sizeof(uint64_t) * data->words.size()
+				+ sizeof(IGameObjectCallbacks*) * data->callbacks.size()
+				+ sizeof(IResourceBase*) * data->resources.size();
+			snapshot.m_chunks[chunk] = std::move(data);
+		}
+
+		auto const free_indices = m_ObjectPool.freeIndices();
+		snapshot.m_free_indices.assign(free_indices, free_indices + m_ObjectPool.freeCount());
+		snapshot.m_update_list = m_update_list;
+		snapshot.m_detect_lists = m_detect_lists;
+		snapshot.m_uid = m_iUid;
+		snapshot.m_superpause = m_superpause;
+		snapshot.m_next_superpause = m_nextsuperpause;
+		snapshot.m_bound_left = m_BoundLeft;
+		snapshot.m_bound_right = m_BoundRight;
+		snapshot.m_bound_top = m_BoundTop;
+		snapshot.m_bound_bottom = m_BoundBottom;
+	#ifdef USING_MULTI_GAME_WORLD
+		snapshot.m_world = m_iWorld;
+		snapshot.m_worlds = m_Worlds;
+	#endif // USING_MULTI_GAME_WORLD
+		snapshot.m_valid = true;
+		return true;
+	}
+	bool GameObjectPool::restoreSnapshot(GameObjectPoolSnapshot const& snapshot) {
+		// 在对象回调中恢复的话，正在遍历链表的调用方会访问到已经回收的对象
+		if (m_is_rendering || m_is_detecting_intersect || m_callback_depth > 0 || snapshot.empty()) {
+			return false;
+		}
+		CallbackScope const callback_scope(this);
+
+		// 快照中的对象，增量块中的对象在关键块中有相同的 unique_id
+		m_snapshot_unique_ids.assign(LOBJPOOL_SIZE, 0);
+		for (auto const& chunk : snapshot.m_chunks) {
+			if (!chunk) {
+				continue;
+			}
+			for (auto const& record : chunk->records) {
+				m_snapshot_unique_ids[record.object.id] = record.object.unique_id + 1;
+			}
+			for (auto const& delta : chunk->deltas) {
+				auto const& object = chunk->key->records[delta.key_record].object;
+				m_snapshot_unique_ids[object.id] = object.unique_id + 1;
+			}
+		}
+
+		// 首先，回收快照中不存在的对象，包括索引相同但已经换成别的对象的
+		dispatchOnBeforeBatchDestroy();
+		for (auto p = m_update_list.first(); p != nullptr;) {
+			if (m_snapshot_unique_ids[p->id] == p->unique_id + 1) {
+				p = p->update_list_next;
+				continue;
+			}
+			p = freeWithCallbacks(p);
+		}
+		dispatchOnAfterBatchDestroy();
+
+		// 然后恢复空闲索引栈，剩下的索引正好是快照中的对象
+		m_ObjectPool.restore(snapshot.m_free_indices.data(), snapshot.m_free_indices.size());
+		m_render_list.clear();
+		for (auto const& chunk : snapshot.m_chunks) {
+			if (!chunk) {
+				continue;
+			}
+			chunk->decode(m_snapshot_records);
+			for (auto const& record : m_snapshot_records) {
+				auto const p = m_ObjectPool.object(record.object.id);
+				assert(p != nullptr);
+				bool const alive = p->status != GameObjectStatus::Free && p->unique_id == record.object.unique_id;
+				if (alive) {
+					p->removeAllCallbacks();
+					if (p->res != record.object.res) {
+						p->ReleaseResource();
+					}
+				}
+				else {
+					assert(p->res == nullptr && p->ps == nullptr);
+				}
+				// 链表指针也一起恢复，对象池的存储是固定的，对象的地址不会变化
+				auto const res = p->res;
+				auto const ps = p->ps;
+				std::memcpy(static_cast<void*>(p), static_cast<void const*>(&record.object), sizeof(GameObject));
+				p->res = res;
+				p->ps = ps;
+				if (p->res == nullptr && record.object.res != nullptr) {
+					restoreResource(p, record.object.res);
+				}
+				for (uint32_t i = 0; i < record.callbacks_count; i += 1) {
+					p->addCallbacks(chunk->callbacks[record.callbacks_offset + i]);
+				}
+				m_render_list.insert(p);
+			}
+		}
+
+		m_update_list = snapshot.m_update_list;
+		m_detect_lists = snapshot.m_detect_lists;
+		m_iUid = snapshot.m_uid;
+		m_superpause = snapshot.m_superpause;
+		m_nextsuperpause = snapshot.m_next_superpause;
+		m_BoundLeft = snapshot.m_bound_left;
+		m_BoundRight = snapshot.m_bound_right;
+		m_BoundTop = snapshot.m_bound_top;
+		m_BoundBottom = snapshot.m_bound_bottom;
+	#ifdef USING_MULTI_GAME_WORLD
+		m_iWorld = snapshot.m_world;
+		m_Worlds = snapshot.m_worlds;
+		m_pCurrentObject = nullptr;
+	#endif // USING_MULTI_GAME_WORLD
+		m_LockObjectA = nullptr;
+		m_LockObjectB = nullptr;
+		invalidateSpatialGrid();
+		return true;
+	}
+}
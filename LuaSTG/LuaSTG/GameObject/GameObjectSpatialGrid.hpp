@@ -0,0 +1,165 @@
+#pragma once
+#include "GameObject/GameObject.hpp"
+#include <unordered_map>
+#include <vector>
+
+namespace luastg {
+	// 按对象坐标划分的均匀网格，用于加速空间查询
+	// 第一次查询时按链表构建，之后由 GameObjectPool 在对象增删、移动时增量更新
+	class GameObjectSpatialGrid {
+	public:
+		struct Entry {
+			uint64_t order{}; // 对象加入链表的顺序，用于保证查询结果的顺序稳定
+			GameObject* object{};
+		};
+
+		// objects 需要按链表顺序排列
+		void build(std::vector<GameObject*> const& objects, double cell_size);
+		void clear() noexcept;
+		[[nodiscard]] bool isBuilt() const noexcept { return m_built; }
+		[[nodiscard]] bool empty() const noexcept { return m_cells.empty(); }
+
+		// 以下操作在网格还没有构建时什么也不做
+		// 对象加入链表末尾
+		void insert(GameObject* object);
+		// 对象离开链表
+		void remove(GameObject* object);
+		// 对象移动后，如果换了格子，就移到新的格子里，顺序不变
+		void update(GameObject* const object) {
+			if (!m_built || object->id >= m_slots.size()) {
+				return;
+			}
+			auto& slot = m_slots[object->id];
+			if (!slot.present) {
+				return;
+			}
+			int32_t const cx = toCell(object->x);
+			int32_t const cy = toCell(object->y);
+			if (makeKey(cx, cy) != slot.cell) {
+				move(slot, object, cx, cy);
+			}
+		}
+		// 删除对象后格子的范围可能缩小了，查询前重新计算
+		void refreshBounds();
+
+		// 遍历与矩形区域相交的格子中的对象，顺序不确定
+		template<typename Function>
+		void forEachInRect(double const l, double const r, double const b, double const t, Function&& function) const {
+			if (m_cells.empty() || l > r || b > t) {
+				return;
+			}
+			int32_t const cx0 = std::max(toCell(l), m_min_x);
+			int32_t const cx1 = std::min(toCell(r), m_max_x);
+			int32_t const cy0 = std::max(toCell(b), m_min_y);
+			int32_t const cy1 = std::min(toCell(t), m_max_y);
+			if (cx0 > cx1 || cy0 > cy1) {
+				return;
+			}
+			uint64_t const cell_count = static_cast<uint64_t>(cx1 - cx0 + 1) * static_cast<uint64_t>(cy1 - cy0 + 1);
+			if (cell_count > m_cells.size()) {
+				// 区域内的格子比非空的格子还多，直接遍历非空的格子
+				for (auto const& [key, entries] : m_cells) {
+					int32_t const cx = getCellX(key);
+					int32_t const cy = getCellY(key);
+					if (cx >= cx0 && cx <= cx1 && cy >= cy0 && cy <= cy1) {
+						for (auto const& entry : entries) {
+							function(entry);
+						}
+					}
+				}
+				return;
+			}
+			for (int32_t cy = cy0; cy <= cy1; cy += 1) {
+				for (int32_t cx = cx0; cx <= cx1; cx += 1) {
+					visitCell(cx, cy, function);
+				}
+			}
+		}
+
+		// 遍历一个环上的格子：以 (cx, cy) 为中心、切比雪夫距离为 ring 的格子，ring 为 0 时只有中心格子
+		template<typename Function>
+		void forEachInRing(int32_t const cx, int32_t const cy, int32_t const ring, Function&& function) const {
+			if (m_cells.empty()) {
+				return;
+			}
+			if (ring > 0 && static_cast<uint64_t>(ring) * 8 > m_cells.size()) {
+				// 环上的格子比非空的格子还多，直接遍历非空的格子
+				for (auto const& [key, entries] : m_cells) {
+					int32_t const distance = std::max(std::abs(getCellX(key) - cx), std::abs(getCellY(key) - cy));
+					if (distance == ring) {
+						for (auto const& entry : entries) {
+							function(entry);
+						}
+					}
+				}
+				return;
+			}
+			auto const visit_row = [&](int32_t const y, int32_t const x0, int32_t const x1) {
+				if (y < m_min_y || y > m_max_y) {
+					return;
+				}
+				int32_t const to = std::min(x1, m_max_x);
+				for (int32_t x = std::max(x0, m_min_x); x <= to; x += 1) {
+					visitCell(x, y, function);
+				}
+			};
+			if (ring == 0) {
+				visit_row(cy, cx, cx);
+				return;
+			}
+			visit_row(cy - ring, cx - ring, cx + ring);
+			visit_row(cy + ring, cx - ring, cx + ring);
+			for (int32_t y = std::max(cy - ring + 1, m_min_y); y <= std::min(cy + ring - 1, m_max_y); y += 1) {
+				visit_row(y, cx - ring, cx - ring);
+				visit_row(y, cx + ring, cx + ring);
+			}
+		}
+
+		[[nodiscard]] int32_t toCell(double value) const noexcept;
+		[[nodiscard]] double getCellSize() const noexcept { return m_cell_size; }
+		// 与 (cx, cy) 的切比雪夫距离在 [min_ring, max_ring] 之外的环上没有对象
+		[[nodiscard]] int32_t getMinRing(int32_t cx, int32_t cy) const noexcept;
+		[[nodiscard]] int32_t getMaxRing(int32_t cx, int32_t cy) const noexcept;
+
+	private:
+		// 对象在网格中的位置，按对象 id 索引
+		struct Slot {
+			uint64_t cell{};
+			uint32_t index{};
+			bool present{};
+		};
+
+		static uint64_t makeKey(int32_t const cx, int32_t const cy) noexcept {
+			return (static_cast<uint64_t>(static_cast<uint32_t>(cy)) << 32) | static_cast<uint64_t>(static_cast<uint32_t>(cx));
+		}
+		static int32_t getCellX(uint64_t const key) noexcept { return static_cast<int32_t>(static_cast<uint32_t>(key)); }
+		static int32_t getCellY(uint64_t const key) noexcept { return static_cast<int32_t>(static_cast<uint32_t>(key >> 32)); }
+
+		template<typename Function>
+		void visitCell(int32_t const cx, int32_t const cy, Function& function) const {
+			auto const it = m_cells.find(makeKey(cx, cy));
+			if (it != m_cells.end()) {
+				for (auto const& entry : it->second) {
+					function(entry);
+				}
+			}
+		}
+		void move(Slot& slot, GameObject* object, int32_t cx, int32_t cy);
+		// 从格子中取出对象，返回它的顺序
+		uint64_t detach(Slot const& slot);
+		void attach(Slot& slot, Entry const& entry, int32_t cx, int32_t cy);
+
+	private:
+		std::unordered_map<uint64_t, std::vector<Entry>> m_cells; // 只保存非空的格子
+		std::vector<Slot> m_slots;
+		double m_cell_size{ 64.0 };
+		double m_inv_cell_size{ 1.0 / 64.0 };
+		uint64_t m_next_order{};
+		int32_t m_min_x{ INT32_MAX };
+		int32_t m_max_x{ INT32_MIN };
+		int32_t m_min_y{ INT32_MAX };
+		int32_t m_max_y{ INT32_MIN };
+		bool m_bounds_dirty{ false };
+		bool m_built{ false };
+	};
+}
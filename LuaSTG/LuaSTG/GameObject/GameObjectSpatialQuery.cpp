@@ -0,0 +1,287 @@
+#include "GameObject/GameObjectSpatialGrid.hpp"
+#include "GameObject/GameObjectPool.h"
+
+namespace {
+	// 离原点太远的格子坐标收拢到这个范围内，避免计算环的时候溢出
+	constexpr int32_t max_cell_coordinate{ 1 << 30 };
+
+	bool compareEntryOrder(luastg::GameObjectSpatialGrid::Entry const& a, luastg::GameObjectSpatialGrid::Entry const& b) noexcept {
+		return a.order < b.order;
+	}
+}
+
+namespace luastg {
+	// GameObjectSpatialGrid
+
+	void GameObjectSpatialGrid::build(std::vector<GameObject*> const& objects, double const cell_size) {
+		clear();
+		m_built = true;
+		m_cell_size = cell_size;
+		m_inv_cell_size = 1.0 / cell_size;
+		for (auto const object : objects) {
+			insert(object);
+		}
+	}
+	void GameObjectSpatialGrid::clear() noexcept {
+		m_cells.clear();
+		std::fill(m_slots.begin(), m_slots.end(), Slot{});
+		m_next_order = 0;
+		m_min_x = INT32_MAX;
+		m_max_x = INT32_MIN;
+		m_min_y = INT32_MAX;
+		m_max_y = INT32_MIN;
+		m_bounds_dirty = false;
+		m_built = false;
+	}
+	void GameObjectSpatialGrid::insert(GameObject* const object) {
+		if (!m_built) {
+			return;
+		}
+		if (object->id >= m_slots.size()) {
+			m_slots.resize(object->id + 1);
+		}
+		auto& slot = m_slots[object->id];
+		assert(!slot.present);
+		attach(slot, Entry{ .order = m_next_order, .object = object }, toCell(object->x), toCell(object->y));
+		m_next_order += 1;
+	}
+	void GameObjectSpatialGrid::remove(GameObject* const object) {
+		if (!m_built || object->id >= m_slots.size()) {
+			return;
+		}
+		auto& slot = m_slots[object->id];
+		if (slot.present) {
+			detach(slot);
+			slot.present = false;
+		}
+	}
+	void GameObjectSpatialGrid::refreshBounds() {
+		if (!m_bounds_dirty) {
+			return;
+		}
+		m_bounds_dirty = false;
+		m_min_x = INT32_MAX;
+		m_max_x = INT32_MIN;
+		m_min_y = INT32_MAX;
+		m_max_y = INT32_MIN;
+		for (auto const& [key, entries] : m_cells) {
+			m_min_x = std::min(m_min_x, getCellX(key));
+			m_max_x = std::max(m_max_x, getCellX(key));
+			m_min_y = std::min(m_min_y, getCellY(key));
+			m_max_y = std::max(m_max_y, getCellY(key));
+		}
+	}
+	void GameObjectSpatialGrid::move(Slot& slot, GameObject* const object, int32_t const cx, int32_t const cy) {
+		auto const order = detach(slot);
+		attach(slot, Entry{ .order = order, .object = object }, cx, cy);
+	}
+	uint64_t GameObjectSpatialGrid::detach(Slot const& slot) {
+		auto const it = m_cells.find(slot.cell);
+		assert(it != m_cells.end());
+		auto& entries = it->second;
+		auto const order = entries[slot.index].order;
+		if (slot.index + 1 != entries.size()) {
+			// 用最后一个对象填补空位，格子内的顺序不重要，查询结果会按 order 排序
+			entries[slot.index] = entries.back();
+			m_slots[entries[slot.index].object->id].index = slot.index;
+		}
+		entries.pop_back();
+		if (entries.empty()) {
+			int32_t const cx = getCellX(slot.cell);
+			int32_t const cy = getCellY(slot.cell);
+			if (cx == m_min_x || cx == m_max_x || cy == m_min_y || cy == m_max_y) {
+				m_bounds_dirty = true;
+			}
+			m_cells.erase(it);
+		}
+		return order;
+	}
+	void GameObjectSpatialGrid::attach(Slot& slot, Entry const& entry, int32_t const cx, int32_t const cy) {
+		slot.cell = makeKey(cx, cy);
+		auto& entries = m_cells[slot.cell];
+		slot.index = static_cast<uint32_t>(entries.size());
+		slot.present = true;
+		entries.push_back(entry);
+		m_min_x = std::min(m_min_x, cx);
+		m_max_x = std::max(m_max_x, cx);
+		m_min_y = std::min(m_min_y, cy);
+		m_max_y = std::max(m_max_y, cy);
+	}
+	int32_t GameObjectSpatialGrid::toCell(double const value) const noexcept {
+		double const cell = std::floor(value * m_inv_cell_size);
+		if (!(cell > -static_cast<double>(max_cell_coordinate))) {
+			return -max_cell_coordinate; // 包括 NaN
+		}
+		if (cell > static_cast<double>(max_cell_coordinate)) {
+			return max_cell_coordinate;
+		}
+		return static_cast<int32_t>(cell);
+	}
+	int32_t GameObjectSpatialGrid::getMinRing(int32_t const cx, int32_t const cy) const noexcept {
+		return std::max({ 0, m_min_x - cx, cx - m_max_x, m_min_y - cy, cy - m_max_y });
+	}
+	int32_t GameObjectSpatialGrid::getMaxRing(int32_t const cx, int32_t const cy) const noexcept {
+		return std::max({ std::abs(cx - m_min_x), std::abs(cx - m_max_x), std::abs(cy - m_min_y), std::abs(cy - m_max_y) });
+	}
+
+	// GameObjectPool
+
+	GameObjectSpatialGrid const& GameObjectPool::getSpatialGrid(int64_t const group) {
+		bool const is_group = group >= 0 && group < LOBJPOOL_GROUPN;
+		auto& grid = m_spatial_grids[is_group ? static_cast<size_t>(group) : LOBJPOOL_GROUPN];
+		if (!grid.isBuilt()) {
+			// 包括非活跃的对象，它们的状态还可能改回来，查询时再过滤
+			m_spatial_objects.clear();
+			forEachObjectInList(group, [this](GameObject* const p) {
+				m_spatial_objects.push_back(p);
+			});
+			grid.build(m_spatial_objects, m_spatial_cell_size);
+		}
+		grid.refreshBounds();
+		return grid;
+	}
+
+	void GameObjectPool::setSpatialGridCellSize(double const size) {
+		if (size > 0.0 && size != m_spatial_cell_size) {
+			m_spatial_cell_size = size;
+			invalidateSpatialGrid();
+		}
+	}
+	void GameObjectPool::queryCircle(int64_t const group, double const x, double const y, double const radius, std::vector<GameObject*>& output) {
+		output.clear();
+		m_spatial_results.clear();
+		double const r = std::abs(radius);
+		double const radius_squared = r * r;
+		getSpatialGrid(group).forEachInRect(x - r, x + r, y - r, y + r, [&](GameObjectSpatialGrid::Entry const& entry) {
+			auto const p = entry.object;
+			if (p->status != GameObjectStatus::Active) {
+				return;
+			}
+			double const dx = p->x - x;
+			double const dy = p->y - y;
+			if (dx * dx + dy * dy <= radius_squared) {
+				m_spatial_results.push_back(entry);
+			}
+		});
+		std::sort(m_spatial_results.begin(), m_spatial_results.end(), &compareEntryOrder);
+		for (auto const& entry : m_spatial_results) {
+			output.push_back(entry.object);
+		}
+	}
+	void GameObjectPool::queryRect(int64_t const group, double const l, double const r, double const b, double const t, std::vector<GameObject*>& output) {
+		output.clear();
+		m_spatial_results.clear();
+		getSpatialGrid(group).forEachInRect(l, r, b, t, [&](GameObjectSpatialGrid::Entry const& entry) {
+			auto const p = entry.object;
+			if (p->status == GameObjectStatus::Active && p->isInRect(l, r, b, t)) {
+				m_spatial_results.push_back(entry);
+			}
+		});
+		std::sort(m_spatial_results.begin(), m_spatial_results.end(), &compareEntryOrder);
+		for (auto const& entry : m_spatial_results) {
+			output.push_back(entry.object);
+		}
+	}
+	void GameObjectPool::queryNearest(int64_t const group, double const x, double const y, size_t const k, double const max_distance, std::vector<GameObject*>& output) {
+		output.clear();
+		if (k == 0) {
+			return;
+		}
+		auto const& grid = getSpatialGrid(group);
+		if (grid.empty()) {
+			return;
+		}
+
+		struct Candidate {
+			double distance_squared{};
+			uint64_t order{};
+			GameObject* object{};
+		};
+		auto const compare = [](Candidate const& a, Candidate const& b) {
+			if (a.distance_squared != b.distance_squared) {
+				return a.distance_squared < b.distance_squared;
+			}
+			return a.order < b.order;
+		};
+
+		std::vector<Candidate> candidates;
+		double const max_distance_squared = max_distance * max_distance;
+		double const cell_size = grid.getCellSize();
+		int32_t const cx = grid.toCell(x);
+		int32_t const cy = grid.toCell(y);
+		int32_t const max_ring = grid.getMaxRing(cx, cy);
+		for (int32_t ring = grid.getMinRing(cx, cy); ring <= max_ring; ring += 1) {
+			// 环上任意一点到 (x, y) 的距离都不小于 (ring - 1) 个格子
+			double const lower_bound = static_cast<double>(ring - 1) * cell_size;
+			if (ring > 0 && lower_bound > max_distance) {
+				break;
+			}
+			if (ring > 0 && candidates.size() >= k && lower_bound * lower_bound > candidates[k - 1].distance_squared) {
+				break;
+			}
+			grid.forEachInRing(cx, cy, ring, [&](GameObjectSpatialGrid::Entry const& entry) {
+				auto const p = entry.object;
+				if (p->status != GameObjectStatus::Active) {
+					return;
+				}
+				double const dx = p->x - x;
+				double const dy = p->y - y;
+				double const distance_squared = dx * dx + dy * dy;
+				if (distance_squared <= max_distance_squared) {
+					candidates.push_back(Candidate{ .distance_squared = distance_squared, .order = entry.order, .object = p });
+				}
+			});
+			std::sort(candidates.begin(), candidates.end(), compare);
+			if (candidates.size() > k) {
+				candidates.resize(k);
+			}
+		}
+		for (auto const& candidate : candidates) {
+			output.push_back(candidate.object);
+		}
+	}
+	void GameObjectPool::querySegment(int64_t const group, double const x1, double const y1, double const x2, double const y2, double const half_width, std::vector<GameObject*>& output) {
+		output.clear();
+
+		struct Candidate {
+			double t{};
+			uint64_t order{};
+			GameObject* object{};
+		};
+
+		std::vector<Candidate> candidates;
+		double const w = std::abs(half_width);
+		double const w_squared = w * w;
+		double const sx = x2 - x1;
+		double const sy = y2 - y1;
+		double const length_squared = sx * sx + sy * sy;
+		getSpatialGrid(group).forEachInRect(
+			std::min(x1, x2) - w, std::max(x1, x2) + w,
+			std::min(y1, y2) - w, std::max(y1, y2) + w,
+			[&](GameObjectSpatialGrid::Entry const& entry) {
+				auto const p = entry.object;
+				if (p->status != GameObjectStatus::Active) {
+					return;
+				}
+				// 投影到线段上，再计算到最近点的距离
+				double t = 0.0;
+				if (length_squared > 0.0) {
+					t = std::clamp(((p->x - x1) * sx + (p->y - y1) * sy) / length_squared, 0.0, 1.0);
+				}
+				double const dx = p->x - (x1 + sx * t);
+				double const dy = p->y - (y1 + sy * t);
+				if (dx * dx + dy * dy <= w_squared) {
+					candidates.push_back(Candidate{ .t = t, .order = entry.order, .object = p });
+				}
+			});
+		std::sort(candidates.begin(), candidates.end(), [](Candidate const& a, Candidate const& b) {
+			if (a.t != b.t) {
+				return a.t < b.t;
+			}
+			return a.order < b.order;
+		});
+		for (auto const& candidate : candidates) {
+			output.push_back(candidate.object);
+		}
+	}
+}
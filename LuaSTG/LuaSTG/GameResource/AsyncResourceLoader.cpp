@@ -1,7 +1,9 @@
 #include "GameResource/AsyncResourceLoader.hpp"
+#include "GameResource/AudioSampleCache.hpp"
 #include "core/FileSystem.hpp"
 #include "utf8.hpp"
 
+#include <algorithm>
 #include <cstring>
 #include <filesystem>
 #include <string_view>
@@ -23,6 +25,14 @@ namespace luastg {
 				|| state == AsyncResourceJobState::Cancelled;
 		}
 
+		template<typename TimePoint>
+		double durationMs(TimePoint const from, TimePoint const to) {
+			if (from == TimePoint{} || to < from) {
+				return 0.0;
+			}
+			return std::chrono::duration<double, std::milli>(to - from).count();
+		}
+
 		bool readHgeFontTexturePath(core::IData* const data, std::string& texture) {
 			if (!data) {
 				return false;
@@ -72,14 +82,16 @@ namespace luastg {
 		}
 	}
 
-	AsyncResourceJob::AsyncResourceJob(std::string_view const path)
+	AsyncResourceJob::AsyncResourceJob(std::string_view const path, AsyncResourcePriority const priority)
 		: m_kind(AsyncResourceJobKind::FileRead)
+		, m_priority(priority)
 		, m_file_path(path)
 		, m_debug_files{ std::string(path) } {
 	}
 
 	AsyncResourceJob::AsyncResourceJob(AsyncResourceRequest request)
 		: m_kind(AsyncResourceJobKind::Resource)
+		, m_priority(request.priority)
 		, m_request(std::move(request)) {
 		auto const add_file = [this](std::string_view const path) {
 			if (!path.empty()) {
@@ -156,6 +168,16 @@ namespace luastg {
 		return isTerminal(m_state);
 	}
 
+	AsyncResourcePriority AsyncResourceJob::getPriority() const {
+		std::lock_guard const lock(m_mutex);
+		return m_priority;
+	}
+
+	void AsyncResourceJob::setPriority(AsyncResourcePriority const priority) {
+		std::lock_guard const lock(m_mutex);
+		m_priority = priority;
+	}
+
 	bool AsyncResourceJob::cancel() {
 		std::lock_guard const lock(m_mutex);
 		if (isTerminal(m_state)) {
@@ -164,6 +186,7 @@ namespace luastg {
 		m_cancel_requested = true;
 		if (m_state == AsyncResourceJobState::Queued || m_state == AsyncResourceJobState::Ready) {
 			m_state = AsyncResourceJobState::Cancelled;
+			m_end_time = Clock::now();
 		}
 		return true;
 	}
@@ -185,9 +208,22 @@ namespace luastg {
 		info.state = m_state;
 		info.resource_type = m_request.type;
 		info.pool_id = m_request.pool_id;
+		info.priority = m_priority;
 		info.resource_name = m_request.name;
 		info.files = m_debug_files;
 		info.error = m_error;
+		info.dependency_count = m_request.dependencies.size();
+		info.worker = m_worker;
+
+		auto const end = isTerminal(m_state) ? m_end_time : Clock::now();
+		auto const started = m_start_time != Clock::time_point{};
+		auto const ready = m_ready_time != Clock::time_point{};
+		auto const finalizing = m_finalize_time != Clock::time_point{};
+		info.queued_ms = durationMs(m_submit_time, started ? m_start_time : end);
+		info.running_ms = durationMs(m_start_time, ready ? m_ready_time : end);
+		info.waiting_ms = durationMs(m_ready_time, finalizing ? m_finalize_time : end);
+		info.finalize_ms = durationMs(m_finalize_time, end);
+		info.total_ms = durationMs(m_submit_time, end);
 		return info;
 	}
 
@@ -196,6 +232,39 @@ namespace luastg {
 		return m_cancel_requested || m_state == AsyncResourceJobState::Cancelled;
 	}
 
+	AsyncResourceJob::DependencyState AsyncResourceJob::getDependencyState(std::string& error) const {
+		// Dependencies are fixed at construction, no lock needed
+		auto result = DependencyState::Done;
+		for (auto const& dependency : m_request.dependencies) {
+			if (!dependency) {
+				continue;
+			}
+			switch (dependency->getState()) {
+			case AsyncResourceJobState::Done:
+				break;
+			case AsyncResourceJobState::Failed:
+				error = "dependency '";
+				error.append(dependency->getDisplayName());
+				error.append("' failed");
+				return DependencyState::Failed;
+			case AsyncResourceJobState::Cancelled:
+				error = "dependency '";
+				error.append(dependency->getDisplayName());
+				error.append("' was cancelled");
+				return DependencyState::Failed;
+			default:
+				result = DependencyState::Waiting;
+				break;
+			}
+		}
+		return result;
+	}
+
+	std::string_view AsyncResourceJob::getDisplayName() const {
+		// Both are fixed at construction
+		return m_kind == AsyncResourceJobKind::FileRead ? std::string_view(m_file_path) : std::string_view(m_request.name);
+	}
+
 	void AsyncResourceJob::setState(AsyncResourceJobState const state) {
 		std::lock_guard const lock(m_mutex);
 		if (m_cancel_requested && !isTerminal(state)) {
@@ -204,10 +273,31 @@ namespace luastg {
 		else {
 			m_state = state;
 		}
+		if (m_state == AsyncResourceJobState::Ready) {
+			m_ready_time = Clock::now();
+		}
+		else if (isTerminal(m_state) && m_end_time == Clock::time_point{}) {
+			m_end_time = Clock::now();
+		}
+	}
+
+	void AsyncResourceJob::start(int32_t const worker) {
+		{
+			std::lock_guard const lock(m_mutex);
+			m_worker = worker;
+			m_start_time = Clock::now();
+		}
+		setState(AsyncResourceJobState::Running);
+	}
+
+	void AsyncResourceJob::beginFinalize() {
+		std::lock_guard const lock(m_mutex);
+		m_finalize_time = Clock::now();
 	}
 
 	void AsyncResourceJob::fail(std::string_view const message) {
 		std::lock_guard const lock(m_mutex);
+		m_end_time = Clock::now();
 		if (m_cancel_requested) {
 			m_state = AsyncResourceJobState::Cancelled;
 			return;
@@ -218,6 +308,7 @@ namespace luastg {
 
 	void AsyncResourceJob::finish() {
 		std::lock_guard const lock(m_mutex);
+		m_end_time = Clock::now();
 		m_state = m_cancel_requested ? AsyncResourceJobState::Cancelled : AsyncResourceJobState::Done;
 	}
 
@@ -231,28 +322,45 @@ namespace luastg {
 		}
 	}
 
-	AsyncResourceLoader::AsyncResourceLoader() {
-		m_worker = std::thread(&AsyncResourceLoader::workerMain, this);
+	AsyncResourceLoader::AsyncResourceLoader(AudioSampleCache& sample_cache, uint32_t worker_count) : m_sample_cache(sample_cache) {
+		if (worker_count == 0) {
+			// Leave a core to the main thread, loading is mostly bound by storage beyond a few workers,
+			// but keep a second worker so prefetch jobs can run next to the one reserved for other jobs
+			auto const concurrency = std::thread::hardware_concurrency();
+			worker_count = std::clamp(concurrency > 1 ? concurrency - 1 : 1u, 2u, 4u);
+		}
+		m_worker_count = worker_count;
+		m_workers.reserve(worker_count);
+		for (uint32_t i = 0; i < worker_count; i += 1) {
+			m_workers.emplace_back(&AsyncResourceLoader::workerMain, this, static_cast<int32_t>(i));
+		}
 	}
 
 	AsyncResourceLoader::~AsyncResourceLoader() {
 		stop();
 	}
 
+	uint32_t AsyncResourceLoader::getWorkerCount() const noexcept {
+		return m_worker_count;
+	}
+
 	void AsyncResourceLoader::stop() noexcept {
 		cancelAll();
 		{
 			std::lock_guard const lock(m_mutex);
 			m_exit = true;
 		}
-		m_cv.notify_one();
-		if (m_worker.joinable()) {
-			m_worker.join();
+		m_cv.notify_all();
+		for (auto& worker : m_workers) {
+			if (worker.joinable()) {
+				worker.join();
+			}
 		}
+		m_workers.clear();
 	}
 
-	std::shared_ptr<AsyncResourceJob> AsyncResourceLoader::submitFileRead(std::string_view const path) {
-		auto job = std::shared_ptr<AsyncResourceJob>(new AsyncResourceJob(path));
+	std::shared_ptr<AsyncResourceJob> AsyncResourceLoader::submitFileRead(std::string_view const path, AsyncResourcePriority const priority) {
+		auto job = std::shared_ptr<AsyncResourceJob>(new AsyncResourceJob(path, priority));
 		{
 			std::lock_guard const lock(m_mutex);
 			if (m_exit) {
@@ -281,6 +389,14 @@ namespace luastg {
 		return job;
 	}
 
+	void AsyncResourceLoader::setPriority(AsyncResourceJob& job, AsyncResourcePriority const priority) {
+		{
+			std::lock_guard const lock(m_mutex);
+			job.setPriority(priority);
+		}
+		m_cv.notify_all();
+	}
+
 	std::shared_ptr<AsyncResourceJob> AsyncResourceLoader::submitFailedResource(AsyncResourceRequest request, std::string_view const message) {
 		auto job = std::shared_ptr<AsyncResourceJob>(new AsyncResourceJob(std::move(request)));
 		job->fail(message);
@@ -304,13 +420,22 @@ namespace luastg {
 		return result;
 	}
 
-	void AsyncResourceLoader::cancel(ResourcePoolId const pool_id) noexcept {
+	AsyncResourceFinalizeStatistics AsyncResourceLoader::getFinalizeStatistics() {
 		std::lock_guard const lock(m_mutex);
-		for (auto& job : m_jobs) {
-			if (job && job->getKind() == AsyncResourceJobKind::Resource && job->m_request.pool_id == pool_id) {
-				(void)job->cancel();
+		return m_finalize_statistics;
+	}
+
+	void AsyncResourceLoader::cancel(ResourcePoolId const pool_id) noexcept {
+		{
+			std::lock_guard const lock(m_mutex);
+			for (auto& job : m_jobs) {
+				if (job && job->getKind() == AsyncResourceJobKind::Resource && job->m_request.pool_id == pool_id) {
+					(void)job->cancel();
+				}
 			}
 		}
+		// Jobs of other pools may depend on the cancelled ones
+		m_cv.notify_all();
 	}
 
 	void AsyncResourceLoader::cancelAll() noexcept {
@@ -322,35 +447,93 @@ namespace luastg {
 		}
 	}
 
-	void AsyncResourceLoader::workerMain() {
+	void AsyncResourceLoader::workerMain(int32_t const index) {
 		for (;;) {
 			std::shared_ptr<AsyncResourceJob> job;
 			{
 				std::unique_lock lock(m_mutex);
-				m_cv.wait(lock, [this] { return m_exit || !m_queue.empty(); });
-				if (m_exit) {
-					break;
+				for (;;) {
+					if (m_exit) {
+						return;
+					}
+					job = takeNextLocked();
+					if (job) {
+						break;
+					}
+					m_cv.wait(lock);
 				}
-				job = std::move(m_queue.front());
-				m_queue.pop_front();
 			}
 
+			job->start(index);
+			process(*job);
+			{
+				std::lock_guard const lock(m_mutex);
+				if (job->m_prefetch_slot) {
+					job->m_prefetch_slot = false;
+					m_running_prefetch -= 1;
+				}
+			}
+			if (job->getKind() == AsyncResourceJobKind::Resource && job->getState() == AsyncResourceJobState::Ready) {
+				queueReady(job);
+			}
+			// A finished file read may unblock dependent jobs, a finished prefetch frees its slot
+			m_cv.notify_all();
+		}
+	}
+
+	std::shared_ptr<AsyncResourceJob> AsyncResourceLoader::takeNextLocked() {
+		std::erase_if(m_queue, [](std::shared_ptr<AsyncResourceJob> const& job) {
 			if (!job) {
-				continue;
+				return true;
 			}
 			if (job->isCancelled()) {
 				job->setState(AsyncResourceJobState::Cancelled);
+				return true;
+			}
+			std::string error;
+			if (job->getDependencyState(error) == AsyncResourceJob::DependencyState::Failed) {
+				job->fail(error);
+				return true;
+			}
+			return false;
+		});
+
+		// One worker is always left to urgent and normal jobs, with a single worker prefetch jobs wait for promotion
+		size_t const prefetch_limit = m_worker_count - 1;
+		size_t best = m_queue.size();
+		auto best_priority = AsyncResourcePriority::Prefetch;
+		for (size_t i = 0; i < m_queue.size(); i += 1) {
+			auto const priority = m_queue[i]->getPriority();
+			if (best < m_queue.size() && priority >= best_priority) {
 				continue;
 			}
-			process(*job);
-			if (job->getKind() == AsyncResourceJobKind::Resource && job->getState() == AsyncResourceJobState::Ready) {
-				queueReady(job);
+			if (priority == AsyncResourcePriority::Prefetch && m_running_prefetch >= prefetch_limit) {
+				continue;
+			}
+			std::string error;
+			if (m_queue[i]->getDependencyState(error) != AsyncResourceJob::DependencyState::Done) {
+				continue;
+			}
+			best = i;
+			best_priority = priority;
+			if (priority == AsyncResourcePriority::Urgent) {
+				break;
 			}
 		}
+		if (best == m_queue.size()) {
+			return nullptr;
+		}
+
+		auto job = std::move(m_queue[best]);
+		m_queue.erase(m_queue.begin() + static_cast<ptrdiff_t>(best));
+		if (best_priority == AsyncResourcePriority::Prefetch) {
+			job->m_prefetch_slot = true;
+			m_running_prefetch += 1;
+		}
+		return job;
 	}
 
 	void AsyncResourceLoader::process(AsyncResourceJob& job) {
-		job.setState(AsyncResourceJobState::Running);
 		if (job.isCancelled()) {
 			job.setState(AsyncResourceJobState::Cancelled);
 			return;
@@ -369,6 +552,13 @@ namespace luastg {
 		auto& request = job.m_request;
 		switch (request.type) {
 		case AsyncResourceRequestType::Texture:
+			// Decoding and mipmap generation happen here, finalize only uploads the levels
+			if (!readTexture(request.path, request.mipmap, job.m_prepared_texture)) {
+				job.fail("failed to read file");
+				return;
+			}
+			break;
+
 		case AsyncResourceRequestType::Video:
 		case AsyncResourceRequestType::FX:
 		case AsyncResourceRequestType::Model:
@@ -379,6 +569,18 @@ namespace luastg {
 			break;
 
 		case AsyncResourceRequestType::Sound:
+			if (!readFile(request.path, job.m_data, error)) {
+				job.fail(error);
+				return;
+			}
+			// Sound effects are decoded to PCM here, finalize only creates the resource
+			if (!m_sample_cache.getOrCreate(job.m_data.get(), job.m_audio_sample.put())) {
+				job.fail("failed to decode audio");
+				return;
+			}
+			job.m_data.reset();
+			break;
+
 		case AsyncResourceRequestType::Music:
 			if (!readFile(request.path, job.m_data, error)) {
 				job.fail(error);
@@ -469,7 +671,9 @@ namespace luastg {
 		m_ready.emplace_back(job);
 	}
 
-	void AsyncResourceLoader::update(ResourceMgr& manager, size_t const max_count) {
+	void AsyncResourceLoader::update(ResourceMgr& manager, size_t const max_count, std::chrono::microseconds const budget) {
+		using Microseconds = std::chrono::duration<double, std::micro>;
+		auto const start = std::chrono::steady_clock::now();
 		size_t count = 0;
 		while (count < max_count) {
 			std::shared_ptr<AsyncResourceJob> job;
@@ -478,8 +682,21 @@ namespace luastg {
 				if (m_ready.empty()) {
 					break;
 				}
-				job = std::move(m_ready.front());
-				m_ready.pop_front();
+				// Most urgent first, the oldest one among equals
+				auto it = std::min_element(m_ready.begin(), m_ready.end(), [](auto const& a, auto const& b) {
+					auto const pa = a ? a->getPriority() : AsyncResourcePriority::Urgent;
+					auto const pb = b ? b->getPriority() : AsyncResourcePriority::Urgent;
+					return pa < pb;
+				});
+				if (budget.count() > 0 && count > 0 && *it) {
+					auto const& cost = m_finalize_statistics.costs[static_cast<size_t>((*it)->m_request.type)];
+					auto const spent = Microseconds(std::chrono::steady_clock::now() - start);
+					if (spent + Microseconds(cost.estimate_us) > budget) {
+						break;
+					}
+				}
+				job = std::move(*it);
+				m_ready.erase(it);
 			}
 			if (!job || job->isFinished()) {
 				continue;
@@ -488,11 +705,31 @@ namespace luastg {
 				job->setState(AsyncResourceJobState::Cancelled);
 				continue;
 			}
+			job->beginFinalize();
+			auto const finalize_start = std::chrono::steady_clock::now();
 			if (finalize(manager, *job)) {
 				job->finish();
+				// Failures return early and would drag the estimate down
+				auto const elapsed = Microseconds(std::chrono::steady_clock::now() - finalize_start).count();
+				std::lock_guard const lock(m_mutex);
+				auto& cost = m_finalize_statistics.costs[static_cast<size_t>(job->m_request.type)];
+				cost.estimate_us = cost.samples == 0 ? elapsed : cost.estimate_us + (elapsed - cost.estimate_us) * 0.25;
+				cost.last_us = elapsed;
+				cost.samples += 1;
 			}
 			++count;
 		}
+		if (std::lock_guard const lock(m_mutex); count > 0 || !m_ready.empty()) {
+			// Idle updates would hide the last interesting one
+			m_finalize_statistics.budget_us = budget.count();
+			m_finalize_statistics.spent_us = Microseconds(std::chrono::steady_clock::now() - start).count();
+			m_finalize_statistics.finalized = count;
+			m_finalize_statistics.deferred = m_ready.size();
+		}
+		if (count > 0) {
+			// Finished jobs may unblock the jobs depending on them
+			m_cv.notify_all();
+		}
 
 		std::lock_guard const lock(m_mutex);
 		for (auto it = m_jobs.begin(); it != m_jobs.end();) {
@@ -529,12 +766,41 @@ namespace luastg {
 			return false;
 		}
 
+		// Textures and sprites created by dependencies, they are all done at this point
+		for (auto const& dependency : request.dependencies) {
+			if (!dependency || dependency->m_kind != AsyncResourceJobKind::Resource) {
+				continue;
+			}
+			auto const& dependency_request = dependency->m_request;
+			auto* dependency_pool = manager.GetResourcePool(dependency_request.pool_id);
+			if (!dependency_pool) {
+				continue;
+			}
+			if (!request.texture && (dependency_request.type == AsyncResourceRequestType::Texture || dependency_request.type == AsyncResourceRequestType::Video)) {
+				request.texture = dependency_pool->GetTexture(dependency_request.name);
+			}
+			else if (!request.sprite && dependency_request.type == AsyncResourceRequestType::Sprite) {
+				request.sprite = dependency_pool->GetSprite(dependency_request.name);
+			}
+		}
+		bool const needs_texture = request.type == AsyncResourceRequestType::Sprite
+			|| (request.type == AsyncResourceRequestType::Animation && !request.animation_uses_sprite_list);
+		if (needs_texture && !request.texture) {
+			job.fail("texture is not available");
+			return false;
+		}
+		if (request.type == AsyncResourceRequestType::Particle && !request.sprite) {
+			job.fail("sprite is not available");
+			return false;
+		}
+
 		switch (request.type) {
 		case AsyncResourceRequestType::Texture:
-			if (!pool->LoadTexture(request.name.c_str(), job.m_data.get(), request.path.c_str(), request.mipmap)) {
+			if (!pool->LoadTexture(request.name.c_str(), job.m_prepared_texture, request.path.c_str(), request.mipmap)) {
 				job.fail("failed to load texture");
 				return false;
 			}
+			job.m_prepared_texture = {}; // the texture keeps the source data, decoded pixels are no longer needed
 			break;
 
 		case AsyncResourceRequestType::Video:
@@ -590,7 +856,7 @@ namespace luastg {
 			break;
 
 		case AsyncResourceRequestType::Sound:
-			if (!pool->LoadSoundEffect(request.name.c_str(), job.m_audio_decoder.get(), request.path.c_str())) {
+			if (!pool->LoadSoundEffect(request.name.c_str(), job.m_audio_sample.get(), request.path.c_str())) {
 				job.fail("failed to load sound");
 				return false;
 			}
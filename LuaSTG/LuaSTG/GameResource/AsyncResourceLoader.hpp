@@ -1,10 +1,14 @@
 #pragma once
 #include "GameResource/ResourceManager.h"
+#include "GameResource/TexturePreparer.hpp"
 #include "core/AudioDecoder.hpp"
+#include "core/AudioSample.hpp"
 #include "core/Data.hpp"
 #include "core/SmartReference.hpp"
 #include "core/VideoDecoder.hpp"
 
+#include <array>
+#include <chrono>
 #include <condition_variable>
 #include <cstddef>
 #include <cstdint>
@@ -32,6 +36,15 @@ namespace luastg {
 		Resource,
 	};
 
+	// Workers always pick the most urgent runnable job first, jobs of the same priority run in submission order.
+	// Prefetch jobs never occupy every worker, so urgent and normal jobs don't wait behind them;
+	// with a single worker they wait until a later request raises their priority.
+	enum class AsyncResourcePriority : uint8_t {
+		Urgent,
+		Normal,
+		Prefetch,
+	};
+
 	enum class AsyncResourceRequestType {
 		Texture,
 		Video,
@@ -46,10 +59,16 @@ namespace luastg {
 		Model,
 	};
 
+	inline constexpr size_t AsyncResourceRequestTypeCount = static_cast<size_t>(AsyncResourceRequestType::Model) + 1;
+
 	struct AsyncResourceRequest {
 		AsyncResourceRequestType type{ AsyncResourceRequestType::Texture };
+		AsyncResourcePriority priority{ AsyncResourcePriority::Normal };
 		ResourcePoolId pool_id{ InvalidResourcePoolId };
 		size_t pool_generation{};
+		// The job starts after all dependencies are done and fails if one of them fails.
+		// Sprites, animations and particles without texture or sprite use the one created by a dependency.
+		std::vector<std::shared_ptr<AsyncResourceJob>> dependencies;
 
 		std::string name;
 		std::string path;
@@ -87,10 +106,35 @@ namespace luastg {
 		AsyncResourceJobKind kind{ AsyncResourceJobKind::FileRead };
 		AsyncResourceJobState state{ AsyncResourceJobState::Queued };
 		AsyncResourceRequestType resource_type{ AsyncResourceRequestType::Texture };
+		AsyncResourcePriority priority{ AsyncResourcePriority::Normal };
 		ResourcePoolId pool_id{ InvalidResourcePoolId };
 		std::string resource_name;
 		std::vector<std::string> files;
 		std::string error;
+		size_t dependency_count{};
+		int32_t worker{ -1 };
+		// Milliseconds spent in each stage, stages still in progress count up to now
+		double queued_ms{};
+		double running_ms{};
+		double waiting_ms{};
+		double finalize_ms{};
+		double total_ms{};
+	};
+
+	// Main thread time needed to create one resource of a type, learned from previous finalizations
+	struct AsyncResourceFinalizeCost {
+		double estimate_us{}; // moving average
+		double last_us{};
+		size_t samples{};
+	};
+
+	struct AsyncResourceFinalizeStatistics {
+		std::array<AsyncResourceFinalizeCost, AsyncResourceRequestTypeCount> costs{};
+		// The last update that had something to finalize
+		int64_t budget_us{}; // 0 means only limited by count
+		double spent_us{};
+		size_t finalized{};
+		size_t deferred{}; // ready jobs left for the next update
 	};
 
 	class AsyncResourceJob {
@@ -99,6 +143,9 @@ namespace luastg {
 		AsyncResourceJobState getState() const;
 		char const* getStateName() const;
 		bool isFinished() const;
+		AsyncResourcePriority getPriority() const;
+		// Only affects jobs that are not running yet
+		void setPriority(AsyncResourcePriority priority);
 		bool cancel();
 		std::string getError() const;
 		core::SmartReference<core::IData> getFileData() const;
@@ -107,11 +154,23 @@ namespace luastg {
 	private:
 		friend class AsyncResourceLoader;
 
-		explicit AsyncResourceJob(std::string_view path);
+		using Clock = std::chrono::steady_clock;
+
+		enum class DependencyState {
+			Done,
+			Waiting,
+			Failed,
+		};
+
+		explicit AsyncResourceJob(std::string_view path, AsyncResourcePriority priority);
 		explicit AsyncResourceJob(AsyncResourceRequest request);
 
 		bool isCancelled() const;
+		DependencyState getDependencyState(std::string& error) const;
+		std::string_view getDisplayName() const;
 		void setState(AsyncResourceJobState state);
+		void start(int32_t worker);
+		void beginFinalize();
 		void fail(std::string_view message);
 		void finish();
 		void setSecondaryDebugFile(std::string_view path);
@@ -120,48 +179,71 @@ namespace luastg {
 		mutable std::mutex m_mutex;
 		AsyncResourceJobKind m_kind{ AsyncResourceJobKind::FileRead };
 		AsyncResourceJobState m_state{ AsyncResourceJobState::Queued };
+		AsyncResourcePriority m_priority{ AsyncResourcePriority::Normal };
 		bool m_cancel_requested{};
+		int32_t m_worker{ -1 };
+		Clock::time_point m_submit_time{ Clock::now() };
+		Clock::time_point m_start_time{};
+		Clock::time_point m_ready_time{};
+		Clock::time_point m_finalize_time{};
+		Clock::time_point m_end_time{};
 		std::string m_error;
 		std::string m_file_path;
 		AsyncResourceRequest m_request;
 		std::vector<std::string> m_debug_files;
 
+		bool m_prefetch_slot{}; // guarded by the loader mutex
+
 		core::SmartReference<core::IData> m_data;
 		core::SmartReference<core::IData> m_texture_data;
+		PreparedTexture m_prepared_texture;
 		core::SmartReference<core::IAudioDecoder> m_audio_decoder;
+		core::SmartReference<core::IAudioSample> m_audio_sample;
 		hgeParticleSystemInfo m_particle_info{};
 		std::vector<core::SmartReference<core::IData>> m_font_data;
 	};
 
 	class AsyncResourceLoader {
 	public:
-		AsyncResourceLoader();
+		// worker_count == 0 picks a count from the hardware concurrency, at least 2 so prefetching can run
+		AsyncResourceLoader(AudioSampleCache& sample_cache, uint32_t worker_count);
 		~AsyncResourceLoader();
 
-		std::shared_ptr<AsyncResourceJob> submitFileRead(std::string_view path);
+		uint32_t getWorkerCount() const noexcept;
+		std::shared_ptr<AsyncResourceJob> submitFileRead(std::string_view path, AsyncResourcePriority priority);
 		std::shared_ptr<AsyncResourceJob> submitResource(AsyncResourceRequest request);
 		std::shared_ptr<AsyncResourceJob> submitFailedResource(AsyncResourceRequest request, std::string_view message);
-		void update(ResourceMgr& manager, size_t max_count);
+		// Wakes the workers, a promoted prefetch job may be runnable now
+		void setPriority(AsyncResourceJob& job, AsyncResourcePriority priority);
+		// Finalizes up to max_count ready jobs on the calling thread. With a budget, stops before the next job
+		// whose estimated cost would exceed it, but always finalizes at least one job so nothing starves
+		void update(ResourceMgr& manager, size_t max_count, std::chrono::microseconds budget = {});
 		void cancel(ResourcePoolId pool_id) noexcept;
 		void cancelAll() noexcept;
 		void stop() noexcept;
 		std::vector<AsyncResourceJobDebugInfo> getDebugSnapshot();
+		AsyncResourceFinalizeStatistics getFinalizeStatistics();
 
 	private:
-		void workerMain();
+		void workerMain(int32_t index);
+		std::shared_ptr<AsyncResourceJob> takeNextLocked();
 		void process(AsyncResourceJob& job);
 		bool finalize(ResourceMgr& manager, AsyncResourceJob& job);
 		void queueReady(std::shared_ptr<AsyncResourceJob> const& job);
 		void addHistory(AsyncResourceJobDebugInfo info);
 
 	private:
+		AudioSampleCache& m_sample_cache;
 		std::mutex m_mutex;
 		std::condition_variable m_cv;
 		std::deque<std::shared_ptr<AsyncResourceJob>> m_queue;
 		std::deque<std::shared_ptr<AsyncResourceJob>> m_ready;
 		std::vector<std::shared_ptr<AsyncResourceJob>> m_jobs;
 		std::deque<AsyncResourceJobDebugInfo> m_history;
-		std::thread m_worker;
+		AsyncResourceFinalizeStatistics m_finalize_statistics;
+		std::vector<std::thread> m_workers;
+		uint32_t m_worker_count{};
+		size_t m_running_prefetch{};
 		bool m_exit{};
 	};
 
@@ -0,0 +1,107 @@
+#include "GameResource/AudioSampleCache.hpp"
+#include "core/AudioDecoder.hpp"
+#include "xxhash.h"
+
+#include <algorithm>
+#include <future>
+
+namespace {
+	// Below this, hashing takes less time than starting a thread
+	constexpr size_t background_hash_threshold{ 256 * 1024 };
+}
+
+namespace luastg {
+
+	bool AudioSampleCache::getOrCreate(core::IData* const data, core::IAudioSample** const output, bool const background_hash) {
+		if (data == nullptr || output == nullptr) {
+			return false;
+		}
+
+		core::SmartReference<core::IAudioDecoder> decoder;
+		bool decoder_created{ false };
+		Key key;
+		if (background_hash && data->size() >= background_hash_threshold) {
+			auto hashing = std::async(std::launch::async, &AudioSampleCache::makeKey, data);
+			decoder_created = core::IAudioDecoder::create(data, decoder.put());
+			key = hashing.get();
+		}
+		else {
+			key = makeKey(data);
+		}
+		{
+			std::lock_guard const lock(m_mutex);
+			if (findLocked(key, output)) {
+				m_statistics.hit += 1;
+				return true;
+			}
+		}
+
+		// Decode without holding the lock, other loads must not wait for it
+		core::SmartReference<core::IAudioSample> sample;
+		if (!decoder_created) {
+			decoder_created = core::IAudioDecoder::create(data, decoder.put());
+		}
+		if (!decoder_created || !core::IAudioSample::create(decoder.get(), sample.put())) {
+			std::lock_guard const lock(m_mutex);
+			m_statistics.failed += 1;
+			return false;
+		}
+
+		std::lock_guard const lock(m_mutex);
+		// Someone else decoded the same content meanwhile, keep a single copy alive
+		if (findLocked(key, output)) {
+			m_statistics.hit += 1;
+			return true;
+		}
+		sample->getWeakReference(m_entries[key].put());
+		if (m_entries.size() >= m_trim_threshold) {
+			trimLocked();
+			m_trim_threshold = std::max<size_t>(64, m_entries.size() * 2);
+		}
+		m_statistics.miss += 1;
+		*output = sample.detach();
+		return true;
+	}
+
+	void AudioSampleCache::trim() {
+		std::lock_guard const lock(m_mutex);
+		trimLocked();
+	}
+
+	AudioSampleCacheStatistics AudioSampleCache::getStatistics() {
+		std::lock_guard const lock(m_mutex);
+		trimLocked();
+		auto statistics = m_statistics;
+		statistics.entries = m_entries.size();
+		return statistics;
+	}
+
+	AudioSampleCache::Key AudioSampleCache::makeKey(core::IData* const data) {
+		auto const hash = XXH3_128bits(data->data(), data->size());
+		Key key;
+		key.hash[0] = hash.low64;
+		key.hash[1] = hash.high64;
+		key.size = data->size();
+		return key;
+	}
+
+	bool AudioSampleCache::findLocked(Key const& key, core::IAudioSample** const output) {
+		auto const it = m_entries.find(key);
+		if (it == m_entries.end()) {
+			return false;
+		}
+		if (!it->second->resolve(output)) {
+			m_entries.erase(it);
+			return false;
+		}
+		return true;
+	}
+
+	void AudioSampleCache::trimLocked() {
+		std::erase_if(m_entries, [](auto const& entry) {
+			core::SmartReference<core::IReferenceCounted> object;
+			return !entry.second->resolve(object.put());
+		});
+	}
+
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include "core/AudioSample.hpp"
+#include "core/Data.hpp"
+#include "core/SmartReference.hpp"
+#include "core/WeakReference.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+
+namespace luastg {
+
+	struct AudioSampleCacheStatistics {
+		size_t entries{};
+		size_t hit{};
+		size_t miss{};
+		size_t failed{};
+	};
+
+	// Decoded sound effect PCM shared by file content, the same file loaded under several names,
+	// paths or resource pools is only decoded and kept in memory once.
+	// Entries only hold weak references, a sample is freed when the last sound effect using it is released.
+	// Content is identified by a 128-bit hash and the size, the encoded bytes are not kept.
+	// Thread safe, the async resource loader decodes through it on its worker thread.
+	class AudioSampleCache {
+	public:
+		AudioSampleCache() = default;
+		AudioSampleCache(AudioSampleCache const&) = delete;
+		AudioSampleCache(AudioSampleCache&&) = delete;
+		~AudioSampleCache() = default;
+
+		AudioSampleCache& operator=(AudioSampleCache const&) = delete;
+		AudioSampleCache& operator=(AudioSampleCache&&) = delete;
+
+		// Returns the cached sample decoded from the same bytes, or decodes data and caches it.
+		// On the main thread pass background_hash, large files are then hashed on another thread
+		// while the decoder reads the header
+		bool getOrCreate(core::IData* data, core::IAudioSample** output, bool background_hash = false);
+		// Drops entries whose sample was already released
+		void trim();
+		AudioSampleCacheStatistics getStatistics();
+
+	private:
+		struct Key {
+			uint64_t hash[2]{};
+			size_t size{};
+
+			bool operator==(Key const&) const noexcept = default;
+		};
+
+		struct KeyHash {
+			size_t operator()(Key const& key) const noexcept { return static_cast<size_t>(key.hash[0]); }
+		};
+
+		static Key makeKey(core::IData* data);
+		bool findLocked(Key const& key, core::IAudioSample** output);
+		void trimLocked();
+
+	private:
+		std::mutex m_mutex;
+		std::unordered_map<Key, core::SmartReference<core::IWeakReference>, KeyHash> m_entries;
+		AudioSampleCacheStatistics m_statistics;
+		size_t m_trim_threshold{ 64 };
+	};
+
+}
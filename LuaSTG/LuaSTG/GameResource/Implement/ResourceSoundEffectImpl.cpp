@@ -1,4 +1,5 @@
 #include "GameResource/Implement/ResourceSoundEffectImpl.hpp"
+#include "GameResource/SoundEffectVoicePool.hpp"
 
 namespace luastg {
 	void ResourceSoundEffectImpl::FlushCommand() {
@@ -7,18 +8,16 @@ namespace luastg {
 		case CommandType::none:
 			break;
 		case CommandType::play:
-			m_player->setVolume(m_last_command.vol);
-			m_player->setBalance(m_last_command.pan);
-			m_player->play(0.0);
+			m_voice_pool->play(this, m_sample.get(), m_last_command.vol, m_last_command.pan, m_speed, m_polyphony, m_priority);
 			break;
 		case CommandType::pause:
-			m_player->pause();
+			m_voice_pool->pause(this);
 			break;
 		case CommandType::resume:
-			m_player->resume();
+			m_voice_pool->resume(this);
 			break;
 		case CommandType::stop:
-			m_player->stop();
+			m_voice_pool->stop(this);
 			break;
 		}
 		// clear
@@ -27,7 +26,7 @@ namespace luastg {
 		m_last_command.pan = 0.0f;
 		// read state
 		if (m_state != core::AudioPlayerState::stopped) {
-			if (m_player->getState() == core::AudioPlayerState::stopped) {
+			if (m_voice_pool->getVoiceCount(this) == 0) {
 				m_state = core::AudioPlayerState::stopped;
 			}
 		}
@@ -56,11 +55,24 @@ namespace luastg {
 	}
 	bool ResourceSoundEffectImpl::IsPlaying() { return m_state == core::AudioPlayerState::playing; }
 	bool ResourceSoundEffectImpl::IsStopped() { return m_state == core::AudioPlayerState::stopped; }
-	bool ResourceSoundEffectImpl::SetSpeed(float const speed) { return m_player->setSpeed(speed); }
-	float ResourceSoundEffectImpl::GetSpeed() { return m_player->getSpeed(); }
+	bool ResourceSoundEffectImpl::SetSpeed(float const speed) {
+		m_speed = speed;
+		m_voice_pool->setSpeed(this, speed);
+		return true;
+	}
+	float ResourceSoundEffectImpl::GetSpeed() { return m_speed; }
+	void ResourceSoundEffectImpl::SetPolyphony(uint32_t const polyphony) { m_polyphony = polyphony > 0 ? polyphony : 1; }
+	uint32_t ResourceSoundEffectImpl::GetPolyphony() { return m_polyphony; }
+	void ResourceSoundEffectImpl::SetPriority(int32_t const priority) { m_priority = priority; }
+	int32_t ResourceSoundEffectImpl::GetPriority() { return m_priority; }
+	uint32_t ResourceSoundEffectImpl::GetVoiceCount() { return m_voice_pool->getVoiceCount(this); }
 
-	ResourceSoundEffectImpl::ResourceSoundEffectImpl(const char* name, core::IAudioPlayer* p_player)
+	ResourceSoundEffectImpl::ResourceSoundEffectImpl(const char* name, core::IAudioSample* p_sample, SoundEffectVoicePool* p_voice_pool)
 		: ResourceBaseImpl(ResourceType::SoundEffect, name)
-		, m_player(p_player) {
+		, m_sample(p_sample)
+		, m_voice_pool(p_voice_pool) {
+	}
+	ResourceSoundEffectImpl::~ResourceSoundEffectImpl() {
+		m_voice_pool->release(this);
 	}
 }
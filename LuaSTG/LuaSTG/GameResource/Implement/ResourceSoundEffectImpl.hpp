@@ -3,8 +3,11 @@
 #include "GameResource/ResourceSoundEffect.hpp"
 #include "GameResource/Implement/ResourceBaseImpl.hpp"
 #include "core/AudioPlayer.hpp"
+#include "core/AudioSample.hpp"
 
 namespace luastg {
+	class SoundEffectVoicePool;
+
 	class ResourceSoundEffectImpl final : public ResourceBaseImpl<IResourceSoundEffect> {
 	public:
 		void FlushCommand() override;
@@ -16,8 +19,14 @@ namespace luastg {
 		bool IsStopped() override;
 		bool SetSpeed(float speed) override;
 		float GetSpeed() override;
+		void SetPolyphony(uint32_t polyphony) override;
+		uint32_t GetPolyphony() override;
+		void SetPriority(int32_t priority) override;
+		int32_t GetPriority() override;
+		uint32_t GetVoiceCount() override;
 
-		ResourceSoundEffectImpl(const char* name, core::IAudioPlayer* p_player);
+		ResourceSoundEffectImpl(const char* name, core::IAudioSample* p_sample, SoundEffectVoicePool* p_voice_pool);
+		~ResourceSoundEffectImpl() override;
 
 	private:
 		enum class CommandType : uint8_t {
@@ -34,8 +43,12 @@ namespace luastg {
 			float pan{ 0.0f };
 		};
 
-		core::SmartReference<core::IAudioPlayer> m_player;
+		core::SmartReference<core::IAudioSample> m_sample;
+		SoundEffectVoicePool* m_voice_pool{};
 		core::AudioPlayerState m_state{ core::AudioPlayerState::stopped };
 		Command m_last_command;
+		float m_speed{ 1.0f };
+		uint32_t m_polyphony{ 1 };
+		int32_t m_priority{};
 	};
 }
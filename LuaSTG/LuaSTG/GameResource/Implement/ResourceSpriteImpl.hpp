@@ -13,6 +13,7 @@ namespace luastg
 		double m_HalfSizeX = 0.0;
 		double m_HalfSizeY = 0.0;
 		bool m_bRectangle = false;
+		core::Vector2F m_TextureAtlasOffset;
 	public:
 		core::Graphics::ISprite* GetSprite() { return m_sprite.get(); }
 		BlendMode GetBlendMode() { return m_BlendMode; }
@@ -24,6 +25,8 @@ namespace luastg
 		void Render(float x, float y, float rot, float hscale, float vscale, float z);
 		void Render(float x, float y, float rot, float hscale, float vscale, BlendMode blend, core::Color4B color, float z);
 		void Render4V(float x1, float y1, float z1, float x2, float y2, float z2, float x3, float y3, float z3, float x4, float y4, float z4);
+		core::Vector2F GetTextureAtlasOffset() { return m_TextureAtlasOffset; }
+		void SetTextureAtlasOffset(core::Vector2F const& offset) { m_TextureAtlasOffset = offset; }
 	public:
 		ResourceSpriteImpl(const char* name, core::Graphics::ISprite* sprite, double hx, double hy, bool rect);
 	};
@@ -56,6 +56,10 @@ namespace luastg {
 	}
 
 	ResourceVideoImpl::~ResourceVideoImpl() {
+		// recorded uploads still point at this object
+		if (auto const model = LAPP.GetAppModel(); model) {
+			model->synchronizeRenderThread();
+		}
 		{
 			std::lock_guard const lock(m_worker_mutex);
 			m_worker_exit = true;
@@ -80,6 +84,31 @@ namespace luastg {
 			frame.pitch);
 	}
 
+	void ResourceVideoImpl::scheduleUpload(core::VideoFrame&& frame) {
+		{
+			std::lock_guard const lock(m_upload_mutex);
+			m_upload_frame = std::move(frame);
+			if (m_upload_scheduled) {
+				return; // the pending upload picks up the newer frame
+			}
+			m_upload_scheduled = true;
+		}
+		LAPP.GetAppModel()->executeOnRenderThread([](void* const userdata, core::Graphics::IRenderer*) {
+			static_cast<ResourceVideoImpl*>(userdata)->uploadScheduledFrame();
+		}, this);
+	}
+
+	void ResourceVideoImpl::uploadScheduledFrame() {
+		core::VideoFrame frame;
+		{
+			std::lock_guard const lock(m_upload_mutex);
+			frame = std::move(m_upload_frame);
+			m_upload_frame = {};
+			m_upload_scheduled = false;
+		}
+		(void)uploadFrame(frame);
+	}
+
 	bool ResourceVideoImpl::uploadFrameAtCurrentTime() {
 		if (!m_decoder->seek(m_time)) {
 			return false;
@@ -237,7 +266,7 @@ namespace luastg {
 				}
 			}
 			if (has_frame_to_upload) {
-				(void)uploadFrame(frame_to_upload);
+				scheduleUpload(std::move(frame_to_upload));
 			}
 			return;
 		}
@@ -278,7 +307,7 @@ namespace luastg {
 		}
 
 		if (has_frame_to_upload) {
-			(void)uploadFrame(frame_to_upload);
+			scheduleUpload(std::move(frame_to_upload));
 		}
 		if (m_state == VideoPlaybackState::Ended) {
 			std::lock_guard const lock(m_worker_mutex);
@@ -37,6 +37,8 @@ namespace luastg {
 		void initialize();
 		bool uploadFrame(core::VideoFrame const& frame);
 		bool uploadFrameAtCurrentTime();
+		void scheduleUpload(core::VideoFrame&& frame);
+		void uploadScheduledFrame();
 		void requestWorkerSeek(double seconds, bool decode_one_frame);
 		void workerMain();
 
@@ -63,5 +65,11 @@ namespace luastg {
 		bool m_force_upload_next_frame{ false };
 		double m_worker_seek_time{ 0.0 };
 		uint64_t m_worker_serial{ 0 };
+
+		// pipelined rendering replays the previous frame while this one updates,
+		// so frame uploads are recorded and run on the render thread in order
+		std::mutex m_upload_mutex;
+		core::VideoFrame m_upload_frame;
+		bool m_upload_scheduled{ false };
 	};
 }
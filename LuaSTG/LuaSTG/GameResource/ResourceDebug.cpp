@@ -41,14 +41,9 @@ static std::string async_resource_pool_name(luastg::ResourceMgr const& manager,
 	return "#" + std::to_string(id) + " (destroyed)";
 }
 
-static char const* async_resource_type_name(luastg::AsyncResourceJobDebugInfo const& info)
+static char const* async_resource_type_name(luastg::AsyncResourceRequestType const type)
 {
-	if (info.kind == luastg::AsyncResourceJobKind::FileRead)
-	{
-		return "File Read";
-	}
-
-	switch (info.resource_type)
+	switch (type)
 	{
 	case luastg::AsyncResourceRequestType::Texture:
 		return "Texture";
@@ -77,6 +72,28 @@ static char const* async_resource_type_name(luastg::AsyncResourceJobDebugInfo co
 	}
 }
 
+static char const* async_resource_type_name(luastg::AsyncResourceJobDebugInfo const& info)
+{
+	if (info.kind == luastg::AsyncResourceJobKind::FileRead)
+	{
+		return "File Read";
+	}
+	return async_resource_type_name(info.resource_type);
+}
+
+static char const* async_resource_priority_name(luastg::AsyncResourcePriority const priority)
+{
+	switch (priority)
+	{
+	case luastg::AsyncResourcePriority::Urgent:
+		return "Urgent";
+	case luastg::AsyncResourcePriority::Prefetch:
+		return "Prefetch";
+	default:
+		return "Normal";
+	}
+}
+
 static char const* async_resource_state_name(luastg::AsyncResourceJobState const state)
 {
 	switch (state)
@@ -264,9 +281,53 @@ namespace luastg
 							}
 							visible_count += 1;
 						}
-						ImGui::Text("Jobs: %zu | Active: %zu | Failed: %zu", visible_count, active_count, failed_count);
+						ImGui::Text("Jobs: %zu | Active: %zu | Failed: %zu | Workers: %u", visible_count, active_count, failed_count, m_AsyncLoader->getWorkerCount());
 
-						if (ImGui::BeginTable("##lstg.AsyncResourceJobs", 6,
+						auto const finalize_statistics = m_AsyncLoader->getFinalizeStatistics();
+						if (m_AsyncFinalizeBudget > 0)
+						{
+							ImGui::Text("Finalize: budget %u us", m_AsyncFinalizeBudget);
+						}
+						else
+						{
+							ImGui::Text("Finalize: up to %zu per frame", m_AsyncFinalizeCount);
+						}
+						ImGui::SameLine();
+						ImGui::TextDisabled("| Last: %zu finalized in %.0f us, %zu deferred",
+							finalize_statistics.finalized, finalize_statistics.spent_us, finalize_statistics.deferred);
+						if (ImGui::TreeNode("Finalize Cost Estimates"))
+						{
+							if (ImGui::BeginTable("##lstg.AsyncResourceFinalizeCost", 4,
+								ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg))
+							{
+								ImGui::TableSetupColumn("Type");
+								ImGui::TableSetupColumn("Estimate (us)");
+								ImGui::TableSetupColumn("Last (us)");
+								ImGui::TableSetupColumn("Samples");
+								ImGui::TableHeadersRow();
+								for (size_t i = 0; i < finalize_statistics.costs.size(); ++i)
+								{
+									auto const& cost = finalize_statistics.costs[i];
+									if (cost.samples == 0)
+									{
+										continue;
+									}
+									ImGui::TableNextRow();
+									ImGui::TableSetColumnIndex(0);
+									ImGui::TextUnformatted(async_resource_type_name(static_cast<AsyncResourceRequestType>(i)));
+									ImGui::TableSetColumnIndex(1);
+									ImGui::Text("%.0f", cost.estimate_us);
+									ImGui::TableSetColumnIndex(2);
+									ImGui::Text("%.0f", cost.last_us);
+									ImGui::TableSetColumnIndex(3);
+									ImGui::Text("%zu", cost.samples);
+								}
+								ImGui::EndTable();
+							}
+							ImGui::TreePop();
+						}
+
+						if (ImGui::BeginTable("##lstg.AsyncResourceJobs", 8,
 							ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_Resizable))
 						{
 							ImGui::TableSetupColumn("Type", ImGuiTableColumnFlags_WidthFixed);
@@ -274,6 +335,8 @@ namespace luastg
 							ImGui::TableSetupColumn("Resource");
 							ImGui::TableSetupColumn("Files");
 							ImGui::TableSetupColumn("Status", ImGuiTableColumnFlags_WidthFixed);
+							ImGui::TableSetupColumn("Priority", ImGuiTableColumnFlags_WidthFixed);
+							ImGui::TableSetupColumn("Time (ms)", ImGuiTableColumnFlags_WidthFixed);
 							ImGui::TableSetupColumn("Details");
 							ImGui::TableHeadersRow();
 
@@ -332,6 +395,17 @@ namespace luastg
 								ImGui::TextColored(async_resource_state_color(job.state), "%s", async_resource_state_name(job.state));
 
 								ImGui::TableSetColumnIndex(5);
+								ImGui::TextUnformatted(async_resource_priority_name(job.priority));
+
+								ImGui::TableSetColumnIndex(6);
+								ImGui::Text("%.2f", job.total_ms);
+								if (ImGui::IsItemHovered())
+								{
+									ImGui::SetTooltip("Queued: %.2f\nWorker #%d: %.2f\nWaiting for main thread: %.2f\nFinalize: %.2f",
+										job.queued_ms, job.worker, job.running_ms, job.waiting_ms, job.finalize_ms);
+								}
+
+								ImGui::TableSetColumnIndex(7);
 								if (!job.error.empty())
 								{
 									ImGui::TextWrapped("%s", job.error.c_str());
@@ -340,6 +414,10 @@ namespace luastg
 								{
 									ImGui::TextDisabled("Waiting for main thread");
 								}
+								else if (job.state == AsyncResourceJobState::Queued && job.dependency_count > 0)
+								{
+									ImGui::TextDisabled("Depends on %zu job(s)", job.dependency_count);
+								}
 
 								ImGui::PopID();
 							}
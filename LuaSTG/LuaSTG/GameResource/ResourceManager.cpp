@@ -1,7 +1,14 @@
 #include "GameResource/ResourceManager.h"
 #include "GameResource/AsyncResourceLoader.hpp"
+#include "GameResource/SoundEffectVoicePool.hpp"
+#include "GameResource/AudioSampleCache.hpp"
+#include "core/Configuration.hpp"
+#include "core/FileSystem.hpp"
+#include "AppFrame.h"
 
 #include <algorithm>
+#include <chrono>
+#include <cstdint>
 #include <memory>
 #include <unordered_set>
 #include <utility>
@@ -9,7 +16,11 @@
 namespace luastg
 {
 	ResourceMgr::ResourceMgr()
-		: m_AsyncLoader(std::make_unique<AsyncResourceLoader>())
+		: m_SoundEffectVoicePool(std::make_unique<SoundEffectVoicePool>())
+		, m_AudioSampleCache(std::make_unique<AudioSampleCache>())
+		, m_AsyncLoader(std::make_unique<AsyncResourceLoader>(*m_AudioSampleCache,
+			core::ConfigurationLoader::getInstance().getResourceSystem().getAsyncWorkerCount()))
+		, m_AsyncPriority(AsyncResourcePriority::Normal)
 	{
 	}
 
@@ -24,6 +35,7 @@ namespace luastg
 		m_lookupOrder.clear();
 		m_resourcePoolNames.clear();
 		m_resourcePools.clear();
+		m_SoundEffectVoicePool->clear();
 		m_GlobalImageScaleFactor = 1.0f;
 	}
 
@@ -32,6 +44,15 @@ namespace luastg
 		return pool ? pool->GetGeneration() : 0;
 	}
 
+	void ResourceMgr::UpdateAsyncResourceLoading() {
+		if (m_AsyncFinalizeBudget == 0) {
+			UpdateAsyncResourceLoading(m_AsyncFinalizeCount);
+		}
+		else if (m_AsyncLoader) {
+			m_AsyncLoader->update(*this, SIZE_MAX, std::chrono::microseconds(m_AsyncFinalizeBudget));
+		}
+	}
+
 	void ResourceMgr::UpdateAsyncResourceLoading(size_t const max_count) {
 		if (m_AsyncLoader) {
 			m_AsyncLoader->update(*this, max_count);
@@ -51,7 +72,7 @@ namespace luastg
 	}
 
 	std::shared_ptr<AsyncResourceJob> ResourceMgr::SubmitAsyncFileRead(std::string_view const path) {
-		return m_AsyncLoader->submitFileRead(path);
+		return m_AsyncLoader->submitFileRead(path, m_AsyncPriority);
 	}
 
 	std::shared_ptr<AsyncResourceJob> ResourceMgr::SubmitAsyncResource(AsyncResourceRequest request) {
@@ -62,6 +83,123 @@ namespace luastg
 		return m_AsyncLoader->submitResource(std::move(request));
 	}
 
+	void ResourceMgr::SetAsyncResourceJobPriority(AsyncResourceJob& job, AsyncResourcePriority const priority) {
+		if (m_AsyncLoader) {
+			m_AsyncLoader->setPriority(job, priority);
+		}
+		else {
+			job.setPriority(priority);
+		}
+	}
+
+	AsyncResourceFinalizeStatistics ResourceMgr::GetAsyncResourceFinalizeStatistics() {
+		return m_AsyncLoader ? m_AsyncLoader->getFinalizeStatistics() : AsyncResourceFinalizeStatistics{};
+	}
+
+	uint32_t ResourceMgr::GetAsyncResourceWorkerCount() const noexcept {
+		return m_AsyncLoader ? m_AsyncLoader->getWorkerCount() : 0;
+	}
+
+	// 纹理图集
+
+	void ResourceMgr::SetTextureAtlasLayoutPath(std::string_view const path) {
+		m_TextureAtlasLayoutPath = path;
+		m_TextureAtlasLayout.reset();
+		if (path.empty()) {
+			return;
+		}
+		m_TextureAtlasLayout = std::make_unique<TextureAtlasLayout>();
+		// A missing file is the first run
+		if (core::FileSystemManager::hasFile(path)) {
+			m_TextureAtlasLayout->load(path);
+		}
+	}
+
+	void ResourceMgr::UpdateTextureAtlas() {
+		bool built = false;
+		for (auto const& [id, pool] : m_resourcePools) {
+			if (pool->m_TextureAtlas.hasPending()) {
+				if (!pool->m_TextureAtlas.build(LAPP.GetAppModel()->getDevice(), pool->GetName(), m_TextureAtlasLayout.get())) {
+					spdlog::warn("[luastg] Some textures of resource pool '{}' could not be packed into the texture atlas", pool->GetName());
+				}
+				built = true;
+			}
+		}
+		if (!built) {
+			return;
+		}
+
+		// Sprites created before their texture was packed, from every pool since sprites may use the textures of another pool
+		for (auto const& [id, pool] : m_resourcePools) {
+			for (auto const& [name, sprite] : pool->m_SpritePool) {
+				RemapSpriteToTextureAtlas(sprite.get());
+			}
+			for (auto const& [name, animation] : pool->m_AnimationPool) {
+				for (uint32_t i = 0; i < animation->GetCount(); i += 1) {
+					RemapSpriteToTextureAtlas(animation->GetSprite(i));
+				}
+			}
+		}
+
+		if (m_TextureAtlasLayout && m_TextureAtlasLayout->isDirty() && !m_TextureAtlasLayout->save(m_TextureAtlasLayoutPath)) {
+			spdlog::warn("[luastg] Failed to save texture atlas layout to '{}'", m_TextureAtlasLayoutPath);
+		}
+	}
+
+	void ResourceMgr::RemapSpriteToTextureAtlas(IResourceSprite* const sprite) const {
+		if (sprite == nullptr) {
+			return;
+		}
+		for (auto const& [id, pool] : m_resourcePools) {
+			if (core::Vector2F offset; pool->m_TextureAtlas.remap(sprite->GetSprite(), offset)) {
+				sprite->SetTextureAtlasOffset(sprite->GetTextureAtlasOffset() + offset);
+				return;
+			}
+		}
+	}
+
+	void ResourceMgr::RemoveTextureFromTextureAtlas(core::Graphics::ITexture2D* const texture) {
+		for (auto const& [id, pool] : m_resourcePools) {
+			auto& atlas = pool->m_TextureAtlas;
+			if (!atlas.contains(texture)) {
+				continue;
+			}
+			auto const unmap = [&atlas, texture](IResourceSprite* const sprite) {
+				if (core::Vector2F offset; atlas.unmap(sprite->GetSprite(), texture, offset)) {
+					sprite->SetTextureAtlasOffset(sprite->GetTextureAtlasOffset() + offset);
+				}
+			};
+			for (auto const& [other_id, other_pool] : m_resourcePools) {
+				for (auto const& [name, sprite] : other_pool->m_SpritePool) {
+					unmap(sprite.get());
+				}
+				for (auto const& [name, animation] : other_pool->m_AnimationPool) {
+					for (uint32_t i = 0; i < animation->GetCount(); i += 1) {
+						unmap(animation->GetSprite(i));
+					}
+				}
+			}
+			atlas.remove(texture);
+		}
+	}
+
+	TextureAtlasStatistics ResourceMgr::GetTextureAtlasStatistics() const {
+		TextureAtlasStatistics total;
+		double occupancy = 0.0;
+		for (auto const& [id, pool] : m_resourcePools) {
+			auto const statistics = pool->m_TextureAtlas.getStatistics();
+			total.page_count += statistics.page_count;
+			total.texture_count += statistics.texture_count;
+			total.pending_count += statistics.pending_count;
+			total.page_bytes += statistics.page_bytes;
+			occupancy += statistics.occupancy * static_cast<double>(statistics.page_count);
+		}
+		if (total.page_count > 0) {
+			total.occupancy = occupancy / static_cast<double>(total.page_count);
+		}
+		return total;
+	}
+
 	ResourcePoolId ResourceMgr::CreateResourcePool(std::string_view const name) noexcept {
 		if (name.empty() || m_nextPoolId == InvalidResourcePoolId) {
 			spdlog::warn("[luastg] Rejected resource pool creation: name is empty or the pool ID space is exhausted");
@@ -253,11 +391,22 @@ namespace luastg
 	void ResourceMgr::CacheTTFFontString(const char* name, const char* text, size_t len) noexcept {
 		core::SmartReference<IResourceFont> f = FindTTFFont(name);
 		if (f)
-			f->GetGlyphManager()->cacheString(core::StringView(text, len));
+			f->GetGlyphManager()->prefetchString(core::StringView(text, len));
 		else
 			spdlog::error("[luastg] CacheTTFFontString: 缓存字形时未找到指定字体'{}'", name);
 	}
 
+	void ResourceMgr::UpdateTTFGlyphCache() noexcept {
+		for (auto const& [id, pool] : m_resourcePools) {
+			for (auto const& [name, font] : pool->m_TTFFontPool) {
+				// 流水线渲染时，渲染线程可能还在回放引用旧纹理坐标的字形，整理纹理之前先等它完成
+				font->GetGlyphManager()->collect(m_TTFGlyphCacheLimit, [](void*) {
+					LAPP.GetAppModel()->synchronizeRenderThread();
+				}, nullptr);
+			}
+		}
+	}
+
 	void ResourceMgr::UpdateSound()
 	{
 		for (auto& pool : m_resourcePools) {
@@ -265,6 +414,7 @@ namespace luastg
 				sound.second->FlushCommand();
 			}
 		}
+		m_SoundEffectVoicePool->update();
 	}
 
 	void ResourceMgr::UpdateVideo(double const delta_seconds)
@@ -10,6 +10,7 @@
 #include "GameResource/ResourceFont.hpp"
 #include "GameResource/ResourcePostEffectShader.hpp"
 #include "GameResource/ResourceModel.hpp"
+#include "GameResource/TextureAtlas.hpp"
 #include "lua.hpp"
 #include <cstdint>
 #include <functional>
@@ -23,6 +24,7 @@ namespace core
 {
     struct IData;
     struct IAudioDecoder;
+    struct IAudioSample;
     struct IVideoDecoder;
 }
 
@@ -31,6 +33,11 @@ namespace luastg
     class AsyncResourceLoader;
     class AsyncResourceJob;
     struct AsyncResourceRequest;
+    struct AsyncResourceFinalizeStatistics;
+    enum class AsyncResourcePriority : uint8_t;
+    class SoundEffectVoicePool;
+    class AudioSampleCache;
+    struct PreparedTexture;
     class ResourceMgr;
     
     using ResourcePoolId = uint64_t;
@@ -64,6 +71,7 @@ namespace luastg
         dictionary_t<core::SmartReference<IResourceFont>> m_TTFFontPool;
         dictionary_t<core::SmartReference<IResourcePostEffectShader>> m_FXPool;
         dictionary_t<core::SmartReference<IResourceModel>> m_ModelPool;
+        TextureAtlas m_TextureAtlas;
     private:
         const char* getResourcePoolName() const noexcept { return m_name.c_str(); }
     public:
@@ -75,6 +83,7 @@ namespace luastg
         // 纹理
         bool LoadTexture(const char* name, const char* path, bool mipmaps = true) noexcept;
         bool LoadTexture(const char* name, core::IData* data, const char* path, bool mipmaps = true) noexcept;
+        bool LoadTexture(const char* name, PreparedTexture const& texture, const char* path, bool mipmaps = true) noexcept;
         bool LoadVideo(const char* name, const char* path, bool loop = false) noexcept;
         bool LoadVideo(const char* name, core::IVideoDecoder* decoder, bool loop = false) noexcept;
         bool CreateTexture(const char* name, int width, int height) noexcept;
@@ -97,7 +106,7 @@ namespace luastg
         bool LoadMusic(const char* name, core::IAudioDecoder* decoder, const char* path, double start, double end, bool once_decode) noexcept;
         // 音效
         bool LoadSoundEffect(const char* name, const char* path) noexcept;
-        bool LoadSoundEffect(const char* name, core::IAudioDecoder* decoder, const char* path) noexcept;
+        bool LoadSoundEffect(const char* name, core::IAudioSample* sample, const char* path) noexcept;
         // 粒子特效(HGE)
         bool LoadParticle(const char* name, const hgeParticleSystemInfo& info, IResourceSprite* sprite,
                           double a, double b, bool rect = false, bool _nolog = false) noexcept;
@@ -137,6 +146,7 @@ namespace luastg
         std::string_view GetName() const noexcept { return m_name; }
         std::string const& GetNameString() const noexcept { return m_name; }
         size_t GetGeneration() const noexcept { return m_generation; }
+        TextureAtlas const& GetTextureAtlas() const noexcept { return m_TextureAtlas; }
         ResourcePool& operator=(const ResourcePool&) = delete;
         ResourcePool(const ResourcePool&) = delete;
     private:
@@ -147,6 +157,10 @@ namespace luastg
     class ResourceMgr
     {
     private:
+        // declared before the resource pools, sound effects give their voices back when destroyed
+        std::unique_ptr<SoundEffectVoicePool> m_SoundEffectVoicePool;
+        // decoded sound effect data shared by content, used by the async loader worker
+        std::unique_ptr<AudioSampleCache> m_AudioSampleCache;
         ResourcePoolId m_nextPoolId = 1;
         std::unordered_map<ResourcePoolId, std::unique_ptr<ResourcePool>> m_resourcePools;
         std::unordered_map<std::string, ResourcePoolId> m_resourcePoolNames;
@@ -163,11 +177,43 @@ namespace luastg
         std::vector<ResourcePoolId> const& GetLookupOrder() const noexcept { return m_lookupOrder; }
         void ClearAllResource() noexcept;
         size_t GetResourcePoolGeneration(ResourcePoolId id) const noexcept;
-        void UpdateAsyncResourceLoading(size_t max_count = 8);
+        // finalizes ready async loads with the current finalize policy, called once per frame
+        void UpdateAsyncResourceLoading();
+        void UpdateAsyncResourceLoading(size_t max_count);
+        // count mode: up to max_count resources per update, no matter how expensive they are
+        void SetAsyncResourceFinalizeCount(size_t max_count) noexcept { m_AsyncFinalizeCount = max_count; m_AsyncFinalizeBudget = 0; }
+        // time budget mode: resources are finalized until the budget is spent, based on the learned cost of each type,
+        // 0 returns to count mode
+        void SetAsyncResourceFinalizeBudget(uint32_t budget_us) noexcept { m_AsyncFinalizeBudget = budget_us; }
+        size_t GetAsyncResourceFinalizeCount() const noexcept { return m_AsyncFinalizeCount; }
+        uint32_t GetAsyncResourceFinalizeBudget() const noexcept { return m_AsyncFinalizeBudget; }
+        AsyncResourceFinalizeStatistics GetAsyncResourceFinalizeStatistics();
         void CancelAsyncResourceLoading() noexcept;
         void CancelAsyncResourceLoading(ResourcePoolId pool_id) noexcept;
         std::shared_ptr<AsyncResourceJob> SubmitAsyncFileRead(std::string_view path);
         std::shared_ptr<AsyncResourceJob> SubmitAsyncResource(AsyncResourceRequest request);
+        void SetAsyncResourceJobPriority(AsyncResourceJob& job, AsyncResourcePriority priority);
+        // priority of async loads submitted from scripts from now on
+        void SetAsyncResourcePriority(AsyncResourcePriority priority) noexcept { m_AsyncPriority = priority; }
+        AsyncResourcePriority GetAsyncResourcePriority() const noexcept { return m_AsyncPriority; }
+        uint32_t GetAsyncResourceWorkerCount() const noexcept;
+        // small textures loaded without mipmaps are packed into the texture atlas of their pool,
+        // max_texture_size is the largest width/height packed
+        void SetTextureAtlasEnable(bool enable, uint32_t max_texture_size) noexcept { m_TextureAtlasEnable = enable; m_TextureAtlasMaxTextureSize = max_texture_size; }
+        bool IsTextureAtlasEnabled() const noexcept { return m_TextureAtlasEnable; }
+        uint32_t GetTextureAtlasMaxTextureSize() const noexcept { return m_TextureAtlasMaxTextureSize; }
+        // the layout is loaded from path if it exists and saved there whenever it changes, empty path disables it
+        void SetTextureAtlasLayoutPath(std::string_view path);
+        // packs the textures loaded since the last update and moves the sprites drawn from them onto the atlas pages,
+        // called once per frame
+        void UpdateTextureAtlas();
+        // moves sprite onto an atlas page if its texture was packed
+        void RemapSpriteToTextureAtlas(IResourceSprite* sprite) const;
+        // takes texture out of the texture atlas and moves the sprites drawn from it back onto it,
+        // for a texture that got a sampler or alpha mode of its own
+        void RemoveTextureFromTextureAtlas(core::Graphics::ITexture2D* texture);
+        // sum of the atlases of all pools, occupancy is the average of all pages
+        TextureAtlasStatistics GetTextureAtlasStatistics() const;
 
         core::SmartReference<IResourceTexture> FindTexture(const char* name) noexcept;
         core::SmartReference<IResourceVideo> FindVideo(const char* name) noexcept;
@@ -182,13 +228,29 @@ namespace luastg
         core::SmartReference<IResourceModel> FindModel(const char* name) noexcept;
         
         bool GetTextureSize(const char* name, core::Vector2U& out) noexcept;
+        // rasterizes the glyphs of text on the background thread of the font, they are uploaded by the next draw or frame
         void CacheTTFFontString(const char* name, const char* text, size_t len) noexcept;
+        // glyph textures kept per TTF font before the least recently used glyphs are evicted
+        void SetTTFGlyphCacheLimit(uint32_t texture_count) noexcept { m_TTFGlyphCacheLimit = texture_count; }
+        uint32_t GetTTFGlyphCacheLimit() const noexcept { return m_TTFGlyphCacheLimit; }
+        // evicts and compacts the glyph caches of all TTF fonts, called once per frame before anything is drawn
+        void UpdateTTFGlyphCache() noexcept;
         void UpdateSound();
+        SoundEffectVoicePool& GetSoundEffectVoicePool() noexcept { return *m_SoundEffectVoicePool; }
+        AudioSampleCache& GetAudioSampleCache() noexcept { return *m_AudioSampleCache; }
         void UpdateVideo(double delta_seconds);
     private:
         static bool g_ResourceLoadingLog;
         float m_GlobalImageScaleFactor = 1.0f;
         std::unique_ptr<AsyncResourceLoader> m_AsyncLoader;
+        AsyncResourcePriority m_AsyncPriority;
+        size_t m_AsyncFinalizeCount{ 8 };
+        uint32_t m_AsyncFinalizeBudget{ 0 };
+        bool m_TextureAtlasEnable{ false };
+        uint32_t m_TextureAtlasMaxTextureSize{ 256 };
+        std::string m_TextureAtlasLayoutPath;
+        std::unique_ptr<TextureAtlasLayout> m_TextureAtlasLayout;
+        uint32_t m_TTFGlyphCacheLimit{ 4 };
     public:
         static void SetResourceLoadingLog(bool b);
         static bool GetResourceLoadingLog();
@@ -5,6 +5,10 @@
 #include "GameResource/Implement/ResourceAnimationImpl.hpp"
 #include "GameResource/Implement/ResourceMusicImpl.hpp"
 #include "GameResource/Implement/ResourceSoundEffectImpl.hpp"
+#include "GameResource/SoundEffectVoicePool.hpp"
+#include "GameResource/AudioSampleCache.hpp"
+#include "GameResource/TexturePreparer.hpp"
+#include "Core/Graphics/Common/BakedTexture.hpp"
 #include "GameResource/Implement/ResourceParticleImpl.hpp"
 #include "GameResource/Implement/ResourceFontImpl.hpp"
 #include "GameResource/Implement/ResourcePostEffectShaderImpl.hpp"
@@ -37,6 +41,7 @@ namespace luastg
         m_TTFFontPool.clear();
         m_FXPool.clear();
         m_ModelPool.clear();
+        m_TextureAtlas.clear();
         spdlog::info("[luastg] 已清空资源池 '{}'", getResourcePoolName());
     }
 
@@ -61,6 +66,11 @@ namespace luastg
         switch (t)
         {
         case ResourceType::Texture:
+            // The atlas would keep the texture alive until the pool is cleared
+            if (auto const i = m_TexturePool.find(std::string_view(name)); i != m_TexturePool.end())
+            {
+                m_TextureAtlas.remove(i->second->GetTexture());
+            }
             removeResource(m_TexturePool, name, getResourcePoolName());
             break;
         case ResourceType::Sprite:
@@ -196,35 +206,39 @@ namespace luastg
             }
             return false;
         }
-    
-        core::SmartReference<core::Graphics::ITexture2D> p_texture;
-        if (!LAPP.GetAppModel()->getDevice()->createTextureFromFile(path, mipmaps, p_texture.put()))
+
+        PreparedTexture texture;
+        if (!readTexture(path, mipmaps, texture))
         {
-            spdlog::error("[luastg] 从 '{}' 创建纹理 '{}' 失败 (资源池 '{}')", path, name, getResourcePoolName());
+            spdlog::error("[luastg] LoadTexture: 无法读取文件 '{}' (资源池 '{}')", path, getResourcePoolName());
             return false;
         }
 
-        try
-        {
-            core::SmartReference<IResourceTexture> tRes;
-            tRes.attach(new ResourceTextureImpl(name, p_texture.get()));
-            m_TexturePool.emplace(name, tRes);
-        }
-        catch (std::exception const& e)
+        return LoadTexture(name, texture, path, mipmaps);
+    }
+
+    bool ResourcePool::LoadTexture(const char* name, core::IData* data, const char* path, bool mipmaps) noexcept
+    {
+        if (m_TexturePool.find(std::string_view(name)) != m_TexturePool.end())
         {
-            spdlog::error("[luastg] LoadTexture: 创建纹理 '{}' 失败 ({}) (资源池 '{}')", name, e.what(), getResourcePoolName());
+            if (ResourceMgr::GetResourceLoadingLog())
+            {
+                spdlog::warn("[luastg] LoadTexture: 纹理 '{}' 已存在，加载操作已取消 (资源池 '{}')", name, getResourcePoolName());
+            }
             return false;
         }
-    
-        if (ResourceMgr::GetResourceLoadingLog())
+
+        PreparedTexture texture;
+        if (!prepareTexture(data, mipmaps, texture))
         {
-            spdlog::info("[luastg] LoadTexture: 已从 '{}' 加载纹理 '{}' (资源池 '{}')", path, name, getResourcePoolName());
+            spdlog::error("[luastg] 从 '{}' 创建纹理 '{}' 失败 (资源池 '{}')", path, name, getResourcePoolName());
+            return false;
         }
-    
-        return true;
+
+        return LoadTexture(name, texture, path, mipmaps);
     }
 
-    bool ResourcePool::LoadTexture(const char* name, core::IData* data, const char* path, bool mipmaps) noexcept
+    bool ResourcePool::LoadTexture(const char* name, PreparedTexture const& texture, const char* path, bool mipmaps) noexcept
     {
         if (m_TexturePool.find(std::string_view(name)) != m_TexturePool.end())
         {
@@ -236,7 +250,38 @@ namespace luastg
         }
 
         core::SmartReference<core::Graphics::ITexture2D> p_texture;
-        if (!LAPP.GetAppModel()->getDevice()->createTextureFromData(data, mipmaps, p_texture.put()))
+        auto* const device = LAPP.GetAppModel()->getDevice();
+        bool result = false;
+        if (!texture.levels.empty())
+        {
+            std::vector<core::IImage*> levels;
+            levels.reserve(texture.levels.size());
+            for (auto const& level : texture.levels)
+            {
+                levels.emplace_back(level.get());
+            }
+            // Read from a file: the texture reads it again after device lost, the encoded bytes are not kept
+            std::string_view const source_path = texture.from_file ? std::string_view(path) : std::string_view();
+            result = device->createTextureFromImage(source_path, texture.source.get(), levels.data(), static_cast<uint32_t>(levels.size()), p_texture.put());
+        }
+        else if (texture.source)
+        {
+            // Not decodable on the CPU (DDS...), the device loads it
+            result = device->createTextureFromData(texture.source.get(), mipmaps, p_texture.put());
+        }
+        if (!result && texture.baked && core::FileSystemManager::hasFile(path))
+        {
+            // The device may not support the block compression format of the baked texture, decode the original file instead
+            spdlog::warn("[luastg] LoadTexture: 无法使用预压缩纹理 '{}'，改为从 '{}' 加载 (资源池 '{}')", core::Graphics::Common::getBakedTexturePath(path), path, getResourcePoolName());
+            core::SmartReference<core::IData> data;
+            PreparedTexture fallback;
+            if (core::FileSystemManager::readFile(path, data.put()) && prepareTexture(data.get(), mipmaps, fallback))
+            {
+                fallback.from_file = true;
+                return LoadTexture(name, fallback, path, mipmaps);
+            }
+        }
+        if (!result)
         {
             spdlog::error("[luastg] 从 '{}' 创建纹理 '{}' 失败 (资源池 '{}')", path, name, getResourcePoolName());
             return false;
@@ -254,6 +299,17 @@ namespace luastg
             return false;
         }
 
+        // Small textures without mipmaps are packed into the texture atlas at the end of the frame
+        if (m_pMgr && m_pMgr->IsTextureAtlasEnabled() && !mipmaps && texture.levels.size() == 1)
+        {
+            auto const size = texture.levels[0]->getSize();
+            auto const max_size = m_pMgr->GetTextureAtlasMaxTextureSize();
+            if (size.x <= max_size && size.y <= max_size)
+            {
+                m_TextureAtlas.add(name, p_texture.get(), texture.levels[0].get());
+            }
+        }
+
         if (ResourceMgr::GetResourceLoadingLog())
         {
             spdlog::info("[luastg] LoadTexture: 已从 '{}' 加载纹理 '{}' (资源池 '{}')", path, name, getResourcePoolName());
@@ -449,6 +505,10 @@ namespace luastg
         {
             core::SmartReference<IResourceSprite> tRes;
             tRes.attach(new ResourceSpriteImpl(name, p_sprite.get(), a, b, rect));
+            if (m_pMgr)
+            {
+                m_pMgr->RemapSpriteToTextureAtlas(tRes.get());
+            }
             m_SpritePool.emplace(name, tRes);
         }
         catch (std::exception const& e)
@@ -497,6 +557,13 @@ namespace luastg
                     n, m, intv,
                     a, b, rect)
             );
+            if (m_pMgr)
+            {
+                for (uint32_t i = 0; i < tRes->GetCount(); i += 1)
+                {
+                    m_pMgr->RemapSpriteToTextureAtlas(tRes->GetSprite(i));
+                }
+            }
             m_AnimationPool.emplace(name, tRes);
         }
         catch (std::exception const& e)
@@ -718,26 +785,25 @@ namespace luastg
 
         using namespace core;
 
-        // 创建解码器
-        SmartReference<IAudioDecoder> p_decoder;
-        if (!IAudioDecoder::create(path, p_decoder.put()))
+        SmartReference<IData> p_data;
+        if (!FileSystemManager::readFile(path, p_data.put()))
         {
-            spdlog::error("[luastg] LoadSoundEffect: 无法解码文件 '{}'，要求文件格式为 WAV/OGG/FLAC (资源池 '{}')", path, getResourcePoolName());
+            spdlog::error("[luastg] LoadSoundEffect: 无法读取文件 '{}' (资源池 '{}')", path, getResourcePoolName());
             return false;
         }
 
-        // 创建播放器
-        SmartReference<IAudioPlayer> p_player;
-        if (!LAPP.getAudioEngine()->createAudioPlayer(p_decoder.get(), AudioMixingChannel::sound_effect, p_player.put()))
+        // 解码到内存，内容相同的音效共享同一份 PCM 数据，大文件在其他线程上计算哈希
+        SmartReference<IAudioSample> p_sample;
+        if (!m_pMgr->GetAudioSampleCache().getOrCreate(p_data.get(), p_sample.put(), true))
         {
-            spdlog::error("[luastg] LoadSoundEffect: 无法为音效 '{}' 创建音频播放器 (资源池 '{}')", name, getResourcePoolName());
+            spdlog::error("[luastg] LoadSoundEffect: 无法解码文件 '{}'，要求文件格式为 WAV/OGG/FLAC (资源池 '{}')", path, getResourcePoolName());
             return false;
         }
 
         try
         {
             core::SmartReference<IResourceSoundEffect> tRes;
-            tRes.attach(new ResourceSoundEffectImpl(name, p_player.get()));
+            tRes.attach(new ResourceSoundEffectImpl(name, p_sample.get(), &m_pMgr->GetSoundEffectVoicePool()));
             m_SoundSpritePool.emplace(name, tRes);
         }
         catch (std::exception const& e)
@@ -754,7 +820,7 @@ namespace luastg
         return true;
     }
 
-    bool ResourcePool::LoadSoundEffect(const char* name, core::IAudioDecoder* decoder, const char* path) noexcept
+    bool ResourcePool::LoadSoundEffect(const char* name, core::IAudioSample* sample, const char* path) noexcept
     {
         if (m_SoundSpritePool.find(std::string_view(name)) != m_SoundSpritePool.end())
         {
@@ -765,23 +831,16 @@ namespace luastg
             return false;
         }
 
-        if (!decoder)
+        if (!sample)
         {
             spdlog::error("[luastg] LoadSoundEffect: 无法解码文件 '{}'，要求文件格式为 WAV/OGG/FLAC (资源池 '{}')", path, getResourcePoolName());
             return false;
         }
 
-        core::SmartReference<core::IAudioPlayer> p_player;
-        if (!LAPP.getAudioEngine()->createAudioPlayer(decoder, core::AudioMixingChannel::sound_effect, p_player.put()))
-        {
-            spdlog::error("[luastg] LoadSoundEffect: 无法为音效 '{}' 创建音频播放器 (资源池 '{}')", name, getResourcePoolName());
-            return false;
-        }
-
         try
         {
             core::SmartReference<IResourceSoundEffect> tRes;
-            tRes.attach(new ResourceSoundEffectImpl(name, p_player.get()));
+            tRes.attach(new ResourceSoundEffectImpl(name, sample, &m_pMgr->GetSoundEffectVoicePool()));
             m_SoundSpritePool.emplace(name, tRes);
         }
         catch (std::exception const& e)
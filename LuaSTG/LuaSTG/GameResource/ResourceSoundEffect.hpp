@@ -14,6 +14,13 @@ namespace luastg
 		virtual bool IsStopped() = 0;
 		virtual bool SetSpeed(float speed) = 0;
 		virtual float GetSpeed() = 0;
+		// Maximum number of voices this sound effect can play at the same time
+		virtual void SetPolyphony(uint32_t polyphony) = 0;
+		virtual uint32_t GetPolyphony() = 0;
+		// Voices of higher priority sound effects are never stolen by lower ones
+		virtual void SetPriority(int32_t priority) = 0;
+		virtual int32_t GetPriority() = 0;
+		virtual uint32_t GetVoiceCount() = 0;
 	};
 }
 
@@ -16,6 +16,10 @@ namespace luastg
 		virtual void Render(float x, float y, float rot, float hscale, float vscale, float z = 0.5f) = 0;
 		virtual void Render(float x, float y, float rot, float hscale, float vscale, BlendMode blend, core::Color4B color, float z = 0.5f) = 0;
 		virtual void Render4V(float x1, float y1, float z1, float x2, float y2, float z2, float x3, float y3, float z3, float x4, float y4, float z4) = 0;
+		// How far the texture coordinates moved when the sprite was put onto a texture atlas page,
+		// add it to a center given in the coordinates of the original texture
+		virtual core::Vector2F GetTextureAtlasOffset() = 0;
+		virtual void SetTextureAtlasOffset(core::Vector2F const& offset) = 0;
 	};
 }
 
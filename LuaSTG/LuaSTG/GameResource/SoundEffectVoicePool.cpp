@@ -0,0 +1,225 @@
+#include "GameResource/SoundEffectVoicePool.hpp"
+#include "core/Configuration.hpp"
+#include "AppFrame.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace luastg {
+
+	SoundEffectVoicePool::SoundEffectVoicePool()
+		: m_max_voice_count(std::max(1u, core::ConfigurationLoader::getInstance().getAudioSystem().getSoundEffectVoiceLimit())) {
+	}
+
+	SoundEffectVoicePool::~SoundEffectVoicePool() {
+		clear();
+	}
+
+	bool SoundEffectVoicePool::play(IResourceSoundEffect* const owner, core::IAudioSample* const sample, float const volume, float const pan, float const speed, uint32_t const polyphony, int32_t const priority) {
+		if (owner == nullptr || sample == nullptr) {
+			return false;
+		}
+
+		// Voices of the same sound effect restart the oldest one when the polyphony limit is reached
+		uint32_t count{};
+		Voice* oldest{};
+		for (auto& voice : m_voices) {
+			if (voice.owner == owner && isActive(voice)) {
+				count += 1;
+				if (oldest == nullptr || voice.serial < oldest->serial) {
+					oldest = &voice;
+				}
+			}
+		}
+
+		Voice* voice{};
+		if (oldest != nullptr && count >= std::max(1u, polyphony)) {
+			voice = oldest;
+			m_statistics.reused += 1;
+		}
+		else {
+			voice = acquire(sample, priority);
+		}
+		if (voice == nullptr) {
+			m_statistics.dropped += 1;
+			return false;
+		}
+
+		voice->owner = owner;
+		voice->priority = priority;
+		voice->serial = ++m_serial;
+		auto* const player = voice->player.get();
+		std::ignore = player->setVolume(volume);
+		std::ignore = player->setBalance(pan);
+		std::ignore = player->setSpeed(speed);
+		return player->play(0.0);
+	}
+	void SoundEffectVoicePool::pause(IResourceSoundEffect* const owner) {
+		for (auto& voice : m_voices) {
+			if (voice.owner == owner && voice.player->getState() == core::AudioPlayerState::playing) {
+				std::ignore = voice.player->pause();
+			}
+		}
+	}
+	void SoundEffectVoicePool::resume(IResourceSoundEffect* const owner) {
+		for (auto& voice : m_voices) {
+			if (voice.owner == owner && voice.player->getState() == core::AudioPlayerState::paused) {
+				std::ignore = voice.player->resume();
+			}
+		}
+	}
+	void SoundEffectVoicePool::stop(IResourceSoundEffect* const owner) {
+		for (auto& voice : m_voices) {
+			if (voice.owner == owner) {
+				std::ignore = voice.player->stop();
+				detach(voice);
+			}
+		}
+	}
+	void SoundEffectVoicePool::setSpeed(IResourceSoundEffect* const owner, float const speed) {
+		for (auto& voice : m_voices) {
+			if (voice.owner == owner) {
+				std::ignore = voice.player->setSpeed(speed);
+			}
+		}
+	}
+	uint32_t SoundEffectVoicePool::getVoiceCount(IResourceSoundEffect* const owner) {
+		uint32_t count{};
+		for (auto const& voice : m_voices) {
+			if (voice.owner == owner && isActive(voice)) {
+				count += 1;
+			}
+		}
+		return count;
+	}
+	void SoundEffectVoicePool::release(IResourceSoundEffect* const owner) noexcept {
+		for (auto& voice : m_voices) {
+			if (voice.owner == owner) {
+				std::ignore = voice.player->stop();
+				detach(voice);
+			}
+		}
+	}
+	void SoundEffectVoicePool::update() {
+		size_t active{};
+		for (auto& voice : m_voices) {
+			if (voice.owner != nullptr) {
+				if (isActive(voice)) {
+					active += 1;
+				}
+				else {
+					detach(voice);
+				}
+			}
+		}
+		m_statistics.voices = m_voices.size();
+		m_statistics.active = active;
+	}
+	void SoundEffectVoicePool::clear() noexcept {
+		for (auto& voice : m_voices) {
+			std::ignore = voice.player->stop();
+		}
+		m_voices.clear();
+		m_statistics.voices = 0;
+		m_statistics.active = 0;
+	}
+
+	void SoundEffectVoicePool::setMaxVoiceCount(uint32_t const count) {
+		m_max_voice_count = std::max(1u, count);
+		while (m_voices.size() > m_max_voice_count) {
+			// Drop idle voices first, then the oldest voices with the lowest priority
+			auto const victim = std::min_element(m_voices.begin(), m_voices.end(), [](Voice const& a, Voice const& b) {
+				bool const a_active = isActive(a);
+				bool const b_active = isActive(b);
+				if (a_active != b_active) {
+					return !a_active;
+				}
+				if (a.priority != b.priority) {
+					return a.priority < b.priority;
+				}
+				return a.serial < b.serial;
+			});
+			std::ignore = victim->player->stop();
+			m_voices.erase(victim);
+		}
+		m_statistics.voices = m_voices.size();
+	}
+	SoundEffectVoicePoolStatistics SoundEffectVoicePool::getStatistics() const noexcept {
+		return m_statistics;
+	}
+
+	bool SoundEffectVoicePool::isActive(Voice const& voice) {
+		return voice.owner != nullptr && voice.player->getState() != core::AudioPlayerState::stopped;
+	}
+	SoundEffectVoicePool::Voice* SoundEffectVoicePool::acquire(core::IAudioSample* const sample, int32_t const priority) {
+		// 1. idle voice already bound to this sample
+		for (auto& voice : m_voices) {
+			if (voice.sample.get() == sample && !isActive(voice)) {
+				detach(voice);
+				m_statistics.reused += 1;
+				return &voice;
+			}
+		}
+
+		// 2. new voice
+		if (m_voices.size() < m_max_voice_count) {
+			Voice voice;
+			if (!createPlayer(voice, sample)) {
+				return nullptr;
+			}
+			m_voices.emplace_back(std::move(voice));
+			return &m_voices.back();
+		}
+
+		// 3. least recently used idle voice of another sample, source voice formats are fixed so it must be recreated
+		Voice* idle{};
+		for (auto& voice : m_voices) {
+			if (!isActive(voice) && (idle == nullptr || voice.serial < idle->serial)) {
+				idle = &voice;
+			}
+		}
+		if (idle != nullptr) {
+			detach(*idle);
+			if (!createPlayer(*idle, sample)) {
+				return nullptr;
+			}
+			return idle;
+		}
+
+		// 4. steal the oldest voice with the lowest priority, never steal from a higher priority
+		Voice* victim{};
+		for (auto& voice : m_voices) {
+			if (voice.priority > priority) {
+				continue;
+			}
+			if (victim == nullptr || voice.priority < victim->priority || (voice.priority == victim->priority && voice.serial < victim->serial)) {
+				victim = &voice;
+			}
+		}
+		if (victim == nullptr) {
+			return nullptr;
+		}
+		std::ignore = victim->player->stop();
+		detach(*victim);
+		m_statistics.stolen += 1;
+		if (victim->sample.get() != sample && !createPlayer(*victim, sample)) {
+			return nullptr;
+		}
+		return victim;
+	}
+	bool SoundEffectVoicePool::createPlayer(Voice& voice, core::IAudioSample* const sample) {
+		// The old player is kept if creation fails, so every voice in the pool always has a player
+		core::SmartReference<core::IAudioPlayer> player;
+		if (!LAPP.getAudioEngine()->createAudioPlayer(sample, core::AudioMixingChannel::sound_effect, player.put())) {
+			return false;
+		}
+		voice.player = player;
+		voice.sample = sample;
+		m_statistics.created += 1;
+		return true;
+	}
+	void SoundEffectVoicePool::detach(Voice& voice) {
+		voice.owner = nullptr;
+	}
+
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include "core/AudioPlayer.hpp"
+#include "core/AudioSample.hpp"
+#include "core/SmartReference.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace luastg {
+
+	struct IResourceSoundEffect;
+
+	struct SoundEffectVoicePoolStatistics {
+		size_t voices{};
+		size_t active{};
+		size_t created{};
+		size_t reused{};
+		size_t stolen{};
+		size_t dropped{};
+	};
+
+	// Shared source voices for all sound effects. A sound effect only owns its decoded PCM,
+	// voices are borrowed on play and go back to the pool when they finish.
+	// When the pool is full, idle voices of other samples are recycled first (least recently used),
+	// then the oldest voice with the lowest priority not higher than the requester is stolen.
+	class SoundEffectVoicePool {
+	public:
+		SoundEffectVoicePool();
+		SoundEffectVoicePool(SoundEffectVoicePool const&) = delete;
+		SoundEffectVoicePool(SoundEffectVoicePool&&) = delete;
+		~SoundEffectVoicePool();
+
+		SoundEffectVoicePool& operator=(SoundEffectVoicePool const&) = delete;
+		SoundEffectVoicePool& operator=(SoundEffectVoicePool&&) = delete;
+
+		// Starts a new voice of owner, restarts the oldest voice of owner if it already has polyphony voices
+		bool play(IResourceSoundEffect* owner, core::IAudioSample* sample, float volume, float pan, float speed, uint32_t polyphony, int32_t priority);
+		void pause(IResourceSoundEffect* owner);
+		void resume(IResourceSoundEffect* owner);
+		void stop(IResourceSoundEffect* owner);
+		void setSpeed(IResourceSoundEffect* owner, float speed);
+		// Number of voices of owner that are playing or paused
+		uint32_t getVoiceCount(IResourceSoundEffect* owner);
+		// Stops and detaches all voices of owner, must be called before owner is destroyed
+		void release(IResourceSoundEffect* owner) noexcept;
+		// Returns finished voices to the pool, call once per frame
+		void update();
+		void clear() noexcept;
+
+		void setMaxVoiceCount(uint32_t count);
+		uint32_t getMaxVoiceCount() const noexcept { return m_max_voice_count; }
+		SoundEffectVoicePoolStatistics getStatistics() const noexcept;
+
+	private:
+		struct Voice {
+			core::SmartReference<core::IAudioPlayer> player;
+			core::SmartReference<core::IAudioSample> sample;
+			IResourceSoundEffect* owner{};
+			uint64_t serial{}; // last time this voice was started
+			int32_t priority{};
+		};
+
+		static bool isActive(Voice const& voice);
+		Voice* acquire(core::IAudioSample* sample, int32_t priority);
+		bool createPlayer(Voice& voice, core::IAudioSample* sample);
+		void detach(Voice& voice);
+
+	private:
+		std::vector<Voice> m_voices;
+		SoundEffectVoicePoolStatistics m_statistics;
+		uint64_t m_serial{};
+		uint32_t m_max_voice_count{ 64 };
+	};
+
+}
@@ -0,0 +1,447 @@
+#include "GameResource/TextureAtlas.hpp"
+#include "core/FileSystem.hpp"
+#include "core/Logger.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <format>
+
+using std::string_view_literals::operator ""sv;
+
+namespace {
+	constexpr auto layout_header{ "# luastg texture atlas layout 1"sv };
+	// A saved layout never makes the atlas grow beyond this, in case the file is broken
+	constexpr uint32_t max_restored_page_count{ 16 };
+
+	bool contains(luastg::TextureAtlasRect const& outer, luastg::TextureAtlasRect const& inner) {
+		return inner.x >= outer.x && inner.y >= outer.y
+			&& inner.x + inner.width <= outer.x + outer.width
+			&& inner.y + inner.height <= outer.y + outer.height;
+	}
+
+	bool intersects(luastg::TextureAtlasRect const& a, luastg::TextureAtlasRect const& b) {
+		return a.x < b.x + b.width && b.x < a.x + a.width
+			&& a.y < b.y + b.height && b.y < a.y + a.height;
+	}
+
+	template<typename T>
+	bool parseInteger(std::string_view const text, T& value) {
+		auto const [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+		return ec == std::errc{} && ptr == text.data() + text.size();
+	}
+}
+
+namespace luastg {
+
+	// TextureAtlasPacker
+
+	TextureAtlasPacker::TextureAtlasPacker(uint32_t const width, uint32_t const height) : m_width(width), m_height(height) {
+		m_free_rects.push_back(TextureAtlasRect{ 0, 0, width, height });
+	}
+
+	bool TextureAtlasPacker::insert(uint32_t const width, uint32_t const height, TextureAtlasRect& output) {
+		uint32_t best_short_side{ UINT32_MAX };
+		uint32_t best_long_side{ UINT32_MAX };
+		TextureAtlasRect const* best{};
+		for (auto const& rect : m_free_rects) {
+			if (rect.width < width || rect.height < height) {
+				continue;
+			}
+			uint32_t const leftover_x = rect.width - width;
+			uint32_t const leftover_y = rect.height - height;
+			uint32_t const short_side = std::min(leftover_x, leftover_y);
+			uint32_t const long_side = std::max(leftover_x, leftover_y);
+			if (short_side < best_short_side || (short_side == best_short_side && long_side < best_long_side)) {
+				best_short_side = short_side;
+				best_long_side = long_side;
+				best = &rect;
+			}
+		}
+		if (best == nullptr) {
+			return false;
+		}
+		output = TextureAtlasRect{ best->x, best->y, width, height };
+		splitFreeRects(output);
+		pruneFreeRects();
+		m_used_area += static_cast<uint64_t>(width) * height;
+		return true;
+	}
+
+	bool TextureAtlasPacker::claim(TextureAtlasRect const& rect) {
+		// Free rectangles are maximal, a free area is always inside one of them
+		auto const it = std::ranges::find_if(m_free_rects, [&rect](TextureAtlasRect const& free_rect) { return contains(free_rect, rect); });
+		if (rect.width == 0 || rect.height == 0 || it == m_free_rects.end()) {
+			return false;
+		}
+		splitFreeRects(rect);
+		pruneFreeRects();
+		m_used_area += static_cast<uint64_t>(rect.width) * rect.height;
+		return true;
+	}
+
+	double TextureAtlasPacker::getOccupancy() const noexcept {
+		return static_cast<double>(m_used_area) / (static_cast<double>(m_width) * static_cast<double>(m_height));
+	}
+
+	void TextureAtlasPacker::splitFreeRects(TextureAtlasRect const& used) {
+		std::vector<TextureAtlasRect> result;
+		result.reserve(m_free_rects.size() + 4);
+		for (auto const& rect : m_free_rects) {
+			if (!intersects(rect, used)) {
+				result.push_back(rect);
+				continue;
+			}
+			if (used.x > rect.x) {
+				result.push_back(TextureAtlasRect{ rect.x, rect.y, used.x - rect.x, rect.height });
+			}
+			if (used.x + used.width < rect.x + rect.width) {
+				result.push_back(TextureAtlasRect{ used.x + used.width, rect.y, rect.x + rect.width - (used.x + used.width), rect.height });
+			}
+			if (used.y > rect.y) {
+				result.push_back(TextureAtlasRect{ rect.x, rect.y, rect.width, used.y - rect.y });
+			}
+			if (used.y + used.height < rect.y + rect.height) {
+				result.push_back(TextureAtlasRect{ rect.x, used.y + used.height, rect.width, rect.y + rect.height - (used.y + used.height) });
+			}
+		}
+		m_free_rects = std::move(result);
+	}
+
+	void TextureAtlasPacker::pruneFreeRects() {
+		for (size_t i = 0; i < m_free_rects.size(); i += 1) {
+			for (size_t j = i + 1; j < m_free_rects.size(); j += 1) {
+				if (contains(m_free_rects[j], m_free_rects[i])) {
+					m_free_rects.erase(m_free_rects.begin() + static_cast<ptrdiff_t>(i));
+					i -= 1;
+					break;
+				}
+				if (contains(m_free_rects[i], m_free_rects[j])) {
+					m_free_rects.erase(m_free_rects.begin() + static_cast<ptrdiff_t>(j));
+					j -= 1;
+				}
+			}
+		}
+	}
+
+	// TextureAtlasLayout
+
+	bool TextureAtlasLayout::load(std::string_view const path) {
+		m_placements.clear();
+		m_dirty = false;
+		core::SmartReference<core::IData> data;
+		if (!core::FileSystemManager::readFile(path, data.put())) {
+			return false;
+		}
+		std::string_view text(static_cast<char const*>(data->data()), data->size());
+		bool header = true;
+		while (!text.empty()) {
+			auto const end = text.find('\n');
+			auto line = text.substr(0, end);
+			text = (end == std::string_view::npos) ? std::string_view{} : text.substr(end + 1);
+			if (line.ends_with('\r')) {
+				line.remove_suffix(1);
+			}
+			if (header) {
+				if (line != layout_header) {
+					core::Logger::warn("[luastg] [TextureAtlas] '{}' is not a texture atlas layout", path);
+					return false;
+				}
+				header = false;
+				continue;
+			}
+			// page x y width height pool texture, separated by tabs
+			std::string_view fields[7]{};
+			size_t count{};
+			while (count < 6) {
+				auto const tab = line.find('\t');
+				if (tab == std::string_view::npos) {
+					break;
+				}
+				fields[count++] = line.substr(0, tab);
+				line = line.substr(tab + 1);
+			}
+			fields[count++] = line;
+			Placement placement;
+			if (count != 7
+				|| !parseInteger(fields[0], placement.page)
+				|| !parseInteger(fields[1], placement.rect.x)
+				|| !parseInteger(fields[2], placement.rect.y)
+				|| !parseInteger(fields[3], placement.rect.width)
+				|| !parseInteger(fields[4], placement.rect.height)) {
+				continue;
+			}
+			m_placements.insert_or_assign(makeKey(fields[5], fields[6]), placement);
+		}
+		return true;
+	}
+
+	bool TextureAtlasLayout::save(std::string_view const path) {
+		std::string text(layout_header);
+		text.push_back('\n');
+		for (auto const& [key, placement] : m_placements) {
+			auto const separator = key.find('\n');
+			text.append(std::format("{}\t{}\t{}\t{}\t{}\t{}\t{}\n",
+				placement.page, placement.rect.x, placement.rect.y, placement.rect.width, placement.rect.height,
+				std::string_view(key).substr(0, separator), std::string_view(key).substr(separator + 1)));
+		}
+		core::SmartReference<core::IData> data;
+		if (!core::IData::create(text.size(), data.put())) {
+			return false;
+		}
+		std::memcpy(data->data(), text.data(), text.size());
+		if (!core::FileSystemManager::writeFile(path, data.get())) {
+			return false;
+		}
+		m_dirty = false;
+		return true;
+	}
+
+	bool TextureAtlasLayout::find(std::string_view const pool, std::string_view const texture, Placement& placement) const {
+		auto const it = m_placements.find(makeKey(pool, texture));
+		if (it == m_placements.end()) {
+			return false;
+		}
+		placement = it->second;
+		return true;
+	}
+
+	void TextureAtlasLayout::set(std::string_view const pool, std::string_view const texture, Placement const& placement) {
+		auto const [it, inserted] = m_placements.try_emplace(makeKey(pool, texture), placement);
+		if (!inserted) {
+			if (it->second.page == placement.page && it->second.rect.x == placement.rect.x && it->second.rect.y == placement.rect.y
+				&& it->second.rect.width == placement.rect.width && it->second.rect.height == placement.rect.height) {
+				return;
+			}
+			it->second = placement;
+		}
+		m_dirty = true;
+	}
+
+	std::string TextureAtlasLayout::makeKey(std::string_view const pool, std::string_view const texture) {
+		std::string key;
+		key.reserve(pool.size() + 1 + texture.size());
+		key.append(pool);
+		key.push_back('\n');
+		key.append(texture);
+		return key;
+	}
+
+	// TextureAtlas
+
+	void TextureAtlas::add(std::string_view const name, core::Graphics::ITexture2D* const texture, core::IImage* const image) {
+		auto const size = image->getSize();
+		if (size.x == 0 || size.y == 0 || size.x + 2 * padding > page_size || size.y + 2 * padding > page_size) {
+			return;
+		}
+		m_pending.push_back(Pending{ std::string(name), core::SmartReference(texture), core::SmartReference(image) });
+	}
+
+	bool TextureAtlas::build(core::Graphics::IDevice* const device, std::string_view const pool_name, TextureAtlasLayout* const layout) {
+		// Textures with a saved position go first, in page order, then the rest from the largest down, which packs tighter
+		struct Item {
+			Pending* pending{};
+			TextureAtlasLayout::Placement saved;
+			bool restore{};
+		};
+		std::vector<Item> items;
+		items.reserve(m_pending.size());
+		for (auto& pending : m_pending) {
+			Item item{ &pending };
+			auto const size = pending.image->getSize();
+			item.restore = layout && layout->find(pool_name, pending.name, item.saved)
+				&& item.saved.rect.width == size.x && item.saved.rect.height == size.y
+				&& item.saved.rect.x >= padding && item.saved.rect.y >= padding
+				&& item.saved.page < max_restored_page_count;
+			items.push_back(item);
+		}
+		std::ranges::stable_sort(items, [](Item const& a, Item const& b) {
+			if (a.restore != b.restore) {
+				return a.restore;
+			}
+			if (a.restore) {
+				return a.saved.page < b.saved.page;
+			}
+			auto const sa = a.pending->image->getSize();
+			auto const sb = b.pending->image->getSize();
+			return std::max(sa.x, sa.y) > std::max(sb.x, sb.y);
+		});
+
+		bool result = true;
+		size_t restored{};
+		for (auto const& item : items) {
+			auto const size = item.pending->image->getSize();
+			uint32_t const width = size.x + 2 * padding;
+			uint32_t const height = size.y + 2 * padding;
+			uint32_t page_index{ UINT32_MAX };
+			TextureAtlasRect rect;
+			if (item.restore) {
+				while (m_pages.size() <= item.saved.page && addPage(device)) {
+				}
+				rect = TextureAtlasRect{ item.saved.rect.x - padding, item.saved.rect.y - padding, width, height };
+				if (item.saved.page < m_pages.size() && m_pages[item.saved.page].packer.claim(rect)) {
+					page_index = item.saved.page;
+					restored += 1;
+				}
+			}
+			if (page_index == UINT32_MAX) {
+				for (uint32_t i = 0; i < m_pages.size(); i += 1) {
+					if (m_pages[i].packer.insert(width, height, rect)) {
+						page_index = i;
+						break;
+					}
+				}
+			}
+			if (page_index == UINT32_MAX) {
+				if (!addPage(device) || !m_pages.back().packer.insert(width, height, rect)) {
+					result = false;
+					continue;
+				}
+				page_index = static_cast<uint32_t>(m_pages.size() - 1);
+			}
+
+			blit(m_pages[page_index], rect, item.pending->image.get());
+			TextureAtlasRect const inner{ rect.x + padding, rect.y + padding, size.x, size.y };
+			m_entries.insert_or_assign(item.pending->texture.get(), Entry{ item.pending->texture, page_index, inner });
+			if (layout) {
+				layout->set(pool_name, item.pending->name, TextureAtlasLayout::Placement{ page_index, inner });
+			}
+		}
+		m_pending.clear();
+
+		for (auto& page : m_pages) {
+			if (page.dirty_l == UINT32_MAX) {
+				continue;
+			}
+			auto const pixels = static_cast<core::Color4B const*>(page.pixels->data());
+			if (!page.texture->uploadPixelData(
+				core::RectU(page.dirty_l, page.dirty_t, page.dirty_r, page.dirty_b),
+				pixels + static_cast<size_t>(page.dirty_t) * page_size + page.dirty_l,
+				page_size * sizeof(core::Color4B))) {
+				result = false;
+			}
+			page.dirty_l = UINT32_MAX;
+			page.dirty_t = UINT32_MAX;
+			page.dirty_r = 0;
+			page.dirty_b = 0;
+		}
+
+		if (!items.empty()) {
+			core::Logger::info("[luastg] [TextureAtlas] Packed {} texture(s) ({} at their saved position) of resource pool '{}' into {} page(s)",
+				items.size(), restored, pool_name, m_pages.size());
+		}
+		return result;
+	}
+
+	bool TextureAtlas::remap(core::Graphics::ISprite* const sprite, core::Vector2F& offset) const {
+		auto const it = m_entries.find(sprite->getTexture());
+		if (it == m_entries.end()) {
+			return false;
+		}
+		auto const& entry = it->second;
+		if (entry.texture->getSamplerState() != nullptr || entry.texture->isPremultipliedAlpha()) {
+			return false;
+		}
+		auto const rect = sprite->getTextureRect();
+		if (rect.a.x < 0.0f || rect.a.y < 0.0f || rect.a.x > rect.b.x || rect.a.y > rect.b.y
+			|| rect.b.x > static_cast<float>(entry.rect.width) || rect.b.y > static_cast<float>(entry.rect.height)) {
+			return false;
+		}
+		offset = core::Vector2F(static_cast<float>(entry.rect.x), static_cast<float>(entry.rect.y));
+		auto const center = sprite->getTextureCenter();
+		sprite->setTexture(m_pages[entry.page].texture.get());
+		sprite->setTextureRect(core::RectF(rect.a + offset, rect.b + offset));
+		sprite->setTextureCenter(center + offset);
+		return true;
+	}
+
+	bool TextureAtlas::unmap(core::Graphics::ISprite* const sprite, core::Graphics::ITexture2D* const texture, core::Vector2F& offset) const {
+		auto const it = m_entries.find(texture);
+		if (it == m_entries.end()) {
+			return false;
+		}
+		auto const& entry = it->second;
+		if (sprite->getTexture() != m_pages[entry.page].texture.get()) {
+			return false;
+		}
+		// Packed textures never overlap, a rectangle inside the area of texture came from it
+		auto const rect = sprite->getTextureRect();
+		auto const l = static_cast<float>(entry.rect.x);
+		auto const t = static_cast<float>(entry.rect.y);
+		if (rect.a.x < l || rect.a.y < t
+			|| rect.b.x > l + static_cast<float>(entry.rect.width) || rect.b.y > t + static_cast<float>(entry.rect.height)) {
+			return false;
+		}
+		offset = core::Vector2F(-l, -t);
+		auto const center = sprite->getTextureCenter();
+		sprite->setTexture(texture);
+		sprite->setTextureRect(core::RectF(rect.a + offset, rect.b + offset));
+		sprite->setTextureCenter(center + offset);
+		return true;
+	}
+
+	bool TextureAtlas::contains(core::Graphics::ITexture2D* const texture) const {
+		return m_entries.contains(texture)
+			|| std::ranges::any_of(m_pending, [texture](Pending const& pending) { return pending.texture.get() == texture; });
+	}
+
+	void TextureAtlas::remove(core::Graphics::ITexture2D* const texture) {
+		std::erase_if(m_pending, [texture](Pending const& pending) { return pending.texture.get() == texture; });
+		m_entries.erase(texture);
+	}
+
+	void TextureAtlas::clear() noexcept {
+		m_pending.clear();
+		m_entries.clear();
+		m_pages.clear();
+	}
+
+	TextureAtlasStatistics TextureAtlas::getStatistics() const {
+		TextureAtlasStatistics statistics;
+		statistics.page_count = m_pages.size();
+		statistics.texture_count = m_entries.size();
+		statistics.pending_count = m_pending.size();
+		statistics.page_bytes = static_cast<uint64_t>(m_pages.size()) * page_size * page_size * sizeof(core::Color4B);
+		for (auto const& page : m_pages) {
+			statistics.occupancy += page.packer.getOccupancy();
+		}
+		if (!m_pages.empty()) {
+			statistics.occupancy /= static_cast<double>(m_pages.size());
+		}
+		return statistics;
+	}
+
+	bool TextureAtlas::addPage(core::Graphics::IDevice* const device) {
+		Page page;
+		size_t const size = static_cast<size_t>(page_size) * page_size * sizeof(core::Color4B);
+		if (!core::IData::create(size, page.pixels.put())) {
+			return false;
+		}
+		std::memset(page.pixels->data(), 0, size);
+		if (!device->createTexture(core::Vector2U(page_size, page_size), page.texture.put())) {
+			return false;
+		}
+		page.texture->setPixelData(page.pixels.get());
+		m_pages.emplace_back(std::move(page));
+		return true;
+	}
+
+	void TextureAtlas::blit(Page& page, TextureAtlasRect const& rect, core::IImage* const image) {
+		auto const size = image->getSize();
+		auto const source = image->getPixelData();
+		auto const pixels = static_cast<core::Color4B*>(page.pixels->data());
+		for (uint32_t y = 0; y < rect.height; y += 1) {
+			uint32_t const source_y = std::min(y > padding ? y - padding : 0u, size.y - 1);
+			auto const source_row = source + static_cast<size_t>(source_y) * size.x;
+			auto const row = pixels + static_cast<size_t>(rect.y + y) * page_size + rect.x;
+			std::fill_n(row, padding, source_row[0]);
+			std::memcpy(row + padding, source_row, size.x * sizeof(core::Color4B));
+			std::fill_n(row + padding + size.x, padding, source_row[size.x - 1]);
+		}
+		page.dirty_l = std::min(page.dirty_l, rect.x);
+		page.dirty_t = std::min(page.dirty_t, rect.y);
+		page.dirty_r = std::max(page.dirty_r, rect.x + rect.width);
+		page.dirty_b = std::max(page.dirty_b, rect.y + rect.height);
+	}
+
+}
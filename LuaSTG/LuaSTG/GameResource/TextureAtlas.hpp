@@ -0,0 +1,143 @@
+#pragma once
+#include "core/Data.hpp"
+#include "core/SmartReference.hpp"
+#include "core/Vector2.hpp"
+#include "Core/Graphics/Device.hpp"
+#include "Core/Graphics/Image.hpp"
+#include "Core/Graphics/Sprite.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace luastg {
+
+	struct TextureAtlasRect {
+		uint32_t x{};
+		uint32_t y{};
+		uint32_t width{};
+		uint32_t height{};
+	};
+
+	// MaxRects bin packer, best short side fit.
+	// claim places a rectangle at a fixed position, which is how a saved layout is restored.
+	class TextureAtlasPacker {
+	public:
+		TextureAtlasPacker(uint32_t width, uint32_t height);
+
+		bool insert(uint32_t width, uint32_t height, TextureAtlasRect& output);
+		bool claim(TextureAtlasRect const& rect);
+		// Used area / total area
+		double getOccupancy() const noexcept;
+
+	private:
+		void splitFreeRects(TextureAtlasRect const& used);
+		void pruneFreeRects();
+
+	private:
+		uint32_t m_width{};
+		uint32_t m_height{};
+		uint64_t m_used_area{};
+		std::vector<TextureAtlasRect> m_free_rects;
+	};
+
+	// Page and position of every atlased texture of the previous runs, keyed by pool and texture name.
+	// A texture is only put back at its saved position if it still has the same size.
+	class TextureAtlasLayout {
+	public:
+		struct Placement {
+			uint32_t page{};
+			TextureAtlasRect rect; // without padding
+		};
+
+		bool load(std::string_view path);
+		// Clears the dirty flag on success
+		bool save(std::string_view path);
+		bool find(std::string_view pool, std::string_view texture, Placement& placement) const;
+		void set(std::string_view pool, std::string_view texture, Placement const& placement);
+		bool isDirty() const noexcept { return m_dirty; }
+
+	private:
+		static std::string makeKey(std::string_view pool, std::string_view texture);
+
+	private:
+		std::unordered_map<std::string, Placement> m_placements;
+		bool m_dirty{};
+	};
+
+	struct TextureAtlasStatistics {
+		size_t page_count{};
+		size_t texture_count{};
+		size_t pending_count{};
+		uint64_t page_bytes{};
+		double occupancy{}; // average of all pages
+	};
+
+	// Packs the small textures of one resource pool into shared pages, so sprites drawn from
+	// different textures stop breaking the batches of the renderer.
+	// The original textures stay untouched for everything that uses them directly (RenderTexture, models...),
+	// only sprites are moved onto the pages, see remap.
+	// A texture that is removed, or gets a sampler or alpha mode of its own after it was packed, leaves the atlas,
+	// its area on the page is not reused.
+	class TextureAtlas {
+	public:
+		static constexpr uint32_t page_size{ 2048 };
+		// Edge pixels are repeated into the padding, so bilinear filtering at the border
+		// of a texture samples the same colors as clamp addressing would
+		static constexpr uint32_t padding{ 2 };
+
+		// Queues a texture for the next build, image is its only level
+		void add(std::string_view name, core::Graphics::ITexture2D* texture, core::IImage* image);
+		bool hasPending() const noexcept { return !m_pending.empty(); }
+		// Packs the pending textures and uploads them to the pages, layout is optional
+		bool build(core::Graphics::IDevice* device, std::string_view pool_name, TextureAtlasLayout* layout);
+		// Moves a sprite drawn from an atlased texture onto its page, keeping what it shows.
+		// Sprites that sample outside of their texture (wrap addressing), or whose texture has a sampler
+		// or alpha mode of its own, are left alone.
+		// offset receives how far the texture coordinates of the sprite moved.
+		bool remap(core::Graphics::ISprite* sprite, core::Vector2F& offset) const;
+		// Moves a sprite that remap put onto the page back onto texture, offset receives how far it moved back
+		bool unmap(core::Graphics::ISprite* sprite, core::Graphics::ITexture2D* texture, core::Vector2F& offset) const;
+		bool contains(core::Graphics::ITexture2D* texture) const;
+		// Forgets texture, pending or packed, sprites already remapped keep using the page
+		void remove(core::Graphics::ITexture2D* texture);
+		void clear() noexcept;
+		TextureAtlasStatistics getStatistics() const;
+
+	private:
+		struct Page {
+			core::SmartReference<core::Graphics::ITexture2D> texture;
+			core::SmartReference<core::IData> pixels; // BGRA, restored by the texture after device lost
+			TextureAtlasPacker packer{ page_size, page_size };
+			uint32_t dirty_l{ UINT32_MAX };
+			uint32_t dirty_t{ UINT32_MAX };
+			uint32_t dirty_r{};
+			uint32_t dirty_b{};
+		};
+
+		struct Pending {
+			std::string name;
+			core::SmartReference<core::Graphics::ITexture2D> texture;
+			core::SmartReference<core::IImage> image;
+		};
+
+		struct Entry {
+			// Keeps the texture alive, so its address is never reused by another texture while it is a key
+			core::SmartReference<core::Graphics::ITexture2D> texture;
+			uint32_t page{};
+			TextureAtlasRect rect; // without padding
+		};
+
+		bool addPage(core::Graphics::IDevice* device);
+		void blit(Page& page, TextureAtlasRect const& rect, core::IImage* image);
+
+	private:
+		std::vector<Page> m_pages;
+		std::vector<Pending> m_pending;
+		std::unordered_map<core::Graphics::ITexture2D*, Entry> m_entries;
+	};
+
+}
@@ -0,0 +1,63 @@
+#include "GameResource/TexturePreparer.hpp"
+#include "Core/Graphics/Common/BakedTexture.hpp"
+#include "core/FileSystem.hpp"
+
+namespace luastg {
+
+	bool prepareTexture(core::IData* const data, bool const mipmap, PreparedTexture& output) {
+		output.source = data;
+		output.levels.clear();
+		output.baked = false;
+		output.from_file = false;
+		if (data == nullptr) {
+			return false;
+		}
+
+		// WIC can decode some DDS files, but that would throw away the compression and the prebuilt mipmaps
+		if (core::Graphics::Common::isDdsFile(data)) {
+			return true;
+		}
+
+		core::SmartReference<core::IImage> image;
+		if (!core::IImage::loadFromData(data, image.put())) {
+			return true;
+		}
+		output.levels.emplace_back(image);
+
+		if (mipmap) {
+			for (;;) {
+				auto const size = output.levels.back()->getSize();
+				if (size.x <= 1 && size.y <= 1) {
+					break;
+				}
+				core::SmartReference<core::IImage> level;
+				if (!output.levels.back()->createMipmap(level.put())) {
+					// Out of memory most likely, let the device generate the mipmaps instead
+					output.levels.clear();
+					break;
+				}
+				output.levels.emplace_back(level);
+			}
+		}
+		return true;
+	}
+
+	bool readTexture(std::string_view const path, bool const mipmap, PreparedTexture& output) {
+		output = {};
+		if (core::Graphics::Common::readBakedTexture(path, mipmap, output.source.put())) {
+			output.baked = true;
+			return true;
+		}
+
+		core::SmartReference<core::IData> data;
+		if (!core::FileSystemManager::readFile(path, data.put())) {
+			return false;
+		}
+		if (!prepareTexture(data.get(), mipmap, output)) {
+			return false;
+		}
+		output.from_file = true;
+		return true;
+	}
+
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include "core/Data.hpp"
+#include "core/SmartReference.hpp"
+#include "Core/Graphics/Image.hpp"
+
+#include <string_view>
+#include <vector>
+
+namespace luastg {
+
+	// Texture decoded on the CPU, only the upload is left for the thread that owns the graphics device.
+	// levels is the full mip chain (or only the base level), straight alpha BGRA;
+	// it is empty when the file is not decodable on the CPU (DDS for example),
+	// then the device loads source the same way it always did.
+	// baked is true when source is the precompressed DDS written by texture-compressor
+	// instead of the file that was asked for.
+	// from_file is true when source was read from the path passed to readTexture, the texture can then read it
+	// again after device lost instead of keeping source in memory.
+	struct PreparedTexture {
+		core::SmartReference<core::IData> source;
+		std::vector<core::SmartReference<core::IImage>> levels;
+		bool baked{};
+		bool from_file{};
+	};
+
+	// Decodes data and builds the mip chain, does not touch the graphics device and can run on any thread.
+	// Returns false only when data is null, a format the CPU decoder doesn't know is not an error.
+	bool prepareTexture(core::IData* data, bool mipmap, PreparedTexture& output);
+
+	// Reads the baked texture of path if the mounted file systems have one, which already contains
+	// compressed mipmaps and skips the CPU decode; otherwise reads path and prepares it.
+	// Returns false when neither file can be read.
+	bool readTexture(std::string_view path, bool mipmap, PreparedTexture& output);
+
+}
@@ -2,6 +2,7 @@
 #include "GameResource/AsyncResourceLoader.hpp"
 #include "lua/plus.hpp"
 #include "lua.hpp"
+#include "AppFrame.h"
 
 #include <optional>
 #include <string_view>
@@ -114,6 +115,25 @@ namespace luastg::binding {
 			return 1;
 		}
 
+		static int priority(lua_State* const L) {
+			auto* self = cast(L, 1);
+			if (!self->job || !*self->job) {
+				AsyncResourceJobBinding::pushPriority(L, AsyncResourcePriority::Normal);
+				return 1;
+			}
+			AsyncResourceJobBinding::pushPriority(L, (*self->job)->getPriority());
+			return 1;
+		}
+
+		static int setPriority(lua_State* const L) {
+			auto* self = cast(L, 1);
+			auto const value = AsyncResourceJobBinding::checkPriority(L, 2);
+			if (self->job && *self->job) {
+				LRESMGR().SetAsyncResourceJobPriority(**self->job, value);
+			}
+			return 0;
+		}
+
 		static int cancel(lua_State* const L) {
 			lua::stack_t const S(L);
 			auto* self = cast(L, 1);
@@ -131,6 +151,8 @@ namespace luastg::binding {
 		S.set_map_value(method_table, "isDone"sv, &isDone);
 		S.set_map_value(method_table, "error"sv, &error);
 		S.set_map_value(method_table, "read"sv, &read);
+		S.set_map_value(method_table, "priority"sv, &priority);
+		S.set_map_value(method_table, "setPriority"sv, &setPriority);
 		S.set_map_value(method_table, "cancel"sv, &cancel);
 
 		auto const metatable = S.create_metatable(class_name);
@@ -147,4 +169,42 @@ namespace luastg::binding {
 		self->job = new std::shared_ptr<AsyncResourceJob>(std::move(job));
 	}
 
+	bool AsyncResourceJobBinding::is(lua_State* const L, int const index) {
+		lua::stack_t const S(L);
+		return S.is_metatable(index, class_name);
+	}
+
+	std::shared_ptr<AsyncResourceJob> AsyncResourceJobBinding::as(lua_State* const L, int const index) {
+		auto* self = cast(L, index);
+		if (!self->job) {
+			return {};
+		}
+		return *self->job;
+	}
+
+	AsyncResourcePriority AsyncResourceJobBinding::checkPriority(lua_State* const L, int const index) {
+		lua::stack_t const S(L);
+		auto const name = S.get_value<std::string_view>(index);
+		if (name == "urgent"sv) {
+			return AsyncResourcePriority::Urgent;
+		}
+		if (name == "normal"sv) {
+			return AsyncResourcePriority::Normal;
+		}
+		if (name == "prefetch"sv) {
+			return AsyncResourcePriority::Prefetch;
+		}
+		luaL_argerror(L, index, "priority must be 'urgent', 'normal' or 'prefetch'");
+		return AsyncResourcePriority::Normal;
+	}
+
+	void AsyncResourceJobBinding::pushPriority(lua_State* const L, AsyncResourcePriority const priority) {
+		lua::stack_t const S(L);
+		switch (priority) {
+		case AsyncResourcePriority::Urgent: S.push_value("urgent"sv); break;
+		case AsyncResourcePriority::Prefetch: S.push_value("prefetch"sv); break;
+		default: S.push_value("normal"sv); break;
+		}
+	}
+
 }
@@ -1,10 +1,12 @@
 #pragma once
+#include <cstdint>
 #include <memory>
 
 struct lua_State;
 
 namespace luastg {
 	class AsyncResourceJob;
+	enum class AsyncResourcePriority : uint8_t;
 }
 
 namespace luastg::binding {
@@ -12,6 +14,11 @@ namespace luastg::binding {
 	struct AsyncResourceJobBinding {
 		static void registerClass(lua_State* L);
 		static void createAndPush(lua_State* L, std::shared_ptr<AsyncResourceJob> job);
+		static bool is(lua_State* L, int index);
+		static std::shared_ptr<AsyncResourceJob> as(lua_State* L, int index);
+		// "urgent", "normal" or "prefetch"
+		static AsyncResourcePriority checkPriority(lua_State* L, int index);
+		static void pushPriority(lua_State* L, AsyncResourcePriority priority);
 	};
 
 }
@@ -1,6 +1,7 @@
 #include "LuaBinding/LuaWrapper.hpp"
 #include "lua/plus.hpp"
 #include "AppFrame.h"
+#include "GameResource/SoundEffectVoicePool.hpp"
 
 // 微软我日你仙人
 #ifdef PlaySound
@@ -140,6 +141,47 @@ void luastg::binding::Audio::Register(lua_State* L)noexcept
 			lua_pushnumber(L, p->GetSpeed());
 			return 1;
 		}
+		static int SetSEPolyphony(lua_State* vm) {
+			lua::stack_t const ctx(vm);
+			auto const name = ctx.get_value<std::string_view>(1);
+			core::SmartReference<IResourceSoundEffect> p = LRES.FindSound(name.data());
+			if (!p)
+				return luaL_error(vm, "sound '%s' not found.", name.data());
+			auto const polyphony = ctx.get_value<int32_t>(2);
+			if (polyphony < 1)
+				return luaL_error(vm, "invalid polyphony %d, must be at least 1.", polyphony);
+			p->SetPolyphony(static_cast<uint32_t>(polyphony));
+			p->SetPriority(ctx.get_value<int32_t>(3, p->GetPriority()));
+			return 0;
+		}
+		static int GetSEPolyphony(lua_State* vm) {
+			lua::stack_t const ctx(vm);
+			auto const name = ctx.get_value<std::string_view>(1);
+			core::SmartReference<IResourceSoundEffect> p = LRES.FindSound(name.data());
+			if (!p)
+				return luaL_error(vm, "sound '%s' not found.", name.data());
+			ctx.push_value<int32_t>(static_cast<int32_t>(p->GetPolyphony()));
+			ctx.push_value<int32_t>(p->GetPriority());
+			ctx.push_value<int32_t>(static_cast<int32_t>(p->GetVoiceCount()));
+			return 3;
+		}
+		static int SetSEVoiceLimit(lua_State* vm) {
+			lua::stack_t const ctx(vm);
+			auto const count = ctx.get_value<int32_t>(1);
+			if (count < 1)
+				return luaL_error(vm, "invalid voice limit %d, must be at least 1.", count);
+			LRES.GetSoundEffectVoicePool().setMaxVoiceCount(static_cast<uint32_t>(count));
+			return 0;
+		}
+		static int GetSEVoiceLimit(lua_State* vm) {
+			lua::stack_t const ctx(vm);
+			auto const& pool = LRES.GetSoundEffectVoicePool();
+			auto const statistics = pool.getStatistics();
+			ctx.push_value<int32_t>(static_cast<int32_t>(pool.getMaxVoiceCount()));
+			ctx.push_value<int32_t>(static_cast<int32_t>(statistics.voices));
+			ctx.push_value<int32_t>(static_cast<int32_t>(statistics.active));
+			return 3;
+		}
 		static int UpdateSound(lua_State*)noexcept
 		{
 			// 否决的方法
@@ -405,6 +447,10 @@ void luastg::binding::Audio::Register(lua_State* L)noexcept
 		{ "GetSEVolume", &Wrapper::GetSEVolume },
 		{ "SetSESpeed", &Wrapper::SetSESpeed },
 		{ "GetSESpeed", &Wrapper::GetSESpeed },
+		{ "SetSEPolyphony", &Wrapper::SetSEPolyphony },
+		{ "GetSEPolyphony", &Wrapper::GetSEPolyphony },
+		{ "SetSEVoiceLimit", &Wrapper::SetSEVoiceLimit },
+		{ "GetSEVoiceLimit", &Wrapper::GetSEVoiceLimit },
 		{ "UpdateSound", &Wrapper::UpdateSound },
 
 		{ "PlayMusic", &Wrapper::PlayMusic },
@@ -329,6 +329,27 @@ void luastg::binding::Input::Register(lua_State* L) noexcept
 			lua_pushinteger(L, LAPP.GetLastKey());
 			return 1;
 		}
+		static int GetInputReplayFrame(lua_State* L) noexcept
+		{
+			uint64_t frame{};
+			if (!LAPP.GetInputReplayFrame(frame))
+			{
+				lua_pushnil(L);
+				return 1;
+			}
+			lua_pushinteger(L, static_cast<lua_Integer>(frame));
+			return 1;
+		}
+		static int SeekInputReplay(lua_State* L)
+		{
+			auto const frame = luaL_checkinteger(L, 1);
+			if (frame < 0)
+			{
+				return luaL_argerror(L, 1, "frame must not be negative");
+			}
+			lua_pushboolean(L, LAPP.SeekInputReplay(static_cast<uint64_t>(frame)));
+			return 1;
+		}
 	};
 
 	luaL_Reg lib_empty[] = {
@@ -339,6 +360,8 @@ void luastg::binding::Input::Register(lua_State* L) noexcept
 		{ "GetMouseState", &Wrapper::GetMouseState },
 		{ "GetMousePosition", &Wrapper::GetMousePosition },
 		{ "GetMouseWheelDelta", &Wrapper::GetMouseWheelDelta },
+		{ "GetInputReplayFrame", &Wrapper::GetInputReplayFrame },
+		{ "SeekInputReplay", &Wrapper::SeekInputReplay },
 		// 应该废弃的方法
 		{ "GetLastKey", &Wrapper::GetLastKey },
 		{NULL, NULL},
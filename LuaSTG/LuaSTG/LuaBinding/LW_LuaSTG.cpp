@@ -1,6 +1,7 @@
 #include "LuaBinding/LuaWrapper.hpp"
 #include "lua/plus.hpp"
 #include "AppFrame.h"
+#include "utf8.hpp"
 
 inline core::RectI lua_to_Core_RectI(lua_State* L, int idx)
 {
@@ -86,6 +87,54 @@ void luastg::binding::BuiltInFunction::Register(lua_State* L)noexcept
 			lua_pushnumber(L, LAPP.GetFPS());
 			return 1;
 		}
+		static int GetFrameTelemetry(lua_State* L)noexcept
+		{
+			// 最近 count 帧的统计，时间单位为毫秒
+			lua::stack_t S(L);
+			auto const count = S.get_value<uint32_t>(1, 0);
+			auto const summary = LAPP.GetAppModel()->getFrameTelemetry()->summarize(count);
+			auto const push_percentile = [&S](core::FrameTelemetryPercentile const& value) {
+				auto const idx = S.create_map(4);
+				S.set_map_value(idx, "p50", value.p50 * 1000.0);
+				S.set_map_value(idx, "p95", value.p95 * 1000.0);
+				S.set_map_value(idx, "p99", value.p99 * 1000.0);
+				S.set_map_value(idx, "max", value.max * 1000.0);
+			};
+			auto const idx = S.create_map(10);
+			S.set_map_value(idx, "frame_count", static_cast<uint64_t>(summary.frame_count));
+			S.set_map_value(idx, "missed_vblank", summary.missed_vblank);
+			S.set_map_value(idx, "missed_frame_count", static_cast<uint64_t>(summary.missed_frame_count));
+			std::pair<std::string_view, core::FrameTelemetryPercentile const*> const fields[] = {
+				{ "total_time", &summary.total_time },
+				{ "update_time", &summary.update_time },
+				{ "render_time", &summary.render_time },
+				{ "present_time", &summary.present_time },
+				{ "wait_time", &summary.wait_time },
+				{ "sleep_overshoot", &summary.sleep_overshoot },
+				{ "input_latency", &summary.input_latency },
+			};
+			for (auto const& [key, value] : fields) {
+				S.push_value(key);
+				push_percentile(*value);
+				lua_settable(L, idx.value);
+			}
+			return 1;
+		}
+		static int SaveFrameTelemetry(lua_State* L)noexcept
+		{
+			lua::stack_t S(L);
+			auto const path = S.get_value<std::string_view>(1);
+			auto const count = S.get_value<uint32_t>(2, 0);
+			auto const result = LAPP.GetAppModel()->getFrameTelemetry()->writeCSV(utf8::to_wstring(path), count);
+			S.push_value(result);
+			return 1;
+		}
+		static int ClearFrameTelemetry(lua_State* L)noexcept
+		{
+			std::ignore = L;
+			LAPP.GetAppModel()->getFrameTelemetry()->clear();
+			return 0;
+		}
 		static int Log(lua_State* L)noexcept
 		{
 			lua::stack_t S(L);
@@ -210,6 +259,7 @@ void luastg::binding::BuiltInFunction::Register(lua_State* L)noexcept
 		}
 		static int SetSwapChainScalingMode(lua_State* L)noexcept
 		{
+			LAPP.GetAppModel()->synchronizeRenderThread();
 			LAPP.GetAppModel()->getSwapChain()->setScalingMode(
 				(core::Graphics::SwapChainScalingMode)luaL_checkinteger(L, 1));
 			return 0;
@@ -224,6 +274,9 @@ void luastg::binding::BuiltInFunction::Register(lua_State* L)noexcept
 		{ "SetWindowed", &Wrapper::SetWindowed },
 		{ "SetFPS", &Wrapper::SetFPS },
 		{ "GetFPS", &Wrapper::GetFPS },
+		{ "GetFrameTelemetry", &Wrapper::GetFrameTelemetry },
+		{ "SaveFrameTelemetry", &Wrapper::SaveFrameTelemetry },
+		{ "ClearFrameTelemetry", &Wrapper::ClearFrameTelemetry },
 		{ "SetVsync", &Wrapper::SetVsync },
 		{ "SetPreferenceGPU", &Wrapper::SetPreferenceGPU },
 		{ "SetResolution", &Wrapper::SetResolution },
@@ -6,6 +6,7 @@
 #include "LuaBinding/modern/Vector4.hpp"
 #include "LuaBinding/modern/RenderTarget.hpp"
 #include "LuaBinding/modern/DepthStencilBuffer.hpp"
+#include "LuaBinding/modern/Sprite.hpp"
 #include "AppFrame.h"
 #include "GameResource/Implement/ResourceTextureImpl.hpp"
 #include "GameResource/LegacyBlendStateHelper.hpp"
@@ -461,6 +462,121 @@ namespace luastg {
 		return 0;
 	}
 
+	// Size in bytes of a cdata as ffi.sizeof reports it, for a pointer cdata this is the size of the pointer
+	static bool get_cdata_size(lua_State* L, int const index, size_t& size) {
+		lua_getfield(L, LUA_REGISTRYINDEX, "_LOADED");
+		lua_getfield(L, -1, "ffi");
+		if (!lua_istable(L, -1)) {
+			lua_pop(L, 2);
+			return false;
+		}
+		lua_getfield(L, -1, "sizeof");
+		lua_pushvalue(L, index);
+		lua_call(L, 1, 1);
+		bool const result = lua_isnumber(L, -1);
+		size = result ? (size_t)lua_tonumber(L, -1) : 0;
+		lua_pop(L, 3);
+		return result;
+	}
+
+	// drawSpriteBatch(sprite, instances, [count], [blend], [z])
+	// sprite: sprite name or lstg.Sprite, lstg.Sprite uses "mul+alpha" when no blend mode is given
+	// instances: flat table { x, y, rot, hscale, vscale, color, ... }, color is lstg.Color or an ARGB number,
+	//            or a LuaJIT FFI array (or lightuserdata) of struct { float x, y, rot, hscale, vscale; uint32_t color; }, count is required,
+	//            FFI pointers (ffi.cast("T*", ...)) are rejected, pass the array itself or a lightuserdata instead
+	// rot is in degrees, same as drawSprite
+	static int lib_drawSpriteBatch(lua_State* L) {
+		validate_render_scope();
+
+		// LuaJIT cdata, not defined in lua.h
+		constexpr int lua_type_cdata = 10;
+		static std::vector<core::Graphics::SpriteInstance> instances;
+
+		core::SmartReference<IResourceSprite> pimg2dres;
+		core::Graphics::ISprite* p_sprite{};
+		if (binding::Sprite::is(L, 1)) {
+			p_sprite = binding::Sprite::as(L, 1)->data;
+		}
+		else {
+			const char* name = luaL_checkstring(L, 1);
+			pimg2dres = LRESMGR().FindSprite(name);
+			if (!pimg2dres) {
+				spdlog::error("[luastg] lstg.Renderer.drawSpriteBatch failed, can't find sprite '{}'", name);
+				return luaL_error(L, "can't find sprite '%s'", name);
+			}
+			p_sprite = pimg2dres->GetSprite();
+		}
+
+		float const scale = pimg2dres ? LRESMGR().GetGlobalImageScaleFactor() : 1.0f;
+		instances.clear();
+		if (lua_istable(L, 2)) {
+			size_t const length = lua_objlen(L, 2);
+			size_t const count = lua_isnoneornil(L, 3) ? (length / 6) : (size_t)luaL_checkinteger(L, 3);
+			if (count > length / 6) {
+				return luaL_error(L, "instances table too short, %d instances need %d values", (int)count, (int)(count * 6));
+			}
+			instances.resize(count);
+			for (size_t i = 0; i < count; i += 1) {
+				int const base = (int)(i * 6);
+				for (int k = 1; k <= 6; k += 1) {
+					lua_rawgeti(L, 2, base + k);
+				}
+				auto& instance = instances[i];
+				instance.x = (float)lua_tonumber(L, -6);
+				instance.y = (float)lua_tonumber(L, -5);
+				instance.rotation = (float)(lua_tonumber(L, -4) * L_DEG_TO_RAD);
+				instance.hscale = (float)lua_tonumber(L, -3) * scale;
+				instance.vscale = (float)lua_tonumber(L, -2) * scale;
+				if (lua_isnumber(L, -1)) {
+					instance.color = (uint32_t)lua_tonumber(L, -1);
+				}
+				else {
+					instance.color = binding::Color::Cast(L, -1)->color();
+				}
+				lua_pop(L, 6);
+			}
+		}
+		else if (lua_type(L, 2) == lua_type_cdata || lua_islightuserdata(L, 2)) {
+			// For cdata lua_topointer returns the address of the payload: the elements of an array,
+			// but the pointer value itself for a pointer cdata, so only arrays large enough for count are accepted
+			auto const p_source = static_cast<core::Graphics::SpriteInstance const*>(lua_topointer(L, 2));
+			lua_Integer const count = luaL_checkinteger(L, 3);
+			if (!p_source || count < 0) {
+				return luaL_error(L, "invalid instances buffer");
+			}
+			if (lua_type(L, 2) == lua_type_cdata) {
+				size_t size{};
+				if (!get_cdata_size(L, 2, size) || size < (size_t)count * sizeof(core::Graphics::SpriteInstance)) {
+					return luaL_error(L, "instances cdata must be an array of at least %d instances, pointers are not accepted", (int)count);
+				}
+			}
+			instances.assign(p_source, p_source + count);
+			for (auto& instance : instances) {
+				instance.rotation *= L_DEG_TO_RAD_F;
+				instance.hscale *= scale;
+				instance.vscale *= scale;
+			}
+		}
+		else {
+			return luaL_typerror(L, 2, "table or cdata");
+		}
+
+		if (!lua_isnoneornil(L, 4)) {
+			translate_blend(LR2D(), TranslateBlendMode(L, 4));
+		}
+		else {
+			translate_blend(LR2D(), pimg2dres ? pimg2dres->GetBlendMode() : BlendMode::MulAlpha);
+		}
+		float const z_backup = p_sprite->getZ();
+		p_sprite->setZ((float)luaL_optnumber(L, 5, 0.5));
+		bool const result = p_sprite->drawInstances(instances.data(), instances.size());
+		p_sprite->setZ(z_backup);
+		if (!result) {
+			return luaL_error(L, "draw sprite batch failed");
+		}
+		return 0;
+	}
+
 	static int lib_drawSpriteSequence(lua_State* L) {
 		validate_render_scope();
 		float const hscale = (float)luaL_optnumber(L, 6, 1.0);
@@ -597,6 +713,7 @@ namespace luastg {
 		MKFUNC(drawSprite),
 		MKFUNC(drawSpriteRect),
 		MKFUNC(drawSprite4V),
+		MKFUNC(drawSpriteBatch),
 
 		MKFUNC(drawSpriteSequence),
 
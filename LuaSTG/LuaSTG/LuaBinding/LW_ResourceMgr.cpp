@@ -35,15 +35,127 @@ void luastg::binding::ResourceManager::Register(lua_State* L) noexcept
 			ResourceMgr::SetResourceLoadingLog((bool)lua_toboolean(L, 1));
 			return 0;
 		}
+		static int SetAsyncLoadPriority(lua_State* L) noexcept {
+			LRES.SetAsyncResourcePriority(AsyncResourceJobBinding::checkPriority(L, 1));
+			return 0;
+		}
+		static int GetAsyncLoadPriority(lua_State* L) noexcept {
+			AsyncResourceJobBinding::pushPriority(L, LRES.GetAsyncResourcePriority());
+			lua_pushinteger(L, static_cast<lua_Integer>(LRES.GetAsyncResourceWorkerCount()));
+			return 2;
+		}
+		static int SetAsyncLoadFinalizeCount(lua_State* L) noexcept {
+			lua_Integer const count = luaL_checkinteger(L, 1);
+			if (count < 1) {
+				return luaL_argerror(L, 1, "count must be at least 1");
+			}
+			LRES.SetAsyncResourceFinalizeCount(static_cast<size_t>(count));
+			return 0;
+		}
+		static int SetAsyncLoadFinalizeBudget(lua_State* L) noexcept {
+			lua_Integer const budget_us = luaL_checkinteger(L, 1);
+			if (budget_us < 0 || budget_us > UINT32_MAX) {
+				return luaL_argerror(L, 1, "budget (microseconds) out of range");
+			}
+			LRES.SetAsyncResourceFinalizeBudget(static_cast<uint32_t>(budget_us));
+			return 0;
+		}
+		static int SetTextureAtlasEnable(lua_State* L) noexcept {
+			bool const enable = lua_toboolean(L, 1);
+			lua_Integer const max_size = luaL_optinteger(L, 2, 256);
+			if (max_size < 1 || max_size > static_cast<lua_Integer>(TextureAtlas::page_size - 2 * TextureAtlas::padding)) {
+				return luaL_argerror(L, 2, "max texture size out of range");
+			}
+			LRES.SetTextureAtlasEnable(enable, static_cast<uint32_t>(max_size));
+			return 0;
+		}
+		static int SetTextureAtlasLayoutFile(lua_State* L) noexcept {
+			if (lua_isnoneornil(L, 1)) {
+				LRES.SetTextureAtlasLayoutPath({});
+			}
+			else {
+				size_t len = 0;
+				char const* const path = luaL_checklstring(L, 1, &len);
+				LRES.SetTextureAtlasLayoutPath(std::string_view(path, len));
+			}
+			return 0;
+		}
+		static int BuildTextureAtlas(lua_State*) noexcept {
+			LRES.UpdateTextureAtlas();
+			return 0;
+		}
+		static int GetTextureAtlasStatistics(lua_State* L) noexcept {
+			auto const statistics = LRES.GetTextureAtlasStatistics();
+			lua_createtable(L, 0, 5);
+			lua_pushinteger(L, static_cast<lua_Integer>(statistics.page_count));
+			lua_setfield(L, -2, "pages");
+			lua_pushinteger(L, static_cast<lua_Integer>(statistics.texture_count));
+			lua_setfield(L, -2, "textures");
+			lua_pushinteger(L, static_cast<lua_Integer>(statistics.pending_count));
+			lua_setfield(L, -2, "pending");
+			lua_pushnumber(L, static_cast<lua_Number>(statistics.page_bytes));
+			lua_setfield(L, -2, "bytes");
+			lua_pushnumber(L, statistics.occupancy);
+			lua_setfield(L, -2, "occupancy");
+			return 1;
+		}
+		static int GetAsyncLoadFinalizeStatistics(lua_State* L) noexcept {
+			static char const* const type_names[AsyncResourceRequestTypeCount] = {
+				"texture", "video", "sprite", "animation", "particle", "sound",
+				"music", "sprite_font", "ttf", "fx", "model",
+			};
+			auto const statistics = LRES.GetAsyncResourceFinalizeStatistics();
+			lua_createtable(L, 0, 7);
+			lua_pushinteger(L, static_cast<lua_Integer>(LRES.GetAsyncResourceFinalizeCount()));
+			lua_setfield(L, -2, "count");
+			lua_pushinteger(L, static_cast<lua_Integer>(LRES.GetAsyncResourceFinalizeBudget()));
+			lua_setfield(L, -2, "budget");
+			lua_pushnumber(L, statistics.spent_us);
+			lua_setfield(L, -2, "spent");
+			lua_pushinteger(L, static_cast<lua_Integer>(statistics.finalized));
+			lua_setfield(L, -2, "finalized");
+			lua_pushinteger(L, static_cast<lua_Integer>(statistics.deferred));
+			lua_setfield(L, -2, "deferred");
+			lua_createtable(L, 0, static_cast<int>(AsyncResourceRequestTypeCount));
+			for (size_t i = 0; i < AsyncResourceRequestTypeCount; i += 1) {
+				if (statistics.costs[i].samples > 0) {
+					lua_pushnumber(L, statistics.costs[i].estimate_us);
+					lua_setfield(L, -2, type_names[i]);
+				}
+			}
+			lua_setfield(L, -2, "cost");
+			return 1;
+		}
 		static AsyncResourceRequest CreateAsyncRequest(lua_State* L, AsyncResourceRequestType type)
 		{
 			auto* pool = BeginPoolCall(L);
 			AsyncResourceRequest request;
 			request.type = type;
 			request.pool_id = pool->GetId();
+			request.priority = LRES.GetAsyncResourcePriority();
 			request.name = luaL_checkstring(L, 1);
 			return request;
 		}
+		// A texture, or the async job loading it
+		static void CheckAsyncTexture(lua_State* L, int index, AsyncResourceRequest& request)
+		{
+			if (AsyncResourceJobBinding::is(L, index)) {
+				request.dependencies.emplace_back(AsyncResourceJobBinding::as(L, index));
+			}
+			else {
+				request.texture = luastg::binding::checkResourceTexture(L, index);
+			}
+		}
+		// A sprite, or the async job creating it
+		static void CheckAsyncSprite(lua_State* L, int index, AsyncResourceRequest& request)
+		{
+			if (AsyncResourceJobBinding::is(L, index)) {
+				request.dependencies.emplace_back(AsyncResourceJobBinding::as(L, index));
+			}
+			else {
+				request.sprite = luastg::binding::checkResourceSprite(L, index);
+			}
+		}
 		static int PushAsyncJob(lua_State* L, AsyncResourceRequest request)
 		{
 			AsyncResourceJobBinding::createAndPush(L, LRES.SubmitAsyncResource(std::move(request)));
@@ -118,7 +230,7 @@ void luastg::binding::ResourceManager::Register(lua_State* L) noexcept
 		static int LoadSpriteAsync(lua_State* L) noexcept
 		{
 			auto request = CreateAsyncRequest(L, AsyncResourceRequestType::Sprite);
-			request.texture = luastg::binding::checkResourceTexture(L, 2);
+			CheckAsyncTexture(L, 2, request);
 			request.x = luaL_checknumber(L, 3);
 			request.y = luaL_checknumber(L, 4);
 			request.w = luaL_checknumber(L, 5);
@@ -197,7 +309,7 @@ void luastg::binding::ResourceManager::Register(lua_State* L) noexcept
 				request.rect = lua_toboolean(L, 6) != 0;
 			}
 			else {
-				request.texture = luastg::binding::checkResourceTexture(L, 2);
+				CheckAsyncTexture(L, 2, request);
 				request.x = luaL_checknumber(L, 3);
 				request.y = luaL_checknumber(L, 4);
 				request.w = luaL_checknumber(L, 5);
@@ -258,7 +370,7 @@ void luastg::binding::ResourceManager::Register(lua_State* L) noexcept
 		static int LoadPSAsync(lua_State* L) noexcept
 		{
 			auto request = CreateAsyncRequest(L, AsyncResourceRequestType::Particle);
-			request.sprite = luastg::binding::checkResourceSprite(L, 3);
+			CheckAsyncSprite(L, 3, request);
 			request.a = luaL_optnumber(L, 4, 0.0f);
 			request.b = luaL_optnumber(L, 5, 0.0f);
 			request.rect = lua_toboolean(L, 6) != 0;
@@ -620,6 +732,7 @@ void luastg::binding::ResourceManager::Register(lua_State* L) noexcept
 			if (p)
 			{
 				p->GetTexture()->setPremultipliedAlpha(lua_toboolean(L, 2));
+				LRES.RemoveTextureFromTextureAtlas(p->GetTexture());
 				return 0;
 			}
 			return luaL_error(L, "texture '%s' not found.", luaL_checkstring(L, 1));
@@ -649,6 +762,7 @@ void luastg::binding::ResourceManager::Register(lua_State* L) noexcept
 				// 设置
 				core::Graphics::ISamplerState* p_sampler = LAPP.GetRenderer2D()->getKnownSamplerState(state);
 				p->GetTexture()->setSamplerState(p_sampler);
+				LRES.RemoveTextureFromTextureAtlas(p->GetTexture());
 
 				return 0;
 			}
@@ -913,10 +1027,27 @@ void luastg::binding::ResourceManager::Register(lua_State* L) noexcept
 			LRES.CacheTTFFontString(luaL_checkstring(L, 1), str, len);
 			return 0;
 		}
+		static int SetTTFGlyphCacheLimit(lua_State* L) noexcept {
+			lua_Integer const count = luaL_checkinteger(L, 1);
+			if (count < 1 || count > 64) {
+				return luaL_argerror(L, 1, "texture count must be between 1 and 64");
+			}
+			LRES.SetTTFGlyphCacheLimit(static_cast<uint32_t>(count));
+			return 0;
+		}
 	};
 
 	luaL_Reg const lib[] = {
 		{ "SetResLoadInfo", &Wrapper::SetResLoadInfo },
+		{ "SetAsyncLoadPriority", &Wrapper::SetAsyncLoadPriority },
+		{ "GetAsyncLoadPriority", &Wrapper::GetAsyncLoadPriority },
+		{ "SetAsyncLoadFinalizeCount", &Wrapper::SetAsyncLoadFinalizeCount },
+		{ "SetAsyncLoadFinalizeBudget", &Wrapper::SetAsyncLoadFinalizeBudget },
+		{ "GetAsyncLoadFinalizeStatistics", &Wrapper::GetAsyncLoadFinalizeStatistics },
+		{ "SetTextureAtlasEnable", &Wrapper::SetTextureAtlasEnable },
+		{ "SetTextureAtlasLayoutFile", &Wrapper::SetTextureAtlasLayoutFile },
+		{ "BuildTextureAtlas", &Wrapper::BuildTextureAtlas },
+		{ "GetTextureAtlasStatistics", &Wrapper::GetTextureAtlasStatistics },
 		{ "LoadTexture", &Wrapper::LoadTexture },
 		{ "LoadTextureAsync", &Wrapper::LoadTextureAsync },
 		{ "LoadVideo", &Wrapper::LoadVideo },
@@ -967,6 +1098,7 @@ void luastg::binding::ResourceManager::Register(lua_State* L) noexcept
 		{ "SetFontState", &Wrapper::SetFontState },
 
 		{ "CacheTTFString", &Wrapper::CacheTTFString },
+		{ "SetTTFGlyphCacheLimit", &Wrapper::SetTTFGlyphCacheLimit },
 		{ NULL, NULL },
 	};
 
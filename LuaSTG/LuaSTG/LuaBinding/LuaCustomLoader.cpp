@@ -1,4 +1,5 @@
 #include "LuaBinding/LuaCustomLoader.hpp"
+#include "LuaBinding/LuaScriptPrecompiler.hpp"
 #include "core/FileSystem.hpp"
 #include "core/SmartReference.hpp"
 #include <algorithm>
@@ -195,7 +196,8 @@ static int package_loader_luastg(lua_State* L) {
 #ifndef NDEBUG
         spdlog::info(R"(require "{}" from {})", name, filename);
 #endif
-        if (luaL_loadbuffer(L,
+        if (!luastg::LuaScriptPrecompiler::getInstance().load(L, filename, src.get())
+            && luaL_loadbuffer(L,
             (char*)src->data(),
             src->size(),
             filename) != 0)
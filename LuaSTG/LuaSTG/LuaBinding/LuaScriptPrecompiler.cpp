@@ -0,0 +1,267 @@
+#include "LuaBinding/LuaScriptPrecompiler.hpp"
+#include "core/Logger.hpp"
+#include "xxhash.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <ranges>
+
+using std::string_view_literals::operator ""sv;
+
+namespace {
+	int writeBytecode(lua_State*, void const* const p, size_t const sz, void* const ud) {
+		static_cast<std::string*>(ud)->append(static_cast<char const*>(p), sz);
+		return 0;
+	}
+
+	void hashSource(core::IData* const source, uint64_t (&output)[2]) {
+		auto const hash = XXH3_128bits(source->data(), source->size());
+		output[0] = hash.low64;
+		output[1] = hash.high64;
+	}
+
+	// Same normalization as the OS file system enumerator, with a trailing separator, empty for the working directory
+	std::string makeDirectoryPrefix(std::string_view const directory) {
+		std::filesystem::path const path(std::u8string_view(reinterpret_cast<char8_t const*>(directory.data()), directory.size()));
+		auto const normalized = path.lexically_normal().generic_u8string();
+		std::string prefix(reinterpret_cast<char const*>(normalized.data()), normalized.size());
+		if (prefix == "."sv || prefix == "/"sv) {
+			prefix.clear();
+		}
+		if (!prefix.empty() && prefix.back() != '/') {
+			prefix.push_back('/');
+		}
+		return prefix;
+	}
+}
+
+namespace luastg {
+
+	LuaScriptPrecompiler::~LuaScriptPrecompiler() {
+		stop();
+	}
+
+	void LuaScriptPrecompiler::start(uint32_t worker_count) {
+		stop();
+		{
+			std::lock_guard const lock(m_mutex);
+			m_exit = false;
+			m_statistics = {};
+		}
+
+		discover();
+
+		if (worker_count == 0) {
+			worker_count = std::max(1u, std::thread::hardware_concurrency());
+		}
+		size_t queued{};
+		{
+			std::lock_guard const lock(m_mutex);
+			queued = m_queue.size();
+		}
+		if (queued == 0) {
+			return;
+		}
+		worker_count = static_cast<uint32_t>(std::min<size_t>(worker_count, queued));
+		core::Logger::info("[luajit] Precompiling {} script(s) on {} worker(s)", queued, worker_count);
+		m_workers.reserve(worker_count);
+		for (uint32_t i = 0; i < worker_count; i += 1) {
+			m_workers.emplace_back(&LuaScriptPrecompiler::workerMain, this);
+		}
+	}
+
+	void LuaScriptPrecompiler::stop() noexcept {
+		{
+			std::lock_guard const lock(m_mutex);
+			m_exit = true;
+			m_queue.clear();
+		}
+		m_cv.notify_all();
+		for (auto& worker : m_workers) {
+			if (worker.joinable()) {
+				worker.join();
+			}
+		}
+		m_workers.clear();
+
+		std::lock_guard const lock(m_mutex);
+		if (m_statistics.discovered != 0) {
+			core::Logger::info("[luajit] Script precompiler: {} discovered, {} compiled, {} failed, {} hit, {} miss",
+				m_statistics.discovered, m_statistics.compiled, m_statistics.failed, m_statistics.hit, m_statistics.miss);
+		}
+		m_entries.clear();
+	}
+
+	bool LuaScriptPrecompiler::load(lua_State* const L, std::string_view const path, core::IData* const source) {
+		std::string const name(path);
+		std::unique_lock lock(m_mutex);
+		auto const it = m_entries.find(name);
+		if (it == m_entries.end()) {
+			return false;
+		}
+		auto& entry = it->second;
+		if (entry.state == EntryState::queued) {
+			// Nobody picked it up yet, compiling it here is faster than waiting, the workers skip it from now on
+			entry.state = EntryState::skipped;
+			m_statistics.miss += 1;
+			return false;
+		}
+		m_cv.wait(lock, [&entry] { return entry.state != EntryState::compiling; });
+		// The workers are done with this entry, nothing needs it after this call
+		bool const compiled = (entry.state == EntryState::compiled);
+		auto const source_size = entry.source_size;
+		uint64_t const source_hash[2]{ entry.source_hash[0], entry.source_hash[1] };
+		auto const bytecode = std::move(entry.bytecode);
+		m_entries.erase(it);
+		lock.unlock();
+
+		bool loaded = false;
+		if (compiled && source != nullptr && source->size() == source_size) {
+			uint64_t hash[2]{};
+			hashSource(source, hash);
+			if (hash[0] == source_hash[0] && hash[1] == source_hash[1]) {
+				loaded = (0 == luaL_loadbuffer(L, bytecode.data(), bytecode.size(), name.c_str()));
+				if (!loaded) {
+					lua_pop(L, 1);
+				}
+			}
+		}
+		lock.lock();
+		if (loaded) {
+			m_statistics.hit += 1;
+		}
+		else {
+			m_statistics.miss += 1;
+		}
+		return loaded;
+	}
+
+	LuaScriptPrecompilerStatistics LuaScriptPrecompiler::getStatistics() {
+		std::lock_guard const lock(m_mutex);
+		return m_statistics;
+	}
+
+	void LuaScriptPrecompiler::discover() {
+		// Same order as FileSystemManager resolves a path: mounted file systems first,
+		// then the directory search paths, the last added one wins
+		core::SmartReference<core::IFileSystemFileSystemEnumerator> enumerator;
+		if (core::FileSystemManager::createFileSystemEnumerator(enumerator.put())) {
+			core::SmartReference<core::IFileSystem> file_system;
+			while (enumerator->next(file_system.put())) {
+				discover(file_system.get(), ""sv);
+			}
+		}
+		auto const search_paths = core::FileSystemManager::getSearchPaths();
+		for (auto const& search_path : search_paths | std::views::reverse) {
+			discover(core::IFileSystemOS::getInstance(), search_path);
+		}
+	}
+
+	void LuaScriptPrecompiler::discover(core::IFileSystem* const file_system, std::string_view const directory) {
+		auto const prefix = makeDirectoryPrefix(directory);
+		core::SmartReference<core::IFileSystemEnumerator> e;
+		if (!file_system->createEnumerator(e.put(), directory, true)) {
+			return;
+		}
+		std::lock_guard const lock(m_mutex);
+		while (e->next()) {
+			auto const path = e->getName();
+			if (e->getNodeType() != core::FileSystemNodeType::file || !path.ends_with(".lua"sv) || !path.starts_with(prefix)) {
+				continue;
+			}
+			// Scripts are loaded by their path relative to the search path, the first one found wins
+			auto const [it, inserted] = m_entries.try_emplace(std::string(path.substr(prefix.size())));
+			if (!inserted) {
+				continue;
+			}
+			it->second.file_system = file_system;
+			it->second.path.assign(path);
+			m_queue.emplace_back(it->first);
+			m_statistics.discovered += 1;
+		}
+	}
+
+	void LuaScriptPrecompiler::workerMain() {
+		lua_State* const W = luaL_newstate();
+		if (W == nullptr) {
+			core::Logger::error("[luajit] Failed to create LuaJIT engine for script precompiler");
+			return;
+		}
+
+		for (;;) {
+			std::string name;
+			std::string path;
+			core::SmartReference<core::IFileSystem> file_system;
+			{
+				std::lock_guard const lock(m_mutex);
+				for (;;) {
+					if (m_exit || m_queue.empty()) {
+						lua_close(W);
+						return;
+					}
+					name = std::move(m_queue.front());
+					m_queue.pop_front();
+					auto const it = m_entries.find(name);
+					if (it == m_entries.end()) {
+						continue;
+					}
+					if (it->second.state == EntryState::skipped) {
+						// The loader already compiled it itself
+						m_entries.erase(it);
+						continue;
+					}
+					auto& entry = it->second;
+					entry.state = EntryState::compiling;
+					file_system = std::move(entry.file_system);
+					path = std::move(entry.path);
+					break;
+				}
+			}
+
+			uint64_t source_hash[2]{};
+			size_t source_size{};
+			std::string bytecode;
+			bool success = false;
+			try {
+				core::SmartReference<core::IData> source;
+				if (file_system->readFile(path, source.put())) {
+					// Compile errors are reported when the main VM compiles the file again
+					if (0 == luaL_loadbuffer(W, static_cast<char const*>(source->data()), source->size(), name.c_str())) {
+						success = (0 == lua_dump(W, &writeBytecode, &bytecode));
+					}
+					lua_settop(W, 0);
+					hashSource(source.get(), source_hash);
+					source_size = source->size();
+				}
+			}
+			catch (...) {
+				lua_settop(W, 0);
+				success = false;
+			}
+
+			{
+				std::lock_guard const lock(m_mutex);
+				auto& entry = m_entries.at(name);
+				if (success) {
+					entry.state = EntryState::compiled;
+					entry.source_hash[0] = source_hash[0];
+					entry.source_hash[1] = source_hash[1];
+					entry.source_size = source_size;
+					entry.bytecode = std::move(bytecode);
+					m_statistics.compiled += 1;
+				}
+				else {
+					entry.state = EntryState::failed;
+					m_statistics.failed += 1;
+				}
+			}
+			m_cv.notify_all();
+		}
+	}
+
+	LuaScriptPrecompiler& LuaScriptPrecompiler::getInstance() {
+		static LuaScriptPrecompiler instance;
+		return instance;
+	}
+
+}
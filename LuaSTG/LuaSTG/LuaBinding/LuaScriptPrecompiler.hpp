@@ -0,0 +1,90 @@
+#pragma once
+#include "lua.hpp"
+#include "core/Data.hpp"
+#include "core/FileSystem.hpp"
+#include "core/SmartReference.hpp"
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace luastg {
+
+	struct LuaScriptPrecompilerStatistics {
+		size_t discovered{};
+		size_t compiled{};
+		size_t failed{};
+		size_t hit{};
+		size_t miss{};
+	};
+
+	// Compiles every *.lua file of the mounted file systems and of the directory search paths to LuaJIT bytecode
+	// on worker lua_States while the engine keeps initializing, and hands the bytecode to the main VM loader on demand.
+	// The working directory itself is not walked, scripts that are only found there are compiled by the loader as usual.
+	// Bytecode is only used when the source read by the loader has the same size and 128-bit hash as the one compiled,
+	// so overridden or hot reloaded scripts always fall back to a normal compile.
+	// Each entry is released once the loader asked for it, the sources are never kept.
+	class LuaScriptPrecompiler {
+	public:
+		LuaScriptPrecompiler() = default;
+		LuaScriptPrecompiler(LuaScriptPrecompiler const&) = delete;
+		LuaScriptPrecompiler(LuaScriptPrecompiler&&) = delete;
+		~LuaScriptPrecompiler();
+
+		LuaScriptPrecompiler& operator=(LuaScriptPrecompiler const&) = delete;
+		LuaScriptPrecompiler& operator=(LuaScriptPrecompiler&&) = delete;
+
+		// Discovers scripts from the mounted file systems and search paths and starts the workers,
+		// worker_count == 0 means hardware concurrency
+		void start(uint32_t worker_count);
+		// Cancels pending work, joins the workers and releases all bytecode
+		void stop() noexcept;
+		// Loads the precompiled chunk of path onto the stack if source matches,
+		// waits if path is being compiled right now, returns false if the caller should compile it itself,
+		// later calls for the same path always return false
+		bool load(lua_State* L, std::string_view path, core::IData* source);
+		LuaScriptPrecompilerStatistics getStatistics();
+
+	public:
+		static LuaScriptPrecompiler& getInstance();
+
+	private:
+		enum class EntryState : uint8_t {
+			queued,
+			compiling,
+			compiled,
+			failed,
+			skipped,
+		};
+
+		struct Entry {
+			EntryState state{ EntryState::queued };
+			core::SmartReference<core::IFileSystem> file_system;
+			std::string path; // in file_system, differs from the name for search paths
+			uint64_t source_hash[2]{};
+			size_t source_size{};
+			std::string bytecode;
+		};
+
+		void discover();
+		void discover(core::IFileSystem* file_system, std::string_view directory);
+		void workerMain();
+
+	private:
+		std::mutex m_mutex;
+		std::condition_variable m_cv;
+		std::unordered_map<std::string, Entry> m_entries;
+		std::deque<std::string> m_queue;
+		std::vector<std::thread> m_workers;
+		LuaScriptPrecompilerStatistics m_statistics;
+		bool m_exit{};
+	};
+
+}
@@ -17,8 +17,10 @@
 #include "LuaBinding/modern/Vector4.hpp"
 #include "LuaBinding/modern/Sprite.hpp"
 #include "LuaBinding/modern/SpriteRenderer.hpp"
+#include "LuaBinding/modern/TextLayout.hpp"
 #include "LuaBinding/modern/FileSystemWatcher.hpp"
 #include "LuaBinding/modern/GameObject.hpp"
+#include "LuaBinding/modern/GameObjectSnapshot.hpp"
 #include "LuaBinding/modern/Well512.hpp"
 #include "LuaBinding/modern/ShellIntegration.hpp"
 
@@ -93,8 +95,10 @@ namespace luastg::binding
 		SpriteRenderer::registerClass(L);
 		SpriteRectRenderer::registerClass(L);
 		SpriteQuadRenderer::registerClass(L);
+		TextLayout::registerClass(L);
 		FileSystemWatcher::registerClass(L);
 		GameObject::registerClass(L);
+		GameObjectSnapshot::registerClass(L);
 		Well512::registerClass(L);
 		ShellIntegration::registerClass(L);
 	}
@@ -166,7 +166,8 @@ namespace luastg::binding
 			auto* self = cast(L, 1);
 			auto const x = S.get_value<float>(2);
 			auto const y = S.get_value<float>(3);
-			self->data->GetSprite()->setTextureCenter(core::Vector2F(x, y));
+			// 坐标是原纹理上的，精灵可能已经被移动到纹理图集
+			self->data->GetSprite()->setTextureCenter(core::Vector2F(x, y) + self->data->GetTextureAtlasOffset());
 			return 0;
 		}
 		static int api_setUnitsPerPixel(lua_State* L)
@@ -2140,6 +2140,7 @@ namespace DirectWrite
 
 			// 获取渲染器和渲染目标
 
+			LAPP.GetAppModel()->synchronizeRenderThread();
 			HRESULT hr = S_OK;
 
 			Microsoft::WRL::ComPtr<ID2D1DeviceContext> d2d1_device_context;
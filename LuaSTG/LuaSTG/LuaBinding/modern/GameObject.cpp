@@ -1,4 +1,5 @@
 #include "LuaBinding/modern/GameObject.hpp"
+#include "LuaBinding/modern/GameObjectSnapshot.hpp"
 #include "LuaBinding/generated/GameObjectMember.hpp"
 #include "GameObject/GameObjectPool.h"
 #include "AppFrame.h"
@@ -9,8 +10,105 @@
 using std::string_view_literals::operator ""sv;
 
 namespace {
+	constexpr auto embedded_script = R"(--- Luastg Retro built-in script
+local declaration = ...
+local has_ffi, ffi = pcall(require, "ffi")
+if not has_ffi then
+	return
+end
+if not pcall(ffi.typeof, "lstg_GameObjectView") then
+	ffi.cdef(declaration)
+end
+local lstg = require("lstg")
+local rawget = rawget
+local cast = ffi.cast
+local view_pointer = ffi.typeof("lstg_GameObjectView*")
+--- Direct view on the hot fields of a game object, JIT-compiled code reads and writes them without going through __index/__newindex
+--- x, y, vx, vy, ax, ay, hscale, vscale, rot, omega, timer are writable, dx, dy are readonly
+--- rot and omega are in radians (o.rot and o.omega are in degrees), timer is an int64_t cdata
+--- Properties with side effects (group, layer, img, colli, status...) still have to be set on the object
+--- The view is only valid until the object is freed, don't keep it after lstg.Del/lstg.Kill or across frames
+--- Writing x/y through the view bypasses the spatial query cache, call lstg.ObjQueryInvalidate afterwards
+---@param o lstg.GameObject
+function lstg.GetGameObjectView(o)
+	return cast(view_pointer, rawget(o, 3))
+end
+)"sv;
+
 	std::byte game_object_meta_table_key{};
 	std::byte game_object_tables_key{};
+	std::byte game_object_snapshot_save_hook_key{};
+	std::byte game_object_snapshot_load_hook_key{};
+
+	// LuaJIT 的 cdata，lua.h 中没有定义
+	constexpr int lua_type_cdata{ 10 };
+
+	// ffi.sizeof 给出的 cdata 大小；指针 cdata 得到的是指针本身的大小
+	bool getCdataSize(lua_State* const vm, int const index, size_t& size) {
+		lua_getfield(vm, LUA_REGISTRYINDEX, "_LOADED");
+		lua_getfield(vm, -1, "ffi");
+		if (!lua_istable(vm, -1)) {
+			lua_pop(vm, 2);
+			return false;
+		}
+		lua_getfield(vm, -1, "sizeof");
+		lua_pushvalue(vm, index);
+		lua_call(vm, 1, 1);
+		bool const result = lua_isnumber(vm, -1);
+		size = result ? static_cast<size_t>(lua_tonumber(vm, -1)) : 0;
+		lua_pop(vm, 3);
+		return result;
+	}
+
+	std::vector<luastg::GameObject*>& getObjectQueryBuffer() {
+		static std::vector<luastg::GameObject*> buffer;
+		return buffer;
+	}
+	// GameObject 的布局受编译选项影响，所以 FFI 声明按实际的偏移量生成，字段之间用字节数组填充
+	std::string makeGameObjectViewDeclaration() {
+		struct Field {
+			size_t offset;
+			size_t size;
+			std::string_view declaration;
+		};
+	#define GAME_OBJECT_VIEW_FIELD(DECLARATION, NAME) Field{ offsetof(luastg::GameObject, NAME), sizeof(luastg::GameObject::NAME), DECLARATION }
+		std::array fields{
+			GAME_OBJECT_VIEW_FIELD("double x;"sv, x),
+			GAME_OBJECT_VIEW_FIELD("double y;"sv, y),
+			GAME_OBJECT_VIEW_FIELD("const double dx;"sv, dx),
+			GAME_OBJECT_VIEW_FIELD("const double dy;"sv, dy),
+			GAME_OBJECT_VIEW_FIELD("double vx;"sv, vx),
+			GAME_OBJECT_VIEW_FIELD("double vy;"sv, vy),
+			GAME_OBJECT_VIEW_FIELD("double ax;"sv, ax),
+			GAME_OBJECT_VIEW_FIELD("double ay;"sv, ay),
+			GAME_OBJECT_VIEW_FIELD("double hscale;"sv, hscale),
+			GAME_OBJECT_VIEW_FIELD("double vscale;"sv, vscale),
+			GAME_OBJECT_VIEW_FIELD("double rot;"sv, rot),
+			GAME_OBJECT_VIEW_FIELD("double omega;"sv, omega),
+			GAME_OBJECT_VIEW_FIELD("int64_t timer;"sv, timer),
+		};
+	#undef GAME_OBJECT_VIEW_FIELD
+		std::sort(fields.begin(), fields.end(), [](Field const& a, Field const& b) { return a.offset < b.offset; });
+
+		std::string declaration("typedef struct lstg_GameObjectView {\n"sv);
+		size_t offset{};
+		size_t padding_index{};
+		for (auto const& field : fields) {
+			if (field.offset > offset) {
+				declaration.append("\tuint8_t _padding"sv);
+				declaration.append(std::to_string(padding_index++));
+				declaration.push_back('[');
+				declaration.append(std::to_string(field.offset - offset));
+				declaration.append("];\n"sv);
+			}
+			declaration.push_back('\t');
+			declaration.append(field.declaration);
+			declaration.push_back('\n');
+			offset = field.offset + field.size;
+		}
+		declaration.append("} lstg_GameObjectView;\n"sv);
+		return declaration;
+	}
 
 	std::string_view getStatusName(luastg::GameObjectStatus const status) {
 		switch (status) {
@@ -147,6 +245,12 @@ namespace {
 		void onAfterBatchIntersectDetect() override {
 			afterBatch();
 		}
+		void onBeforeBatchQueueToDestroy() override {
+			beforeBatch();
+		}
+		void onAfterBatchQueueToDestroy() override {
+			afterBatch();
+		}
 
 		void beforeBatch() {
 			auto const vm = lua_vm.back();
@@ -228,6 +332,120 @@ namespace {
 			return instance;
 		}
 	};
+
+	// 把对象的 id（和 lstg.ObjList 的一样，从 1 开始）写进 Lua 数组或 FFI 的 int32_t 数组，返回对象数量
+	// Lua 数组中多余的旧元素会被清除；FFI 数组的容量由 index + 1 处的参数给出，超出容量的部分不写入，但仍然计入数量
+	// 如果 index 处是字符串 "del"，则不写入 id，而是直接删除这些对象，index + 1 处是可选的删除原因，返回删除的对象数量
+	int writeObjectIds(lua_State* const vm, int const index, std::vector<luastg::GameObject*> const& objects) {
+		lua::stack_t const ctx(vm);
+		auto const count = static_cast<int32_t>(objects.size());
+		if (lua_type(vm, index) == LUA_TSTRING) {
+			auto const action = ctx.get_value<std::string_view>(index);
+			if (action != "del"sv) {
+				return luaL_error(vm, "invalid query action '%s'", action.data());
+			}
+			auto const reason = ctx.get_value<std::string_view>(index + 1, "luastg:query"sv);
+			GameObjectManagerCallbacks::getInstance().lua_vm.push_back(vm);
+			auto const destroyed = LPOOL.queueToFreeObjects(objects, reason);
+			GameObjectManagerCallbacks::getInstance().lua_vm.pop_back();
+			ctx.push_value(static_cast<int32_t>(destroyed));
+			return 1;
+		}
+		if (ctx.is_table(index)) {
+			for (int32_t i = 0; i < count; i += 1) {
+				lua_pushinteger(vm, static_cast<lua_Integer>(objects[i]->id + 1));
+				lua_rawseti(vm, index, i + 1);
+			}
+			for (int32_t i = count + 1;; i += 1) {
+				lua_rawgeti(vm, index, i);
+				bool const is_nil = lua_isnil(vm, -1);
+				lua_pop(vm, 1);
+				if (is_nil) {
+					break;
+				}
+				lua_pushnil(vm);
+				lua_rawseti(vm, index, i);
+			}
+		}
+		else if (lua_type(vm, index) == lua_type_cdata || lua_islightuserdata(vm, index)) {
+			auto const buffer = static_cast<int32_t*>(const_cast<void*>(lua_topointer(vm, index)));
+			auto const capacity = luaL_checkinteger(vm, index + 1);
+			if (buffer == nullptr || capacity < 0) {
+				return luaL_error(vm, "invalid id buffer");
+			}
+			// 对 cdata，lua_topointer 返回的是数据的地址：数组就是元素本身，指针却是指针变量，所以只接受容量足够的数组
+			if (lua_type(vm, index) == lua_type_cdata) {
+				size_t size{};
+				if (!getCdataSize(vm, index, size) || size < static_cast<size_t>(capacity) * sizeof(int32_t)) {
+					return luaL_error(vm, "id buffer cdata must be an int32_t array of at least %d elements, pointers are not accepted", static_cast<int>(capacity));
+				}
+			}
+			auto const write_count = std::min<int32_t>(count, static_cast<int32_t>(capacity));
+			for (int32_t i = 0; i < write_count; i += 1) {
+				buffer[i] = static_cast<int32_t>(objects[i]->id + 1);
+			}
+		}
+		else {
+			return luaL_typerror(vm, index, "table or cdata");
+		}
+		ctx.push_value(count);
+		return 1;
+	}
+
+	std::optional<double> getOptionalNumberField(lua_State* const vm, int const index, char const* const name) {
+		lua_getfield(vm, index, name);
+		std::optional<double> value;
+		if (!lua_isnil(vm, -1)) {
+			value = luaL_checknumber(vm, -1);
+		}
+		lua_pop(vm, 1);
+		return value;
+	}
+	// 筛选条件可以是碰撞组，或者是 { group = ?, world = ?, l = ?, r = ?, b = ?, t = ? } 或 { group = ?, world = ?, x = ?, y = ?, radius = ? }
+	luastg::GameObjectFilter readObjectFilter(lua_State* const vm, int const index) {
+		luastg::GameObjectFilter filter;
+		if (lua_isnumber(vm, index)) {
+			filter.group = static_cast<int64_t>(lua_tointeger(vm, index));
+			return filter;
+		}
+		luaL_checktype(vm, index, LUA_TTABLE);
+		filter.group = static_cast<int64_t>(getOptionalNumberField(vm, index, "group").value_or(-1.0));
+		filter.world = static_cast<int64_t>(getOptionalNumberField(vm, index, "world").value_or(0.0));
+		if (auto const radius = getOptionalNumberField(vm, index, "radius"); radius) {
+			filter.shape = luastg::GameObjectFilter::Shape::Circle;
+			filter.x = getOptionalNumberField(vm, index, "x").value_or(0.0);
+			filter.y = getOptionalNumberField(vm, index, "y").value_or(0.0);
+			filter.radius = *radius;
+		}
+		else if (auto const l = getOptionalNumberField(vm, index, "l"); l) {
+			filter.shape = luastg::GameObjectFilter::Shape::Rect;
+			filter.l = *l;
+			filter.r = getOptionalNumberField(vm, index, "r").value_or(*l);
+			filter.b = getOptionalNumberField(vm, index, "b").value_or(0.0);
+			filter.t = getOptionalNumberField(vm, index, "t").value_or(filter.b);
+		}
+		return filter;
+	}
+	luastg::GameObjectProperties readObjectProperties(lua_State* const vm, int const index) {
+		luaL_checktype(vm, index, LUA_TTABLE);
+		luastg::GameObjectProperties properties;
+		properties.vx = getOptionalNumberField(vm, index, "vx");
+		properties.vy = getOptionalNumberField(vm, index, "vy");
+		properties.ax = getOptionalNumberField(vm, index, "ax");
+		properties.ay = getOptionalNumberField(vm, index, "ay");
+		properties.a = getOptionalNumberField(vm, index, "a");
+		properties.b = getOptionalNumberField(vm, index, "b");
+	#ifdef GLOBAL_SCALE_COLLI_SHAPE
+		if (properties.a) *properties.a *= LRES.GetGlobalImageScaleFactor();
+		if (properties.b) *properties.b *= LRES.GetGlobalImageScaleFactor();
+	#endif // GLOBAL_SCALE_COLLI_SHAPE
+		lua_getfield(vm, index, "colli");
+		if (!lua_isnil(vm, -1)) {
+			properties.colli = lua_toboolean(vm, -1) != 0;
+		}
+		lua_pop(vm, 1);
+		return properties;
+	}
 }
 
 namespace luastg::binding {
@@ -486,9 +704,11 @@ namespace luastg::binding {
 
 			case LuaSTG::GameObjectMember::X:
 				self->x = ctx.get_value<lua_Number>(3);
+				LPOOL.updateSpatialGrid(self);
 				return 0;
 			case LuaSTG::GameObjectMember::Y:
 				self->y = ctx.get_value<lua_Number>(3);
+				LPOOL.updateSpatialGrid(self);
 				return 0;
 			case LuaSTG::GameObjectMember::DX:
 				return luaL_error(vm, "property 'dx' is readonly.");
@@ -1011,6 +1231,270 @@ namespace luastg::binding {
 			}
 			return 1;
 		}
+		static int snapshotObjectList(lua_State* const vm) {
+			lua::stack_t const ctx(vm);
+			auto const group = ctx.get_value<int64_t>(1);
+			auto& objects = getObjectQueryBuffer();
+			LPOOL.collectObjects(group, objects);
+			return writeObjectIds(vm, 2, objects);
+		}
+		static int findNearestObject(lua_State* const vm) {
+			lua::stack_t const ctx(vm);
+			auto const group = ctx.get_value<int64_t>(1);
+			auto const x = ctx.get_value<double>(2);
+			auto const y = ctx.get_value<double>(3);
+			auto& objects = getObjectQueryBuffer();
+			LPOOL.queryNearest(group, x, y, 1, std::numeric_limits<double>::infinity(), objects);
+			if (objects.empty()) {
+				lua_pushnil(vm);
+				return 1;
+			}
+			auto const object = objects.front();
+			pushGameObjectTable(vm);
+			lua_rawgeti(vm, -1, static_cast<int>(object->id + 1));
+			ctx.push_value(std::hypot(object->x - x, object->y - y));
+			return 2;
+		}
+		static int findObjectsInRadius(lua_State* const vm) {
+			lua::stack_t const ctx(vm);
+			auto const group = ctx.get_value<int64_t>(1);
+			auto const x = ctx.get_value<double>(2);
+			auto const y = ctx.get_value<double>(3);
+			auto const radius = ctx.get_value<double>(4);
+			auto& objects = getObjectQueryBuffer();
+			LPOOL.queryCircle(group, x, y, radius, objects);
+			return writeObjectIds(vm, 5, objects);
+		}
+		static int findObjectsInRect(lua_State* const vm) {
+			lua::stack_t const ctx(vm);
+			auto const group = ctx.get_value<int64_t>(1);
+			auto const l = ctx.get_value<double>(2);
+			auto const r = ctx.get_value<double>(3);
+			auto const b = ctx.get_value<double>(4);
+			auto const t = ctx.get_value<double>(5);
+			auto& objects = getObjectQueryBuffer();
+			LPOOL.queryRect(group, l, r, b, t, objects);
+			return writeObjectIds(vm, 6, objects);
+		}
+		static int findNearestObjects(lua_State* const vm) {
+			lua::stack_t const ctx(vm);
+			auto const group = ctx.get_value<int64_t>(1);
+			auto const x = ctx.get_value<double>(2);
+			auto const y = ctx.get_value<double>(3);
+			auto const k = ctx.get_value<int32_t>(4);
+			auto const max_distance = ctx.get_value<double>(5, std::numeric_limits<double>::infinity());
+			auto& objects = getObjectQueryBuffer();
+			LPOOL.queryNearest(group, x, y, static_cast<size_t>(std::max(0, k)), max_distance, objects);
+			return writeObjectIds(vm, 6, objects);
+		}
+		static int findObjectsOnSegment(lua_State* const vm) {
+			lua::stack_t const ctx(vm);
+			auto const group = ctx.get_value<int64_t>(1);
+			auto const x1 = ctx.get_value<double>(2);
+			auto const y1 = ctx.get_value<double>(3);
+			auto const x2 = ctx.get_value<double>(4);
+			auto const y2 = ctx.get_value<double>(5);
+			auto const half_width = ctx.get_value<double>(6);
+			auto& objects = getObjectQueryBuffer();
+			LPOOL.querySegment(group, x1, y1, x2, y2, half_width, objects);
+			return writeObjectIds(vm, 7, objects);
+		}
+		static int setObjectQueryCellSize(lua_State* const vm) {
+			lua::stack_t const ctx(vm);
+			auto const size = ctx.get_value<double>(1);
+			if (!(size > 0.0)) {
+				return luaL_error(vm, "cell size must be greater than 0");
+			}
+			LPOOL.setSpatialGridCellSize(size);
+			return 0;
+		}
+		static int invalidateObjectQuery(lua_State* const) {
+			LPOOL.invalidateSpatialGrid();
+			return 0;
+		}
+		static int bulkQueueToFree(lua_State* const vm) {
+			lua::stack_t const ctx(vm);
+			auto const filter = readObjectFilter(vm, 1);
+			auto const reason = ctx.get_value<std::string_view>(2, "luastg:bulk"sv);
+			auto& objects = getObjectQueryBuffer();
+			LPOOL.collectObjects(filter, objects);
+			GameObjectManagerCallbacks::getInstance().lua_vm.push_back(vm);
+			auto const count = LPOOL.queueToFreeObjects(objects, reason);
+			GameObjectManagerCallbacks::getInstance().lua_vm.pop_back();
+			ctx.push_value(static_cast<int32_t>(count));
+			return 1;
+		}
+		static int bulkQueueToFreeLegacyKillMode(lua_State* const vm) {
+			lua::stack_t const ctx(vm);
+			auto const filter = readObjectFilter(vm, 1);
+			// 和 lstg.Kill 一样，调用者没有提供 reason 时回调只收到对象
+			bool const has_reason = !lua_isnoneornil(vm, 2);
+			auto const reason = has_reason ? ctx.get_value<std::string_view>(2) : std::string_view{};
+			auto& objects = getObjectQueryBuffer();
+			LPOOL.collectObjects(filter, objects);
+			// kill 回调中可能还会查询，不能用共享的缓冲区
+			std::vector<luastg::GameObject*> killed;
+			auto const count = LPOOL.queueToFreeObjectsLegacyKillMode(objects, killed);
+			if (!killed.empty()) {
+				std::vector<uint64_t> unique_ids;
+				unique_ids.reserve(killed.size());
+				for (auto const p : killed) {
+					unique_ids.push_back(p->unique_id);
+				}
+				pushGameObjectTable(vm);
+				auto const table = lua_gettop(vm);
+				for (size_t i = 0; i < killed.size(); i += 1) {
+					auto const p = killed[i];
+					if (p->unique_id != unique_ids[i] || p->status != luastg::GameObjectStatus::Killed) {
+						continue; // 前面的回调重置了对象池
+					}
+					lua_rawgeti(vm, table, static_cast<int>(p->id + 1)); // ... t object
+					lua_rawgeti(vm, -1, 1); // ... t object class
+					lua_rawgeti(vm, -1, LGOBJ_CC_KILL); // ... t object class callback
+					lua_pushvalue(vm, -3); // ... t object class callback object
+					if (has_reason) {
+						ctx.push_value(reason); // ... t object class callback object reason
+						lua_call(vm, 2, 0); // ... t object class
+					}
+					else {
+						lua_call(vm, 1, 0); // ... t object class
+					}
+					lua_pop(vm, 2); // ... t
+				}
+				lua_pop(vm, 1);
+			}
+			ctx.push_value(static_cast<int32_t>(count));
+			return 1;
+		}
+		static int bulkSetProperties(lua_State* const vm) {
+			lua::stack_t const ctx(vm);
+			auto const filter = readObjectFilter(vm, 1);
+			auto const properties = readObjectProperties(vm, 2);
+			auto& objects = getObjectQueryBuffer();
+			LPOOL.collectObjects(filter, objects);
+			ctx.push_value(static_cast<int32_t>(LPOOL.setObjectProperties(objects, properties)));
+			return 1;
+		}
+		static int bulkCall(lua_State* const vm) {
+			lua::stack_t const ctx(vm);
+			auto const filter = readObjectFilter(vm, 1);
+			luaL_checktype(vm, 2, LUA_TFUNCTION);
+			auto const argc = lua_gettop(vm) - 2;
+			auto& objects = getObjectQueryBuffer();
+			LPOOL.collectObjects(filter, objects);
+			auto const count = static_cast<int32_t>(objects.size());
+			if (count == 0) {
+				ctx.push_value(0);
+				return 1;
+			}
+			// 一次性打包所有对象再调用，回调中可以随意增删对象
+			lua_pushvalue(vm, 2); // ... callback
+			pushGameObjectTable(vm); // ... callback t
+			lua_createtable(vm, count, 0); // ... callback t objects
+			for (int32_t i = 0; i < count; i += 1) {
+				lua_rawgeti(vm, -2, static_cast<int>(objects[i]->id + 1));
+				lua_rawseti(vm, -2, i + 1);
+			}
+			lua_remove(vm, -2); // ... callback objects
+			ctx.push_value(count); // ... callback objects count
+			for (int i = 0; i < argc; i += 1) {
+				lua_pushvalue(vm, 3 + i);
+			}
+			lua_call(vm, 2 + argc, 0);
+			ctx.push_value(count);
+			return 1;
+		}
+		static int takeSnapshot(lua_State* const vm) {
+			lua::stack_t const ctx(vm);
+			luastg::GameObjectPoolSnapshot const* base{};
+			if (GameObjectSnapshot::is(vm, 1)) {
+				base = GameObjectSnapshot::as(vm, 1)->data;
+			}
+			else if (!ctx.is_non_or_nil(1)) {
+				return luaL_argerror(vm, 1, "lstg.GameObjectSnapshot or nil expected");
+			}
+			auto const self = GameObjectSnapshot::create(vm);					// snapshot
+			if (!LPOOL.takeSnapshot(*self->data, base)) {
+				return luaL_error(vm, "can not take snapshot while rendering or detecting intersection");
+			}
+
+			// 对象表本身不复制，只记录引用，脚本在对象表上添加的字段由快照钩子负责
+			pushGameObjectTable(vm);											// snapshot t
+			auto const objects_table = lua_gettop(vm);
+			lua_createtable(vm, 0, static_cast<int>(self->data->getObjectCount()));	// snapshot t tables
+			auto const tables = lua_gettop(vm);
+			for (auto p = LPOOL.getUpdateListFirst(); p != nullptr; p = p->update_list_next) {
+				auto const index = static_cast<int>(p->id + 1);
+				lua_rawgeti(vm, objects_table, index);
+				lua_rawseti(vm, tables, index);
+			}
+			self->object_tables = luaL_ref(vm, LUA_REGISTRYINDEX);				// snapshot t
+			lua_pop(vm, 1);														// snapshot
+
+			lua_pushlightuserdata(vm, &game_object_snapshot_save_hook_key);
+			lua_gettable(vm, LUA_REGISTRYINDEX);								// snapshot save
+			if (lua_isfunction(vm, -1)) {
+				lua_call(vm, 0, 1);												// snapshot state
+				self->user_state = luaL_ref(vm, LUA_REGISTRYINDEX);				// snapshot
+			}
+			else {
+				lua_pop(vm, 1);													// snapshot
+			}
+			return 1;
+		}
+		static int restoreSnapshot(lua_State* const vm) {
+			lua::stack_t const ctx(vm);
+			auto const self = GameObjectSnapshot::as(vm, 1);
+			GameObjectManagerCallbacks::getInstance().lua_vm.push_back(vm);
+			auto const result = LPOOL.restoreSnapshot(*self->data);
+			GameObjectManagerCallbacks::getInstance().lua_vm.pop_back();
+			if (!result) {
+				ctx.push_value(false);
+				return 1;
+			}
+
+			// 放回对象表，被回收过的对象表需要重新关联到对象
+			pushGameObjectTable(vm);											// ... t
+			auto const objects_table = lua_gettop(vm);
+			lua_rawgeti(vm, LUA_REGISTRYINDEX, self->object_tables);			// ... t tables
+			auto const tables = lua_gettop(vm);
+			lua_pushnil(vm);													// ... t tables nil
+			while (lua_next(vm, tables)) {										// ... t tables index object
+				auto const index = static_cast<int>(lua_tointeger(vm, -2));
+				lua_pushlightuserdata(vm, LPOOL.GetPooledObject(static_cast<size_t>(index - 1)));
+				lua_rawseti(vm, -2, 3);											// ... t tables index object
+				lua_rawseti(vm, objects_table, index);							// ... t tables index
+			}
+			lua_pop(vm, 2);														// ...
+
+			lua_pushlightuserdata(vm, &game_object_snapshot_load_hook_key);
+			lua_gettable(vm, LUA_REGISTRYINDEX);								// ... load
+			if (lua_isfunction(vm, -1)) {
+				lua_rawgeti(vm, LUA_REGISTRYINDEX, self->user_state);			// ... load state
+				lua_call(vm, 1, 0);												// ...
+			}
+			else {
+				lua_pop(vm, 1);													// ...
+			}
+			ctx.push_value(true);
+			return 1;
+		}
+		static int setSnapshotHook(lua_State* const vm) {
+			if (!lua_isnoneornil(vm, 1)) {
+				luaL_checktype(vm, 1, LUA_TFUNCTION);
+			}
+			if (!lua_isnoneornil(vm, 2)) {
+				luaL_checktype(vm, 2, LUA_TFUNCTION);
+			}
+			lua_pushlightuserdata(vm, &game_object_snapshot_save_hook_key);
+			lua_pushvalue(vm, 1);
+			lua_settable(vm, LUA_REGISTRYINDEX);
+			lua_pushlightuserdata(vm, &game_object_snapshot_load_hook_key);
+			lua_pushvalue(vm, 2);
+			lua_settable(vm, LUA_REGISTRYINDEX);
+			return 0;
+		}
+
 		static int isValid(lua_State* const vm) {
 			lua::stack_t const ctx(vm);
 			ctx.push_value(is(vm, 1));
@@ -1101,9 +1585,31 @@ namespace luastg::binding {
 		ctx.set_map_value(lstg_table, "_UpdateListNext"sv, &GameObjectBinding::getUpdateListNext);
 		ctx.set_map_value(lstg_table, "_DetectListFirst"sv, &GameObjectBinding::getDetectListFirst);
 		ctx.set_map_value(lstg_table, "_DetectListNext"sv, &GameObjectBinding::getDetectListNext);
+		ctx.set_map_value(lstg_table, "ObjListSnapshot"sv, &GameObjectBinding::snapshotObjectList);
+		ctx.set_map_value(lstg_table, "ObjNearest"sv, &GameObjectBinding::findNearestObject);
+		ctx.set_map_value(lstg_table, "ObjInRadius"sv, &GameObjectBinding::findObjectsInRadius);
+		ctx.set_map_value(lstg_table, "ObjInRect"sv, &GameObjectBinding::findObjectsInRect);
+		ctx.set_map_value(lstg_table, "ObjNearestK"sv, &GameObjectBinding::findNearestObjects);
+		ctx.set_map_value(lstg_table, "ObjOnSegment"sv, &GameObjectBinding::findObjectsOnSegment);
+		ctx.set_map_value(lstg_table, "SetObjQueryCellSize"sv, &GameObjectBinding::setObjectQueryCellSize);
+		ctx.set_map_value(lstg_table, "ObjQueryInvalidate"sv, &GameObjectBinding::invalidateObjectQuery);
+		ctx.set_map_value(lstg_table, "ObjBulkDel"sv, &GameObjectBinding::bulkQueueToFree);
+		ctx.set_map_value(lstg_table, "ObjBulkKill"sv, &GameObjectBinding::bulkQueueToFreeLegacyKillMode);
+		ctx.set_map_value(lstg_table, "ObjBulkSet"sv, &GameObjectBinding::bulkSetProperties);
+		ctx.set_map_value(lstg_table, "ObjBulkCall"sv, &GameObjectBinding::bulkCall);
+		ctx.set_map_value(lstg_table, "ObjSnapshot"sv, &GameObjectBinding::takeSnapshot);
+		ctx.set_map_value(lstg_table, "ObjRestore"sv, &GameObjectBinding::restoreSnapshot);
+		ctx.set_map_value(lstg_table, "SetObjSnapshotHook"sv, &GameObjectBinding::setSnapshotHook);
 		ctx.set_map_value(lstg_table, "IsValid"sv, &GameObjectBinding::isValid);
 		ctx.set_map_value(lstg_table, "ObjTable"sv, &pushGameObjectTable);
 
+		// embedded script
+
+		if (LUA_OK == luaL_loadbuffer(vm, embedded_script.data(), embedded_script.size(), "lstg/GameObject.lua")) {
+			ctx.push_value(makeGameObjectViewDeclaration());
+			lua_call(vm, 1, 0);
+		}
+
 		LPOOL.addCallbacks(&GameObjectManagerCallbacks::getInstance());
 		GameObjectManagerCallbacks::getInstance().lua_vm.reserve(16);
 		GameObjectManagerCallbacks::getInstance().lua_vm.push_back(LAPP.GetLuaEngine());
@@ -0,0 +1,101 @@
+#include "GameObjectSnapshot.hpp"
+#include "lua/plus.hpp"
+
+namespace luastg::binding {
+	std::string_view const GameObjectSnapshot::class_name{ "lstg.GameObjectSnapshot" };
+
+	struct GameObjectSnapshotBinding : GameObjectSnapshot {
+		// meta methods
+
+		// NOLINTBEGIN(*-reserved-identifier)
+
+		static int __gc(lua_State* vm) {
+			auto const self = as(vm, 1);
+			delete self->data;
+			self->data = nullptr;
+			luaL_unref(vm, LUA_REGISTRYINDEX, self->object_tables);
+			luaL_unref(vm, LUA_REGISTRYINDEX, self->user_state);
+			self->object_tables = LUA_NOREF;
+			self->user_state = LUA_NOREF;
+			return 0;
+		}
+		static int __tostring(lua_State* vm) {
+			lua::stack_t const ctx(vm);
+			[[maybe_unused]] auto const self = as(vm, 1);
+			ctx.push_value(class_name);
+			return 1;
+		}
+
+		// NOLINTEND(*-reserved-identifier)
+
+		// method
+
+		static int getObjectCount(lua_State* vm) {
+			lua::stack_t const ctx(vm);
+			auto const self = as(vm, 1);
+			ctx.push_value(static_cast<int32_t>(self->data->getObjectCount()));
+			return 1;
+		}
+		static int getSharedChunkCount(lua_State* vm) {
+			lua::stack_t const ctx(vm);
+			auto const self = as(vm, 1);
+			ctx.push_value(static_cast<int32_t>(self->data->getSharedChunkCount()));
+			return 1;
+		}
+		static int getDeltaChunkCount(lua_State* vm) {
+			lua::stack_t const ctx(vm);
+			auto const self = as(vm, 1);
+			ctx.push_value(static_cast<int32_t>(self->data->getDeltaChunkCount()));
+			return 1;
+		}
+		static int getMemoryUsage(lua_State* vm) {
+			lua::stack_t const ctx(vm);
+			auto const self = as(vm, 1);
+			ctx.push_value(static_cast<double>(self->data->getMemoryUsage()));
+			return 1;
+		}
+		static int getUserState(lua_State* vm) {
+			auto const self = as(vm, 1);
+			lua_rawgeti(vm, LUA_REGISTRYINDEX, self->user_state);
+			return 1;
+		}
+	};
+
+	bool GameObjectSnapshot::is(lua_State* vm, int const index) {
+		lua::stack_t const ctx(vm);
+		return ctx.is_metatable(index, class_name);
+	}
+	GameObjectSnapshot* GameObjectSnapshot::as(lua_State* vm, int const index) {
+		lua::stack_t const ctx(vm);
+		return ctx.as_userdata<GameObjectSnapshot>(index);
+	}
+	GameObjectSnapshot* GameObjectSnapshot::create(lua_State* vm) {
+		lua::stack_t const ctx(vm);
+		auto const self = ctx.create_userdata<GameObjectSnapshot>();
+		auto const self_index = ctx.index_of_top();
+		ctx.set_metatable(self_index, class_name);
+		new(self) GameObjectSnapshot();
+		self->data = new luastg::GameObjectPoolSnapshot();
+		return self;
+	}
+	void GameObjectSnapshot::registerClass(lua_State* vm) {
+		[[maybe_unused]] lua::stack_balancer_t stack_balancer(vm);
+		lua::stack_t const ctx(vm);
+
+		// method
+
+		auto const method_table = ctx.create_module(class_name);
+		ctx.set_map_value(method_table, "getObjectCount", &GameObjectSnapshotBinding::getObjectCount);
+		ctx.set_map_value(method_table, "getSharedChunkCount", &GameObjectSnapshotBinding::getSharedChunkCount);
+		ctx.set_map_value(method_table, "getDeltaChunkCount", &GameObjectSnapshotBinding::getDeltaChunkCount);
+		ctx.set_map_value(method_table, "getMemoryUsage", &GameObjectSnapshotBinding::getMemoryUsage);
+		ctx.set_map_value(method_table, "getUserState", &GameObjectSnapshotBinding::getUserState);
+
+		// metatable
+
+		auto const metatable = ctx.create_metatable(class_name);
+		ctx.set_map_value(metatable, "__gc", &GameObjectSnapshotBinding::__gc);
+		ctx.set_map_value(metatable, "__tostring", &GameObjectSnapshotBinding::__tostring);
+		ctx.set_map_value(metatable, "__index", method_table);
+	}
+}
@@ -0,0 +1,18 @@
+#pragma once
+#include "lua.hpp"
+#include "GameObject/GameObjectPool.h"
+
+namespace luastg::binding {
+	struct GameObjectSnapshot {
+		static std::string_view const class_name;
+
+		[[maybe_unused]] luastg::GameObjectPoolSnapshot* data{};
+		[[maybe_unused]] int object_tables{ LUA_NOREF }; // 拍摄时 lstg.ObjTable 中的对象表，恢复时放回去
+		[[maybe_unused]] int user_state{ LUA_NOREF }; // 快照钩子返回的脚本状态
+
+		static bool is(lua_State* vm, int index);
+		static GameObjectSnapshot* as(lua_State* vm, int index);
+		static GameObjectSnapshot* create(lua_State* vm);
+		static void registerClass(lua_State* vm);
+	};
+}
@@ -54,6 +54,7 @@ namespace luastg::binding {
 			auto const width = S.get_value<uint32_t>(2);
 			auto const height = S.get_value<uint32_t>(3);
 			auto const size = core::Vector2U(width, height);
+			LAPP.GetAppModel()->synchronizeRenderThread();
 			auto const result = self->data->setWindowMode(size);
 			S.push_value(result);
 			return 1;
@@ -72,6 +73,7 @@ namespace luastg::binding {
 			auto const width = S.get_value<uint32_t>(2);
 			auto const height = S.get_value<uint32_t>(3);
 			auto const size = core::Vector2U(width, height);
+			LAPP.GetAppModel()->synchronizeRenderThread();
 			auto const result = self->data->setCanvasSize(size);
 			S.push_value(result);
 			return 1;
@@ -89,6 +91,7 @@ namespace luastg::binding {
 			auto self = as(L, 1);
 			lua::stack_t S(L);
 			auto const allow = S.get_value<bool>(2);
+			LAPP.GetAppModel()->synchronizeRenderThread();
 			self->data->setVSync(allow);
 			return 0;
 		}
@@ -105,6 +108,7 @@ namespace luastg::binding {
 			auto self = as(L, 1);
 			lua::stack_t S(L);
 			auto const mode = static_cast<core::Graphics::SwapChainScalingMode>(S.get_value<int32_t>(2));
+			LAPP.GetAppModel()->synchronizeRenderThread();
 			self->data->setScalingMode(mode);
 			return 0;
 		}
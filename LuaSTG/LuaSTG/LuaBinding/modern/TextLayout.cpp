@@ -0,0 +1,187 @@
+#include "TextLayout.hpp"
+#include "lua/plus.hpp"
+#include "LuaWrapper.hpp"
+#include "LuaWrapperMisc.hpp"
+#include "AppFrame.h"
+
+namespace luastg::binding {
+	std::string_view const TextLayout::class_name{ "lstg.TextLayout" };
+
+	struct TextLayoutBinding : TextLayout {
+		// meta methods
+
+		// NOLINTBEGIN(*-reserved-identifier)
+
+		static int __gc(lua_State* vm) {
+			if (auto const self = as(vm, 1); self->data) {
+				self->data->release();
+				self->data = nullptr;
+			}
+			return 0;
+		}
+		static int __tostring(lua_State* vm) {
+			lua::stack_t const ctx(vm);
+			[[maybe_unused]] auto const self = as(vm, 1);
+			ctx.push_value(class_name);
+			return 1;
+		}
+		static int __eq(lua_State* vm) {
+			lua::stack_t const ctx(vm);
+			auto const self = as(vm, 1);
+			if (is(vm, 2)) {
+				auto const other = as(vm, 2);
+				ctx.push_value(self->data == other->data);
+			}
+			else {
+				ctx.push_value(false);
+			}
+			return 1;
+		}
+
+		// NOLINTEND(*-reserved-identifier)
+
+		// method
+
+		static int setText(lua_State* vm) {
+			lua::stack_t const ctx(vm);
+			auto const self = as(vm, 1);
+			auto const text = ctx.get_value<std::string_view>(1 + 1);
+			self->data->setText(text);
+			return 0;
+		}
+		static int getText(lua_State* vm) {
+			lua::stack_t const ctx(vm);
+			auto const self = as(vm, 1);
+			ctx.push_value(self->data->getText());
+			return 1;
+		}
+		static int setFont(lua_State* vm) {
+			lua::stack_t const ctx(vm);
+			auto const self = as(vm, 1);
+			auto const name = ctx.get_value<std::string_view>(1 + 1);
+			auto const font = LRES.FindTTFFont(std::string(name).c_str());
+			if (!font) {
+				return luaL_error(vm, "TTF font '%s' not found", std::string(name).c_str());
+			}
+			self->data->setGlyphManager(font->GetGlyphManager());
+			return 0;
+		}
+		static int setScale(lua_State* vm) {
+			lua::stack_t const ctx(vm);
+			auto const self = as(vm, 1);
+			auto const x = ctx.get_value<float>(1 + 1);
+			auto const y = ctx.get_value<float>(1 + 2, x);
+			self->data->setScale(core::Vector2F(x, y));
+			return 0;
+		}
+		static int getScale(lua_State* vm) {
+			lua::stack_t const ctx(vm);
+			auto const self = as(vm, 1);
+			auto const scale = self->data->getScale();
+			ctx.push_value(scale.x);
+			ctx.push_value(scale.y);
+			return 2;
+		}
+		static int getBoundary(lua_State* vm) {
+			lua::stack_t const ctx(vm);
+			auto const self = as(vm, 1);
+			// same order as lstg.FontRenderer.MeasureTextBoundary: l, r, b, t
+			auto const rect = self->data->getBoundary();
+			ctx.push_value(rect.a.x);
+			ctx.push_value(rect.b.x);
+			ctx.push_value(rect.b.y);
+			ctx.push_value(rect.a.y);
+			return 4;
+		}
+		static int getAdvance(lua_State* vm) {
+			lua::stack_t const ctx(vm);
+			auto const self = as(vm, 1);
+			auto const advance = self->data->getAdvance();
+			ctx.push_value(advance.x);
+			ctx.push_value(advance.y);
+			return 2;
+		}
+		static int draw(lua_State* vm) {
+			lua::stack_t const ctx(vm);
+			auto const self = as(vm, 1);
+			auto const x = ctx.get_value<float>(1 + 1);
+			auto const y = ctx.get_value<float>(1 + 2);
+			auto const z = ctx.get_value<float>(1 + 3, 0.5f);
+			auto const blend = ctx.is_non_or_nil(1 + 4) ? BlendMode::MulAlpha : luastg::TranslateBlendMode(vm, 1 + 4);
+			auto const color = ctx.is_non_or_nil(1 + 5) ? core::Color4B(0xFFFFFFFFu) : *Color::Cast(vm, 1 + 5);
+			LAPP.updateGraph2DBlendMode(blend);
+			if (!self->data->draw(LAPP.GetAppModel()->getRenderer(), core::Vector2F(x, y), z, color)) {
+				return luaL_error(vm, "draw TextLayout failed");
+			}
+			// the same end position as lstg.FontRenderer.RenderText
+			auto const advance = self->data->getAdvance();
+			ctx.push_value(x + advance.x);
+			ctx.push_value(y + advance.y);
+			return 2;
+		}
+
+		// static method
+
+		static int create(lua_State* vm) {
+			lua::stack_t const ctx(vm);
+			auto const name = ctx.get_value<std::string_view>(1);
+			auto const text = ctx.get_value<std::string_view>(2, {});
+			auto const scale_x = ctx.get_value<float>(3, 1.0f);
+			auto const scale_y = ctx.get_value<float>(4, scale_x);
+			auto const font = LRES.FindTTFFont(std::string(name).c_str());
+			if (!font) {
+				return luaL_error(vm, "TTF font '%s' not found", std::string(name).c_str());
+			}
+			auto const self = TextLayout::create(vm);
+			if (!core::Graphics::ITextLayout::create(&self->data)) {
+				return luaL_error(vm, "create TextLayout failed");
+			}
+			self->data->setGlyphManager(font->GetGlyphManager());
+			self->data->setText(text);
+			self->data->setScale(core::Vector2F(scale_x, scale_y));
+			return 1;
+		}
+	};
+
+	bool TextLayout::is(lua_State* vm, int const index) {
+		lua::stack_t const ctx(vm);
+		return ctx.is_metatable(index, class_name);
+	}
+	TextLayout* TextLayout::as(lua_State* vm, int const index) {
+		lua::stack_t const ctx(vm);
+		return ctx.as_userdata<TextLayout>(index);
+	}
+	TextLayout* TextLayout::create(lua_State* vm) {
+		lua::stack_t const ctx(vm);
+		auto const self = ctx.create_userdata<TextLayout>();
+		auto const self_index = ctx.index_of_top();
+		ctx.set_metatable(self_index, class_name);
+		self->data = nullptr;
+		return self;
+	}
+	void TextLayout::registerClass(lua_State* vm) {
+		[[maybe_unused]] lua::stack_balancer_t stack_balancer(vm);
+		lua::stack_t const ctx(vm);
+
+		// method
+
+		auto const method_table = ctx.create_module(class_name);
+		ctx.set_map_value(method_table, "setText", &TextLayoutBinding::setText);
+		ctx.set_map_value(method_table, "getText", &TextLayoutBinding::getText);
+		ctx.set_map_value(method_table, "setFont", &TextLayoutBinding::setFont);
+		ctx.set_map_value(method_table, "setScale", &TextLayoutBinding::setScale);
+		ctx.set_map_value(method_table, "getScale", &TextLayoutBinding::getScale);
+		ctx.set_map_value(method_table, "getBoundary", &TextLayoutBinding::getBoundary);
+		ctx.set_map_value(method_table, "getAdvance", &TextLayoutBinding::getAdvance);
+		ctx.set_map_value(method_table, "draw", &TextLayoutBinding::draw);
+		ctx.set_map_value(method_table, "create", &TextLayoutBinding::create);
+
+		// metatable
+
+		auto const metatable = ctx.create_metatable(class_name);
+		ctx.set_map_value(metatable, "__gc", &TextLayoutBinding::__gc);
+		ctx.set_map_value(metatable, "__tostring", &TextLayoutBinding::__tostring);
+		ctx.set_map_value(metatable, "__eq", &TextLayoutBinding::__eq);
+		ctx.set_map_value(metatable, "__index", method_table);
+	}
+}
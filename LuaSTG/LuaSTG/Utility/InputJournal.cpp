@@ -0,0 +1,338 @@
+#include "Utility/InputJournal.hpp"
+#include <cassert>
+#include <cstring>
+#include <algorithm>
+#include <iterator>
+
+namespace {
+	constexpr char journal_magic[8]{ 'L', 'S', 'T', 'G', 'I', 'N', 'P', 'J' };
+	constexpr uint32_t journal_version{ 1 };
+	constexpr size_t header_size{ sizeof(journal_magic) + 3 * sizeof(uint32_t) };
+
+	constexpr uint8_t record_keyframe{ 'K' };
+	constexpr uint8_t record_delta{ 'D' };
+	constexpr uint8_t record_repeat{ 'S' };
+
+	// 异或结果中至少连续这么多个零字节才会结束一个非零段，太短的零段直接并入非零段更省空间
+	constexpr size_t min_zero_run{ 3 };
+
+	template<typename T>
+	void writeInteger(std::vector<uint8_t>& buffer, T const value) {
+		for (size_t i = 0; i < sizeof(T); i += 1) {
+			buffer.push_back(static_cast<uint8_t>(value >> (i * 8)));
+		}
+	}
+	void writeVarint(std::vector<uint8_t>& buffer, size_t value) {
+		while (value >= 0x80) {
+			buffer.push_back(static_cast<uint8_t>(value | 0x80));
+			value >>= 7;
+		}
+		buffer.push_back(static_cast<uint8_t>(value));
+	}
+
+	template<typename T>
+	bool readInteger(std::vector<uint8_t> const& data, size_t& offset, T& value) {
+		if (data.size() - offset < sizeof(T)) {
+			return false;
+		}
+		value = 0;
+		for (size_t i = 0; i < sizeof(T); i += 1) {
+			value |= static_cast<T>(data[offset + i]) << (i * 8);
+		}
+		offset += sizeof(T);
+		return true;
+	}
+	bool readVarint(std::vector<uint8_t> const& data, size_t& offset, size_t& value) {
+		value = 0;
+		for (size_t shift = 0; shift < sizeof(size_t) * 8; shift += 7) {
+			if (offset >= data.size()) {
+				return false;
+			}
+			uint8_t const byte = data[offset];
+			offset += 1;
+			value |= static_cast<size_t>(byte & 0x7F) << shift;
+			if ((byte & 0x80) == 0) {
+				return true;
+			}
+		}
+		return false;
+	}
+}
+
+namespace luastg {
+	// InputJournalWriter
+
+	bool InputJournalWriter::open(std::filesystem::path const& path, uint32_t const frame_size, uint32_t const keyframe_interval) {
+		close();
+		if (frame_size == 0) {
+			return false;
+		}
+		m_file.open(path, std::ios::binary | std::ios::trunc);
+		if (!m_file.is_open()) {
+			return false;
+		}
+		m_frame_size = frame_size;
+		m_keyframe_interval = std::max(keyframe_interval, 1u);
+		m_frame_count = 0;
+		m_previous.assign(frame_size, 0);
+		m_buffer.clear();
+		m_buffer.insert(m_buffer.end(), std::begin(journal_magic), std::end(journal_magic));
+		writeInteger(m_buffer, journal_version);
+		writeInteger(m_buffer, m_frame_size);
+		writeInteger(m_buffer, m_keyframe_interval);
+		m_file.write(reinterpret_cast<char const*>(m_buffer.data()), static_cast<std::streamsize>(m_buffer.size()));
+		m_file.flush();
+		if (!m_file.good()) {
+			close();
+			return false;
+		}
+		return true;
+	}
+	void InputJournalWriter::close() {
+		if (m_file.is_open()) {
+			m_file.close();
+		}
+		m_previous.clear();
+		m_buffer.clear();
+		m_frame_count = 0;
+	}
+	bool InputJournalWriter::write(std::span<uint8_t const> const frame, uint64_t const state_hash) {
+		if (!m_file.is_open() || frame.size() != m_frame_size) {
+			return false;
+		}
+		m_buffer.clear();
+		bool const is_keyframe = isNextKeyframe();
+		if (is_keyframe) {
+			m_buffer.push_back(record_keyframe);
+			writeInteger(m_buffer, m_frame_count);
+			writeInteger(m_buffer, state_hash);
+			m_buffer.insert(m_buffer.end(), frame.begin(), frame.end());
+		}
+		else if (std::memcmp(frame.data(), m_previous.data(), m_frame_size) == 0) {
+			m_buffer.push_back(record_repeat);
+		}
+		else {
+			m_buffer.push_back(record_delta);
+			size_t i = 0;
+			while (i < m_frame_size) {
+				size_t const zero_begin = i;
+				while (i < m_frame_size && frame[i] == m_previous[i]) {
+					i += 1;
+				}
+				size_t const literal_begin = i;
+				// 非零段一直延伸到下一个足够长的零段
+				while (i < m_frame_size) {
+					size_t zero_run = 0;
+					while (i + zero_run < m_frame_size && zero_run < min_zero_run && frame[i + zero_run] == m_previous[i + zero_run]) {
+						zero_run += 1;
+					}
+					if (zero_run >= min_zero_run || i + zero_run == m_frame_size) {
+						break;
+					}
+					i += zero_run + 1;
+				}
+				writeVarint(m_buffer, literal_begin - zero_begin);
+				writeVarint(m_buffer, i - literal_begin);
+				for (size_t j = literal_begin; j < i; j += 1) {
+					m_buffer.push_back(frame[j] ^ m_previous[j]);
+				}
+			}
+		}
+		m_file.write(reinterpret_cast<char const*>(m_buffer.data()), static_cast<std::streamsize>(m_buffer.size()));
+		if (is_keyframe) {
+			m_file.flush();
+		}
+		std::memcpy(m_previous.data(), frame.data(), m_frame_size);
+		m_frame_count += 1;
+		return m_file.good();
+	}
+
+	// InputJournalReader
+
+	bool InputJournalReader::open(std::filesystem::path const& path) {
+		close();
+		std::ifstream file(path, std::ios::binary | std::ios::ate);
+		if (!file.is_open()) {
+			return false;
+		}
+		auto const file_size = static_cast<size_t>(file.tellg());
+		if (file_size < header_size) {
+			return false;
+		}
+		std::vector<uint8_t> data(file_size);
+		file.seekg(0);
+		if (!file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(file_size))) {
+			return false;
+		}
+
+		if (std::memcmp(data.data(), journal_magic, sizeof(journal_magic)) != 0) {
+			return false;
+		}
+		size_t offset = sizeof(journal_magic);
+		uint32_t version{};
+		uint32_t frame_size{};
+		uint32_t keyframe_interval{};
+		readInteger(data, offset, version);
+		readInteger(data, offset, frame_size);
+		readInteger(data, offset, keyframe_interval);
+		if (version != journal_version || frame_size == 0) {
+			return false;
+		}
+		m_data = std::move(data);
+		m_frame_size = frame_size;
+
+		// 完整解码一遍：检查数据并建立关键帧索引，同时确定有效帧数
+		m_current.assign(m_frame_size, 0);
+		size_t const data_begin = offset;
+		while (offset < m_data.size()) {
+			Keyframe keyframe{ .frame = UINT64_MAX };
+			size_t const record_offset = offset;
+			if (!decode(offset, m_current, &keyframe)) {
+				break; // 末尾不完整的记录
+			}
+			if (keyframe.frame != UINT64_MAX) {
+				if (keyframe.frame != m_frame_count) {
+					break; // 数据损坏
+				}
+				keyframe.offset = record_offset;
+				m_keyframes.push_back(keyframe);
+			}
+			else if (m_frame_count == 0) {
+				break; // 第一帧必须是关键帧
+			}
+			m_frame_count += 1;
+		}
+		if (m_frame_count == 0) {
+			close();
+			return false;
+		}
+
+		m_offset = data_begin;
+		m_next_keyframe = 0;
+		m_frame_index = 0;
+		m_current.assign(m_frame_size, 0);
+		return true;
+	}
+	void InputJournalReader::close() {
+		m_data.clear();
+		m_current.clear();
+		m_keyframes.clear();
+		m_offset = 0;
+		m_next_keyframe = 0;
+		m_frame_size = 0;
+		m_frame_count = 0;
+		m_frame_index = 0;
+	}
+	bool InputJournalReader::read(std::span<uint8_t> const frame, Keyframe const** const keyframe) {
+		if (keyframe) {
+			*keyframe = nullptr;
+		}
+		if (m_frame_index >= m_frame_count || frame.size() != m_frame_size) {
+			return false;
+		}
+		if (!decode(m_offset, m_current, nullptr)) {
+			assert(false); return false; // open 时已经检查过
+		}
+		if (m_next_keyframe < m_keyframes.size() && m_keyframes[m_next_keyframe].frame == m_frame_index) {
+			if (keyframe) {
+				*keyframe = &m_keyframes[m_next_keyframe];
+			}
+			m_next_keyframe += 1;
+		}
+		std::memcpy(frame.data(), m_current.data(), m_frame_size);
+		m_frame_index += 1;
+		return true;
+	}
+	bool InputJournalReader::seek(uint64_t const frame) {
+		if (m_data.empty() || frame > m_frame_count) {
+			return false;
+		}
+		auto const it = std::upper_bound(m_keyframes.begin(), m_keyframes.end(), frame, [](uint64_t const value, Keyframe const& keyframe) {
+			return value < keyframe.frame;
+		});
+		assert(it != m_keyframes.begin()); // 第一帧总是关键帧
+		auto const& keyframe = *(it - 1);
+		m_offset = keyframe.offset;
+		m_next_keyframe = static_cast<size_t>(it - m_keyframes.begin()) - 1;
+		m_frame_index = keyframe.frame;
+		// 关键帧之后的增量帧都基于上一帧，需要逐帧解码过去
+		while (m_frame_index < frame) {
+			if (!decode(m_offset, m_current, nullptr)) {
+				return false;
+			}
+			if (m_next_keyframe < m_keyframes.size() && m_keyframes[m_next_keyframe].frame == m_frame_index) {
+				m_next_keyframe += 1;
+			}
+			m_frame_index += 1;
+		}
+		return true;
+	}
+	bool InputJournalReader::decode(size_t& offset, std::vector<uint8_t>& frame, Keyframe* const keyframe) const {
+		size_t cursor = offset;
+		if (cursor >= m_data.size()) {
+			return false;
+		}
+		uint8_t const type = m_data[cursor];
+		cursor += 1;
+		switch (type) {
+		case record_keyframe: {
+			uint64_t index{};
+			uint64_t state_hash{};
+			if (!readInteger(m_data, cursor, index) || !readInteger(m_data, cursor, state_hash)) {
+				return false;
+			}
+			if (m_data.size() - cursor < m_frame_size) {
+				return false;
+			}
+			std::memcpy(frame.data(), m_data.data() + cursor, m_frame_size);
+			cursor += m_frame_size;
+			if (keyframe) {
+				keyframe->frame = index;
+				keyframe->state_hash = state_hash;
+			}
+			break;
+		}
+		case record_delta: {
+			// 先解码到临时位置，记录不完整时不能破坏当前帧
+			size_t position = 0;
+			size_t const literal_offset = cursor;
+			while (position < m_frame_size) {
+				size_t zero_run{};
+				size_t literal_run{};
+				if (!readVarint(m_data, cursor, zero_run) || !readVarint(m_data, cursor, literal_run)) {
+					return false;
+				}
+				if (zero_run > m_frame_size - position || literal_run > m_frame_size - position - zero_run) {
+					return false;
+				}
+				if (m_data.size() - cursor < literal_run) {
+					return false;
+				}
+				position += zero_run + literal_run;
+				cursor += literal_run;
+			}
+			cursor = literal_offset;
+			position = 0;
+			while (position < m_frame_size) {
+				size_t zero_run{};
+				size_t literal_run{};
+				readVarint(m_data, cursor, zero_run);
+				readVarint(m_data, cursor, literal_run);
+				position += zero_run;
+				for (size_t i = 0; i < literal_run; i += 1) {
+					frame[position + i] ^= m_data[cursor + i];
+				}
+				position += literal_run;
+				cursor += literal_run;
+			}
+			break;
+		}
+		case record_repeat:
+			break;
+		default:
+			return false;
+		}
+		offset = cursor;
+		return true;
+	}
+}
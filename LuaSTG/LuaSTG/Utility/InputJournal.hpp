@@ -0,0 +1,71 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <vector>
+#include <fstream>
+#include <filesystem>
+
+namespace luastg {
+	// 输入日志：逐帧记录轮询得到的输入状态，每帧的数据长度固定，由调用方决定其内容
+	// 文件格式（小端）：
+	//   文件头：magic "LSTGINPJ"、版本 u32、每帧字节数 u32、关键帧间隔 u32
+	//   之后是连续的帧记录，每条记录以一个字节的类型开头：
+	//     关键帧：帧序号 u64、状态摘要 u64、完整的帧数据
+	//     增量帧：与上一帧按字节异或，然后编码为若干组 (varint 零字节数, varint 非零段字节数, 非零段)
+	//     重复帧：与上一帧完全相同，只有类型字节
+	// 写入时每个关键帧之后都会刷新文件，程序异常退出时也能保留之前的记录
+
+	class InputJournalWriter {
+	public:
+		bool open(std::filesystem::path const& path, uint32_t frame_size, uint32_t keyframe_interval);
+		void close();
+		[[nodiscard]] bool isOpen() const noexcept { return m_file.is_open(); }
+		// 下一帧是否为关键帧，关键帧需要提供状态摘要
+		[[nodiscard]] bool isNextKeyframe() const noexcept { return m_frame_count % m_keyframe_interval == 0; }
+		[[nodiscard]] uint64_t getFrameCount() const noexcept { return m_frame_count; }
+		bool write(std::span<uint8_t const> frame, uint64_t state_hash);
+
+	private:
+		std::ofstream m_file;
+		std::vector<uint8_t> m_previous;
+		std::vector<uint8_t> m_buffer;
+		uint32_t m_frame_size{};
+		uint32_t m_keyframe_interval{ 1 };
+		uint64_t m_frame_count{};
+	};
+
+	class InputJournalReader {
+	public:
+		struct Keyframe {
+			uint64_t frame{};
+			uint64_t state_hash{};
+			size_t offset{}; // 关键帧记录在文件中的位置
+		};
+
+		// 整个文件读入内存并建立关键帧索引，末尾不完整的记录会被忽略
+		bool open(std::filesystem::path const& path);
+		void close();
+		[[nodiscard]] bool isOpen() const noexcept { return !m_data.empty(); }
+		[[nodiscard]] uint32_t getFrameSize() const noexcept { return m_frame_size; }
+		[[nodiscard]] uint64_t getFrameCount() const noexcept { return m_frame_count; }
+		// 下一次 read 得到的帧序号
+		[[nodiscard]] uint64_t getFrameIndex() const noexcept { return m_frame_index; }
+		[[nodiscard]] std::vector<Keyframe> const& getKeyframes() const noexcept { return m_keyframes; }
+		// 读取下一帧，没有更多帧时返回 false；如果读到的是关键帧，keyframe 指向它的信息，否则为空
+		bool read(std::span<uint8_t> frame, Keyframe const** keyframe = nullptr);
+		// 跳转到不晚于 frame 的最近关键帧，然后逐帧解码，使下一次 read 得到第 frame 帧
+		bool seek(uint64_t frame);
+
+	private:
+		bool decode(size_t& offset, std::vector<uint8_t>& frame, Keyframe* keyframe) const;
+
+		std::vector<uint8_t> m_data;
+		std::vector<uint8_t> m_current;
+		std::vector<Keyframe> m_keyframes;
+		size_t m_offset{};
+		size_t m_next_keyframe{};
+		uint32_t m_frame_size{};
+		uint64_t m_frame_count{};
+		uint64_t m_frame_index{};
+	};
+}
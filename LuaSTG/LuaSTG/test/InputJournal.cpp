@@ -0,0 +1,155 @@
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string_view>
+#include <vector>
+#include "Utility/InputJournal.hpp"
+#include "gtest/gtest.h"
+
+using luastg::InputJournalReader;
+using luastg::InputJournalWriter;
+
+namespace {
+	constexpr uint32_t frame_size{ 40 };
+	constexpr uint32_t keyframe_interval{ 16 };
+
+	std::filesystem::path makeTempPath(std::string_view const name) {
+		auto const directory = std::filesystem::temp_directory_path() / "luastg-test";
+		std::filesystem::create_directories(directory);
+		return directory / name;
+	}
+
+	// Input that mostly stays the same: held keys, a moving cursor and a few sparse changes
+	std::vector<std::vector<uint8_t>> makeFrames(size_t const count) {
+		std::vector<std::vector<uint8_t>> frames;
+		std::vector<uint8_t> frame(frame_size);
+		uint32_t seed{ 12345 };
+		for (size_t i = 0; i < count; i += 1) {
+			seed = seed * 1664525u + 1013904223u;
+			if ((seed >> 28) < 6) {
+				frame[(seed >> 8) % frame_size] ^= static_cast<uint8_t>(1u << ((seed >> 4) % 8));
+			}
+			if (i % 3 == 0) {
+				frame[frame_size - 8] += 1;
+				frame[frame_size - 1] = static_cast<uint8_t>(i);
+			}
+			frames.push_back(frame);
+		}
+		return frames;
+	}
+
+	uint64_t stateHash(size_t const frame) {
+		return 0x9E3779B97F4A7C15ull * (frame + 1);
+	}
+
+	void writeJournal(std::filesystem::path const& path, std::vector<std::vector<uint8_t>> const& frames) {
+		InputJournalWriter writer;
+		ASSERT_TRUE(writer.open(path, frame_size, keyframe_interval));
+		for (size_t i = 0; i < frames.size(); i += 1) {
+			EXPECT_EQ(writer.isNextKeyframe(), i % keyframe_interval == 0);
+			ASSERT_TRUE(writer.write(frames[i], stateHash(i)));
+		}
+		EXPECT_EQ(writer.getFrameCount(), frames.size());
+		writer.close();
+	}
+}
+
+TEST(InputJournal, round_trip) {
+	auto const path = makeTempPath("input-journal-round-trip.bin");
+	auto const frames = makeFrames(100);
+	writeJournal(path, frames);
+	// Deltas and repeats must be much smaller than full frames
+	EXPECT_LT(std::filesystem::file_size(path), frames.size() * frame_size / 2);
+
+	InputJournalReader reader;
+	ASSERT_TRUE(reader.open(path));
+	EXPECT_EQ(reader.getFrameSize(), frame_size);
+	EXPECT_EQ(reader.getFrameCount(), frames.size());
+	ASSERT_EQ(reader.getKeyframes().size(), (frames.size() + keyframe_interval - 1) / keyframe_interval);
+	std::vector<uint8_t> frame(frame_size);
+	for (size_t i = 0; i < frames.size(); i += 1) {
+		EXPECT_EQ(reader.getFrameIndex(), i);
+		InputJournalReader::Keyframe const* keyframe{};
+		ASSERT_TRUE(reader.read(frame, &keyframe));
+		EXPECT_EQ(frame, frames[i]) << "frame " << i;
+		if (i % keyframe_interval == 0) {
+			ASSERT_NE(keyframe, nullptr);
+			EXPECT_EQ(keyframe->frame, i);
+			EXPECT_EQ(keyframe->state_hash, stateHash(i));
+		}
+		else {
+			EXPECT_EQ(keyframe, nullptr);
+		}
+	}
+	EXPECT_FALSE(reader.read(frame));
+	reader.close();
+	std::filesystem::remove(path);
+}
+
+TEST(InputJournal, seek) {
+	auto const path = makeTempPath("input-journal-seek.bin");
+	auto const frames = makeFrames(100);
+	writeJournal(path, frames);
+
+	InputJournalReader reader;
+	ASSERT_TRUE(reader.open(path));
+	std::vector<uint8_t> frame(frame_size);
+	// On a keyframe, between keyframes, backwards, and the first frame
+	for (uint64_t const target : { 32ull, 45ull, 47ull, 3ull, 0ull, 99ull }) {
+		ASSERT_TRUE(reader.seek(target));
+		EXPECT_EQ(reader.getFrameIndex(), target);
+		InputJournalReader::Keyframe const* keyframe{};
+		ASSERT_TRUE(reader.read(frame, &keyframe));
+		EXPECT_EQ(frame, frames[target]) << "frame " << target;
+		EXPECT_EQ(keyframe != nullptr, target % keyframe_interval == 0);
+		// Reading on reports the following keyframe
+		for (uint64_t i = target + 1; i < std::min<uint64_t>(target + keyframe_interval + 1, frames.size()); i += 1) {
+			ASSERT_TRUE(reader.read(frame, &keyframe));
+			EXPECT_EQ(frame, frames[i]) << "frame " << i;
+			EXPECT_EQ(keyframe != nullptr, i % keyframe_interval == 0) << "frame " << i;
+		}
+	}
+	// The end of the journal is a valid position, past it is not
+	ASSERT_TRUE(reader.seek(frames.size()));
+	EXPECT_FALSE(reader.read(frame));
+	EXPECT_FALSE(reader.seek(frames.size() + 1));
+	reader.close();
+	std::filesystem::remove(path);
+}
+
+TEST(InputJournal, truncated_file) {
+	auto const path = makeTempPath("input-journal-truncated.bin");
+	auto const frames = makeFrames(40);
+	writeJournal(path, frames);
+	// Cut in the middle of the last record, as if the program exited while writing
+	std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+
+	InputJournalReader reader;
+	ASSERT_TRUE(reader.open(path));
+	EXPECT_EQ(reader.getFrameCount(), frames.size() - 1);
+	std::vector<uint8_t> frame(frame_size);
+	for (size_t i = 0; i + 1 < frames.size(); i += 1) {
+		ASSERT_TRUE(reader.read(frame));
+		EXPECT_EQ(frame, frames[i]) << "frame " << i;
+	}
+	EXPECT_FALSE(reader.read(frame));
+	reader.close();
+	std::filesystem::remove(path);
+}
+
+TEST(InputJournal, rejects_other_files) {
+	auto const path = makeTempPath("input-journal-bad.bin");
+	{
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		ASSERT_TRUE(file.is_open());
+		file << "LSTGINPX this is not an input journal";
+	}
+	InputJournalReader reader;
+	EXPECT_FALSE(reader.open(path));
+	EXPECT_FALSE(reader.isOpen());
+	EXPECT_FALSE(reader.open(makeTempPath("input-journal-missing.bin")));
+	std::filesystem::remove(path);
+
+	InputJournalWriter writer;
+	EXPECT_FALSE(writer.open(path, 0, keyframe_interval));
+}
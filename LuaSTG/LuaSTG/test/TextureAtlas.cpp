@@ -0,0 +1,175 @@
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "GameResource/TextureAtlas.hpp"
+#include "gtest/gtest.h"
+
+using luastg::TextureAtlasLayout;
+using luastg::TextureAtlasPacker;
+using luastg::TextureAtlasRect;
+
+namespace {
+	bool overlaps(TextureAtlasRect const& a, TextureAtlasRect const& b) {
+		return a.x < b.x + b.width && b.x < a.x + a.width && a.y < b.y + b.height && b.y < a.y + a.height;
+	}
+
+	std::string pathToUtf8(std::filesystem::path const& path) {
+		auto const path_u8 = path.lexically_normal().generic_u8string();
+		return { reinterpret_cast<char const*>(path_u8.data()), path_u8.size() };
+	}
+
+	std::filesystem::path makeTempPath(std::string_view const name) {
+		auto const directory = std::filesystem::temp_directory_path() / "luastg-test";
+		std::filesystem::create_directories(directory);
+		return directory / name;
+	}
+
+	bool equals(TextureAtlasLayout::Placement const& a, TextureAtlasLayout::Placement const& b) {
+		return a.page == b.page && a.rect.x == b.rect.x && a.rect.y == b.rect.y
+			&& a.rect.width == b.rect.width && a.rect.height == b.rect.height;
+	}
+}
+
+TEST(TextureAtlasPacker, insert_without_overlap) {
+	TextureAtlasPacker packer(256, 256);
+	std::vector<TextureAtlasRect> rects;
+	uint32_t const sizes[][2]{ { 64, 32 }, { 100, 100 }, { 17, 90 }, { 128, 16 }, { 33, 33 }, { 1, 1 }, { 200, 40 } };
+	for (auto const& size : sizes) {
+		TextureAtlasRect rect;
+		ASSERT_TRUE(packer.insert(size[0], size[1], rect));
+		EXPECT_EQ(rect.width, size[0]);
+		EXPECT_EQ(rect.height, size[1]);
+		EXPECT_LE(rect.x + rect.width, 256u);
+		EXPECT_LE(rect.y + rect.height, 256u);
+		for (auto const& other : rects) {
+			EXPECT_FALSE(overlaps(rect, other));
+		}
+		rects.push_back(rect);
+	}
+}
+
+TEST(TextureAtlasPacker, fill_exactly) {
+	TextureAtlasPacker packer(128, 128);
+	std::vector<TextureAtlasRect> rects;
+	for (int i = 0; i < 16; i += 1) {
+		TextureAtlasRect rect;
+		ASSERT_TRUE(packer.insert(32, 32, rect));
+		for (auto const& other : rects) {
+			EXPECT_FALSE(overlaps(rect, other));
+		}
+		rects.push_back(rect);
+	}
+	EXPECT_DOUBLE_EQ(packer.getOccupancy(), 1.0);
+	TextureAtlasRect rect;
+	EXPECT_FALSE(packer.insert(1, 1, rect));
+}
+
+TEST(TextureAtlasPacker, insert_too_large) {
+	TextureAtlasPacker packer(64, 64);
+	TextureAtlasRect rect;
+	EXPECT_FALSE(packer.insert(65, 1, rect));
+	EXPECT_FALSE(packer.insert(1, 65, rect));
+	EXPECT_TRUE(packer.insert(64, 64, rect));
+	EXPECT_EQ(rect.x, 0u);
+	EXPECT_EQ(rect.y, 0u);
+}
+
+TEST(TextureAtlasPacker, claim) {
+	TextureAtlasPacker packer(128, 128);
+	EXPECT_TRUE(packer.claim(TextureAtlasRect{ 32, 32, 64, 64 }));
+	// Overlapping, outside of the page, or empty
+	EXPECT_FALSE(packer.claim(TextureAtlasRect{ 80, 80, 32, 32 }));
+	EXPECT_FALSE(packer.claim(TextureAtlasRect{ 100, 0, 32, 32 }));
+	EXPECT_FALSE(packer.claim(TextureAtlasRect{ 0, 0, 0, 8 }));
+	// Right next to the claimed area
+	EXPECT_TRUE(packer.claim(TextureAtlasRect{ 96, 32, 32, 64 }));
+	EXPECT_DOUBLE_EQ(packer.getOccupancy(), (64.0 * 64.0 + 32.0 * 64.0) / (128.0 * 128.0));
+
+	// Insert after claim never overlaps the claimed areas
+	TextureAtlasRect rect;
+	ASSERT_TRUE(packer.insert(128, 32, rect));
+	EXPECT_FALSE(overlaps(rect, TextureAtlasRect{ 32, 32, 96, 64 }));
+	ASSERT_TRUE(packer.insert(128, 32, rect));
+	EXPECT_FALSE(overlaps(rect, TextureAtlasRect{ 32, 32, 96, 64 }));
+	EXPECT_FALSE(packer.insert(128, 32, rect));
+}
+
+TEST(TextureAtlasLayout, set_and_find) {
+	TextureAtlasLayout layout;
+	EXPECT_FALSE(layout.isDirty());
+	TextureAtlasLayout::Placement placement;
+	EXPECT_FALSE(layout.find("global", "tex", placement));
+
+	TextureAtlasLayout::Placement const a{ 1, TextureAtlasRect{ 2, 3, 4, 5 } };
+	layout.set("global", "tex", a);
+	EXPECT_TRUE(layout.isDirty());
+	ASSERT_TRUE(layout.find("global", "tex", placement));
+	EXPECT_TRUE(equals(placement, a));
+	// Pool and texture name are separate parts of the key
+	EXPECT_FALSE(layout.find("stage", "tex", placement));
+	EXPECT_FALSE(layout.find("globalt", "ex", placement));
+}
+
+TEST(TextureAtlasLayout, save_and_load) {
+	auto const path = makeTempPath("texture-atlas-layout.txt");
+	auto const path_u8 = pathToUtf8(path);
+
+	TextureAtlasLayout::Placement const a{ 0, TextureAtlasRect{ 2, 2, 30, 40 } };
+	TextureAtlasLayout::Placement const b{ 3, TextureAtlasRect{ 100, 200, 1, 1 } };
+	TextureAtlasLayout layout;
+	layout.set("global", "bullet", a);
+	layout.set("stage", "item with space", b);
+	ASSERT_TRUE(layout.save(path_u8));
+	EXPECT_FALSE(layout.isDirty());
+	// Setting the same placement again does not make it dirty
+	layout.set("global", "bullet", a);
+	EXPECT_FALSE(layout.isDirty());
+
+	TextureAtlasLayout loaded;
+	ASSERT_TRUE(loaded.load(path_u8));
+	EXPECT_FALSE(loaded.isDirty());
+	TextureAtlasLayout::Placement placement;
+	ASSERT_TRUE(loaded.find("global", "bullet", placement));
+	EXPECT_TRUE(equals(placement, a));
+	ASSERT_TRUE(loaded.find("stage", "item with space", placement));
+	EXPECT_TRUE(equals(placement, b));
+
+	std::filesystem::remove(path);
+}
+
+TEST(TextureAtlasLayout, load_rejects_other_files) {
+	auto const path = makeTempPath("texture-atlas-layout-bad.txt");
+	{
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		ASSERT_TRUE(file.is_open());
+		file << "not a layout\n0\t0\t0\t1\t1\tglobal\ttex\n";
+	}
+	TextureAtlasLayout layout;
+	EXPECT_FALSE(layout.load(pathToUtf8(path)));
+	TextureAtlasLayout::Placement placement;
+	EXPECT_FALSE(layout.find("global", "tex", placement));
+	EXPECT_FALSE(layout.load(pathToUtf8(makeTempPath("texture-atlas-layout-missing.txt"))));
+	std::filesystem::remove(path);
+}
+
+TEST(TextureAtlasLayout, load_skips_broken_lines) {
+	auto const path = makeTempPath("texture-atlas-layout-lines.txt");
+	{
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		ASSERT_TRUE(file.is_open());
+		file << "# luastg texture atlas layout 1\r\n"
+			"1\t2\t3\t4\t5\tglobal\tgood\r\n"
+			"x\t2\t3\t4\t5\tglobal\tbad-number\r\n"
+			"1\t2\t3\tglobal\tmissing-fields\r\n";
+	}
+	TextureAtlasLayout layout;
+	ASSERT_TRUE(layout.load(pathToUtf8(path)));
+	TextureAtlasLayout::Placement placement;
+	ASSERT_TRUE(layout.find("global", "good", placement));
+	EXPECT_TRUE(equals(placement, TextureAtlasLayout::Placement{ 1, TextureAtlasRect{ 2, 3, 4, 5 } }));
+	EXPECT_FALSE(layout.find("global", "bad-number", placement));
+	EXPECT_FALSE(layout.find("global", "missing-fields", placement));
+	std::filesystem::remove(path);
+}
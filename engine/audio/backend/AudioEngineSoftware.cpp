@@ -0,0 +1,227 @@
+#include "backend/AudioEngineSoftware.hpp"
+#include "backend/AudioPlayerSoftware.hpp"
+#include "backend/AudioMixerKernels.hpp"
+#include "core/Configuration.hpp"
+#include "core/Logger.hpp"
+#include <algorithm>
+#include <cassert>
+
+namespace core {
+	// IAudioEngine
+
+	void AudioEngineSoftware::addEventListener(IAudioEngineEventListener* const listener) {
+		if (std::ranges::find(m_listeners, listener) == m_listeners.end()) {
+			m_listeners.push_back(listener);
+		}
+	}
+	void AudioEngineSoftware::removeEventListener(IAudioEngineEventListener* const listener) {
+		std::erase(m_listeners, listener);
+	}
+
+	bool AudioEngineSoftware::refreshAudioEndpoint() {
+		return true;
+	}
+	uint32_t AudioEngineSoftware::getAudioEndpointCount() const noexcept {
+		return 1;
+	}
+	std::string_view AudioEngineSoftware::getAudioEndpointName(uint32_t const index) const noexcept {
+		if (index != 0) {
+			return "";
+		}
+		return m_sink->getName();
+	}
+
+	void AudioEngineSoftware::setPreferredAudioEndpoint(std::string_view const name) {
+		m_preferred_endpoint = name;
+	}
+	bool AudioEngineSoftware::setAudioEndpoint(std::string_view const name) {
+		// the sink is the only endpoint
+		setPreferredAudioEndpoint(name);
+		return name.empty() || name == m_sink->getName();
+	}
+	std::string_view AudioEngineSoftware::getCurrentAudioEndpointName() const noexcept {
+		return m_sink->getName();
+	}
+
+	void AudioEngineSoftware::setVolume(float const volume) {
+		setMixingChannelVolume(AudioMixingChannel::direct, volume);
+	}
+	float AudioEngineSoftware::getVolume() const noexcept {
+		return getMixingChannelVolume(AudioMixingChannel::direct);
+	}
+	void AudioEngineSoftware::setMixingChannelVolume(AudioMixingChannel const channel, float const volume) {
+		std::scoped_lock lock(m_mutex);
+		m_mixing_channel_volumes[static_cast<size_t>(channel)] = std::clamp(volume, 0.0f, 1.0f);
+	}
+	float AudioEngineSoftware::getMixingChannelVolume(AudioMixingChannel const channel) const noexcept {
+		return m_mixing_channel_volumes[static_cast<size_t>(channel)];
+	}
+
+	bool AudioEngineSoftware::createAudioPlayer(IAudioDecoder* const decoder, AudioMixingChannel const channel, IAudioPlayer** const output_player) {
+		SmartReference<IAudioSample> sample;
+		if (!IAudioSample::create(decoder, sample.put())) {
+			return false;
+		}
+		return createAudioPlayer(sample.get(), channel, output_player);
+	}
+	bool AudioEngineSoftware::createAudioPlayer(IAudioSample* const sample, AudioMixingChannel const channel, IAudioPlayer** const output_player) {
+		try {
+			SmartReference<AudioPlayerSoftware> player;
+			player.attach(new AudioPlayerSoftware);
+			if (!player->create(this, channel, sample)) {
+				return false;
+			}
+			*output_player = player.detach();
+			return true;
+		}
+		catch (std::exception const& e) {
+			Logger::error("[core] create AudioPlayerSoftware failed: {}", e.what());
+			return false;
+		}
+	}
+	bool AudioEngineSoftware::createStreamAudioPlayer(IAudioDecoder* const decoder, AudioMixingChannel const channel, IAudioPlayer** const output_player) {
+		try {
+			SmartReference<AudioPlayerSoftware> player;
+			player.attach(new AudioPlayerSoftware);
+			if (!player->createStream(this, channel, decoder)) {
+				return false;
+			}
+			*output_player = player.detach();
+			return true;
+		}
+		catch (std::exception const& e) {
+			Logger::error("[core] create AudioPlayerSoftware failed: {}", e.what());
+			return false;
+		}
+	}
+
+	// ISoftwareAudioEngine
+
+	uint64_t AudioEngineSoftware::getRenderedFrameCount() const noexcept {
+		std::scoped_lock lock(m_mutex);
+		return m_rendered_frame_count;
+	}
+	uint32_t AudioEngineSoftware::getPlayingPlayerCount() const noexcept {
+		std::scoped_lock lock(m_mutex);
+		return m_playing_player_count;
+	}
+
+	void AudioEngineSoftware::render(uint32_t frame_count) {
+		std::scoped_lock lock(m_mutex);
+		while (frame_count > 0) {
+			auto const count = std::min(frame_count, block_frame_count);
+			renderBlockLocked(count);
+			frame_count -= count;
+		}
+	}
+
+	// AudioEngineSoftware
+
+	AudioEngineSoftware::AudioEngineSoftware() {
+		for (auto& volume : m_mixing_channel_volumes) {
+			volume = 1.0f;
+		}
+		auto const& config = ConfigurationLoader::getInstance().getAudioSystem();
+		m_preferred_endpoint = config.getPreferredEndpointName();
+		m_mixing_channel_volumes[static_cast<size_t>(AudioMixingChannel::sound_effect)] = config.getSoundEffectVolume();
+		m_mixing_channel_volumes[static_cast<size_t>(AudioMixingChannel::music)] = config.getMusicVolume();
+	}
+	AudioEngineSoftware::~AudioEngineSoftware() {
+		if (m_sink) {
+			m_sink->close();
+		}
+	}
+
+	bool AudioEngineSoftware::create(IAudioSink* const sink, uint32_t const sample_rate) {
+		if (sink == nullptr || sample_rate == 0) {
+			return false;
+		}
+		if (!sink->open(sample_rate, 2)) {
+			Logger::error("[core] AudioEngineSoftware: open audio sink '{}' failed", sink->getName());
+			return false;
+		}
+		m_sink = sink;
+		m_sample_rate = sample_rate;
+		return true;
+	}
+	void AudioEngineSoftware::addPlayer(AudioPlayerSoftware* const player) {
+		std::scoped_lock lock(m_mutex);
+		m_players.push_back(player);
+	}
+	void AudioEngineSoftware::removePlayer(AudioPlayerSoftware* const player) {
+		std::scoped_lock lock(m_mutex);
+		std::erase(m_players, player);
+	}
+
+	void AudioEngineSoftware::renderBlockLocked(uint32_t const frame_count) {
+		size_t const sample_count = static_cast<size_t>(frame_count) * 2;
+		for (auto& buffer : m_channel_buffers) {
+			buffer.assign(sample_count, 0.0f);
+		}
+
+		uint32_t playing{};
+		for (auto* const player : m_players) {
+			if (player->isPlayingLocked()) {
+				playing += 1;
+				player->mixLocked(m_channel_buffers[static_cast<size_t>(player->getMixingChannel())].data(), frame_count, m_sample_rate);
+			}
+		}
+		m_playing_player_count = playing;
+
+		// submix channels go through the direct channel, whose volume is the master volume
+		auto& direct = m_channel_buffers[static_cast<size_t>(AudioMixingChannel::direct)];
+		for (auto const channel : { AudioMixingChannel::sound_effect, AudioMixingChannel::music }) {
+			auto const volume = m_mixing_channel_volumes[static_cast<size_t>(channel)];
+			audio_mixer::mixStereo(direct.data(), m_channel_buffers[static_cast<size_t>(channel)].data(), frame_count, volume, volume);
+		}
+		auto const master_volume = m_mixing_channel_volumes[static_cast<size_t>(AudioMixingChannel::direct)];
+		m_output_buffer.assign(sample_count, 0.0f);
+		audio_mixer::mixStereo(m_output_buffer.data(), direct.data(), frame_count, master_volume, master_volume);
+		audio_mixer::clamp(m_output_buffer.data(), sample_count);
+
+		m_sink->write(m_output_buffer.data(), frame_count);
+		m_rendered_frame_count += frame_count;
+	}
+
+	// ISoftwareAudioEngine
+
+	bool ISoftwareAudioEngine::create(IAudioSink* const sink, uint32_t const sample_rate, ISoftwareAudioEngine** const output_engine) {
+		if (output_engine == nullptr) {
+			assert(false);
+			return false;
+		}
+		try {
+			SmartReference<AudioEngineSoftware> engine;
+			engine.attach(new AudioEngineSoftware);
+			if (!engine->create(sink, sample_rate)) {
+				return false;
+			}
+			*output_engine = engine.detach();
+			return true;
+		}
+		catch (std::exception const& e) {
+			Logger::error("[core] create AudioEngineSoftware failed: {}", e.what());
+			return false;
+		}
+	}
+
+#ifndef _WIN32
+	// XAudio2 is not available, fall back to a silent software engine
+	bool IAudioEngine::create(IAudioEngine** const output_endpoint) {
+		if (output_endpoint == nullptr) {
+			assert(false);
+			return false;
+		}
+		SmartReference<IAudioSink> sink;
+		if (!IAudioSink::createNull(sink.put())) {
+			return false;
+		}
+		SmartReference<ISoftwareAudioEngine> engine;
+		if (!ISoftwareAudioEngine::create(sink.get(), 48000, engine.put())) {
+			return false;
+		}
+		*output_endpoint = engine.detach();
+		return true;
+	}
+#endif
+}
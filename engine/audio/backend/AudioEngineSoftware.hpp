@@ -0,0 +1,78 @@
+#pragma once
+#include "core/SoftwareAudioEngine.hpp"
+#include "core/SmartReference.hpp"
+#include "core/implement/ReferenceCounted.hpp"
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace core {
+	class AudioPlayerSoftware;
+
+	class AudioEngineSoftware final : public implement::ReferenceCounted<ISoftwareAudioEngine> {
+	public:
+		// IAudioEngine
+
+		void addEventListener(IAudioEngineEventListener* listener) override;
+		void removeEventListener(IAudioEngineEventListener* listener) override;
+
+		[[nodiscard]] bool refreshAudioEndpoint() override;
+		[[nodiscard]] uint32_t getAudioEndpointCount() const noexcept override;
+		[[nodiscard]] std::string_view getAudioEndpointName(uint32_t index) const noexcept override;
+
+		void setPreferredAudioEndpoint(std::string_view name) override;
+		[[nodiscard]] bool setAudioEndpoint(std::string_view name) override;
+		[[nodiscard]] std::string_view getCurrentAudioEndpointName() const noexcept override;
+
+		void setVolume(float volume) override;
+		[[nodiscard]] float getVolume() const noexcept override;
+		void setMixingChannelVolume(AudioMixingChannel channel, float volume) override;
+		[[nodiscard]] float getMixingChannelVolume(AudioMixingChannel channel) const noexcept override;
+
+		[[nodiscard]] bool createAudioPlayer(IAudioDecoder* decoder, AudioMixingChannel channel, IAudioPlayer** output_player) override;
+		[[nodiscard]] bool createAudioPlayer(IAudioSample* sample, AudioMixingChannel channel, IAudioPlayer** output_player) override;
+		[[nodiscard]] bool createStreamAudioPlayer(IAudioDecoder* decoder, AudioMixingChannel channel, IAudioPlayer** output_player) override;
+
+		// ISoftwareAudioEngine
+
+		[[nodiscard]] uint32_t getSampleRate() const noexcept override { return m_sample_rate; }
+		[[nodiscard]] uint16_t getChannelCount() const noexcept override { return 2; }
+		[[nodiscard]] uint64_t getRenderedFrameCount() const noexcept override;
+		[[nodiscard]] uint32_t getPlayingPlayerCount() const noexcept override;
+
+		void render(uint32_t frame_count) override;
+
+		// AudioEngineSoftware
+
+		AudioEngineSoftware();
+		AudioEngineSoftware(AudioEngineSoftware const&) = delete;
+		AudioEngineSoftware(AudioEngineSoftware&&) = delete;
+		~AudioEngineSoftware() override;
+
+		AudioEngineSoftware& operator=(AudioEngineSoftware const&) = delete;
+		AudioEngineSoftware& operator=(AudioEngineSoftware&&) = delete;
+
+		bool create(IAudioSink* sink, uint32_t sample_rate);
+		void addPlayer(AudioPlayerSoftware* player);
+		void removePlayer(AudioPlayerSoftware* player);
+		// Guards all players and the mixing state, held by render
+		std::mutex& getMutex() noexcept { return m_mutex; }
+
+	private:
+		static constexpr uint32_t block_frame_count = 1024;
+
+		void renderBlockLocked(uint32_t frame_count);
+
+		mutable std::mutex m_mutex;
+		SmartReference<IAudioSink> m_sink;
+		std::vector<IAudioEngineEventListener*> m_listeners;
+		std::vector<AudioPlayerSoftware*> m_players;
+		std::string m_preferred_endpoint;
+		std::vector<float> m_channel_buffers[static_cast<size_t>(AudioMixingChannel::count)];
+		std::vector<float> m_output_buffer;
+		uint64_t m_rendered_frame_count{};
+		uint32_t m_playing_player_count{};
+		uint32_t m_sample_rate{};
+		float m_mixing_channel_volumes[static_cast<size_t>(AudioMixingChannel::count)]{};
+	};
+}
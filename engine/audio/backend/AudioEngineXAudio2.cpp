@@ -78,6 +78,21 @@ namespace core {
 			return false;
 		}
 	}
+	bool AudioEngineXAudio2::createAudioPlayer(IAudioSample* const sample, AudioMixingChannel const channel, IAudioPlayer** const output_player) {
+		try {
+			SmartReference<AudioPlayerXAudio2> player;
+			player.attach(new AudioPlayerXAudio2);
+			if (!player->create(this, channel, sample)) {
+				return false;
+			}
+			*output_player = player.detach();
+			return true;
+		}
+		catch (std::exception const& e) {
+			Logger::error("[core] create AudioPlayerXAudio2 failed: {}", e.what());
+			return false;
+		}
+	}
 	bool AudioEngineXAudio2::createStreamAudioPlayer(IAudioDecoder* const decoder, AudioMixingChannel const channel, IAudioPlayer** const output_player) {
 		try {
 			SmartReference<StreamAudioPlayerXAudio2> player;
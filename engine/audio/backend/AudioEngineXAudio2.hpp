@@ -31,6 +31,7 @@ namespace core {
 		[[nodiscard]] float getMixingChannelVolume(AudioMixingChannel channel) const noexcept override;
 
 		[[nodiscard]] bool createAudioPlayer(IAudioDecoder* decoder, AudioMixingChannel channel, IAudioPlayer** output_player) override;
+		[[nodiscard]] bool createAudioPlayer(IAudioSample* sample, AudioMixingChannel channel, IAudioPlayer** output_player) override;
 		[[nodiscard]] bool createStreamAudioPlayer(IAudioDecoder* decoder, AudioMixingChannel channel, IAudioPlayer** output_player) override;
 
 		// AudioEngineXAudio2
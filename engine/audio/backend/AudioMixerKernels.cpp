@@ -0,0 +1,90 @@
+#include "backend/AudioMixerKernels.hpp"
+#include <algorithm>
+#include <cmath>
+
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define CORE_AUDIO_MIXER_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace core::audio_mixer {
+	void convertS16ToFloat(float* const dst, int16_t const* const src, size_t const sample_count) noexcept {
+		constexpr float scale = 1.0f / 32768.0f;
+		size_t i = 0;
+	#ifdef CORE_AUDIO_MIXER_SSE2
+		__m128 const v_scale = _mm_set1_ps(scale);
+		for (; i + 8 <= sample_count; i += 8) {
+			__m128i const v = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + i));
+			// sign extend s16 to s32 by unpacking into the high half and shifting back
+			__m128i const lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+			__m128i const hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+			_mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), v_scale));
+			_mm_storeu_ps(dst + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), v_scale));
+		}
+	#endif
+		for (; i < sample_count; i += 1) {
+			dst[i] = static_cast<float>(src[i]) * scale;
+		}
+	}
+	void convertFloatToS16(int16_t* const dst, float const* const src, size_t const sample_count) noexcept {
+		size_t i = 0;
+	#ifdef CORE_AUDIO_MIXER_SSE2
+		__m128 const v_scale = _mm_set1_ps(32767.0f);
+		for (; i + 8 <= sample_count; i += 8) {
+			// cvtps rounds to nearest, packs saturates
+			__m128i const lo = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(src + i), v_scale));
+			__m128i const hi = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(src + i + 4), v_scale));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packs_epi32(lo, hi));
+		}
+	#endif
+		for (; i < sample_count; i += 1) {
+			auto const v = std::clamp(src[i] * 32767.0f, -32768.0f, 32767.0f);
+			dst[i] = static_cast<int16_t>(std::nearbyint(v));
+		}
+	}
+	void mixStereo(float* const dst, float const* const src, size_t const frame_count, float const left, float const right) noexcept {
+		size_t i = 0;
+		size_t const sample_count = frame_count * 2;
+	#ifdef CORE_AUDIO_MIXER_SSE2
+		__m128 const v_gain = _mm_setr_ps(left, right, left, right);
+		for (; i + 4 <= sample_count; i += 4) {
+			__m128 const v = _mm_add_ps(_mm_loadu_ps(dst + i), _mm_mul_ps(_mm_loadu_ps(src + i), v_gain));
+			_mm_storeu_ps(dst + i, v);
+		}
+	#endif
+		for (; i < sample_count; i += 2) {
+			dst[i] += src[i] * left;
+			dst[i + 1] += src[i + 1] * right;
+		}
+	}
+	void mixMonoToStereo(float* const dst, float const* const src, size_t const frame_count, float const left, float const right) noexcept {
+		size_t i = 0;
+	#ifdef CORE_AUDIO_MIXER_SSE2
+		__m128 const v_gain = _mm_setr_ps(left, right, left, right);
+		for (; i + 4 <= frame_count; i += 4) {
+			__m128 const v = _mm_loadu_ps(src + i);
+			__m128 const v_lo = _mm_unpacklo_ps(v, v); // s0 s0 s1 s1
+			__m128 const v_hi = _mm_unpackhi_ps(v, v); // s2 s2 s3 s3
+			_mm_storeu_ps(dst + i * 2, _mm_add_ps(_mm_loadu_ps(dst + i * 2), _mm_mul_ps(v_lo, v_gain)));
+			_mm_storeu_ps(dst + i * 2 + 4, _mm_add_ps(_mm_loadu_ps(dst + i * 2 + 4), _mm_mul_ps(v_hi, v_gain)));
+		}
+	#endif
+		for (; i < frame_count; i += 1) {
+			dst[i * 2] += src[i] * left;
+			dst[i * 2 + 1] += src[i] * right;
+		}
+	}
+	void clamp(float* const data, size_t const sample_count) noexcept {
+		size_t i = 0;
+	#ifdef CORE_AUDIO_MIXER_SSE2
+		__m128 const v_min = _mm_set1_ps(-1.0f);
+		__m128 const v_max = _mm_set1_ps(1.0f);
+		for (; i + 4 <= sample_count; i += 4) {
+			_mm_storeu_ps(data + i, _mm_min_ps(_mm_max_ps(_mm_loadu_ps(data + i), v_min), v_max));
+		}
+	#endif
+		for (; i < sample_count; i += 1) {
+			data[i] = std::clamp(data[i], -1.0f, 1.0f);
+		}
+	}
+}
@@ -0,0 +1,19 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace core::audio_mixer {
+	// All buffers are interleaved, stereo buffers are [L, R, L, R, ...]
+	// SSE2 is used when available, the scalar path gives identical results
+
+	// dst[i] = src[i] / 32768
+	void convertS16ToFloat(float* dst, int16_t const* src, size_t sample_count) noexcept;
+	// dst[i] = saturate(src[i] * 32767)
+	void convertFloatToS16(int16_t* dst, float const* src, size_t sample_count) noexcept;
+	// dst[2i] += src[2i] * left, dst[2i + 1] += src[2i + 1] * right
+	void mixStereo(float* dst, float const* src, size_t frame_count, float left, float right) noexcept;
+	// dst[2i] += src[i] * left, dst[2i + 1] += src[i] * right
+	void mixMonoToStereo(float* dst, float const* src, size_t frame_count, float left, float right) noexcept;
+	// data[i] = clamp(data[i], -1, 1)
+	void clamp(float* data, size_t sample_count) noexcept;
+}
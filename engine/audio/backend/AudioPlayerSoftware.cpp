@@ -0,0 +1,319 @@
+#include "backend/AudioPlayerSoftware.hpp"
+#include "backend/AudioMixerKernels.hpp"
+#include "core/Logger.hpp"
+#include "xmath/XFFT.h"
+#include <algorithm>
+#include <cmath>
+
+namespace core {
+	// IAudioPlayer
+
+	bool AudioPlayerSoftware::play(double const seconds) {
+		std::scoped_lock lock(m_parent->getMutex());
+		m_position = std::max(0.0, seconds) * static_cast<double>(m_sample_rate);
+		if (m_position >= static_cast<double>(m_total_frame)) {
+			m_position = static_cast<double>(m_total_frame);
+			if (!m_loop) {
+				m_state = AudioPlayerState::stopped;
+				return true; // not a fault
+			}
+		}
+		m_state = AudioPlayerState::playing;
+		return true;
+	}
+	bool AudioPlayerSoftware::pause() {
+		std::scoped_lock lock(m_parent->getMutex());
+		if (m_state == AudioPlayerState::playing) {
+			m_state = AudioPlayerState::paused;
+		}
+		return true;
+	}
+	bool AudioPlayerSoftware::resume() {
+		std::scoped_lock lock(m_parent->getMutex());
+		if (m_state == AudioPlayerState::paused) {
+			m_state = AudioPlayerState::playing;
+		}
+		return true;
+	}
+	bool AudioPlayerSoftware::stop() {
+		std::scoped_lock lock(m_parent->getMutex());
+		m_state = AudioPlayerState::stopped;
+		m_position = 0.0;
+		return true;
+	}
+	AudioPlayerState AudioPlayerSoftware::getState() {
+		std::scoped_lock lock(m_parent->getMutex());
+		return m_state;
+	}
+
+	double AudioPlayerSoftware::getTotalTime() {
+		return static_cast<double>(m_total_frame) / static_cast<double>(m_sample_rate);
+	}
+	double AudioPlayerSoftware::getTime() {
+		std::scoped_lock lock(m_parent->getMutex());
+		return m_position / static_cast<double>(m_sample_rate);
+	}
+	bool AudioPlayerSoftware::setLoop(bool const enable, double const start_pos, double const length) {
+		std::scoped_lock lock(m_parent->getMutex());
+		m_loop = enable;
+		auto const start = static_cast<uint32_t>(std::max(0.0, start_pos) * static_cast<double>(m_sample_rate));
+		auto const count = static_cast<uint32_t>(std::max(0.0, length) * static_cast<double>(m_sample_rate));
+		// zero length means loop to the end, same as XAudio2
+		uint64_t const end = count > 0 ? static_cast<uint64_t>(start) + count : m_total_frame;
+		m_loop_start = std::min(start, m_total_frame);
+		m_loop_end = static_cast<uint32_t>(std::min<uint64_t>(end, m_total_frame));
+		return end <= m_total_frame;
+	}
+
+	float AudioPlayerSoftware::getVolume() {
+		return m_volume;
+	}
+	bool AudioPlayerSoftware::setVolume(float const volume) {
+		std::scoped_lock lock(m_parent->getMutex());
+		m_volume = std::clamp(volume, 0.0f, 1.0f);
+		return true;
+	}
+	float AudioPlayerSoftware::getBalance() {
+		return m_output_balance;
+	}
+	bool AudioPlayerSoftware::setBalance(float const v) {
+		std::scoped_lock lock(m_parent->getMutex());
+		m_output_balance = std::clamp(v, -1.0f, 1.0f);
+		return true;
+	}
+	float AudioPlayerSoftware::getSpeed() {
+		return m_speed;
+	}
+	bool AudioPlayerSoftware::setSpeed(float const speed) {
+		if (!(speed > 0.0f)) {
+			return false;
+		}
+		std::scoped_lock lock(m_parent->getMutex());
+		m_speed = speed;
+		return true;
+	}
+
+	void AudioPlayerSoftware::updateFFT() {
+		if (m_fft_input.size() != fft_sample_count) {
+			m_fft_input.resize(fft_sample_count);
+		}
+		{
+			std::scoped_lock lock(m_parent->getMutex());
+			// oldest sample first
+			for (uint32_t i = 0; i < fft_sample_count; i += 1) {
+				m_fft_input[i] = m_fft_history[(m_fft_history_index + i) % fft_sample_count];
+			}
+		}
+		if (m_fft_window.size() != fft_sample_count) {
+			m_fft_window.resize(fft_sample_count);
+			xmath::fft::getWindow(m_fft_window.size(), m_fft_window.data());
+		}
+		for (size_t i = 0; i < fft_sample_count; i += 1) {
+			m_fft_input[i] *= m_fft_window[i];
+		}
+		size_t const fft_data_size = xmath::fft::getNeededWorksetSize(m_fft_input.size());
+		if (auto const count = fft_data_size / sizeof(float) + 1; m_fft_data.size() != count) {
+			m_fft_data.resize(count);
+		}
+		if (m_fft_complex_result.size() != m_fft_input.size() * 2) {
+			m_fft_complex_result.resize(m_fft_input.size() * 2);
+		}
+		if (m_fft_result.size() != fft_sample_count / 2) {
+			m_fft_result.resize(fft_sample_count / 2);
+		}
+		xmath::fft::fft(m_fft_input.size(), m_fft_data.data(), m_fft_input.data(), m_fft_complex_result.data(), m_fft_result.data());
+	}
+	uint32_t AudioPlayerSoftware::getFFTSize() {
+		return static_cast<uint32_t>(m_fft_result.size());
+	}
+	float const* AudioPlayerSoftware::getFFT() {
+		return m_fft_result.data();
+	}
+
+	// AudioPlayerSoftware
+
+	AudioPlayerSoftware::~AudioPlayerSoftware() {
+		if (m_parent) {
+			m_parent->removePlayer(this);
+		}
+	}
+
+	bool AudioPlayerSoftware::create(AudioEngineSoftware* const parent, AudioMixingChannel const mixing_channel, IAudioSample* const sample) {
+		if (!setFormat(sample->getSampleSize(), sample->getChannelCount(), sample->getSampleRate(), sample->getFrameCount())) {
+			return false;
+		}
+		m_sample = sample;
+		m_mixing_channel = mixing_channel;
+		m_parent = parent;
+		m_parent->addPlayer(this);
+		return true;
+	}
+	bool AudioPlayerSoftware::createStream(AudioEngineSoftware* const parent, AudioMixingChannel const mixing_channel, IAudioDecoder* const decoder) {
+		if (!setFormat(decoder->getSampleSize(), decoder->getChannelCount(), decoder->getSampleRate(), decoder->getFrameCount())) {
+			return false;
+		}
+		if (!decoder->seek(0)) {
+			return false;
+		}
+		m_decoder = decoder;
+		m_mixing_channel = mixing_channel;
+		m_parent = parent;
+		m_parent->addPlayer(this);
+		return true;
+	}
+
+	void AudioPlayerSoftware::mixLocked(float* const output, uint32_t const frame_count, uint32_t const output_sample_rate) {
+		if (m_state != AudioPlayerState::playing) {
+			return;
+		}
+
+		uint32_t const channels = m_channel_count;
+		if (m_scratch.size() < static_cast<size_t>(frame_count) * channels) {
+			m_scratch.resize(static_cast<size_t>(frame_count) * channels);
+		}
+		auto const loop_active = [this]() -> bool { return m_loop && m_loop_end > m_loop_start; };
+
+		uint32_t produced = 0;
+		double const step = static_cast<double>(m_speed) * static_cast<double>(m_sample_rate) / static_cast<double>(output_sample_rate);
+		if (step == 1.0 && m_position == std::floor(m_position)) {
+			// same rate, copy whole runs of frames
+			while (produced < frame_count) {
+				auto const end = getEndFrame();
+				auto const frame = static_cast<uint32_t>(m_position);
+				if (frame >= end) {
+					if (loop_active()) {
+						m_position = static_cast<double>(m_loop_start);
+						continue;
+					}
+					m_state = AudioPlayerState::stopped;
+					break;
+				}
+				uint32_t count{};
+				auto const* const frames = getFrames(frame, std::min(frame_count - produced, end - frame), &count);
+				if (frames == nullptr || count == 0) {
+					m_state = AudioPlayerState::stopped;
+					break;
+				}
+				audio_mixer::convertS16ToFloat(m_scratch.data() + static_cast<size_t>(produced) * channels, frames, static_cast<size_t>(count) * channels);
+				produced += count;
+				m_position += static_cast<double>(count);
+			}
+		}
+		else {
+			// resample with linear interpolation
+			constexpr float scale = 1.0f / 32768.0f;
+			for (; produced < frame_count; produced += 1) {
+				auto const end = getEndFrame();
+				if (m_position >= static_cast<double>(end)) {
+					if (!loop_active()) {
+						m_state = AudioPlayerState::stopped;
+						break;
+					}
+					auto const loop_length = static_cast<double>(m_loop_end - m_loop_start);
+					m_position = static_cast<double>(m_loop_start) + std::fmod(m_position - static_cast<double>(m_loop_start), loop_length);
+				}
+				auto const frame = static_cast<uint32_t>(m_position);
+				auto const t = static_cast<float>(m_position - static_cast<double>(frame));
+
+				uint32_t count{};
+				auto const* const p0 = getFrames(frame, 2, &count);
+				if (p0 == nullptr) {
+					m_state = AudioPlayerState::stopped;
+					break;
+				}
+				float s0[2]{};
+				float s1[2]{};
+				for (uint32_t c = 0; c < channels; c += 1) {
+					s0[c] = static_cast<float>(p0[c]);
+				}
+				if (count >= 2 && frame + 1 < end) {
+					for (uint32_t c = 0; c < channels; c += 1) {
+						s1[c] = static_cast<float>(p0[channels + c]);
+					}
+				}
+				else {
+					// the next frame is behind a loop point or a stream window boundary, silence after the end
+					uint32_t const next = (frame + 1 < end) ? frame + 1 : (loop_active() ? m_loop_start : end);
+					uint32_t next_count{};
+					if (auto const* const p1 = getFrames(next, 1, &next_count); p1 != nullptr && next < end) {
+						for (uint32_t c = 0; c < channels; c += 1) {
+							s1[c] = static_cast<float>(p1[c]);
+						}
+					}
+				}
+
+				float* const dst = m_scratch.data() + static_cast<size_t>(produced) * channels;
+				for (uint32_t c = 0; c < channels; c += 1) {
+					dst[c] = (s0[c] + (s1[c] - s0[c]) * t) * scale;
+				}
+				m_position += step;
+			}
+		}
+
+		if (produced == 0) {
+			return;
+		}
+		recordFFT(m_scratch.data(), produced);
+
+		// same gains as XAudio2 output matrix, see setOutputBalance
+		float const left = std::clamp(0.5f - m_output_balance * 0.5f, 0.0f, 1.0f) * m_volume;
+		float const right = std::clamp(0.5f + m_output_balance * 0.5f, 0.0f, 1.0f) * m_volume;
+		if (channels == 1) {
+			audio_mixer::mixMonoToStereo(output, m_scratch.data(), produced, left, right);
+		}
+		else {
+			audio_mixer::mixStereo(output, m_scratch.data(), produced, left, right);
+		}
+	}
+
+	bool AudioPlayerSoftware::setFormat(uint16_t const sample_size, uint16_t const channel_count, uint32_t const sample_rate, uint32_t const frame_count) {
+		if (sample_size != 2 || (channel_count != 1 && channel_count != 2) || sample_rate == 0) {
+			Logger::error("[core] AudioPlayerSoftware: unsupported format ({} bytes per sample, {} channels, {} Hz)", sample_size, channel_count, sample_rate);
+			return false;
+		}
+		m_channel_count = channel_count;
+		m_sample_rate = sample_rate;
+		m_total_frame = frame_count;
+		m_loop_start = 0;
+		m_loop_end = frame_count;
+		return true;
+	}
+	int16_t const* AudioPlayerSoftware::getFrames(uint32_t const frame, uint32_t const max_count, uint32_t* const output_count) {
+		*output_count = 0;
+		if (frame >= m_total_frame) {
+			return nullptr;
+		}
+		if (m_sample) {
+			*output_count = std::min(max_count, m_total_frame - frame);
+			return static_cast<int16_t const*>(m_sample->getData()) + static_cast<size_t>(frame) * m_channel_count;
+		}
+		if (frame < m_stream_window_start || frame >= m_stream_window_start + m_stream_window_frames) {
+			if (frame != m_decoder_frame && !m_decoder->seek(frame)) {
+				return nullptr;
+			}
+			m_stream_window.resize(static_cast<size_t>(stream_window_frame_count) * m_channel_count);
+			uint32_t frames_read{};
+			if (!m_decoder->read(stream_window_frame_count, m_stream_window.data(), &frames_read) || frames_read == 0) {
+				m_stream_window_frames = 0;
+				return nullptr;
+			}
+			m_stream_window_start = frame;
+			m_stream_window_frames = frames_read;
+			m_decoder_frame = frame + frames_read;
+		}
+		auto const offset = frame - m_stream_window_start;
+		*output_count = std::min(max_count, m_stream_window_frames - offset);
+		return m_stream_window.data() + static_cast<size_t>(offset) * m_channel_count;
+	}
+	uint32_t AudioPlayerSoftware::getEndFrame() const noexcept {
+		return (m_loop && m_loop_end > m_loop_start) ? m_loop_end : m_total_frame;
+	}
+	void AudioPlayerSoftware::recordFFT(float const* const frames, uint32_t const frame_count) {
+		// only the last fft_sample_count frames matter
+		uint32_t const first = frame_count > fft_sample_count ? frame_count - fft_sample_count : 0;
+		for (uint32_t i = first; i < frame_count; i += 1) {
+			m_fft_history[m_fft_history_index] = frames[static_cast<size_t>(i) * m_channel_count];
+			m_fft_history_index = (m_fft_history_index + 1) % fft_sample_count;
+		}
+	}
+}
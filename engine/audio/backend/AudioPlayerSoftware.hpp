@@ -0,0 +1,109 @@
+#pragma once
+#include "core/AudioPlayer.hpp"
+#include "core/AudioEngine.hpp"
+#include "core/SmartReference.hpp"
+#include "core/implement/ReferenceCounted.hpp"
+#include "backend/AudioEngineSoftware.hpp"
+#include <array>
+#include <vector>
+
+namespace core {
+	// Plays a shared IAudioSample, or streams from an IAudioDecoder when created as a stream player.
+	// Everything except the constructor and destructor runs under the parent engine mutex.
+	class AudioPlayerSoftware final : public implement::ReferenceCounted<IAudioPlayer> {
+	public:
+		// IAudioPlayer
+
+		bool play(double seconds) override;
+		bool pause() override;
+		bool resume() override;
+		bool stop() override;
+		AudioPlayerState getState() override;
+
+		double getTotalTime() override;
+		double getTime() override;
+		bool setLoop(bool enable, double start_pos, double length) override;
+
+		float getVolume() override;
+		bool setVolume(float volume) override;
+		float getBalance() override;
+		bool setBalance(float v) override;
+		float getSpeed() override;
+		bool setSpeed(float speed) override;
+
+		void updateFFT() override;
+		uint32_t getFFTSize() override;
+		float const* getFFT() override;
+
+		// AudioPlayerSoftware
+
+		AudioPlayerSoftware() = default;
+		AudioPlayerSoftware(AudioPlayerSoftware const&) = delete;
+		AudioPlayerSoftware(AudioPlayerSoftware&&) = delete;
+		~AudioPlayerSoftware() override;
+
+		AudioPlayerSoftware& operator=(AudioPlayerSoftware const&) = delete;
+		AudioPlayerSoftware& operator=(AudioPlayerSoftware&&) = delete;
+
+		bool create(AudioEngineSoftware* parent, AudioMixingChannel mixing_channel, IAudioSample* sample);
+		bool createStream(AudioEngineSoftware* parent, AudioMixingChannel mixing_channel, IAudioDecoder* decoder);
+
+		[[nodiscard]] AudioMixingChannel getMixingChannel() const noexcept { return m_mixing_channel; }
+		[[nodiscard]] bool isPlayingLocked() const noexcept { return m_state == AudioPlayerState::playing; }
+		// Adds frame_count frames to a stereo float buffer
+		void mixLocked(float* output, uint32_t frame_count, uint32_t output_sample_rate);
+
+	private:
+		static constexpr uint32_t fft_sample_count = 512;
+		static constexpr uint32_t stream_window_frame_count = 4096;
+
+		bool setFormat(uint16_t sample_size, uint16_t channel_count, uint32_t sample_rate, uint32_t frame_count);
+		// Returns up to max_count contiguous s16 frames starting at frame, nullptr past the end
+		int16_t const* getFrames(uint32_t frame, uint32_t max_count, uint32_t* output_count);
+		uint32_t getEndFrame() const noexcept;
+		void recordFFT(float const* frames, uint32_t frame_count);
+
+		SmartReference<AudioEngineSoftware> m_parent;
+		SmartReference<IAudioSample> m_sample;
+		SmartReference<IAudioDecoder> m_decoder;
+		AudioMixingChannel m_mixing_channel{ AudioMixingChannel::direct };
+		AudioPlayerState m_state{ AudioPlayerState::stopped };
+		float m_volume{ 1.0f };
+		float m_output_balance{ 0.0f };
+		float m_speed{ 1.0f };
+
+		// source
+
+		uint32_t m_sample_rate{};
+		uint32_t m_total_frame{};
+		uint16_t m_channel_count{};
+		double m_position{}; // in source frames
+
+		// loop
+
+		bool m_loop{};
+		uint32_t m_loop_start{};
+		uint32_t m_loop_end{};
+
+		// stream
+
+		std::vector<int16_t> m_stream_window;
+		uint32_t m_stream_window_start{};
+		uint32_t m_stream_window_frames{};
+		uint32_t m_decoder_frame{};
+
+		// mixing scratch
+
+		std::vector<float> m_scratch;
+
+		// fft
+
+		std::array<float, fft_sample_count> m_fft_history{};
+		uint32_t m_fft_history_index{};
+		std::vector<float> m_fft_input;
+		std::vector<float> m_fft_window;
+		std::vector<float> m_fft_data;
+		std::vector<float> m_fft_complex_result;
+		std::vector<float> m_fft_result;
+	};
+}
@@ -242,6 +242,33 @@ namespace core {
 		}
 		return true;
 	}
+	bool AudioPlayerXAudio2::create(AudioEngineXAudio2* const parent, AudioMixingChannel const mixing_channel, IAudioSample* const sample) {
+		std::scoped_lock lock(m_voice_mutex);
+		m_parent = parent;
+		m_mixing_channel = mixing_channel;
+		m_sample = sample;
+
+		m_total_frame = sample->getFrameCount();
+		m_sample_rate = sample->getSampleRate();
+		m_frame_size = sample->getFrameSize();
+		m_total_seconds = static_cast<double>(m_total_frame) / static_cast<double>(m_sample_rate);
+
+		m_format.wFormatTag = WAVE_FORMAT_PCM;
+		m_format.nChannels = sample->getChannelCount();
+		m_format.nSamplesPerSec = sample->getSampleRate();
+		m_format.nAvgBytesPerSec = sample->getByteRate();
+		m_format.nBlockAlign = sample->getFrameSize();
+		m_format.wBitsPerSample = static_cast<WORD>(sample->getSampleSize() * 8);
+
+		m_frames_read = m_total_frame;
+		m_decode_failed.store(false, std::memory_order_release);
+		m_decode_ready.store(true, std::memory_order_release);
+		m_async_decode = false;
+
+		std::ignore = create();
+		m_parent->addEventListener(this);
+		return true;
+	}
 	void AudioPlayerXAudio2::destroy() {
 		std::scoped_lock lock(m_voice_mutex);
 		if (m_voice != nullptr) {
@@ -263,8 +290,14 @@ namespace core {
 
 		XAUDIO2_BUFFER buffer{};
 		buffer.Flags = XAUDIO2_END_OF_STREAM;
-		buffer.AudioBytes = static_cast<uint32_t>(m_pcm_data.size());
-		buffer.pAudioData = m_pcm_data.data();
+		if (m_sample) {
+			buffer.AudioBytes = m_sample->getDataSize();
+			buffer.pAudioData = static_cast<BYTE const*>(m_sample->getData());
+		}
+		else {
+			buffer.AudioBytes = static_cast<uint32_t>(m_pcm_data.size());
+			buffer.pAudioData = m_pcm_data.data();
+		}
 
 		auto const start_sample = static_cast<uint32_t>(static_cast<double>(m_sample_rate) * m_start_time);
 		buffer.PlayBegin = start_sample;
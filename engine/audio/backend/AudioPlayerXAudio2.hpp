@@ -1,5 +1,6 @@
 #pragma once
 #include "core/AudioPlayer.hpp"
+#include "core/AudioSample.hpp"
 #include "core/SmartReference.hpp"
 #include "core/implement/ReferenceCounted.hpp"
 #include "backend/CommonAudioPlayerXAudio2.hpp"
@@ -59,6 +60,7 @@ namespace core {
 
 		bool create();
 		bool create(AudioEngineXAudio2* parent, AudioMixingChannel mixing_channel, IAudioDecoder* decoder);
+		bool create(AudioEngineXAudio2* parent, AudioMixingChannel mixing_channel, IAudioSample* sample);
 		void destroy();
 		bool submitBuffer();
 
@@ -71,6 +73,7 @@ namespace core {
 		std::mutex m_voice_mutex;
 		SmartReference<AudioEngineXAudio2> m_parent;
 		SmartReference<IAudioDecoder> m_decoder;
+		SmartReference<IAudioSample> m_sample; // shared pcm data, m_pcm_data is unused if present
 		std::thread m_decode_thread;
 		IXAudio2SourceVoice* m_voice{};
 		WAVEFORMATEX m_format{};
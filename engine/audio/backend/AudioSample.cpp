@@ -0,0 +1,44 @@
+#include "backend/AudioSample.hpp"
+#include "core/SmartReference.hpp"
+#include "core/Logger.hpp"
+
+namespace core {
+	bool AudioSample::decode(IAudioDecoder* const decoder) {
+		if (decoder == nullptr) {
+			return false;
+		}
+		m_sample_size = decoder->getSampleSize();
+		m_channel_count = decoder->getChannelCount();
+		m_frame_size = decoder->getFrameSize();
+		m_sample_rate = decoder->getSampleRate();
+
+		if (!decoder->seek(0)) {
+			return false;
+		}
+		m_data.resize(static_cast<size_t>(decoder->getFrameCount()) * m_frame_size);
+		uint32_t frames_read = 0;
+		if (!decoder->read(decoder->getFrameCount(), m_data.data(), &frames_read)) {
+			return false;
+		}
+		m_frame_count = frames_read;
+		m_data.resize(static_cast<size_t>(frames_read) * m_frame_size);
+		m_data.shrink_to_fit();
+		return true;
+	}
+
+	bool IAudioSample::create(IAudioDecoder* const decoder, IAudioSample** const output_sample) {
+		try {
+			SmartReference<AudioSample> sample;
+			sample.attach(new AudioSample);
+			if (!sample->decode(decoder)) {
+				return false;
+			}
+			*output_sample = sample.detach();
+			return true;
+		}
+		catch (std::exception const& e) {
+			Logger::error("[core] create AudioSample failed: {}", e.what());
+			return false;
+		}
+	}
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include "core/AudioSample.hpp"
+#include "core/implement/WeakReferenceSource.hpp"
+#include <vector>
+
+namespace core {
+	class AudioSample final : public implement::WeakReferenceSource<IAudioSample> {
+	public:
+		// IAudioSample
+
+		[[nodiscard]] uint16_t getSampleSize() const noexcept override { return m_sample_size; }
+		[[nodiscard]] uint16_t getChannelCount() const noexcept override { return m_channel_count; }
+		[[nodiscard]] uint16_t getFrameSize() const noexcept override { return m_frame_size; }
+		[[nodiscard]] uint32_t getSampleRate() const noexcept override { return m_sample_rate; }
+		[[nodiscard]] uint32_t getByteRate() const noexcept override { return m_sample_rate * m_frame_size; }
+		[[nodiscard]] uint32_t getFrameCount() const noexcept override { return m_frame_count; }
+
+		[[nodiscard]] void const* getData() const noexcept override { return m_data.data(); }
+		[[nodiscard]] uint32_t getDataSize() const noexcept override { return static_cast<uint32_t>(m_data.size()); }
+
+		// AudioSample
+
+		AudioSample() = default;
+		AudioSample(AudioSample const&) = delete;
+		AudioSample(AudioSample&&) = delete;
+		~AudioSample() override = default;
+
+		AudioSample& operator=(AudioSample const&) = delete;
+		AudioSample& operator=(AudioSample&&) = delete;
+
+		bool decode(IAudioDecoder* decoder);
+
+	private:
+		std::vector<uint8_t> m_data;
+		uint32_t m_sample_rate{};
+		uint32_t m_frame_count{};
+		uint16_t m_sample_size{};
+		uint16_t m_channel_count{};
+		uint16_t m_frame_size{};
+	};
+}
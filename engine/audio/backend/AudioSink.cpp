@@ -0,0 +1,128 @@
+#include "backend/AudioSink.hpp"
+#include "backend/AudioMixerKernels.hpp"
+#include "core/SmartReference.hpp"
+#include "core/Logger.hpp"
+#include <filesystem>
+#include <limits>
+
+using std::string_view_literals::operator ""sv;
+
+namespace {
+	template<typename T>
+	void writeLittleEndian(std::ofstream& file, T const value) {
+		uint8_t bytes[sizeof(T)]{};
+		for (size_t i = 0; i < sizeof(T); i += 1) {
+			bytes[i] = static_cast<uint8_t>((static_cast<uint64_t>(value) >> (i * 8)) & 0xff);
+		}
+		file.write(reinterpret_cast<char const*>(bytes), sizeof(T));
+	}
+}
+
+namespace core {
+	// NullAudioSink
+
+	std::string_view NullAudioSink::getName() const noexcept { return "null"sv; }
+	bool NullAudioSink::open(uint32_t const, uint16_t const) { return true; }
+	void NullAudioSink::write(float const* const, uint32_t const) {}
+	void NullAudioSink::close() {}
+
+	// WaveFileAudioSink
+
+	std::string_view WaveFileAudioSink::getName() const noexcept { return "wave_file"sv; }
+	bool WaveFileAudioSink::open(uint32_t const sample_rate, uint16_t const channel_count) {
+		close();
+		std::filesystem::path const path(std::u8string_view(reinterpret_cast<char8_t const*>(m_path.data()), m_path.size()));
+		m_file.open(path, std::ios::out | std::ios::trunc | std::ios::binary);
+		if (!m_file.is_open()) {
+			Logger::error("[core] WaveFileAudioSink: cannot open '{}'", m_path);
+			return false;
+		}
+		m_sample_rate = sample_rate;
+		m_channel_count = channel_count;
+		m_data_size = 0;
+		writeHeader();
+		return m_file.good();
+	}
+	void WaveFileAudioSink::write(float const* const samples, uint32_t const frame_count) {
+		if (!m_file.is_open()) {
+			return;
+		}
+		auto const sample_count = static_cast<size_t>(frame_count) * m_channel_count;
+		m_buffer.resize(sample_count);
+		audio_mixer::convertFloatToS16(m_buffer.data(), samples, sample_count);
+		m_file.write(reinterpret_cast<char const*>(m_buffer.data()), static_cast<std::streamsize>(sample_count * sizeof(int16_t)));
+		m_data_size += sample_count * sizeof(int16_t);
+	}
+	void WaveFileAudioSink::close() {
+		if (!m_file.is_open()) {
+			return;
+		}
+		// sizes are only known now
+		m_file.seekp(0);
+		writeHeader();
+		m_file.close();
+	}
+
+	WaveFileAudioSink::WaveFileAudioSink(std::string_view const path) : m_path(path) {}
+	WaveFileAudioSink::~WaveFileAudioSink() {
+		close();
+	}
+
+	void WaveFileAudioSink::writeHeader() {
+		constexpr uint16_t bits_per_sample = 16;
+		auto const block_align = static_cast<uint16_t>(m_channel_count * (bits_per_sample / 8));
+		// RIFF sizes are 32-bit, a longer recording is truncated in the header
+		auto const data_size = static_cast<uint32_t>(std::min<uint64_t>(m_data_size, std::numeric_limits<uint32_t>::max() - 36u));
+		m_file.write("RIFF", 4);
+		writeLittleEndian<uint32_t>(m_file, 36u + data_size);
+		m_file.write("WAVE", 4);
+		m_file.write("fmt ", 4);
+		writeLittleEndian<uint32_t>(m_file, 16u);
+		writeLittleEndian<uint16_t>(m_file, 1u); // PCM
+		writeLittleEndian<uint16_t>(m_file, m_channel_count);
+		writeLittleEndian<uint32_t>(m_file, m_sample_rate);
+		writeLittleEndian<uint32_t>(m_file, m_sample_rate * block_align);
+		writeLittleEndian<uint16_t>(m_file, block_align);
+		writeLittleEndian<uint16_t>(m_file, bits_per_sample);
+		m_file.write("data", 4);
+		writeLittleEndian<uint32_t>(m_file, data_size);
+	}
+
+	// CallbackAudioSink
+
+	std::string_view CallbackAudioSink::getName() const noexcept { return "callback"sv; }
+	bool CallbackAudioSink::open(uint32_t const, uint16_t const channel_count) {
+		m_channel_count = channel_count;
+		return static_cast<bool>(m_callback);
+	}
+	void CallbackAudioSink::write(float const* const samples, uint32_t const frame_count) {
+		m_callback(samples, frame_count, m_channel_count);
+	}
+	void CallbackAudioSink::close() {}
+
+	CallbackAudioSink::CallbackAudioSink(AudioSinkCallback callback) : m_callback(std::move(callback)) {}
+
+	// IAudioSink
+
+	bool IAudioSink::createNull(IAudioSink** const output_sink) {
+		SmartReference<NullAudioSink> sink;
+		sink.attach(new NullAudioSink);
+		*output_sink = sink.detach();
+		return true;
+	}
+	bool IAudioSink::createWaveFile(std::string_view const path, IAudioSink** const output_sink) {
+		SmartReference<WaveFileAudioSink> sink;
+		sink.attach(new WaveFileAudioSink(path));
+		*output_sink = sink.detach();
+		return true;
+	}
+	bool IAudioSink::createCallback(AudioSinkCallback callback, IAudioSink** const output_sink) {
+		if (!callback) {
+			return false;
+		}
+		SmartReference<CallbackAudioSink> sink;
+		sink.attach(new CallbackAudioSink(std::move(callback)));
+		*output_sink = sink.detach();
+		return true;
+	}
+}
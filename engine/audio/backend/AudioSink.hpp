@@ -0,0 +1,66 @@
+#pragma once
+#include "core/AudioSink.hpp"
+#include "core/implement/ReferenceCounted.hpp"
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace core {
+	class NullAudioSink final : public implement::ReferenceCounted<IAudioSink> {
+	public:
+		// IAudioSink
+
+		[[nodiscard]] std::string_view getName() const noexcept override;
+		[[nodiscard]] bool open(uint32_t sample_rate, uint16_t channel_count) override;
+		void write(float const* samples, uint32_t frame_count) override;
+		void close() override;
+	};
+
+	class WaveFileAudioSink final : public implement::ReferenceCounted<IAudioSink> {
+	public:
+		// IAudioSink
+
+		[[nodiscard]] std::string_view getName() const noexcept override;
+		[[nodiscard]] bool open(uint32_t sample_rate, uint16_t channel_count) override;
+		void write(float const* samples, uint32_t frame_count) override;
+		void close() override;
+
+		// WaveFileAudioSink
+
+		explicit WaveFileAudioSink(std::string_view path);
+		WaveFileAudioSink(WaveFileAudioSink const&) = delete;
+		WaveFileAudioSink(WaveFileAudioSink&&) = delete;
+		~WaveFileAudioSink() override;
+
+		WaveFileAudioSink& operator=(WaveFileAudioSink const&) = delete;
+		WaveFileAudioSink& operator=(WaveFileAudioSink&&) = delete;
+
+	private:
+		void writeHeader();
+
+		std::string m_path;
+		std::ofstream m_file;
+		std::vector<int16_t> m_buffer;
+		uint64_t m_data_size{};
+		uint32_t m_sample_rate{};
+		uint16_t m_channel_count{};
+	};
+
+	class CallbackAudioSink final : public implement::ReferenceCounted<IAudioSink> {
+	public:
+		// IAudioSink
+
+		[[nodiscard]] std::string_view getName() const noexcept override;
+		[[nodiscard]] bool open(uint32_t sample_rate, uint16_t channel_count) override;
+		void write(float const* samples, uint32_t frame_count) override;
+		void close() override;
+
+		// CallbackAudioSink
+
+		explicit CallbackAudioSink(AudioSinkCallback callback);
+
+	private:
+		AudioSinkCallback m_callback;
+		uint16_t m_channel_count{};
+	};
+}
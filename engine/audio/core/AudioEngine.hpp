@@ -2,6 +2,7 @@
 #include "core/ReferenceCounted.hpp"
 #include "core/AudioDecoder.hpp"
 #include "core/AudioPlayer.hpp"
+#include "core/AudioSample.hpp"
 
 namespace core {
 	enum class AudioMixingChannel : uint8_t {
@@ -35,6 +36,7 @@ namespace core {
 		[[nodiscard]] virtual float getMixingChannelVolume(AudioMixingChannel channel) const noexcept = 0;
 
 		[[nodiscard]] virtual bool createAudioPlayer(IAudioDecoder* decoder, AudioMixingChannel channel, IAudioPlayer** output_player) = 0;
+		[[nodiscard]] virtual bool createAudioPlayer(IAudioSample* sample, AudioMixingChannel channel, IAudioPlayer** output_player) = 0;
 		[[nodiscard]] virtual bool createStreamAudioPlayer(IAudioDecoder* decoder, AudioMixingChannel channel, IAudioPlayer** output_player) = 0;
 
 		[[nodiscard]] static bool create(IAudioEngine** output_endpoint);
@@ -0,0 +1,26 @@
+#pragma once
+#include "core/WeakReferenceSource.hpp"
+#include "core/AudioDecoder.hpp"
+
+namespace core {
+	// Fully decoded, immutable s16 PCM data, can be shared by any number of audio players
+	// and cached through weak references
+	struct CORE_NO_VIRTUAL_TABLE IAudioSample : IWeakReferenceSource {
+		[[nodiscard]] virtual uint16_t getSampleSize() const noexcept = 0;
+		[[nodiscard]] virtual uint16_t getChannelCount() const noexcept = 0;
+		[[nodiscard]] virtual uint16_t getFrameSize() const noexcept = 0;
+		[[nodiscard]] virtual uint32_t getSampleRate() const noexcept = 0;
+		[[nodiscard]] virtual uint32_t getByteRate() const noexcept = 0;
+		[[nodiscard]] virtual uint32_t getFrameCount() const noexcept = 0;
+
+		[[nodiscard]] virtual void const* getData() const noexcept = 0;
+		[[nodiscard]] virtual uint32_t getDataSize() const noexcept = 0;
+
+		[[nodiscard]] static bool create(IAudioDecoder* decoder, IAudioSample** output_sample);
+	};
+
+	// UUID v5
+	// ns:URL
+	// https://www.luastg-sub.com/core.IAudioSample
+	template<> constexpr InterfaceId getInterfaceId<IAudioSample>() { return UUID::parse("34a23abc-6a0a-5955-b01a-20fe538245d1"); }
+}
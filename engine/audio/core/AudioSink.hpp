@@ -0,0 +1,27 @@
+#pragma once
+#include "core/ReferenceCounted.hpp"
+#include <functional>
+#include <string_view>
+
+namespace core {
+	using AudioSinkCallback = std::function<void(float const* samples, uint32_t frame_count, uint16_t channel_count)>;
+
+	// Receives the final mix of a software audio engine, samples are interleaved float in [-1.0, 1.0]
+	struct CORE_NO_VIRTUAL_TABLE IAudioSink : IReferenceCounted {
+		[[nodiscard]] virtual std::string_view getName() const noexcept = 0;
+		[[nodiscard]] virtual bool open(uint32_t sample_rate, uint16_t channel_count) = 0;
+		virtual void write(float const* samples, uint32_t frame_count) = 0;
+		virtual void close() = 0;
+
+		// Discards everything
+		[[nodiscard]] static bool createNull(IAudioSink** output_sink);
+		// Writes 16-bit PCM wave file
+		[[nodiscard]] static bool createWaveFile(std::string_view path, IAudioSink** output_sink);
+		[[nodiscard]] static bool createCallback(AudioSinkCallback callback, IAudioSink** output_sink);
+	};
+
+	// UUID v5
+	// ns:URL
+	// https://www.luastg-sub.com/core.IAudioSink
+	template<> constexpr InterfaceId getInterfaceId<IAudioSink>() { return UUID::parse("a0169027-b3b2-54ac-acd3-5aa0355cbfdb"); }
+}
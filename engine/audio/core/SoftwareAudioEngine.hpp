@@ -0,0 +1,24 @@
+#pragma once
+#include "core/AudioEngine.hpp"
+#include "core/AudioSink.hpp"
+
+namespace core {
+	// Portable audio engine, mixes on the CPU and pushes the result to an IAudioSink.
+	// Nothing is rendered unless render is called, which makes it usable for headless runs and benchmarks.
+	struct CORE_NO_VIRTUAL_TABLE ISoftwareAudioEngine : IAudioEngine {
+		[[nodiscard]] virtual uint32_t getSampleRate() const noexcept = 0;
+		[[nodiscard]] virtual uint16_t getChannelCount() const noexcept = 0; // always 2
+		[[nodiscard]] virtual uint64_t getRenderedFrameCount() const noexcept = 0;
+		[[nodiscard]] virtual uint32_t getPlayingPlayerCount() const noexcept = 0;
+
+		// Mixes frame_count frames of all playing players and writes them to the sink, thread safe
+		virtual void render(uint32_t frame_count) = 0;
+
+		[[nodiscard]] static bool create(IAudioSink* sink, uint32_t sample_rate, ISoftwareAudioEngine** output_engine);
+	};
+
+	// UUID v5
+	// ns:URL
+	// https://www.luastg-sub.com/core.ISoftwareAudioEngine
+	template<> constexpr InterfaceId getInterfaceId<ISoftwareAudioEngine>() { return UUID::parse("c1303bad-4558-53b9-8ba2-aaa48b8263c5"); }
+}
@@ -0,0 +1,244 @@
+#include "core/Logger.hpp"
+#include "core/SmartReference.hpp"
+#include "core/SoftwareAudioEngine.hpp"
+#include "core/implement/ReferenceCounted.hpp"
+#include "spdlog/spdlog.h"
+#include "spdlog/sinks/stdout_color_sinks.h"
+#include "gtest/gtest.h"
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace {
+    using std::string_literals::operator ""s;
+
+    void setupLogger() {
+        if (!spdlog::get("test"s)) {
+            spdlog::set_default_logger(spdlog::stdout_color_mt("test"s));
+        }
+    }
+
+    // Generated s16 PCM, frame i of channel c is values[(i * channels + c) % values.size()]
+    class TestAudioDecoder final : public core::implement::ReferenceCounted<core::IAudioDecoder> {
+    public:
+        uint16_t getSampleSize() const noexcept override { return 2; }
+        uint16_t getChannelCount() const noexcept override { return m_channels; }
+        uint16_t getFrameSize() const noexcept override { return static_cast<uint16_t>(m_channels * 2); }
+        uint32_t getSampleRate() const noexcept override { return m_sample_rate; }
+        uint32_t getByteRate() const noexcept override { return m_sample_rate * getFrameSize(); }
+        uint32_t getFrameCount() const noexcept override { return m_frame_count; }
+
+        bool seek(uint32_t const pcm_frame) override {
+            m_frame = std::min(pcm_frame, m_frame_count);
+            return true;
+        }
+        bool seekByTime(double const sec) override { return seek(static_cast<uint32_t>(sec * m_sample_rate)); }
+        bool tell(uint32_t* const pcm_frame) override { *pcm_frame = m_frame; return true; }
+        bool tellAsTime(double* const sec) override { *sec = static_cast<double>(m_frame) / m_sample_rate; return true; }
+        bool read(uint32_t const pcm_frame, void* const buffer, uint32_t* const read_pcm_frame) override {
+            auto const count = std::min(pcm_frame, m_frame_count - m_frame);
+            auto* const output = static_cast<int16_t*>(buffer);
+            for (uint32_t i = 0; i < count * m_channels; i += 1) {
+                output[i] = m_values[(m_frame * m_channels + i) % m_values.size()];
+            }
+            m_frame += count;
+            *read_pcm_frame = count;
+            return true;
+        }
+
+        TestAudioDecoder(uint16_t const channels, uint32_t const sample_rate, uint32_t const frame_count, std::vector<int16_t> values)
+            : m_values(std::move(values)), m_sample_rate(sample_rate), m_frame_count(frame_count), m_channels(channels) {}
+
+    private:
+        std::vector<int16_t> m_values;
+        uint32_t m_sample_rate{};
+        uint32_t m_frame_count{};
+        uint32_t m_frame{};
+        uint16_t m_channels{};
+    };
+
+    core::SmartReference<core::IAudioSample> createSample(uint16_t const channels, uint32_t const sample_rate, uint32_t const frame_count, std::vector<int16_t> values) {
+        core::SmartReference<core::IAudioDecoder> decoder;
+        decoder.attach(new TestAudioDecoder(channels, sample_rate, frame_count, std::move(values)));
+        core::SmartReference<core::IAudioSample> sample;
+        EXPECT_TRUE(core::IAudioSample::create(decoder.get(), sample.put()));
+        return sample;
+    }
+
+    struct CapturedOutput {
+        std::vector<float> samples;
+
+        core::SmartReference<core::ISoftwareAudioEngine> createEngine(uint32_t const sample_rate = 48000) {
+            core::SmartReference<core::IAudioSink> sink;
+            EXPECT_TRUE(core::IAudioSink::createCallback([this](float const* const data, uint32_t const frame_count, uint16_t const channel_count) {
+                samples.insert(samples.end(), data, data + static_cast<size_t>(frame_count) * channel_count);
+            }, sink.put()));
+            core::SmartReference<core::ISoftwareAudioEngine> engine;
+            EXPECT_TRUE(core::ISoftwareAudioEngine::create(sink.get(), sample_rate, engine.put()));
+            return engine;
+        }
+    };
+}
+
+TEST(SoftwareAudioEngine, silence) {
+    setupLogger();
+    CapturedOutput output;
+    auto const engine = output.createEngine();
+    engine->render(4000);
+    ASSERT_EQ(output.samples.size(), 8000u);
+    EXPECT_EQ(engine->getRenderedFrameCount(), 4000u);
+    for (auto const v : output.samples) {
+        EXPECT_EQ(v, 0.0f);
+    }
+}
+
+TEST(SoftwareAudioEngine, volumeAndBalance) {
+    setupLogger();
+    CapturedOutput output;
+    auto const engine = output.createEngine();
+    engine->setVolume(1.0f);
+    engine->setMixingChannelVolume(core::AudioMixingChannel::sound_effect, 0.5f);
+    auto const sample = createSample(1, 48000, 1000, { 16384 }); // 0.5
+
+    core::SmartReference<core::IAudioPlayer> player;
+    ASSERT_TRUE(engine->createAudioPlayer(sample.get(), core::AudioMixingChannel::sound_effect, player.put()));
+    ASSERT_TRUE(player->setVolume(1.0f));
+    ASSERT_TRUE(player->setBalance(-1.0f));
+    ASSERT_TRUE(player->play(0.0));
+    engine->render(100);
+    ASSERT_EQ(output.samples.size(), 200u);
+    // 0.5 sample * 1.0 left gain * 0.5 channel volume
+    EXPECT_FLOAT_EQ(output.samples[0], 0.25f);
+    EXPECT_FLOAT_EQ(output.samples[1], 0.0f);
+
+    output.samples.clear();
+    ASSERT_TRUE(player->setBalance(0.0f));
+    engine->render(100);
+    EXPECT_FLOAT_EQ(output.samples[0], 0.125f);
+    EXPECT_FLOAT_EQ(output.samples[1], 0.125f);
+}
+
+TEST(SoftwareAudioEngine, endAndLoop) {
+    setupLogger();
+    CapturedOutput output;
+    auto const engine = output.createEngine();
+    auto const sample = createSample(2, 48000, 100, { 1000, -1000 });
+
+    core::SmartReference<core::IAudioPlayer> player;
+    ASSERT_TRUE(engine->createAudioPlayer(sample.get(), core::AudioMixingChannel::direct, player.put()));
+    ASSERT_TRUE(player->play(0.0));
+    engine->render(150);
+    EXPECT_EQ(player->getState(), core::AudioPlayerState::stopped);
+    EXPECT_NE(output.samples[99 * 2], 0.0f);
+    EXPECT_EQ(output.samples[100 * 2], 0.0f);
+
+    ASSERT_TRUE(player->setLoop(true, 0.0, 0.0));
+    ASSERT_TRUE(player->play(0.0));
+    engine->render(1000);
+    EXPECT_EQ(player->getState(), core::AudioPlayerState::playing);
+    EXPECT_EQ(engine->getPlayingPlayerCount(), 1u);
+}
+
+TEST(SoftwareAudioEngine, speedAndResampling) {
+    setupLogger();
+    CapturedOutput output;
+    auto const engine = output.createEngine(48000);
+    // 24kHz source at 1.5x speed on a 48kHz output advances 0.75 source frames per output frame,
+    // so 1000 source frames last 1334 output frames
+    auto const sample = createSample(1, 24000, 1000, { 0, 2000, 4000, 6000 });
+
+    core::SmartReference<core::IAudioPlayer> player;
+    ASSERT_TRUE(engine->createAudioPlayer(sample.get(), core::AudioMixingChannel::direct, player.put()));
+    ASSERT_TRUE(player->setSpeed(1.5f));
+    ASSERT_TRUE(player->play(0.0));
+    engine->render(1334);
+    EXPECT_EQ(player->getState(), core::AudioPlayerState::playing);
+    engine->render(1);
+    EXPECT_EQ(player->getState(), core::AudioPlayerState::stopped);
+
+    // half speed interpolates between source frames
+    output.samples.clear();
+    ASSERT_TRUE(player->setSpeed(1.0f));
+    ASSERT_TRUE(player->play(0.0));
+    engine->render(2);
+    EXPECT_FLOAT_EQ(output.samples[0], 0.0f);
+    EXPECT_FLOAT_EQ(output.samples[2], 1000.0f / 32768.0f * 0.5f);
+}
+
+TEST(SoftwareAudioEngine, streamMatchesSample) {
+    setupLogger();
+    std::vector<int16_t> values;
+    for (int i = 0; i < 997; i += 1) {
+        values.push_back(static_cast<int16_t>(std::sin(i * 0.05) * 20000.0));
+    }
+    auto const frame_count = 20000u; // several stream windows
+
+    CapturedOutput a;
+    auto const engine_a = a.createEngine();
+    auto const sample = createSample(1, 44100, frame_count, values);
+    core::SmartReference<core::IAudioPlayer> player_a;
+    ASSERT_TRUE(engine_a->createAudioPlayer(sample.get(), core::AudioMixingChannel::music, player_a.put()));
+
+    CapturedOutput b;
+    auto const engine_b = b.createEngine();
+    core::SmartReference<core::IAudioDecoder> decoder;
+    decoder.attach(new TestAudioDecoder(1, 44100, frame_count, values));
+    core::SmartReference<core::IAudioPlayer> player_b;
+    ASSERT_TRUE(engine_b->createStreamAudioPlayer(decoder.get(), core::AudioMixingChannel::music, player_b.put()));
+
+    for (auto const& player : { player_a, player_b }) {
+        ASSERT_TRUE(player->setSpeed(1.25f));
+        ASSERT_TRUE(player->setLoop(true, 0.1, 0.2));
+        ASSERT_TRUE(player->play(0.0));
+    }
+    engine_a->render(30000);
+    engine_b->render(30000);
+    ASSERT_EQ(a.samples.size(), b.samples.size());
+    for (size_t i = 0; i < a.samples.size(); i += 1) {
+        ASSERT_EQ(a.samples[i], b.samples[i]) << "at " << i;
+    }
+}
+
+TEST(SoftwareAudioEngine, waveFileSink) {
+    setupLogger();
+    auto const path = std::filesystem::temp_directory_path() / "luastg_audio_mixer_test.wav";
+    {
+        core::SmartReference<core::IAudioSink> sink;
+        ASSERT_TRUE(core::IAudioSink::createWaveFile(path.string(), sink.put()));
+        core::SmartReference<core::ISoftwareAudioEngine> engine;
+        ASSERT_TRUE(core::ISoftwareAudioEngine::create(sink.get(), 48000, engine.put()));
+        engine->render(480);
+    }
+    EXPECT_EQ(std::filesystem::file_size(path), 44u + 480u * 2u * 2u);
+    std::filesystem::remove(path);
+}
+
+TEST(SoftwareAudioEngine, benchmark) {
+    setupLogger();
+    core::SmartReference<core::IAudioSink> sink;
+    ASSERT_TRUE(core::IAudioSink::createNull(sink.put()));
+    core::SmartReference<core::ISoftwareAudioEngine> engine;
+    ASSERT_TRUE(core::ISoftwareAudioEngine::create(sink.get(), 48000, engine.put()));
+    auto const sample = createSample(2, 44100, 44100, { 1000, -1000, 2000, -2000 });
+
+    constexpr uint32_t voice_count = 64;
+    constexpr uint32_t frame_count = 48000 * 10;
+    std::vector<core::SmartReference<core::IAudioPlayer>> players(voice_count);
+    for (uint32_t i = 0; i < voice_count; i += 1) {
+        ASSERT_TRUE(engine->createAudioPlayer(sample.get(), core::AudioMixingChannel::sound_effect, players[i].put()));
+        ASSERT_TRUE(players[i]->setLoop(true, 0.0, 0.0));
+        ASSERT_TRUE(players[i]->setSpeed(i % 2 == 0 ? 1.0f : 1.5f)); // half on the resampling path
+        ASSERT_TRUE(players[i]->play(0.0));
+    }
+    auto const t0 = std::chrono::steady_clock::now();
+    engine->render(frame_count);
+    auto const t1 = std::chrono::steady_clock::now();
+    auto const ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+    core::Logger::info("[test] {} voices, {} frames, {:.3f} ns per voice-frame, {:.1f}x realtime",
+        voice_count, frame_count,
+        static_cast<double>(ns) / (static_cast<double>(voice_count) * frame_count),
+        10.0 / (static_cast<double>(ns) / 1e9));
+    EXPECT_EQ(engine->getPlayingPlayerCount(), voice_count);
+}
@@ -44,6 +44,28 @@ namespace core {
 		// ReSharper disable once CppMemberFunctionMayBeStatic
 		[[nodiscard]] constexpr size_t capacity() const noexcept { return N; }
 
+		// 空闲索引栈（栈顶在末尾），保存下来可以让恢复后分配到的索引和原来一致
+		[[nodiscard]] size_t const* freeIndices() const noexcept { return m_free_indices; }
+		[[nodiscard]] size_t freeCount() const noexcept { return m_free_count; }
+
+		// 恢复为指定的空闲索引栈，不在栈中的索引都视为已分配，对象本身的内容保持不变
+		template<typename Index>
+		void restore(Index const* const free_indices, size_t const free_count) noexcept {
+			for (auto& v : m_used) {
+				v = true;
+			}
+			m_free_count = free_count < N ? free_count : N;
+			for (size_t idx = 0; idx < N; idx++) {
+				if (idx < m_free_count) {
+					m_free_indices[idx] = static_cast<size_t>(free_indices[idx]);
+					m_used[m_free_indices[idx]] = false;
+				}
+				else {
+					m_free_indices[idx] = static_cast<size_t>(-1);
+				}
+			}
+		}
+
 		void clear() noexcept {
 			m_free_count = N;
 			for (size_t idx = 0; idx < N; idx++) {
@@ -313,6 +313,36 @@ namespace core {
 						loader.logging.rolling_file.setMaxHistory(u32);
 					}
 				}
+				if (logging.contains("async"sv)) {
+					auto const& async = logging.at("async"sv);
+					assert_type_is_object(async, "/logging/async"sv);
+					if (async.contains("enable"sv)) {
+						auto const& enable = async.at("enable"sv);
+						assert_type_is_boolean(enable, "/logging/async/enable"sv);
+						loader.logging.async.setEnable(enable.get<bool>());
+					}
+					if (async.contains("queue_size"sv)) {
+						auto const& queue_size = async.at("queue_size"sv);
+						assert_type_is_unsigned_integer(queue_size, "/logging/async/queue_size"sv);
+						loader.logging.async.setQueueSize(queue_size.get<uint32_t>());
+					}
+					if (async.contains("overflow_policy"sv)) {
+						auto const& overflow_policy = async.at("overflow_policy"sv);
+						assert_type_is_string(overflow_policy, "/logging/async/overflow_policy"sv);
+						auto const& s = overflow_policy.get_ref<std::string const&>();
+						using OverflowPolicy = ConfigurationLoader::Logging::Async::OverflowPolicy;
+						OverflowPolicy value{ OverflowPolicy::block };
+						if (s == "block"sv) { value = OverflowPolicy::block; }
+						else if (s == "drop"sv) { value = OverflowPolicy::drop; }
+						else { error_callback(std::format("[/logging/async/overflow_policy] unknown overflow policy '{}'"sv, s)); return false; }
+						loader.logging.async.setOverflowPolicy(value);
+					}
+					if (async.contains("flush_interval"sv)) {
+						auto const& flush_interval = async.at("flush_interval"sv);
+						assert_type_is_unsigned_integer(flush_interval, "/logging/async/flush_interval"sv);
+						loader.logging.async.setFlushInterval(flush_interval.get<uint32_t>());
+					}
+				}
 
 			#undef get_level
 			}
@@ -366,6 +396,77 @@ namespace core {
 					assert_type_is_unsigned_integer(frame_rate, "/timing/frame_rate"sv);
 					loader.timing.setFrameRate(frame_rate.get<uint32_t>());
 				}
+				if (timing.contains("frame_pacer"sv)) {
+					auto const& frame_pacer = timing.at("frame_pacer"sv);
+					assert_type_is_string(frame_pacer, "/timing/frame_pacer"sv);
+					auto const& s = frame_pacer.get_ref<std::string const&>();
+					using FramePacer = ConfigurationLoader::Timing::FramePacer;
+					FramePacer value{ FramePacer::automatic };
+					if (s == "auto"sv) { value = FramePacer::automatic; }
+					else if (s == "hybrid"sv) { value = FramePacer::hybrid; }
+					else { error_callback(std::format("[/timing/frame_pacer] unknown frame pacer '{}'"sv, s)); return false; }
+					loader.timing.setFramePacer(value);
+				}
+				if (timing.contains("max_catch_up_frames"sv)) {
+					auto const& max_catch_up_frames = timing.at("max_catch_up_frames"sv);
+					assert_type_is_unsigned_integer(max_catch_up_frames, "/timing/max_catch_up_frames"sv);
+					loader.timing.setMaxCatchUpFrames(max_catch_up_frames.get<uint32_t>());
+				}
+			}
+
+			if (root.contains("script"sv)) {
+				auto const& script = root.at("script"sv);
+				assert_type_is_object(script, "/script"sv);
+				if (script.contains("precompile"sv)) {
+					auto const& precompile = script.at("precompile"sv);
+					assert_type_is_boolean(precompile, "/script/precompile"sv);
+					loader.script.setPrecompile(precompile.get<bool>());
+				}
+				if (script.contains("precompile_worker_count"sv)) {
+					auto const& precompile_worker_count = script.at("precompile_worker_count"sv);
+					assert_type_is_unsigned_integer(precompile_worker_count, "/script/precompile_worker_count"sv);
+					loader.script.setPrecompileWorkerCount(precompile_worker_count.get<uint32_t>());
+				}
+			}
+
+			if (root.contains("simulation"sv)) {
+				auto const& simulation = root.at("simulation"sv);
+				assert_type_is_object(simulation, "/simulation"sv);
+				if (simulation.contains("headless"sv)) {
+					auto const& headless = simulation.at("headless"sv);
+					assert_type_is_boolean(headless, "/simulation/headless"sv);
+					loader.simulation.setHeadless(headless.get<bool>());
+				}
+				if (simulation.contains("frame_limit"sv)) {
+					auto const& frame_limit = simulation.at("frame_limit"sv);
+					assert_type_is_unsigned_integer(frame_limit, "/simulation/frame_limit"sv);
+					loader.simulation.setFrameLimit(frame_limit.get<uint64_t>());
+				}
+				if (simulation.contains("digest_path"sv)) {
+					auto const& digest_path = simulation.at("digest_path"sv);
+					assert_type_is_string(digest_path, "/simulation/digest_path"sv);
+					loader.simulation.setDigestPath(digest_path.get_ref<std::string const&>());
+				}
+				if (simulation.contains("input_record_path"sv)) {
+					auto const& input_record_path = simulation.at("input_record_path"sv);
+					assert_type_is_string(input_record_path, "/simulation/input_record_path"sv);
+					loader.simulation.setInputRecordPath(input_record_path.get_ref<std::string const&>());
+				}
+				if (simulation.contains("input_replay_path"sv)) {
+					auto const& input_replay_path = simulation.at("input_replay_path"sv);
+					assert_type_is_string(input_replay_path, "/simulation/input_replay_path"sv);
+					loader.simulation.setInputReplayPath(input_replay_path.get_ref<std::string const&>());
+				}
+			}
+
+			if (root.contains("resource_system"sv)) {
+				auto const& resource_system = root.at("resource_system"sv);
+				assert_type_is_object(resource_system, "/resource_system"sv);
+				if (resource_system.contains("async_worker_count"sv)) {
+					auto const& async_worker_count = resource_system.at("async_worker_count"sv);
+					assert_type_is_unsigned_integer(async_worker_count, "/resource_system/async_worker_count"sv);
+					loader.resource_system.setAsyncWorkerCount(async_worker_count.get<uint32_t>());
+				}
 			}
 
 			if (root.contains("window"sv)) {
@@ -451,6 +552,11 @@ namespace core {
 					assert_type_is_boolean(allow_direct_composition, "/graphics_system/allow_direct_composition"sv);
 					loader.graphics_system.setAllowDirectComposition(allow_direct_composition.get<bool>());
 				}
+				if (graphics_system.contains("pipelined_rendering"sv)) {
+					auto const& pipelined_rendering = graphics_system.at("pipelined_rendering"sv);
+					assert_type_is_boolean(pipelined_rendering, "/graphics_system/pipelined_rendering"sv);
+					loader.graphics_system.setPipelinedRendering(pipelined_rendering.get<bool>());
+				}
 				// TODO: display
 			}
 
@@ -482,6 +588,16 @@ namespace core {
 					}
 					loader.audio_system.setMusicVolume(v);
 				}
+				if (audio_system.contains("sound_effect_voice_limit"sv)) {
+					auto const& sound_effect_voice_limit = audio_system.at("sound_effect_voice_limit"sv);
+					assert_type_is_unsigned_integer(sound_effect_voice_limit, "/audio_system/sound_effect_voice_limit"sv);
+					auto const v = sound_effect_voice_limit.get<uint32_t>();
+					if (v == 0) {
+						error_callback("[/audio_system/sound_effect_voice_limit] must be greater than 0"sv);
+						return false;
+					}
+					loader.audio_system.setSoundEffectVoiceLimit(v);
+				}
 			}
 
 			// compatibility
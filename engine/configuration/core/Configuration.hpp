@@ -76,16 +76,35 @@ namespace core {
 			private:
 				uint32_t max_history{ 10 };
 			};
+			class Async {
+			public:
+				enum class OverflowPolicy {
+					block,
+					drop,
+				};
+			public:
+				GetterSetterBoolean(Async, enable, Enable);
+				GetterSetterPrimitive(Async, uint32_t, queue_size, QueueSize);
+				GetterSetterPrimitive(Async, OverflowPolicy, overflow_policy, OverflowPolicy);
+				GetterSetterPrimitive(Async, uint32_t, flush_interval, FlushInterval);
+			private:
+				bool enable{ false }; // write log files on a background thread instead of the calling thread
+				uint32_t queue_size{ 8192 }; // rounded up to a power of two
+				OverflowPolicy overflow_policy{ OverflowPolicy::block }; // drop: discard messages when the queue is full and report the count later
+				uint32_t flush_interval{ 1000 }; // milliseconds, warn and above are flushed immediately
+			};
 		public:
 			inline Debugger const& getDebugger() const noexcept { return debugger; }
 			inline Console const& getConsole() const noexcept { return console; }
 			inline File const& getFile() const noexcept { return file; }
 			inline RollingFile const& getRollingFile() const noexcept { return rolling_file; }
+			inline Async const& getAsync() const noexcept { return async; }
 		private:
 			Debugger debugger;
 			Console console;
 			File file;
 			RollingFile rolling_file;
+			Async async;
 		};
 		class FileSystem {
 			friend class ConfigurationLoader;
@@ -114,10 +133,47 @@ namespace core {
 			std::string user;
 		};
 		class Timing {
+		public:
+			enum class FramePacer {
+				automatic,
+				hybrid,
+			};
 		public:
 			GetterSetterPrimitive(Timing, uint32_t, frame_rate, FrameRate);
+			GetterSetterPrimitive(Timing, FramePacer, frame_pacer, FramePacer);
+			GetterSetterPrimitive(Timing, uint32_t, max_catch_up_frames, MaxCatchUpFrames);
 		private:
 			uint32_t frame_rate{ 60 };
+			FramePacer frame_pacer{ FramePacer::automatic }; // hybrid: portable sleep-then-spin pacer with adaptive spin margin
+			uint32_t max_catch_up_frames{}; // hybrid pacer only, 0 means drop late frames instead of catching up
+		};
+		class Script {
+		public:
+			GetterSetterBoolean(Script, precompile, Precompile);
+			GetterSetterPrimitive(Script, uint32_t, precompile_worker_count, PrecompileWorkerCount);
+		private:
+			bool precompile{ true };
+			uint32_t precompile_worker_count{}; // 0 means hardware concurrency
+		};
+		class Simulation {
+		public:
+			GetterSetterBoolean(Simulation, headless, Headless);
+			GetterSetterPrimitive(Simulation, uint64_t, frame_limit, FrameLimit);
+			GetterSetterString(Simulation, digest_path, DigestPath);
+			GetterSetterString(Simulation, input_record_path, InputRecordPath);
+			GetterSetterString(Simulation, input_replay_path, InputReplayPath);
+		private:
+			bool headless{ false }; // run FrameFunc as fast as possible without window and rendering
+			uint64_t frame_limit{}; // 0 means until the game exits
+			std::string digest_path; // write a state digest of the object pool per frame
+			std::string input_record_path; // record polled keyboard and mouse input per frame
+			std::string input_replay_path; // replace keyboard and mouse input with a recorded journal
+		};
+		class ResourceSystem {
+		public:
+			GetterSetterPrimitive(ResourceSystem, uint32_t, async_worker_count, AsyncWorkerCount);
+		private:
+			uint32_t async_worker_count{}; // 0 means automatic
 		};
 		/* TODO*/ struct Display {
 			std::string device_name;
@@ -149,6 +205,7 @@ namespace core {
 			GetterSetterBoolean(GraphicsSystem, allow_exclusive_fullscreen, AllowExclusiveFullscreen);
 			GetterSetterBoolean(GraphicsSystem, allow_modern_swap_chain, AllowModernSwapChain);
 			GetterSetterBoolean(GraphicsSystem, allow_direct_composition, AllowDirectComposition);
+			GetterSetterBoolean(GraphicsSystem, pipelined_rendering, PipelinedRendering);
 		private:
 			std::string preferred_device_name;
 			uint32_t width{ 640u };
@@ -159,16 +216,19 @@ namespace core {
 			bool allow_exclusive_fullscreen{ true };
 			bool allow_modern_swap_chain{ true };
 			bool allow_direct_composition{ true };
+			bool pipelined_rendering{}; // record draw calls in onRender and replay them on a render thread
 		};
 		class AudioSystem {
 		public:
 			GetterSetterString(AudioSystem, preferred_endpoint_name, PreferredEndpointName);
 			GetterSetterPrimitive(AudioSystem, float, sound_effect_volume, SoundEffectVolume);
 			GetterSetterPrimitive(AudioSystem, float, music_volume, MusicVolume);
+			GetterSetterPrimitive(AudioSystem, uint32_t, sound_effect_voice_limit, SoundEffectVoiceLimit);
 		private:
 			std::string preferred_endpoint_name;
 			float sound_effect_volume{ 1.0f };
 			float music_volume{ 1.0f };
+			uint32_t sound_effect_voice_limit{ 64 };
 		};
 	public:
 		ConfigurationLoader();
@@ -181,6 +241,9 @@ namespace core {
 		inline Logging const& getLogging() const noexcept { return logging; }
 		inline FileSystem const& getFileSystem() const noexcept { return file_system; }
 		inline Timing const& getTiming() const noexcept { return timing; }
+		inline Script const& getScript() const noexcept { return script; }
+		inline Simulation const& getSimulation() const noexcept { return simulation; }
+		inline ResourceSystem const& getResourceSystem() const noexcept { return resource_system; }
 		inline Window const& getWindow() const noexcept { return window; }
 		inline GraphicsSystem const& getGraphicsSystem() const noexcept { return graphics_system; }
 		inline AudioSystem const& getAudioSystem() const noexcept { return audio_system; }
@@ -188,6 +251,7 @@ namespace core {
 		inline Window& getWindowRef() { return window; }
 		inline GraphicsSystem& getGraphicsSystemRef() { return graphics_system; }
 		inline AudioSystem& getAudioSystemRef() { return audio_system; }
+		inline Simulation& getSimulationRef() { return simulation; }
 	public:
 		static bool exists(std::string_view const& path);
 		static bool replaceAllPredefinedVariables(std::string_view const& input, std::string& output);
@@ -201,6 +265,9 @@ namespace core {
 		Logging logging;
 		FileSystem file_system;
 		Timing timing;
+		Script script;
+		Simulation simulation;
+		ResourceSystem resource_system;
 		Window window;
 		GraphicsSystem graphics_system;
 		AudioSystem audio_system;
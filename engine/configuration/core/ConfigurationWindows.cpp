@@ -175,6 +175,111 @@ namespace core {
 							write_arg_error(raw_arg);
 							return false;
 						});
+					access_field(pipelined_rendering,
+						if (auto const value = to_boolean(arg); value) {
+							graphics_system.setPipelinedRendering(value.value());
+						}
+						else {
+							write_arg_error(raw_arg);
+							return false;
+						});
+				});
+
+			access_parent_field(logging,
+				{
+					access_parent_field(async,
+						{
+							access_field(enable,
+								if (auto const value = to_boolean(arg); value) {
+									logging.async.setEnable(value.value());
+								}
+								else {
+									write_arg_error(raw_arg);
+									return false;
+								});
+							access_field(queue_size,
+								if (auto const value = to_unsigned_integer<uint32_t>(arg); value) {
+									logging.async.setQueueSize(value.value());
+								}
+								else {
+									write_arg_error(raw_arg);
+									return false;
+								});
+							access_field(overflow_policy,
+								if (arg == "block"sv) {
+									logging.async.setOverflowPolicy(Logging::Async::OverflowPolicy::block);
+								}
+								else if (arg == "drop"sv) {
+									logging.async.setOverflowPolicy(Logging::Async::OverflowPolicy::drop);
+								}
+								else {
+									write_message(raw_arg, "unknown overflow policy"sv);
+									return false;
+								});
+							access_field(flush_interval,
+								if (auto const value = to_unsigned_integer<uint32_t>(arg); value) {
+									logging.async.setFlushInterval(value.value());
+								}
+								else {
+									write_arg_error(raw_arg);
+									return false;
+								});
+						});
+				});
+
+			access_parent_field(timing,
+				{
+					access_field(frame_pacer,
+						if (arg == "auto"sv) {
+							timing.setFramePacer(Timing::FramePacer::automatic);
+						}
+						else if (arg == "hybrid"sv) {
+							timing.setFramePacer(Timing::FramePacer::hybrid);
+						}
+						else {
+							write_message(raw_arg, "unknown frame pacer"sv);
+							return false;
+						});
+					access_field(max_catch_up_frames,
+						if (auto const value = to_unsigned_integer<uint32_t>(arg); value) {
+							timing.setMaxCatchUpFrames(value.value());
+						}
+						else {
+							write_arg_error(raw_arg);
+							return false;
+						});
+				});
+
+			access_parent_field(simulation,
+				{
+					access_field(headless,
+						if (auto const value = to_boolean(arg); value) {
+							simulation.setHeadless(value.value());
+						}
+						else {
+							write_arg_error(raw_arg);
+							return false;
+						});
+					access_field(frame_limit,
+						if (auto const value = to_unsigned_integer<uint64_t>(arg); value) {
+							simulation.setFrameLimit(value.value());
+						}
+						else {
+							write_arg_error(raw_arg);
+							return false;
+						});
+					access_field(digest_path,
+						if (!arg.empty()) {
+							simulation.setDigestPath(arg);
+						});
+					access_field(input_record_path,
+						if (!arg.empty()) {
+							simulation.setInputRecordPath(arg);
+						});
+					access_field(input_replay_path,
+						if (!arg.empty()) {
+							simulation.setInputReplayPath(arg);
+						});
 				});
 
 		#undef access_parent_field
@@ -39,3 +39,191 @@ end
 ---@return number
 function lstg._DetectListNext(group_id, id)
 end
+
+--- Writes the ids of a group (or of the whole update list when group is not a collision group) in list order,
+--- the same ids as lstg.ObjList, into a reusable Lua array (stale entries are cleared)
+--- or an FFI int32_t array of the given capacity; returns the object count, which may exceed capacity
+--- FFI pointers (ffi.cast("int32_t*", ...)) are rejected, pass the array itself or a lightuserdata
+---@param group number
+---@param buffer number[]|ffi.cdata*
+---@param capacity number?
+---@return number
+function lstg.ObjListSnapshot(group, buffer, capacity)
+end
+
+--- Nearest object of a group to (x, y), objects already marked del/kill are skipped
+--- All spatial queries test object centers, ties are broken by list order
+---@param group number
+---@param x number
+---@param y number
+---@return lstg.GameObject?, number
+function lstg.ObjNearest(group, x, y)
+end
+
+--- Ids of the objects of a group within radius of (x, y), in list order, same buffer rules as lstg.ObjListSnapshot
+--- Passing "del" as buffer marks the objects del instead (capacity becomes the reason passed to the del callback,
+--- "luastg:query" by default), the del callbacks are called in list order and the count of deleted objects is returned
+---@param group number
+---@param x number
+---@param y number
+---@param radius number
+---@param buffer number[]|ffi.cdata*|"del"
+---@param capacity number|string?
+---@return number
+function lstg.ObjInRadius(group, x, y, radius, buffer, capacity)
+end
+
+--- Ids of the objects of a group whose center is inside the rectangle, in list order, same buffer rules as lstg.ObjInRadius
+---@param group number
+---@param l number
+---@param r number
+---@param b number
+---@param t number
+---@param buffer number[]|ffi.cdata*|"del"
+---@param capacity number|string?
+---@return number
+function lstg.ObjInRect(group, l, r, b, t, buffer, capacity)
+end
+
+--- Ids of the k nearest objects of a group to (x, y), nearest first, same buffer rules as lstg.ObjInRadius
+---@param group number
+---@param x number
+---@param y number
+---@param k number
+---@param max_distance number? unlimited when nil
+---@param buffer number[]|ffi.cdata*|"del"
+---@param capacity number|string?
+---@return number
+function lstg.ObjNearestK(group, x, y, k, max_distance, buffer, capacity)
+end
+
+--- Ids of the objects of a group within half_width of the segment (x1, y1)-(x2, y2),
+--- ordered from (x1, y1) to (x2, y2), same buffer rules as lstg.ObjInRadius
+---@param group number
+---@param x1 number
+---@param y1 number
+---@param x2 number
+---@param y2 number
+---@param half_width number
+---@param buffer number[]|ffi.cdata*|"del"
+---@param capacity number|string?
+---@return number
+function lstg.ObjOnSegment(group, x1, y1, x2, y2, half_width, buffer, capacity)
+end
+
+--- Cell size of the grid used by the spatial queries, 64 by default, should be around the typical query radius
+---@param size number
+function lstg.SetObjQueryCellSize(size)
+end
+
+--- The spatial queries keep a grid per group, built on the first query and kept up to date as objects are created,
+--- deleted, moved by the engine or have x/y set; call this after moving objects through lstg.GetGameObjectView,
+--- the grids are rebuilt on the next query
+function lstg.ObjQueryInvalidate()
+end
+
+--- Filter of the bulk operations: a group number (same meaning as in lstg.ObjList), or a table
+--- { group = ?, world = ?, l = ?, r = ?, b = ?, t = ? } or { group = ?, world = ?, x = ?, y = ?, radius = ? };
+--- world is a world mask and only takes effect when the engine is built with multiple game worlds;
+--- only objects not yet marked del/kill are selected, in list order, shapes test object centers
+---@alias lstg.ObjectFilter number|{ group:number?, world:number?, l:number?, r:number?, b:number?, t:number?, x:number?, y:number?, radius:number? }
+
+--- Marks every selected object del first, then calls the del callbacks in list order with reason
+--- (same ordering as lstg.BoundCheck), returns the number of objects marked
+---@param filter lstg.ObjectFilter
+---@param reason string? "luastg:bulk" by default
+---@return number
+function lstg.ObjBulkDel(filter, reason)
+end
+
+--- Same as lstg.ObjBulkDel, but marks the objects kill and calls the kill callbacks;
+--- like lstg.Kill, the callbacks only receive the object unless reason is given
+---@param filter lstg.ObjectFilter
+---@param reason string?
+---@return number
+function lstg.ObjBulkKill(filter, reason)
+end
+
+--- Sets vx, vy, ax, ay, a, b, colli on every selected object, fields missing from properties are left unchanged,
+--- returns the number of objects changed
+---@param filter lstg.ObjectFilter
+---@param properties { vx:number?, vy:number?, ax:number?, ay:number?, a:number?, b:number?, colli:boolean? }
+---@return number
+function lstg.ObjBulkSet(filter, properties)
+end
+
+--- Calls callback once as callback(objects, count, ...) with an array of the selected objects, in list order;
+--- e.g. spawn an item at each bullet, then lstg.ObjBulkDel the same filter. Returns count
+---@param filter lstg.ObjectFilter
+---@param callback fun(objects:lstg.GameObject[], count:number, ...)
+---@return number
+function lstg.ObjBulkCall(filter, callback, ...)
+end
+
+---@class lstg.GameObjectSnapshot
+local GameObjectSnapshot = {}
+---@return number
+function GameObjectSnapshot:getObjectCount() end
+--- Number of object chunks shared with the base snapshot
+---@return number
+function GameObjectSnapshot:getSharedChunkCount() end
+--- Number of object chunks stored as field-level deltas
+---@return number
+function GameObjectSnapshot:getDeltaChunkCount() end
+--- Bytes owned by this snapshot, shared chunks are not counted
+---@return number
+function GameObjectSnapshot:getMemoryUsage() end
+--- Value returned by the save hook when the snapshot was taken
+---@return any
+function GameObjectSnapshot:getUserState() end
+
+--- Takes a snapshot of the native object world: every object's properties, callbacks and resources, the update,
+--- collision and render lists, free slots, uid counter, superpause, bound and world masks.
+--- Object tables are kept by reference, so restored objects keep their Lua identity; fields that scripts store on
+--- object tables (and any other script state, lstg.Rand included) should be saved by the save hook.
+--- Objects are stored in chunks, chunks unchanged since base are shared instead of copied, other chunks only store
+--- the 8-byte words of each object that differ from the last full chunk (timer, position...), so taking a snapshot
+--- every few frames with the previous one as base is cheap. Particle emitter state is not included.
+--- Can not be called while rendering or detecting intersection
+---@param base lstg.GameObjectSnapshot?
+---@return lstg.GameObjectSnapshot
+function lstg.ObjSnapshot(base)
+end
+
+--- Restores a snapshot. Objects that do not exist in the snapshot are freed without del callbacks,
+--- objects freed since the snapshot come back in their old slots without init callbacks.
+--- Must be called between frames: returns false without doing anything while rendering, detecting intersection
+--- or from callbacks the object manager dispatches while walking its lists (frame, render, colli, del).
+--- Calls the load hook with the saved user state afterwards
+---@param snapshot lstg.GameObjectSnapshot
+---@return boolean
+function lstg.ObjRestore(snapshot)
+end
+
+--- save() is called by lstg.ObjSnapshot, its return value is kept with the snapshot;
+--- load(state) is called by lstg.ObjRestore with that value. Pass nil to remove the hooks
+---@param save fun():any
+---@param load fun(state:any)
+function lstg.SetObjSnapshotHook(save, load)
+end
+
+--- Index of the frame the next update reads from the input journal set by simulation.input_replay_path,
+--- nil when no journal is being replayed. Keep it with a snapshot to seek the replay back together with the world
+---@return number?
+function lstg.GetInputReplayFrame()
+end
+
+--- Moves the input replay to a frame, the next update reads that frame. Used after lstg.ObjRestore with the frame
+--- returned by lstg.GetInputReplayFrame when the snapshot was taken; the state digest of the following keyframes is
+--- checked again. Returns false when no journal is being replayed or the frame is past its end
+---@param frame number
+---@return boolean
+function lstg.SeekInputReplay(frame)
+end
+
+--- LuaJIT FFI view on the hot fields of a game object (x, y, dx, dy, vx, vy, ax, ay, hscale, vscale, rot, omega, timer)
+--- rot and omega are in radians, timer is int64_t, the view is only valid until the object is freed
+---@param object lstg.GameObject
+---@return ffi.cdata*
+function lstg.GetGameObjectView(object)
+end
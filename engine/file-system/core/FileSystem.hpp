@@ -2,6 +2,7 @@
 #include "core/ReferenceCounted.hpp"
 #include "core/Data.hpp"
 #include <string>
+#include <vector>
 
 namespace core {
 	enum class FileSystemNodeType : uint8_t {
@@ -84,6 +85,7 @@ namespace core {
 		static bool hasSearchPath(std::string_view const& path);
 		static void removeSearchPath(std::string_view const& path);
 		static void removeAllSearchPath();
+		static std::vector<std::string> getSearchPaths();
 		static void resolveLocation(std::string_view const& path, IFileSystemEnumerator** enumerator);
 
 		static bool hasNode(std::string_view const& name);
@@ -320,6 +320,10 @@ namespace core {
 		[[maybe_unused]] std::lock_guard lock(s_search_paths_mutex);
 		s_search_paths.clear();
 	}
+	std::vector<std::string> FileSystemManager::getSearchPaths() {
+		[[maybe_unused]] std::lock_guard lock(s_search_paths_mutex);
+		return s_search_paths;
+	}
 
 	bool FileSystemManager::hasNode(std::string_view const& name) {
 		auto const l = ResourceLocation::parse(name);
@@ -1,7 +1,9 @@
 #include "backend/Image.hpp"
+#include "backend/PixelConversion.hpp"
 #include "core/SmartReference.hpp"
 #include "core/Logger.hpp"
 #include <cassert>
+#include <cstring>
 #include <algorithm>
 #include <DirectXPackedVector.h>
 
@@ -83,6 +85,13 @@ namespace {
     size_t getOffset(const core::ImageDescription& description, const uint32_t x, const uint32_t y) {
         return description.size.x * y + x;
     }
+
+    bool isUnorm8(const core::ImageFormat format) {
+        return format == core::ImageFormat::r8g8b8a8_normalized || format == core::ImageFormat::b8g8r8a8_normalized;
+    }
+
+    // Pixels converted through a float buffer at a time, small enough to stay in L1
+    constexpr size_t conversion_chunk_size = 256;
 }
 
 namespace core {
@@ -186,6 +195,148 @@ namespace core {
     }
     bool Image::isReadOnly() const noexcept { return m_read_only; }
     void Image::setReadOnly() noexcept { m_read_only = true; }
+    bool Image::premultiplyAlpha() noexcept {
+        if (m_read_only) {
+            Logger::error("[core] image is read-only"sv);
+            return false;
+        }
+        if (m_description.alpha_mode != ImageAlphaMode::straight) {
+            return true;
+        }
+        const size_t count = static_cast<size_t>(m_description.size.x) * m_description.size.y;
+        switch (m_description.format) {
+            case ImageFormat::r8g8b8a8_normalized:
+            case ImageFormat::b8g8r8a8_normalized: {
+                PixelConversion::premultiplyAlpha(m_pixels, count);
+                break;
+            }
+            case ImageFormat::r16g16b16a16_float: {
+                auto* const pixels = static_cast<DirectX::PackedVector::XMHALF4*>(m_pixels);
+                Vector4F buffer[conversion_chunk_size];
+                for (size_t offset = 0; offset < count; offset += conversion_chunk_size) {
+                    const size_t n = std::min(conversion_chunk_size, count - offset);
+                    PixelConversion::convertHalfToFloat(pixels + offset, buffer, n);
+                    PixelConversion::premultiplyAlpha(buffer, n);
+                    PixelConversion::convertFloatToHalf(buffer, pixels + offset, n);
+                }
+                break;
+            }
+            case ImageFormat::r32g32b32a32_float: {
+                PixelConversion::premultiplyAlpha(static_cast<Vector4F*>(m_pixels), count);
+                break;
+            }
+            default: {
+                assert(false);
+                return false;
+            }
+        }
+        m_description.alpha_mode = ImageAlphaMode::premultiplied;
+        return true;
+    }
+    bool Image::convert(const ImageFormat format, const ImageColorSpace color_space, IImage** const output_image) const noexcept {
+        if (!output_image) {
+            Logger::error("[core] invalid parameter (null pointer)"sv);
+            return false;
+        }
+        ImageDescription description(m_description);
+        description.format = format;
+        description.color_space = color_space;
+        SmartReference<Image> image;
+        image.attach(new Image());
+        if (!image->initialize(description)) {
+            Logger::error("[core] failed to initialize image"sv);
+            return false;
+        }
+
+        const size_t count = static_cast<size_t>(m_description.size.x) * m_description.size.y;
+        const auto* const source = static_cast<const uint8_t*>(m_pixels);
+        auto* const destination = static_cast<uint8_t*>(image->m_pixels);
+        const uint32_t source_pixel_size = getImageFormatPixelSize(m_description.format);
+        const uint32_t destination_pixel_size = getImageFormatPixelSize(format);
+
+        if (format == m_description.format && color_space == m_description.color_space) {
+            std::memcpy(destination, source, count * source_pixel_size);
+        }
+        else if (isUnorm8(format) && isUnorm8(m_description.format) && color_space == m_description.color_space) {
+            std::memcpy(destination, source, count * source_pixel_size);
+            PixelConversion::swapRedBlue(destination, count);
+        }
+        else {
+            const bool source_bgra = m_description.format == ImageFormat::b8g8r8a8_normalized;
+            const bool destination_bgra = format == ImageFormat::b8g8r8a8_normalized;
+            // The transfer function only applies when the color space changes,
+            // otherwise the encoded values are converted as they are
+            const bool decode_srgb = m_description.color_space == ImageColorSpace::srgb_gamma_2_2 && color_space != ImageColorSpace::srgb_gamma_2_2;
+            const bool encode_srgb = color_space == ImageColorSpace::srgb_gamma_2_2 && m_description.color_space != ImageColorSpace::srgb_gamma_2_2;
+            Vector4F buffer[conversion_chunk_size];
+            for (size_t offset = 0; offset < count; offset += conversion_chunk_size) {
+                const size_t n = std::min(conversion_chunk_size, count - offset);
+                const void* const s = source + offset * source_pixel_size;
+                void* const d = destination + offset * destination_pixel_size;
+                const Vector4F* linear = buffer;
+                switch (m_description.format) {
+                    case ImageFormat::r8g8b8a8_normalized:
+                    case ImageFormat::b8g8r8a8_normalized: {
+                        PixelConversion::convertUnorm8ToFloat(s, buffer, n, source_bgra, decode_srgb);
+                        break;
+                    }
+                    case ImageFormat::r16g16b16a16_float: {
+                        PixelConversion::convertHalfToFloat(s, buffer, n);
+                        if (decode_srgb) {
+                            PixelConversion::convertSrgbToLinear(buffer, n);
+                        }
+                        break;
+                    }
+                    case ImageFormat::r32g32b32a32_float: {
+                        if (decode_srgb) {
+                            std::memcpy(buffer, s, n * sizeof(Vector4F));
+                            PixelConversion::convertSrgbToLinear(buffer, n);
+                        }
+                        else {
+                            linear = static_cast<const Vector4F*>(s);
+                        }
+                        break;
+                    }
+                    default: {
+                        assert(false);
+                        return false;
+                    }
+                }
+                switch (format) {
+                    case ImageFormat::r8g8b8a8_normalized:
+                    case ImageFormat::b8g8r8a8_normalized: {
+                        PixelConversion::convertFloatToUnorm8(linear, d, n, destination_bgra, encode_srgb);
+                        break;
+                    }
+                    case ImageFormat::r16g16b16a16_float: {
+                        if (encode_srgb) {
+                            if (linear != buffer) {
+                                std::memcpy(buffer, linear, n * sizeof(Vector4F));
+                                linear = buffer;
+                            }
+                            PixelConversion::convertLinearToSrgb(buffer, n);
+                        }
+                        PixelConversion::convertFloatToHalf(linear, d, n);
+                        break;
+                    }
+                    case ImageFormat::r32g32b32a32_float: {
+                        std::memcpy(d, linear, n * sizeof(Vector4F));
+                        if (encode_srgb) {
+                            PixelConversion::convertLinearToSrgb(static_cast<Vector4F*>(d), n);
+                        }
+                        break;
+                    }
+                    default: {
+                        assert(false);
+                        return false;
+                    }
+                }
+            }
+        }
+
+        *output_image = image.detach();
+        return true;
+    }
 
     // Image
 
@@ -14,6 +14,8 @@ namespace core {
         void setPixel(uint32_t x, uint32_t y, const Vector4F& pixel) noexcept override;
         bool isReadOnly() const noexcept override;
         void setReadOnly() noexcept override;
+        bool premultiplyAlpha() noexcept override;
+        bool convert(ImageFormat format, ImageColorSpace color_space, IImage** output_image) const noexcept override;
 
         // Image
 
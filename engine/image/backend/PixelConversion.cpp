@@ -0,0 +1,738 @@
+#include "backend/PixelConversion.hpp"
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <cstring>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define CORE_PIXEL_CONVERSION_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#elif defined(_M_ARM64) || defined(__aarch64__)
+#define CORE_PIXEL_CONVERSION_NEON
+#include <arm_neon.h>
+#endif
+
+// MSVC lets any function use any intrinsic, GCC and Clang want to be told
+#if defined(_MSC_VER) && !defined(__clang__)
+#define CORE_TARGET(X)
+#else
+#define CORE_TARGET(X) __attribute__((target(X)))
+#endif
+
+namespace {
+    using core::PixelConversionInstructionSet;
+    using core::Vector4F;
+
+    // vvvvvvvvvv Shared helpers vvvvvvvvvv
+
+    // c * a / 255, rounded to nearest, exact for every 8-bit input
+    inline uint8_t mulDiv255(const uint32_t c, const uint32_t a) noexcept {
+        const uint32_t t = c * a + 128u;
+        return static_cast<uint8_t>((t + (t >> 8)) >> 8);
+    }
+
+    inline float clampUnorm(const float v) noexcept {
+        const float low = v > 0.0f ? v : 0.0f; // NaN -> 0
+        return low < 1.0f ? low : 1.0f;
+    }
+
+    inline uint32_t roundToUint(const float v) noexcept {
+        // SIMD conversions round to nearest even as well
+        return static_cast<uint32_t>(std::nearbyint(v));
+    }
+
+    constexpr size_t srgb_encode_table_size = 4096;
+
+    const std::array<float, 256>& getSrgbDecodeTable() noexcept {
+        static const std::array<float, 256> table = [] {
+            std::array<float, 256> t{};
+            for (size_t i = 0; i < t.size(); i += 1) {
+                const double c = static_cast<double>(i) / 255.0;
+                t[i] = static_cast<float>(c <= 0.04045 ? c / 12.92 : std::pow((c + 0.055) / 1.055, 2.4));
+            }
+            return t;
+        }();
+        return table;
+    }
+
+    // Indexed by the linear value quantized to 12 bits, precise enough for an 8-bit result
+    const std::array<uint8_t, srgb_encode_table_size>& getSrgbEncodeTable() noexcept {
+        static const std::array<uint8_t, srgb_encode_table_size> table = [] {
+            std::array<uint8_t, srgb_encode_table_size> t{};
+            for (size_t i = 0; i < t.size(); i += 1) {
+                const double l = static_cast<double>(i) / static_cast<double>(srgb_encode_table_size - 1);
+                const double c = l <= 0.0031308 ? l * 12.92 : 1.055 * std::pow(l, 1.0 / 2.4) - 0.055;
+                t[i] = static_cast<uint8_t>(std::lround(c * 255.0));
+            }
+            return t;
+        }();
+        return table;
+    }
+
+    inline uint8_t encodeSrgb(const float v) noexcept {
+        return getSrgbEncodeTable()[roundToUint(clampUnorm(v) * static_cast<float>(srgb_encode_table_size - 1))];
+    }
+
+    // Exact transfer functions for float pixels, values outside [0, 1] are mirrored/extended like scRGB
+    inline float srgbToLinear(const float v) noexcept {
+        const float c = std::fabs(v);
+        const float l = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+        return std::copysign(l, v);
+    }
+
+    inline float linearToSrgb(const float v) noexcept {
+        const float l = std::fabs(v);
+        const float c = l <= 0.0031308f ? l * 12.92f : 1.055f * std::pow(l, 1.0f / 2.4f) - 0.055f;
+        return std::copysign(c, v);
+    }
+
+    // Round to nearest even, see https://gist.github.com/rygorous/2156668
+    inline uint16_t floatToHalf(const float value) noexcept {
+        constexpr uint32_t f32_infinity = 255u << 23;
+        constexpr uint32_t f16_max = (127u + 16u) << 23;
+        constexpr uint32_t denormal_magic = ((127u - 15u) + (23u - 10u) + 1u) << 23;
+        uint32_t u = std::bit_cast<uint32_t>(value);
+        const uint32_t sign = u & 0x80000000u;
+        u ^= sign;
+        uint16_t o{};
+        if (u >= f16_max) {
+            o = u > f32_infinity ? 0x7e00 : 0x7c00;
+        }
+        else if (u < (113u << 23)) {
+            const float f = std::bit_cast<float>(u) + std::bit_cast<float>(denormal_magic);
+            o = static_cast<uint16_t>(std::bit_cast<uint32_t>(f) - denormal_magic);
+        }
+        else {
+            const uint32_t mantissa_odd = (u >> 13) & 1u;
+            u += (static_cast<uint32_t>(15 - 127) << 23) + 0xfffu;
+            u += mantissa_odd;
+            o = static_cast<uint16_t>(u >> 13);
+        }
+        return static_cast<uint16_t>(o | (sign >> 16));
+    }
+
+    inline float halfToFloat(const uint16_t h) noexcept {
+        constexpr uint32_t shifted_exponent = 0x7c00u << 13;
+        uint32_t o = (h & 0x7fffu) << 13;
+        const uint32_t exponent = shifted_exponent & o;
+        o += (127u - 15u) << 23;
+        if (exponent == shifted_exponent) {
+            o += (128u - 16u) << 23;
+        }
+        else if (exponent == 0) {
+            o += 1u << 23;
+            o = std::bit_cast<uint32_t>(std::bit_cast<float>(o) - std::bit_cast<float>(113u << 23));
+        }
+        return std::bit_cast<float>(o | (static_cast<uint32_t>(h & 0x8000u) << 16));
+    }
+
+    // vvvvvvvvvv Scalar kernels, also used for the tails of the SIMD kernels vvvvvvvvvv
+
+    namespace scalar {
+        void swapRedBlue(uint8_t* const p, const size_t count) noexcept {
+            for (size_t i = 0; i < count; i += 1) {
+                const uint8_t t = p[i * 4 + 0];
+                p[i * 4 + 0] = p[i * 4 + 2];
+                p[i * 4 + 2] = t;
+            }
+        }
+
+        void premultiplyAlpha(uint8_t* const p, const size_t count) noexcept {
+            for (size_t i = 0; i < count; i += 1) {
+                uint8_t* const c = p + i * 4;
+                c[0] = mulDiv255(c[0], c[3]);
+                c[1] = mulDiv255(c[1], c[3]);
+                c[2] = mulDiv255(c[2], c[3]);
+            }
+        }
+
+        void premultiplyAlpha(Vector4F* const p, const size_t count) noexcept {
+            for (size_t i = 0; i < count; i += 1) {
+                p[i].x *= p[i].w;
+                p[i].y *= p[i].w;
+                p[i].z *= p[i].w;
+            }
+        }
+
+        void convertUnorm8ToFloat(const uint8_t* const s, Vector4F* const d, const size_t count, const bool bgra, const bool srgb) noexcept {
+            constexpr float scale = 1.0f / 255.0f;
+            const size_t r = bgra ? 2 : 0;
+            const size_t b = bgra ? 0 : 2;
+            if (srgb) {
+                const auto& table = getSrgbDecodeTable();
+                for (size_t i = 0; i < count; i += 1) {
+                    const uint8_t* const c = s + i * 4;
+                    d[i] = Vector4F(table[c[r]], table[c[1]], table[c[b]], static_cast<float>(c[3]) * scale);
+                }
+            }
+            else {
+                for (size_t i = 0; i < count; i += 1) {
+                    const uint8_t* const c = s + i * 4;
+                    d[i] = Vector4F(static_cast<float>(c[r]) * scale, static_cast<float>(c[1]) * scale, static_cast<float>(c[b]) * scale, static_cast<float>(c[3]) * scale);
+                }
+            }
+        }
+
+        void convertFloatToUnorm8(const Vector4F* const s, uint8_t* const d, const size_t count, const bool bgra, const bool srgb) noexcept {
+            const size_t r = bgra ? 2 : 0;
+            const size_t b = bgra ? 0 : 2;
+            for (size_t i = 0; i < count; i += 1) {
+                uint8_t* const c = d + i * 4;
+                if (srgb) {
+                    c[r] = encodeSrgb(s[i].x);
+                    c[1] = encodeSrgb(s[i].y);
+                    c[b] = encodeSrgb(s[i].z);
+                }
+                else {
+                    c[r] = static_cast<uint8_t>(roundToUint(clampUnorm(s[i].x) * 255.0f));
+                    c[1] = static_cast<uint8_t>(roundToUint(clampUnorm(s[i].y) * 255.0f));
+                    c[b] = static_cast<uint8_t>(roundToUint(clampUnorm(s[i].z) * 255.0f));
+                }
+                c[3] = static_cast<uint8_t>(roundToUint(clampUnorm(s[i].w) * 255.0f));
+            }
+        }
+
+        void convertFloatToHalf(const Vector4F* const s, uint16_t* const d, const size_t count) noexcept {
+            for (size_t i = 0; i < count; i += 1) {
+                d[i * 4 + 0] = floatToHalf(s[i].x);
+                d[i * 4 + 1] = floatToHalf(s[i].y);
+                d[i * 4 + 2] = floatToHalf(s[i].z);
+                d[i * 4 + 3] = floatToHalf(s[i].w);
+            }
+        }
+
+        void convertHalfToFloat(const uint16_t* const s, Vector4F* const d, const size_t count) noexcept {
+            for (size_t i = 0; i < count; i += 1) {
+                d[i] = Vector4F(halfToFloat(s[i * 4 + 0]), halfToFloat(s[i * 4 + 1]), halfToFloat(s[i * 4 + 2]), halfToFloat(s[i * 4 + 3]));
+            }
+        }
+
+        void convertSrgbToLinear(Vector4F* const p, const size_t count) noexcept {
+            for (size_t i = 0; i < count; i += 1) {
+                p[i].x = srgbToLinear(p[i].x);
+                p[i].y = srgbToLinear(p[i].y);
+                p[i].z = srgbToLinear(p[i].z);
+            }
+        }
+
+        void convertLinearToSrgb(Vector4F* const p, const size_t count) noexcept {
+            for (size_t i = 0; i < count; i += 1) {
+                p[i].x = linearToSrgb(p[i].x);
+                p[i].y = linearToSrgb(p[i].y);
+                p[i].z = linearToSrgb(p[i].z);
+            }
+        }
+    }
+
+#ifdef CORE_PIXEL_CONVERSION_X86
+    namespace sse4 {
+        CORE_TARGET("sse4.1")
+        void swapRedBlue(uint8_t* const p, const size_t count) noexcept {
+            const __m128i mask = _mm_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4) {
+                const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i * 4));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(p + i * 4), _mm_shuffle_epi8(v, mask));
+            }
+            scalar::swapRedBlue(p + i * 4, count - i);
+        }
+
+        CORE_TARGET("sse4.1")
+        inline __m128i mulDiv255(const __m128i c, const __m128i a) noexcept {
+            __m128i t = _mm_add_epi16(_mm_mullo_epi16(c, a), _mm_set1_epi16(128));
+            t = _mm_add_epi16(t, _mm_srli_epi16(t, 8));
+            return _mm_srli_epi16(t, 8);
+        }
+
+        CORE_TARGET("sse4.1")
+        void premultiplyAlpha(uint8_t* const p, const size_t count) noexcept {
+            // Broadcast alpha of each pixel to its 4 lanes, the alpha lane itself is multiplied by 255
+            const __m128i alpha_mask = _mm_setr_epi8(6, 7, 6, 7, 6, 7, -1, -1, 14, 15, 14, 15, 14, 15, -1, -1);
+            const __m128i alpha_one = _mm_setr_epi16(0, 0, 0, 255, 0, 0, 0, 255);
+            const __m128i zero = _mm_setzero_si128();
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4) {
+                const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i * 4));
+                const __m128i lo = _mm_unpacklo_epi8(v, zero);
+                const __m128i hi = _mm_unpackhi_epi8(v, zero);
+                const __m128i alpha_lo = _mm_or_si128(_mm_shuffle_epi8(lo, alpha_mask), alpha_one);
+                const __m128i alpha_hi = _mm_or_si128(_mm_shuffle_epi8(hi, alpha_mask), alpha_one);
+                const __m128i result = _mm_packus_epi16(mulDiv255(lo, alpha_lo), mulDiv255(hi, alpha_hi));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(p + i * 4), result);
+            }
+            scalar::premultiplyAlpha(p + i * 4, count - i);
+        }
+
+        CORE_TARGET("sse4.1")
+        void premultiplyAlpha(Vector4F* const p, const size_t count) noexcept {
+            auto* const f = reinterpret_cast<float*>(p);
+            for (size_t i = 0; i < count; i += 1) {
+                const __m128 v = _mm_loadu_ps(f + i * 4);
+                const __m128 a = _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3));
+                _mm_storeu_ps(f + i * 4, _mm_blend_ps(_mm_mul_ps(v, a), v, 0x8));
+            }
+        }
+
+        CORE_TARGET("sse4.1")
+        void convertUnorm8ToFloat(const uint8_t* const s, Vector4F* const d, const size_t count, const bool bgra) noexcept {
+            const __m128 scale = _mm_set1_ps(1.0f / 255.0f);
+            auto* const f = reinterpret_cast<float*>(d);
+            for (size_t i = 0; i < count; i += 1) {
+                int32_t packed;
+                std::memcpy(&packed, s + i * 4, sizeof(packed));
+                __m128 v = _mm_mul_ps(_mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_cvtsi32_si128(packed))), scale);
+                if (bgra) {
+                    v = _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 0, 1, 2));
+                }
+                _mm_storeu_ps(f + i * 4, v);
+            }
+        }
+
+        CORE_TARGET("sse4.1")
+        inline __m128i convertFloatToInt(const float* const f, const bool bgra) noexcept {
+            __m128 v = _mm_loadu_ps(f);
+            if (bgra) {
+                v = _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 0, 1, 2));
+            }
+            v = _mm_min_ps(_mm_max_ps(v, _mm_setzero_ps()), _mm_set1_ps(1.0f)); // NaN -> 0
+            return _mm_cvtps_epi32(_mm_mul_ps(v, _mm_set1_ps(255.0f)));
+        }
+
+        CORE_TARGET("sse4.1")
+        void convertFloatToUnorm8(const Vector4F* const s, uint8_t* const d, const size_t count, const bool bgra) noexcept {
+            const auto* const f = reinterpret_cast<const float*>(s);
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4) {
+                const __m128i p01 = _mm_packus_epi32(convertFloatToInt(f + i * 4 + 0, bgra), convertFloatToInt(f + i * 4 + 4, bgra));
+                const __m128i p23 = _mm_packus_epi32(convertFloatToInt(f + i * 4 + 8, bgra), convertFloatToInt(f + i * 4 + 12, bgra));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(d + i * 4), _mm_packus_epi16(p01, p23));
+            }
+            scalar::convertFloatToUnorm8(s + i, d + i * 4, count - i, bgra, false);
+        }
+    }
+
+    namespace avx2 {
+        CORE_TARGET("avx2,f16c")
+        void swapRedBlue(uint8_t* const p, const size_t count) noexcept {
+            const __m256i mask = _mm256_setr_epi8(
+                2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15,
+                2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8) {
+                const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i * 4));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(p + i * 4), _mm256_shuffle_epi8(v, mask));
+            }
+            sse4::swapRedBlue(p + i * 4, count - i);
+        }
+
+        CORE_TARGET("avx2,f16c")
+        inline __m256i mulDiv255(const __m256i c, const __m256i a) noexcept {
+            __m256i t = _mm256_add_epi16(_mm256_mullo_epi16(c, a), _mm256_set1_epi16(128));
+            t = _mm256_add_epi16(t, _mm256_srli_epi16(t, 8));
+            return _mm256_srli_epi16(t, 8);
+        }
+
+        CORE_TARGET("avx2,f16c")
+        void premultiplyAlpha(uint8_t* const p, const size_t count) noexcept {
+            const __m256i alpha_mask = _mm256_setr_epi8(
+                6, 7, 6, 7, 6, 7, -1, -1, 14, 15, 14, 15, 14, 15, -1, -1,
+                6, 7, 6, 7, 6, 7, -1, -1, 14, 15, 14, 15, 14, 15, -1, -1);
+            const __m256i alpha_one = _mm256_setr_epi16(0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0, 255);
+            const __m256i zero = _mm256_setzero_si256();
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8) {
+                // unpack and pack both work within 128-bit lanes, so the pixel order survives the round trip
+                const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i * 4));
+                const __m256i lo = _mm256_unpacklo_epi8(v, zero);
+                const __m256i hi = _mm256_unpackhi_epi8(v, zero);
+                const __m256i alpha_lo = _mm256_or_si256(_mm256_shuffle_epi8(lo, alpha_mask), alpha_one);
+                const __m256i alpha_hi = _mm256_or_si256(_mm256_shuffle_epi8(hi, alpha_mask), alpha_one);
+                const __m256i result = _mm256_packus_epi16(mulDiv255(lo, alpha_lo), mulDiv255(hi, alpha_hi));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(p + i * 4), result);
+            }
+            sse4::premultiplyAlpha(p + i * 4, count - i);
+        }
+
+        CORE_TARGET("avx2,f16c")
+        void premultiplyAlpha(Vector4F* const p, const size_t count) noexcept {
+            auto* const f = reinterpret_cast<float*>(p);
+            size_t i = 0;
+            for (; i + 2 <= count; i += 2) {
+                const __m256 v = _mm256_loadu_ps(f + i * 4);
+                const __m256 a = _mm256_permute_ps(v, _MM_SHUFFLE(3, 3, 3, 3));
+                _mm256_storeu_ps(f + i * 4, _mm256_blend_ps(_mm256_mul_ps(v, a), v, 0x88));
+            }
+            sse4::premultiplyAlpha(p + i, count - i);
+        }
+
+        CORE_TARGET("avx2,f16c")
+        void convertUnorm8ToFloat(const uint8_t* const s, Vector4F* const d, const size_t count, const bool bgra, const bool srgb) noexcept {
+            const __m256 scale = _mm256_set1_ps(1.0f / 255.0f);
+            const float* const table = getSrgbDecodeTable().data();
+            auto* const f = reinterpret_cast<float*>(d);
+            size_t i = 0;
+            for (; i + 2 <= count; i += 2) {
+                const __m256i c = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(s + i * 4)));
+                __m256 v = _mm256_mul_ps(_mm256_cvtepi32_ps(c), scale);
+                if (srgb) {
+                    // Color channels come from the table, alpha stays linear
+                    v = _mm256_blend_ps(_mm256_i32gather_ps(table, c, 4), v, 0x88);
+                }
+                if (bgra) {
+                    v = _mm256_permute_ps(v, _MM_SHUFFLE(3, 0, 1, 2));
+                }
+                _mm256_storeu_ps(f + i * 4, v);
+            }
+            if (srgb) {
+                scalar::convertUnorm8ToFloat(s + i * 4, d + i, count - i, bgra, true);
+            }
+            else {
+                sse4::convertUnorm8ToFloat(s + i * 4, d + i, count - i, bgra);
+            }
+        }
+
+        CORE_TARGET("avx2,f16c")
+        inline __m256i convertFloatToInt(const float* const f, const bool bgra) noexcept {
+            __m256 v = _mm256_loadu_ps(f);
+            if (bgra) {
+                v = _mm256_permute_ps(v, _MM_SHUFFLE(3, 0, 1, 2));
+            }
+            v = _mm256_min_ps(_mm256_max_ps(v, _mm256_setzero_ps()), _mm256_set1_ps(1.0f)); // NaN -> 0
+            return _mm256_cvtps_epi32(_mm256_mul_ps(v, _mm256_set1_ps(255.0f)));
+        }
+
+        CORE_TARGET("avx2,f16c")
+        void convertFloatToUnorm8(const Vector4F* const s, uint8_t* const d, const size_t count, const bool bgra) noexcept {
+            const auto* const f = reinterpret_cast<const float*>(s);
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8) {
+                // Every load holds one pixel per 128-bit lane and packs work within lanes,
+                // so the packed pixels end up as 0 2 4 6 | 1 3 5 7, the permute restores the order
+                const __m256i a = _mm256_packus_epi32(convertFloatToInt(f + i * 4 + 0, bgra), convertFloatToInt(f + i * 4 + 8, bgra));
+                const __m256i b = _mm256_packus_epi32(convertFloatToInt(f + i * 4 + 16, bgra), convertFloatToInt(f + i * 4 + 24, bgra));
+                const __m256i packed = _mm256_packus_epi16(a, b);
+                const __m256i ordered = _mm256_permutevar8x32_epi32(packed, _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(d + i * 4), ordered);
+            }
+            sse4::convertFloatToUnorm8(s + i, d + i * 4, count - i, bgra);
+        }
+
+        CORE_TARGET("avx2,f16c")
+        void convertFloatToHalf(const Vector4F* const s, uint16_t* const d, const size_t count) noexcept {
+            const auto* const f = reinterpret_cast<const float*>(s);
+            size_t i = 0;
+            for (; i + 2 <= count; i += 2) {
+                const __m128i h = _mm256_cvtps_ph(_mm256_loadu_ps(f + i * 4), _MM_FROUND_TO_NEAREST_INT);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(d + i * 4), h);
+            }
+            scalar::convertFloatToHalf(s + i, d + i * 4, count - i);
+        }
+
+        CORE_TARGET("avx2,f16c")
+        void convertHalfToFloat(const uint16_t* const s, Vector4F* const d, const size_t count) noexcept {
+            auto* const f = reinterpret_cast<float*>(d);
+            size_t i = 0;
+            for (; i + 2 <= count; i += 2) {
+                const __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i * 4));
+                _mm256_storeu_ps(f + i * 4, _mm256_cvtph_ps(h));
+            }
+            scalar::convertHalfToFloat(s + i * 4, d + i, count - i);
+        }
+    }
+#endif // CORE_PIXEL_CONVERSION_X86
+
+#ifdef CORE_PIXEL_CONVERSION_NEON
+    namespace neon {
+        void swapRedBlue(uint8_t* const p, const size_t count) noexcept {
+            size_t i = 0;
+            for (; i + 16 <= count; i += 16) {
+                uint8x16x4_t v = vld4q_u8(p + i * 4);
+                const uint8x16_t t = v.val[0];
+                v.val[0] = v.val[2];
+                v.val[2] = t;
+                vst4q_u8(p + i * 4, v);
+            }
+            scalar::swapRedBlue(p + i * 4, count - i);
+        }
+
+        inline uint8x16_t mulDiv255(const uint8x16_t c, const uint8x16_t a) noexcept {
+            // (t + ((t + 128) >> 8) + 128) >> 8, same as the scalar version
+            const uint16x8_t lo = vmull_u8(vget_low_u8(c), vget_low_u8(a));
+            const uint16x8_t hi = vmull_high_u8(c, a);
+            return vcombine_u8(vrshrn_n_u16(vrsraq_n_u16(lo, lo, 8), 8), vrshrn_n_u16(vrsraq_n_u16(hi, hi, 8), 8));
+        }
+
+        void premultiplyAlpha(uint8_t* const p, const size_t count) noexcept {
+            size_t i = 0;
+            for (; i + 16 <= count; i += 16) {
+                uint8x16x4_t v = vld4q_u8(p + i * 4);
+                v.val[0] = mulDiv255(v.val[0], v.val[3]);
+                v.val[1] = mulDiv255(v.val[1], v.val[3]);
+                v.val[2] = mulDiv255(v.val[2], v.val[3]);
+                vst4q_u8(p + i * 4, v);
+            }
+            scalar::premultiplyAlpha(p + i * 4, count - i);
+        }
+
+        void premultiplyAlpha(Vector4F* const p, const size_t count) noexcept {
+            auto* const f = reinterpret_cast<float*>(p);
+            for (size_t i = 0; i < count; i += 1) {
+                const float32x4_t v = vld1q_f32(f + i * 4);
+                const float32x4_t r = vmulq_f32(v, vdupq_laneq_f32(v, 3));
+                vst1q_f32(f + i * 4, vcopyq_laneq_f32(r, 3, v, 3));
+            }
+        }
+
+        void convertUnorm8ToFloat(const uint8_t* const s, Vector4F* const d, const size_t count, const bool bgra) noexcept {
+            static constexpr uint8_t swap_table[16]{ 2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15 };
+            const uint8x16_t swap = vld1q_u8(swap_table);
+            const float32x4_t scale = vdupq_n_f32(1.0f / 255.0f);
+            auto* const f = reinterpret_cast<float*>(d);
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4) {
+                uint8x16_t v = vld1q_u8(s + i * 4);
+                if (bgra) {
+                    v = vqtbl1q_u8(v, swap);
+                }
+                const uint16x8_t lo = vmovl_u8(vget_low_u8(v));
+                const uint16x8_t hi = vmovl_high_u8(v);
+                vst1q_f32(f + i * 4 + 0, vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(lo))), scale));
+                vst1q_f32(f + i * 4 + 4, vmulq_f32(vcvtq_f32_u32(vmovl_high_u16(lo)), scale));
+                vst1q_f32(f + i * 4 + 8, vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(hi))), scale));
+                vst1q_f32(f + i * 4 + 12, vmulq_f32(vcvtq_f32_u32(vmovl_high_u16(hi)), scale));
+            }
+            scalar::convertUnorm8ToFloat(s + i * 4, d + i, count - i, bgra, false);
+        }
+
+        inline uint32x4_t convertFloatToInt(const float* const f) noexcept {
+            float32x4_t v = vld1q_f32(f);
+            v = vminq_f32(vmaxnmq_f32(v, vdupq_n_f32(0.0f)), vdupq_n_f32(1.0f)); // NaN -> 0
+            return vcvtnq_u32_f32(vmulq_f32(v, vdupq_n_f32(255.0f)));
+        }
+
+        void convertFloatToUnorm8(const Vector4F* const s, uint8_t* const d, const size_t count, const bool bgra) noexcept {
+            static constexpr uint8_t swap_table[16]{ 2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15 };
+            const uint8x16_t swap = vld1q_u8(swap_table);
+            const auto* const f = reinterpret_cast<const float*>(s);
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4) {
+                const uint16x8_t lo = vcombine_u16(vmovn_u32(convertFloatToInt(f + i * 4 + 0)), vmovn_u32(convertFloatToInt(f + i * 4 + 4)));
+                const uint16x8_t hi = vcombine_u16(vmovn_u32(convertFloatToInt(f + i * 4 + 8)), vmovn_u32(convertFloatToInt(f + i * 4 + 12)));
+                uint8x16_t v = vcombine_u8(vmovn_u16(lo), vmovn_u16(hi));
+                if (bgra) {
+                    v = vqtbl1q_u8(v, swap);
+                }
+                vst1q_u8(d + i * 4, v);
+            }
+            scalar::convertFloatToUnorm8(s + i, d + i * 4, count - i, bgra, false);
+        }
+
+        void convertFloatToHalf(const Vector4F* const s, uint16_t* const d, const size_t count) noexcept {
+            const auto* const f = reinterpret_cast<const float*>(s);
+            for (size_t i = 0; i < count; i += 1) {
+                vst1_u16(d + i * 4, vreinterpret_u16_f16(vcvt_f16_f32(vld1q_f32(f + i * 4))));
+            }
+        }
+
+        void convertHalfToFloat(const uint16_t* const s, Vector4F* const d, const size_t count) noexcept {
+            auto* const f = reinterpret_cast<float*>(d);
+            for (size_t i = 0; i < count; i += 1) {
+                vst1q_f32(f + i * 4, vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(s + i * 4))));
+            }
+        }
+    }
+#endif // CORE_PIXEL_CONVERSION_NEON
+
+    PixelConversionInstructionSet detectInstructionSet() noexcept {
+    #if defined(CORE_PIXEL_CONVERSION_X86)
+        bool sse41{}, avx{}, osxsave{}, f16c{}, avx2{};
+    #if defined(_MSC_VER)
+        int info[4]{};
+        __cpuid(info, 0);
+        const int max_leaf = info[0];
+        __cpuid(info, 1);
+        sse41 = (info[2] & (1 << 19)) != 0;
+        osxsave = (info[2] & (1 << 27)) != 0;
+        avx = (info[2] & (1 << 28)) != 0;
+        f16c = (info[2] & (1 << 29)) != 0;
+        if (max_leaf >= 7) {
+            __cpuidex(info, 7, 0);
+            avx2 = (info[1] & (1 << 5)) != 0;
+        }
+        // The OS must save the YMM registers too
+        const bool ymm = osxsave && avx && (_xgetbv(0) & 0x6) == 0x6;
+    #else
+        unsigned int eax{}, ebx{}, ecx{}, edx{};
+        if (__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+            sse41 = (ecx & bit_SSE4_1) != 0;
+            osxsave = (ecx & bit_OSXSAVE) != 0;
+            avx = (ecx & bit_AVX) != 0;
+            f16c = (ecx & bit_F16C) != 0;
+        }
+        if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) {
+            avx2 = (ebx & bit_AVX2) != 0;
+        }
+        const bool ymm = osxsave && avx && __builtin_cpu_supports("avx");
+    #endif
+        if (ymm && avx2 && f16c && sse41) {
+            return PixelConversionInstructionSet::avx2;
+        }
+        if (sse41) {
+            return PixelConversionInstructionSet::sse4;
+        }
+        return PixelConversionInstructionSet::scalar;
+    #elif defined(CORE_PIXEL_CONVERSION_NEON)
+        return PixelConversionInstructionSet::neon;
+    #else
+        return PixelConversionInstructionSet::scalar;
+    #endif
+    }
+
+    std::atomic<PixelConversionInstructionSet>& getInstructionSetState() noexcept {
+        static std::atomic<PixelConversionInstructionSet> state{ core::PixelConversion::getSupportedInstructionSet() };
+        return state;
+    }
+
+    bool isSupported(const PixelConversionInstructionSet instruction_set) noexcept {
+        const auto supported = core::PixelConversion::getSupportedInstructionSet();
+        switch (instruction_set) {
+            case PixelConversionInstructionSet::scalar:
+                return true;
+            case PixelConversionInstructionSet::sse4:
+                return supported == PixelConversionInstructionSet::sse4 || supported == PixelConversionInstructionSet::avx2;
+            case PixelConversionInstructionSet::avx2:
+            case PixelConversionInstructionSet::neon:
+                return supported == instruction_set;
+            default:
+                return false;
+        }
+    }
+}
+
+namespace core {
+    PixelConversionInstructionSet PixelConversion::getSupportedInstructionSet() noexcept {
+        static const PixelConversionInstructionSet supported = detectInstructionSet();
+        return supported;
+    }
+    PixelConversionInstructionSet PixelConversion::getInstructionSet() noexcept {
+        return getInstructionSetState().load(std::memory_order_relaxed);
+    }
+    bool PixelConversion::setInstructionSet(const PixelConversionInstructionSet instruction_set) noexcept {
+        if (!isSupported(instruction_set)) {
+            return false;
+        }
+        getInstructionSetState().store(instruction_set, std::memory_order_relaxed);
+        return true;
+    }
+
+    void PixelConversion::swapRedBlue(void* const pixels, const size_t count) noexcept {
+        auto* const p = static_cast<uint8_t*>(pixels);
+        switch (getInstructionSet()) {
+        #ifdef CORE_PIXEL_CONVERSION_X86
+            case PixelConversionInstructionSet::avx2: avx2::swapRedBlue(p, count); return;
+            case PixelConversionInstructionSet::sse4: sse4::swapRedBlue(p, count); return;
+        #endif
+        #ifdef CORE_PIXEL_CONVERSION_NEON
+            case PixelConversionInstructionSet::neon: neon::swapRedBlue(p, count); return;
+        #endif
+            default: scalar::swapRedBlue(p, count); return;
+        }
+    }
+    void PixelConversion::premultiplyAlpha(void* const pixels, const size_t count) noexcept {
+        auto* const p = static_cast<uint8_t*>(pixels);
+        switch (getInstructionSet()) {
+        #ifdef CORE_PIXEL_CONVERSION_X86
+            case PixelConversionInstructionSet::avx2: avx2::premultiplyAlpha(p, count); return;
+            case PixelConversionInstructionSet::sse4: sse4::premultiplyAlpha(p, count); return;
+        #endif
+        #ifdef CORE_PIXEL_CONVERSION_NEON
+            case PixelConversionInstructionSet::neon: neon::premultiplyAlpha(p, count); return;
+        #endif
+            default: scalar::premultiplyAlpha(p, count); return;
+        }
+    }
+    void PixelConversion::premultiplyAlpha(Vector4F* const pixels, const size_t count) noexcept {
+        switch (getInstructionSet()) {
+        #ifdef CORE_PIXEL_CONVERSION_X86
+            case PixelConversionInstructionSet::avx2: avx2::premultiplyAlpha(pixels, count); return;
+            case PixelConversionInstructionSet::sse4: sse4::premultiplyAlpha(pixels, count); return;
+        #endif
+        #ifdef CORE_PIXEL_CONVERSION_NEON
+            case PixelConversionInstructionSet::neon: neon::premultiplyAlpha(pixels, count); return;
+        #endif
+            default: scalar::premultiplyAlpha(pixels, count); return;
+        }
+    }
+    void PixelConversion::convertUnorm8ToFloat(const void* const source, Vector4F* const destination, const size_t count, const bool bgra, const bool srgb) noexcept {
+        const auto* const s = static_cast<const uint8_t*>(source);
+        switch (getInstructionSet()) {
+        #ifdef CORE_PIXEL_CONVERSION_X86
+            case PixelConversionInstructionSet::avx2: avx2::convertUnorm8ToFloat(s, destination, count, bgra, srgb); return;
+            case PixelConversionInstructionSet::sse4:
+                if (!srgb) { sse4::convertUnorm8ToFloat(s, destination, count, bgra); return; }
+                break;
+        #endif
+        #ifdef CORE_PIXEL_CONVERSION_NEON
+            case PixelConversionInstructionSet::neon:
+                if (!srgb) { neon::convertUnorm8ToFloat(s, destination, count, bgra); return; }
+                break;
+        #endif
+            default: break;
+        }
+        scalar::convertUnorm8ToFloat(s, destination, count, bgra, srgb);
+    }
+    void PixelConversion::convertFloatToUnorm8(const Vector4F* const source, void* const destination, const size_t count, const bool bgra, const bool srgb) noexcept {
+        auto* const d = static_cast<uint8_t*>(destination);
+        if (!srgb) {
+            switch (getInstructionSet()) {
+            #ifdef CORE_PIXEL_CONVERSION_X86
+                case PixelConversionInstructionSet::avx2: avx2::convertFloatToUnorm8(source, d, count, bgra); return;
+                case PixelConversionInstructionSet::sse4: sse4::convertFloatToUnorm8(source, d, count, bgra); return;
+            #endif
+            #ifdef CORE_PIXEL_CONVERSION_NEON
+                case PixelConversionInstructionSet::neon: neon::convertFloatToUnorm8(source, d, count, bgra); return;
+            #endif
+                default: break;
+            }
+        }
+        // sRGB encoding is a table lookup per channel, there is nothing to gain from SIMD
+        scalar::convertFloatToUnorm8(source, d, count, bgra, srgb);
+    }
+    void PixelConversion::convertFloatToHalf(const Vector4F* const source, void* const destination, const size_t count) noexcept {
+        auto* const d = static_cast<uint16_t*>(destination);
+        switch (getInstructionSet()) {
+        #ifdef CORE_PIXEL_CONVERSION_X86
+            case PixelConversionInstructionSet::avx2: avx2::convertFloatToHalf(source, d, count); return;
+        #endif
+        #ifdef CORE_PIXEL_CONVERSION_NEON
+            case PixelConversionInstructionSet::neon: neon::convertFloatToHalf(source, d, count); return;
+        #endif
+            default: scalar::convertFloatToHalf(source, d, count); return;
+        }
+    }
+    void PixelConversion::convertHalfToFloat(const void* const source, Vector4F* const destination, const size_t count) noexcept {
+        const auto* const s = static_cast<const uint16_t*>(source);
+        switch (getInstructionSet()) {
+        #ifdef CORE_PIXEL_CONVERSION_X86
+            case PixelConversionInstructionSet::avx2: avx2::convertHalfToFloat(s, destination, count); return;
+        #endif
+        #ifdef CORE_PIXEL_CONVERSION_NEON
+            case PixelConversionInstructionSet::neon: neon::convertHalfToFloat(s, destination, count); return;
+        #endif
+            default: scalar::convertHalfToFloat(s, destination, count); return;
+        }
+    }
+    void PixelConversion::convertSrgbToLinear(Vector4F* const pixels, const size_t count) noexcept {
+        // pow per channel, there is nothing to gain from SIMD
+        scalar::convertSrgbToLinear(pixels, count);
+    }
+    void PixelConversion::convertLinearToSrgb(Vector4F* const pixels, const size_t count) noexcept {
+        scalar::convertLinearToSrgb(pixels, count);
+    }
+}
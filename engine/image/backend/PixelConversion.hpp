@@ -0,0 +1,57 @@
+#pragma once
+#include "core/Vector4.hpp"
+#include <cstddef>
+#include <cstdint>
+
+namespace core {
+    enum class PixelConversionInstructionSet : int32_t {
+        scalar,
+        sse4,  // SSE4.1
+        avx2,  // AVX2 + F16C
+        neon,  // AArch64 NEON
+    };
+
+    // Bulk pixel conversion kernels.
+    // Every kernel has a scalar implementation and produces bit-identical results on every instruction set.
+    // 8-bit pixels are 4 bytes with alpha as the 4th byte, which holds for both r8g8b8a8 and b8g8r8a8.
+    // Float pixels are always (r, g, b, a).
+    class PixelConversion {
+    public:
+        // Best instruction set supported by the current CPU.
+        static PixelConversionInstructionSet getSupportedInstructionSet() noexcept;
+
+        // Instruction set used by the kernels, the best supported one by default.
+        static PixelConversionInstructionSet getInstructionSet() noexcept;
+
+        // Override the instruction set, for tests and benchmarks.
+        // Returns false and changes nothing if the CPU does not support it.
+        static bool setInstructionSet(PixelConversionInstructionSet instruction_set) noexcept;
+
+        // Swap the 1st and the 3rd byte of every pixel, r8g8b8a8 <-> b8g8r8a8.
+        static void swapRedBlue(void* pixels, size_t count) noexcept;
+
+        // Straight alpha to premultiplied alpha, 8-bit pixels, rounded to nearest.
+        static void premultiplyAlpha(void* pixels, size_t count) noexcept;
+
+        // Straight alpha to premultiplied alpha, float pixels.
+        static void premultiplyAlpha(Vector4F* pixels, size_t count) noexcept;
+
+        // 8-bit to float, bgra selects b8g8r8a8 input, srgb decodes the color channels to linear.
+        static void convertUnorm8ToFloat(const void* source, Vector4F* destination, size_t count, bool bgra, bool srgb) noexcept;
+
+        // Float to 8-bit (clamped, rounded to nearest), bgra selects b8g8r8a8 output, srgb encodes the color channels.
+        static void convertFloatToUnorm8(const Vector4F* source, void* destination, size_t count, bool bgra, bool srgb) noexcept;
+
+        // Float to r16g16b16a16_float, rounded to nearest even.
+        static void convertFloatToHalf(const Vector4F* source, void* destination, size_t count) noexcept;
+
+        // r16g16b16a16_float to float.
+        static void convertHalfToFloat(const void* source, Vector4F* destination, size_t count) noexcept;
+
+        // Decode the color channels of float pixels from sRGB to linear in place, alpha is unchanged.
+        static void convertSrgbToLinear(Vector4F* pixels, size_t count) noexcept;
+
+        // Encode the color channels of float pixels from linear to sRGB in place, alpha is unchanged.
+        static void convertLinearToSrgb(Vector4F* pixels, size_t count) noexcept;
+    };
+}
@@ -107,6 +107,18 @@ namespace core {
         // Sets the image to read-only state.
         virtual void setReadOnly() noexcept = 0;
 
+        // vvvvvvvvvv Bulk operations vvvvvvvvvv
+
+        // Convert straight alpha to premultiplied alpha in place, using SIMD where available.
+        // 8-bit sRGB images are premultiplied in sRGB space, as GPUs expect for texture filtering.
+        // Does nothing if the image is already premultiplied or opaque.
+        virtual bool premultiplyAlpha() noexcept = 0;
+
+        // Create a copy of the image converted to another format and color-space, using SIMD where available.
+        // The alpha mode is preserved. Converting between sRGB and linear color-space decodes/encodes the color channels.
+        // Much faster than converting with getPixel/setPixel.
+        virtual bool convert(ImageFormat format, ImageColorSpace color_space, IImage** output_image) const noexcept = 0;
+
         // vvvvvvvvvv Helper functions vvvvvvvvvv
 
         // Map image to read/write (scoped ver).
@@ -0,0 +1,128 @@
+#include "core/SmartReference.hpp"
+#include "core/Image.hpp"
+#include "backend/PixelConversion.hpp"
+#include "spdlog/spdlog.h"
+#include "spdlog/sinks/stdout_color_sinks.h"
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Pixel conversion throughput over the test assets, run from the test directory.
+// Every kernel runs on every instruction set supported by the CPU, scalar first as the baseline.
+
+namespace {
+    using std::string_literals::operator ""s;
+    using std::string_view_literals::operator ""sv;
+
+    constexpr std::string_view assets[]{
+        "assets/test_color.png"sv,
+        "assets/test_color_1.png"sv,
+        "assets/test_text.png"sv,
+        "assets/test_color.jpg"sv,
+        "assets/test_text.jpg"sv,
+        "assets/test_color_lossless.webp"sv,
+        "assets/test_text_lossless.webp"sv,
+    };
+
+    constexpr std::pair<core::PixelConversionInstructionSet, std::string_view> instruction_sets[]{
+        { core::PixelConversionInstructionSet::scalar, "scalar"sv },
+        { core::PixelConversionInstructionSet::sse4, "sse4"sv },
+        { core::PixelConversionInstructionSet::avx2, "avx2"sv },
+        { core::PixelConversionInstructionSet::neon, "neon"sv },
+    };
+
+    // Megapixels per second, repeats the kernel for at least 100 ms
+    double measure(const size_t pixel_count, const std::function<void()>& kernel) {
+        using clock = std::chrono::steady_clock;
+        kernel(); // warm up caches and lazy tables
+        size_t iterations = 0;
+        const auto start = clock::now();
+        auto elapsed = clock::duration{};
+        do {
+            kernel();
+            iterations += 1;
+            elapsed = clock::now() - start;
+        } while (elapsed < std::chrono::milliseconds(100));
+        const double seconds = std::chrono::duration<double>(elapsed).count();
+        return static_cast<double>(pixel_count) * static_cast<double>(iterations) / seconds / 1.0e6;
+    }
+
+    struct Kernel {
+        std::string_view name;
+        std::function<void()> run;
+    };
+}
+
+int main() {
+    using namespace core;
+    spdlog::set_default_logger(spdlog::stdout_color_mt("benchmark"s));
+
+    // All assets in one buffer, so small images don't measure call overhead
+    std::vector<uint8_t> unorm8;
+    for (const auto path : assets) {
+        SmartReference<IImage> image;
+        if (!ImageFactory::createFromFile(path, image.put())) {
+            std::printf("skipped %.*s\n", static_cast<int>(path.size()), path.data());
+            continue;
+        }
+        SmartReference<IImage> rgba;
+        if (!image->convert(ImageFormat::r8g8b8a8_normalized, ImageColorSpace::srgb_gamma_2_2, rgba.put())) {
+            continue;
+        }
+        ScopedImageMappedBuffer buffer{};
+        if (rgba->createScopedMap(buffer)) {
+            unorm8.insert(unorm8.end(), static_cast<uint8_t*>(buffer.data), static_cast<uint8_t*>(buffer.data) + buffer.size);
+        }
+    }
+    const size_t count = unorm8.size() / 4;
+    if (count == 0) {
+        std::printf("no assets loaded, run from the test directory\n");
+        return 1;
+    }
+
+    std::vector<uint8_t> work8(unorm8.size());
+    std::vector<Vector4F> floats(count);
+    std::vector<Vector4F> work_floats(count);
+    std::vector<uint16_t> halfs(count * 4);
+    PixelConversion::convertUnorm8ToFloat(unorm8.data(), floats.data(), count, false, true);
+    PixelConversion::convertFloatToHalf(floats.data(), halfs.data(), count);
+
+    const Kernel kernels[]{
+        { "swapRedBlue"sv, [&] { work8 = unorm8; PixelConversion::swapRedBlue(work8.data(), count); } },
+        { "premultiplyAlpha (8-bit)"sv, [&] { work8 = unorm8; PixelConversion::premultiplyAlpha(work8.data(), count); } },
+        { "premultiplyAlpha (float)"sv, [&] { work_floats = floats; PixelConversion::premultiplyAlpha(work_floats.data(), count); } },
+        { "rgba8 -> float"sv, [&] { PixelConversion::convertUnorm8ToFloat(unorm8.data(), work_floats.data(), count, false, false); } },
+        { "bgra8 -> float"sv, [&] { PixelConversion::convertUnorm8ToFloat(unorm8.data(), work_floats.data(), count, true, false); } },
+        { "rgba8 sRGB -> float linear"sv, [&] { PixelConversion::convertUnorm8ToFloat(unorm8.data(), work_floats.data(), count, false, true); } },
+        { "float -> rgba8"sv, [&] { PixelConversion::convertFloatToUnorm8(floats.data(), work8.data(), count, false, false); } },
+        { "float linear -> rgba8 sRGB"sv, [&] { PixelConversion::convertFloatToUnorm8(floats.data(), work8.data(), count, false, true); } },
+        { "float -> half"sv, [&] { PixelConversion::convertFloatToHalf(floats.data(), halfs.data(), count); } },
+        { "half -> float"sv, [&] { PixelConversion::convertHalfToFloat(halfs.data(), work_floats.data(), count); } },
+    };
+
+    std::printf("%zu pixels, MPixel/s\n", count);
+    std::printf("%-28s", "");
+    for (const auto& [instruction_set, name] : instruction_sets) {
+        if (PixelConversion::setInstructionSet(instruction_set)) {
+            std::printf("%10.*s", static_cast<int>(name.size()), name.data());
+        }
+    }
+    std::printf("\n");
+
+    const auto supported = PixelConversion::getSupportedInstructionSet();
+    for (const auto& kernel : kernels) {
+        std::printf("%-28.*s", static_cast<int>(kernel.name.size()), kernel.name.data());
+        for (const auto& [instruction_set, name] : instruction_sets) {
+            if (PixelConversion::setInstructionSet(instruction_set)) {
+                std::printf("%10.1f", measure(count, kernel.run));
+            }
+        }
+        std::printf("\n");
+    }
+    PixelConversion::setInstructionSet(supported);
+    return 0;
+}
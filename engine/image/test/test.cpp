@@ -2,6 +2,7 @@
 #include "core/SmartReference.hpp"
 #include "core/FileSystem.hpp"
 #include "core/Image.hpp"
+#include "backend/PixelConversion.hpp"
 #ifdef LUASTG_IMAGE_JPEG_ENABLE
 #include "backend/JpegImageFactory.hpp"
 #endif
@@ -22,6 +23,10 @@
 #include "spdlog/sinks/stdout_color_sinks.h"
 #include "gtest/gtest.h"
 #include <DirectXPackedVector.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
 
 namespace {
     using std::string_literals::operator ""s;
@@ -294,6 +299,286 @@ TEST(ImageFactory, createFromMemory_jpeg) {
     const auto size = image->getSize();
     EXPECT_TRUE(size.x == 256u && size.y == 32u);
 }
+TEST(Image, premultiplyAlpha) {
+    setupLogger();
+    using namespace core;
+
+    ImageDescription description;
+    description.size.x = 1;
+    description.size.y = 1;
+    description.format = ImageFormat::r8g8b8a8_normalized;
+    description.color_space = ImageColorSpace::linear;
+    description.alpha_mode = ImageAlphaMode::straight;
+
+    SmartReference<IImage> image;
+    ASSERT_TRUE(ImageFactory::create(description, image.put()));
+
+    const uint8_t rgba[4]{ 255, 100, 1, 128 };
+    ImageMappedBuffer buffer{};
+    ASSERT_TRUE(image->map(buffer));
+    std::memcpy(buffer.data, rgba, sizeof(rgba));
+    image->unmap();
+
+    ASSERT_TRUE(image->premultiplyAlpha());
+    EXPECT_EQ(ImageAlphaMode::premultiplied, image->getAlphaMode());
+
+    ASSERT_TRUE(image->map(buffer));
+    const auto* const output = static_cast<const uint8_t*>(buffer.data);
+    EXPECT_EQ(128, output[0]);
+    EXPECT_EQ(50, output[1]);
+    EXPECT_EQ(1, output[2]);
+    EXPECT_EQ(128, output[3]);
+    image->unmap();
+
+    // Already premultiplied, nothing changes
+    ASSERT_TRUE(image->premultiplyAlpha());
+    ASSERT_TRUE(image->map(buffer));
+    EXPECT_EQ(128, static_cast<const uint8_t*>(buffer.data)[0]);
+    image->unmap();
+}
+TEST(Image, convert) {
+    setupLogger();
+    using namespace core;
+
+    SmartReference<IImage> image;
+    ASSERT_TRUE(ImageFactory::createFromFile("assets/test_color.png"sv, image.put()));
+
+    static constexpr ImageFormat formats[]{
+        ImageFormat::b8g8r8a8_normalized,
+        ImageFormat::r16g16b16a16_float,
+        ImageFormat::r32g32b32a32_float,
+    };
+    for (const auto format : formats) {
+        const auto color_space = (format == ImageFormat::b8g8r8a8_normalized) ? image->getColorSpace() : ImageColorSpace::linear;
+        SmartReference<IImage> converted;
+        ASSERT_TRUE(image->convert(format, color_space, converted.put()));
+        EXPECT_EQ(format, converted->getFormat());
+        EXPECT_EQ(image->getAlphaMode(), converted->getAlphaMode());
+
+        SmartReference<IImage> restored;
+        ASSERT_TRUE(converted->convert(image->getFormat(), image->getColorSpace(), restored.put()));
+
+        ScopedImageMappedBuffer a{};
+        ScopedImageMappedBuffer b{};
+        ASSERT_TRUE(image->createScopedMap(a));
+        ASSERT_TRUE(restored->createScopedMap(b));
+        ASSERT_EQ(a.size, b.size);
+        int max_difference = 0;
+        for (uint32_t i = 0; i < a.size; i += 1) {
+            const int difference = std::abs(static_cast<const uint8_t*>(a.data)[i] - static_cast<const uint8_t*>(b.data)[i]);
+            max_difference = std::max(max_difference, difference);
+        }
+        // sRGB round trips through a 12-bit table
+        EXPECT_LE(max_difference, 1);
+    }
+}
+TEST(Image, convert_color_space) {
+    setupLogger();
+    using namespace core;
+
+    ImageDescription description;
+    description.size.x = 4;
+    description.size.y = 1;
+    description.format = ImageFormat::r8g8b8a8_normalized;
+    description.color_space = ImageColorSpace::srgb_gamma_2_2;
+    description.alpha_mode = ImageAlphaMode::straight;
+
+    SmartReference<IImage> image;
+    ASSERT_TRUE(ImageFactory::create(description, image.put()));
+    const uint8_t rgba[16]{
+        0, 10, 64, 255,
+        128, 188, 200, 128,
+        255, 1, 32, 0,
+        90, 160, 250, 200,
+    };
+    {
+        ScopedImageMappedBuffer buffer{};
+        ASSERT_TRUE(image->createScopedMap(buffer));
+        std::memcpy(buffer.data, rgba, sizeof(rgba));
+    }
+    const auto decode = [](const uint8_t c) {
+        const double v = c / 255.0;
+        return static_cast<float>(v <= 0.04045 ? v / 12.92 : std::pow((v + 0.055) / 1.055, 2.4));
+    };
+
+    static constexpr ImageFormat float_formats[]{
+        ImageFormat::r16g16b16a16_float,
+        ImageFormat::r32g32b32a32_float,
+    };
+    for (const auto format : float_formats) {
+        // Float formats only store linear values
+        SmartReference<IImage> srgb;
+        EXPECT_FALSE(image->convert(format, ImageColorSpace::srgb_gamma_2_2, srgb.put()));
+
+        // sRGB -> linear decodes the color channels, alpha is unchanged
+        SmartReference<IImage> linear;
+        ASSERT_TRUE(image->convert(format, ImageColorSpace::linear, linear.put()));
+        const float tolerance = format == ImageFormat::r16g16b16a16_float ? 1.0f / 1024.0f : 1e-6f;
+        for (uint32_t x = 0; x < 4; x += 1) {
+            const auto pixel = linear->getPixel(x, 0);
+            const uint8_t* const c = rgba + x * 4;
+            EXPECT_NEAR(decode(c[0]), pixel.x, tolerance);
+            EXPECT_NEAR(decode(c[1]), pixel.y, tolerance);
+            EXPECT_NEAR(decode(c[2]), pixel.z, tolerance);
+            EXPECT_NEAR(c[3] / 255.0f, pixel.w, tolerance);
+        }
+
+        // linear -> sRGB encodes them again, exactly restoring the 8-bit values
+        for (const auto unorm8_format : { ImageFormat::r8g8b8a8_normalized, ImageFormat::b8g8r8a8_normalized }) {
+            SmartReference<IImage> restored;
+            ASSERT_TRUE(linear->convert(unorm8_format, ImageColorSpace::srgb_gamma_2_2, restored.put()));
+            ScopedImageMappedBuffer buffer{};
+            ASSERT_TRUE(restored->createScopedMap(buffer));
+            auto* const output = static_cast<const uint8_t*>(buffer.data);
+            const bool bgra = unorm8_format == ImageFormat::b8g8r8a8_normalized;
+            for (uint32_t x = 0; x < 4; x += 1) {
+                const uint8_t* const c = rgba + x * 4;
+                const uint8_t* const o = output + x * 4;
+                EXPECT_EQ(c[0], o[bgra ? 2 : 0]);
+                EXPECT_EQ(c[1], o[1]);
+                EXPECT_EQ(c[2], o[bgra ? 0 : 2]);
+                EXPECT_EQ(c[3], o[3]);
+            }
+        }
+
+        // linear -> linear 8-bit only quantizes
+        SmartReference<IImage> quantized;
+        ASSERT_TRUE(linear->convert(ImageFormat::r8g8b8a8_normalized, ImageColorSpace::linear, quantized.put()));
+        ScopedImageMappedBuffer buffer{};
+        ASSERT_TRUE(quantized->createScopedMap(buffer));
+        auto* const output = static_cast<const uint8_t*>(buffer.data);
+        for (uint32_t x = 0; x < 4; x += 1) {
+            const auto pixel = linear->getPixel(x, 0);
+            EXPECT_EQ(std::lround(pixel.x * 255.0f), output[x * 4 + 0]);
+            EXPECT_EQ(std::lround(pixel.y * 255.0f), output[x * 4 + 1]);
+            EXPECT_EQ(std::lround(pixel.z * 255.0f), output[x * 4 + 2]);
+        }
+    }
+}
+
+TEST(PixelConversion, same_result_on_every_instruction_set) {
+    setupLogger();
+    using namespace core;
+
+    // Odd count so every SIMD kernel runs its scalar tail too
+    constexpr size_t count = 1021;
+    std::vector<uint8_t> unorm8(count * 4);
+    std::vector<Vector4F> floats(count);
+    uint32_t seed = 1;
+    for (auto& v : unorm8) {
+        seed = seed * 1664525u + 1013904223u;
+        v = static_cast<uint8_t>(seed >> 24);
+    }
+    for (auto& v : floats) {
+        seed = seed * 1664525u + 1013904223u;
+        const float f = static_cast<float>(seed >> 8) / static_cast<float>(1 << 24) * 1.4f - 0.2f;
+        v = Vector4F(f, 1.0f - f, f * 0.5f, f * f);
+    }
+
+    const auto run = [&]() {
+        std::vector<uint8_t> result;
+        const auto append = [&result](const void* data, const size_t size) {
+            result.insert(result.end(), static_cast<const uint8_t*>(data), static_cast<const uint8_t*>(data) + size);
+        };
+        auto bytes = unorm8;
+        PixelConversion::swapRedBlue(bytes.data(), count);
+        append(bytes.data(), bytes.size());
+        bytes = unorm8;
+        PixelConversion::premultiplyAlpha(bytes.data(), count);
+        append(bytes.data(), bytes.size());
+        for (const bool bgra : { false, true }) {
+            for (const bool srgb : { false, true }) {
+                std::vector<Vector4F> f(count);
+                PixelConversion::convertUnorm8ToFloat(unorm8.data(), f.data(), count, bgra, srgb);
+                append(f.data(), f.size() * sizeof(Vector4F));
+                PixelConversion::convertFloatToUnorm8(floats.data(), bytes.data(), count, bgra, srgb);
+                append(bytes.data(), bytes.size());
+            }
+        }
+        auto f = floats;
+        PixelConversion::premultiplyAlpha(f.data(), count);
+        append(f.data(), f.size() * sizeof(Vector4F));
+        std::vector<uint16_t> half(count * 4);
+        PixelConversion::convertFloatToHalf(floats.data(), half.data(), count);
+        append(half.data(), half.size() * sizeof(uint16_t));
+        PixelConversion::convertHalfToFloat(half.data(), f.data(), count);
+        append(f.data(), f.size() * sizeof(Vector4F));
+        return result;
+    };
+
+    const auto supported = PixelConversion::getSupportedInstructionSet();
+    ASSERT_TRUE(PixelConversion::setInstructionSet(PixelConversionInstructionSet::scalar));
+    const auto expected = run();
+    for (const auto instruction_set : { PixelConversionInstructionSet::sse4, PixelConversionInstructionSet::avx2, PixelConversionInstructionSet::neon }) {
+        if (PixelConversion::setInstructionSet(instruction_set)) {
+            EXPECT_EQ(expected, run()) << "instruction set " << static_cast<int32_t>(instruction_set);
+        }
+    }
+    ASSERT_TRUE(PixelConversion::setInstructionSet(supported));
+}
+TEST(PixelConversion, float_srgb_transfer) {
+    setupLogger();
+    using namespace core;
+
+    std::vector<uint8_t> unorm8;
+    std::vector<Vector4F> encoded;
+    for (uint32_t c = 0; c < 256; c += 1) {
+        unorm8.insert(unorm8.end(), { static_cast<uint8_t>(c), static_cast<uint8_t>(255 - c), static_cast<uint8_t>(c / 2), static_cast<uint8_t>(c) });
+        encoded.emplace_back(c / 255.0f, (255 - c) / 255.0f, (c / 2) / 255.0f, c / 255.0f);
+    }
+    std::vector<Vector4F> expected(256);
+    PixelConversion::convertUnorm8ToFloat(unorm8.data(), expected.data(), 256, false, true);
+
+    // Matches the 8-bit decode table, alpha is unchanged
+    auto pixels = encoded;
+    PixelConversion::convertSrgbToLinear(pixels.data(), pixels.size());
+    for (size_t i = 0; i < pixels.size(); i += 1) {
+        EXPECT_NEAR(expected[i].x, pixels[i].x, 1e-6f);
+        EXPECT_NEAR(expected[i].y, pixels[i].y, 1e-6f);
+        EXPECT_NEAR(expected[i].z, pixels[i].z, 1e-6f);
+        EXPECT_EQ(encoded[i].w, pixels[i].w);
+    }
+
+    // Encoding is the inverse
+    PixelConversion::convertLinearToSrgb(pixels.data(), pixels.size());
+    for (size_t i = 0; i < pixels.size(); i += 1) {
+        EXPECT_NEAR(encoded[i].x, pixels[i].x, 1e-5f);
+        EXPECT_NEAR(encoded[i].y, pixels[i].y, 1e-5f);
+        EXPECT_NEAR(encoded[i].z, pixels[i].z, 1e-5f);
+        EXPECT_EQ(encoded[i].w, pixels[i].w);
+    }
+
+    // Out of range values are extended symmetrically instead of clamped
+    Vector4F extended(-0.5f, 2.0f, 0.0f, 1.0f);
+    PixelConversion::convertSrgbToLinear(&extended, 1);
+    EXPECT_LT(extended.x, 0.0f);
+    EXPECT_GT(extended.y, 2.0f);
+    PixelConversion::convertLinearToSrgb(&extended, 1);
+    EXPECT_NEAR(-0.5f, extended.x, 1e-5f);
+    EXPECT_NEAR(2.0f, extended.y, 1e-5f);
+}
+TEST(PixelConversion, premultiplyAlpha_is_exact) {
+    setupLogger();
+    using namespace core;
+
+    std::vector<uint8_t> pixels;
+    pixels.reserve(256 * 256 * 4);
+    for (uint32_t a = 0; a < 256; a += 1) {
+        for (uint32_t c = 0; c < 256; c += 1) {
+            pixels.insert(pixels.end(), { static_cast<uint8_t>(c), static_cast<uint8_t>(c), static_cast<uint8_t>(255 - c), static_cast<uint8_t>(a) });
+        }
+    }
+    PixelConversion::premultiplyAlpha(pixels.data(), 256 * 256);
+    for (uint32_t a = 0; a < 256; a += 1) {
+        for (uint32_t c = 0; c < 256; c += 1) {
+            const auto* const p = pixels.data() + (a * 256 + c) * 4;
+            ASSERT_EQ(std::lround(c * a / 255.0), p[0]);
+            ASSERT_EQ(std::lround((255 - c) * a / 255.0), p[2]);
+            ASSERT_EQ(a, p[3]);
+        }
+    }
+}
+
 TEST(ImageFactory, createFromMemory_wtf) {
     setupLogger();
     using namespace core;
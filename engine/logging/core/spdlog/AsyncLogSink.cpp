@@ -0,0 +1,309 @@
+#include "core/spdlog/AsyncLogSink.hpp"
+#include <algorithm>
+#include <bit>
+#include <exception>
+#include "spdlog/details/log_msg.h"
+#include "spdlog/details/os.h"
+#include "spdlog/fmt/fmt.h"
+
+namespace {
+	// 写入线程上产生的日志（例如子 sink 内部的错误）直接写入，避免等待自己
+	thread_local bool t_writer_thread{ false };
+}
+
+namespace core {
+	void AsyncLogSink::log(spdlog::details::log_msg const& msg) {
+		if (t_writer_thread || !m_running.load(std::memory_order_acquire)) {
+			write(msg);
+			return;
+		}
+		if (tryPush(msg)) {
+			wakeWriterIfIdle();
+			return;
+		}
+		if (m_overflow_policy == OverflowPolicy::drop) {
+			m_dropped.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+		// 队列已满，等待写入线程腾出空间
+		do {
+			wakeWriterIfIdle();
+			std::this_thread::yield();
+			if (!m_running.load(std::memory_order_acquire)) {
+				write(msg);
+				return;
+			}
+		} while (!tryPush(msg));
+		wakeWriterIfIdle();
+	}
+	void AsyncLogSink::flush() {
+		if (t_writer_thread || !m_running.load(std::memory_order_acquire)) {
+			flushSinks();
+			return;
+		}
+		std::unique_lock lock(m_mutex);
+		size_t const target = requestFlush();
+		m_flushed_cv.wait(lock, [this, target] { return isFlushed(target); });
+	}
+	void AsyncLogSink::set_pattern(std::string const& pattern) {
+		for (auto const& sink : m_sinks) {
+			sink->set_pattern(pattern);
+		}
+	}
+	void AsyncLogSink::set_formatter(std::unique_ptr<spdlog::formatter> sink_formatter) {
+		for (auto const& sink : m_sinks) {
+			sink->set_formatter(sink_formatter->clone());
+		}
+	}
+
+	bool AsyncLogSink::waitFlush(std::chrono::milliseconds const timeout) {
+		if (t_writer_thread || !m_running.load(std::memory_order_acquire)) {
+			flushSinks();
+			return true;
+		}
+		std::unique_lock lock(m_mutex);
+		size_t const target = requestFlush();
+		return m_flushed_cv.wait_for(lock, timeout, [this, target] { return isFlushed(target); });
+	}
+	void AsyncLogSink::shutdown() {
+		if (!m_thread.joinable()) {
+			return;
+		}
+		{
+			std::lock_guard lock(m_mutex);
+			m_stop = true;
+			m_wakeup = true;
+		}
+		m_wakeup_cv.notify_one();
+		m_thread.join();
+		{
+			std::lock_guard lock(m_mutex);
+			m_running.store(false, std::memory_order_release);
+		}
+		m_flushed_cv.notify_all();
+		// 写入线程退出前后才推入队列的消息
+		bool urgent{ false };
+		bool written{ false };
+		while (tryPop(urgent)) {
+			written = true;
+		}
+		if (written) {
+			flushSinks();
+		}
+	}
+
+	bool AsyncLogSink::tryPush(spdlog::details::log_msg const& msg) {
+		// 有界 MPSC 队列：每个槽位的序号表示它是否可写（等于 pos）或者可读（等于 pos + 1）
+		Slot* slot{};
+		size_t pos = m_enqueue_pos.load(std::memory_order_relaxed);
+		for (;;) {
+			slot = &m_slots[pos & m_mask];
+			size_t const sequence = slot->sequence.load(std::memory_order_acquire);
+			auto const diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+			if (diff == 0) {
+				if (m_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+					break;
+				}
+			}
+			else if (diff < 0) {
+				return false; // 队列已满
+			}
+			else {
+				pos = m_enqueue_pos.load(std::memory_order_relaxed);
+			}
+		}
+		slot->time = msg.time;
+		slot->thread_id = msg.thread_id;
+		slot->level = msg.level;
+		try {
+			slot->logger_name.assign(msg.logger_name.data(), msg.logger_name.size());
+			slot->payload.assign(msg.payload.data(), msg.payload.size());
+		}
+		catch (std::exception const&) {
+			// 槽位已经占用，必须发布，否则写入线程会永远停在这里
+			slot->payload.clear();
+		}
+		slot->sequence.store(pos + 1, std::memory_order_release);
+		return true;
+	}
+	bool AsyncLogSink::tryPop(bool& urgent) {
+		Slot& slot = m_slots[m_dequeue_pos & m_mask];
+		if (slot.sequence.load(std::memory_order_acquire) != m_dequeue_pos + 1) {
+			return false;
+		}
+		spdlog::details::log_msg msg(slot.time, spdlog::source_loc{}, slot.logger_name, slot.level, slot.payload);
+		msg.thread_id = slot.thread_id;
+		write(msg);
+		if (slot.level >= flush_level) {
+			urgent = true;
+		}
+		if (m_last_logger_name != slot.logger_name) {
+			m_last_logger_name = slot.logger_name;
+		}
+		slot.sequence.store(m_dequeue_pos + m_mask + 1, std::memory_order_release);
+		m_dequeue_pos += 1;
+		return true;
+	}
+	bool AsyncLogSink::isQueueEmpty() const noexcept {
+		return m_slots[m_dequeue_pos & m_mask].sequence.load(std::memory_order_acquire) != m_dequeue_pos + 1;
+	}
+	bool AsyncLogSink::isFlushPending() const noexcept {
+		return m_flush_target.load(std::memory_order_relaxed) > m_flushed_pos.load(std::memory_order_relaxed);
+	}
+	bool AsyncLogSink::isFlushed(size_t const target) const noexcept {
+		return m_flushed_pos.load(std::memory_order_acquire) >= target || !m_running.load(std::memory_order_acquire);
+	}
+	size_t AsyncLogSink::requestFlush() {
+		// 调用者持有 m_mutex
+		size_t const target = m_enqueue_pos.load(std::memory_order_acquire);
+		if (m_flush_target.load(std::memory_order_relaxed) < target) {
+			m_flush_target.store(target, std::memory_order_relaxed);
+		}
+		m_wakeup = true;
+		m_wakeup_cv.notify_one();
+		return target;
+	}
+	void AsyncLogSink::publishFlushed() {
+		if (m_flushed_pos.load(std::memory_order_relaxed) == m_dequeue_pos) {
+			return;
+		}
+		{
+			std::lock_guard lock(m_mutex);
+			m_flushed_pos.store(m_dequeue_pos, std::memory_order_release);
+		}
+		m_flushed_cv.notify_all();
+	}
+	void AsyncLogSink::wakeWriter() {
+		{
+			std::lock_guard lock(m_mutex);
+			m_wakeup = true;
+		}
+		m_wakeup_cv.notify_one();
+	}
+	void AsyncLogSink::wakeWriterIfIdle() {
+		// 和写入线程进入等待前的检查配对：要么写入线程看到新消息，要么这里看到写入线程空闲
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (m_idle.load(std::memory_order_relaxed)) {
+			wakeWriter();
+		}
+	}
+	void AsyncLogSink::write(spdlog::details::log_msg const& msg) {
+		for (auto const& sink : m_sinks) {
+			if (sink->should_log(msg.level)) {
+				try {
+					sink->log(msg);
+				}
+				catch (std::exception const&) {
+					// 写入线程上没有地方报告错误，忽略
+				}
+			}
+		}
+	}
+	void AsyncLogSink::flushSinks() {
+		for (auto const& sink : m_sinks) {
+			try {
+				sink->flush();
+			}
+			catch (std::exception const&) {
+				// 同上
+			}
+		}
+	}
+	void AsyncLogSink::reportDropped() {
+		uint64_t const dropped = m_dropped.load(std::memory_order_relaxed);
+		if (dropped == m_dropped_reported) {
+			return;
+		}
+		auto const message = fmt::format("[core] async logging queue is full, {} message(s) dropped", dropped - m_dropped_reported);
+		m_dropped_reported = dropped;
+		spdlog::details::log_msg const msg(spdlog::source_loc{}, m_last_logger_name, spdlog::level::warn, message);
+		write(msg);
+	}
+	void AsyncLogSink::run() {
+		t_writer_thread = true;
+		auto last_flush = std::chrono::steady_clock::now();
+		bool dirty{ false }; // 有写入但还没有刷新的消息
+		for (;;) {
+			bool urgent{ false };
+			while (tryPop(urgent)) {
+				dirty = true;
+			}
+			if (m_dropped.load(std::memory_order_relaxed) != m_dropped_reported) {
+				reportDropped();
+				dirty = true;
+				urgent = true;
+			}
+
+			auto const now = std::chrono::steady_clock::now();
+			if (dirty && (urgent || isFlushPending() || now - last_flush >= m_flush_interval)) {
+				flushSinks();
+				dirty = false;
+				last_flush = now;
+			}
+			if (!dirty) {
+				publishFlushed();
+			}
+
+			std::unique_lock lock(m_mutex);
+			if (m_stop) {
+				break;
+			}
+			m_idle.store(true, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if (!isQueueEmpty()) {
+				m_idle.store(false, std::memory_order_relaxed);
+				continue;
+			}
+			if (isFlushPending()) {
+				// 有生产者占用了槽位但还没有写完，稍后再看
+				m_idle.store(false, std::memory_order_relaxed);
+				lock.unlock();
+				std::this_thread::yield();
+				continue;
+			}
+			auto const timeout = dirty
+				? std::max<std::chrono::steady_clock::duration>(last_flush + m_flush_interval - now, std::chrono::steady_clock::duration::zero())
+				: std::chrono::steady_clock::duration(m_flush_interval);
+			m_wakeup_cv.wait_for(lock, timeout, [this] { return m_wakeup || m_stop; });
+			m_wakeup = false;
+			m_idle.store(false, std::memory_order_relaxed);
+		}
+
+		// 停止前写完队列中剩下的消息
+		bool urgent{ false };
+		while (tryPop(urgent)) {
+		}
+		reportDropped();
+		flushSinks();
+		publishFlushed();
+		t_writer_thread = false;
+	}
+
+	AsyncLogSink::AsyncLogSink(
+		std::vector<spdlog::sink_ptr> sinks,
+		size_t const queue_size,
+		OverflowPolicy const overflow_policy,
+		std::chrono::milliseconds const flush_interval
+	)
+		: m_sinks(std::move(sinks))
+		, m_flush_interval(std::max(flush_interval, std::chrono::milliseconds(1)))
+		, m_overflow_policy(overflow_policy) {
+		size_t const capacity = std::bit_ceil(std::clamp<size_t>(queue_size, 2, size_t{ 1 } << 20));
+		m_slots = std::make_unique<Slot[]>(capacity);
+		m_mask = capacity - 1;
+		for (size_t i = 0; i < capacity; i += 1) {
+			m_slots[i].sequence.store(i, std::memory_order_relaxed);
+		}
+		// 只接收至少一个子 sink 需要的消息
+		auto level = spdlog::level::off;
+		for (auto const& sink : m_sinks) {
+			level = std::min(level, sink->level());
+		}
+		set_level(level);
+		m_running.store(true, std::memory_order_release);
+		m_thread = std::thread(&AsyncLogSink::run, this);
+	}
+	AsyncLogSink::~AsyncLogSink() {
+		shutdown();
+	}
+}
@@ -0,0 +1,97 @@
+#pragma once
+#include <cstdint>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "spdlog/sinks/sink.h"
+
+namespace core {
+	// 异步日志 sink：日志线程只把消息复制进无锁的多生产者单消费者环形缓冲区，
+	// 由后台写入线程格式化并写入子 sink，批量刷新（定时，或者遇到 warn 及以上级别）
+	class AsyncLogSink final : public spdlog::sinks::sink {
+	public:
+		enum class OverflowPolicy {
+			block, // 队列满时等待写入线程腾出空间
+			drop, // 队列满时丢弃消息并计数，之后由写入线程报告丢弃的数量
+		};
+
+		static constexpr size_t default_queue_size{ 8192 };
+		static constexpr std::chrono::milliseconds default_flush_interval{ 1000 };
+		static constexpr spdlog::level::level_enum flush_level{ spdlog::level::warn };
+
+		void log(spdlog::details::log_msg const& msg) override;
+		// 等待之前的消息全部写入并刷新
+		void flush() override;
+		void set_pattern(std::string const& pattern) override;
+		void set_formatter(std::unique_ptr<spdlog::formatter> sink_formatter) override;
+
+		// 等待之前的消息全部写入并刷新，超时返回 false，用于崩溃时尽量保存日志
+		bool waitFlush(std::chrono::milliseconds timeout);
+		// 写完队列中的消息并停止写入线程，之后的消息直接同步写入子 sink
+		void shutdown();
+		[[nodiscard]] uint64_t getDroppedCount() const noexcept { return m_dropped.load(std::memory_order_relaxed); }
+
+		AsyncLogSink(
+			std::vector<spdlog::sink_ptr> sinks,
+			size_t queue_size = default_queue_size,
+			OverflowPolicy overflow_policy = OverflowPolicy::block,
+			std::chrono::milliseconds flush_interval = default_flush_interval
+		);
+		AsyncLogSink(AsyncLogSink const&) = delete;
+		AsyncLogSink(AsyncLogSink&&) = delete;
+		~AsyncLogSink() override;
+
+		AsyncLogSink& operator=(AsyncLogSink const&) = delete;
+		AsyncLogSink& operator=(AsyncLogSink&&) = delete;
+
+	private:
+		struct Slot {
+			std::atomic<size_t> sequence{};
+			spdlog::log_clock::time_point time;
+			size_t thread_id{};
+			spdlog::level::level_enum level{ spdlog::level::info };
+			std::string logger_name;
+			std::string payload; // 复用容量，稳定之后不再分配内存
+		};
+
+		bool tryPush(spdlog::details::log_msg const& msg);
+		bool tryPop(bool& urgent);
+		[[nodiscard]] bool isQueueEmpty() const noexcept;
+		[[nodiscard]] bool isFlushPending() const noexcept;
+		[[nodiscard]] bool isFlushed(size_t target) const noexcept;
+		size_t requestFlush();
+		void publishFlushed();
+		void wakeWriter();
+		void wakeWriterIfIdle();
+		void write(spdlog::details::log_msg const& msg);
+		void flushSinks();
+		void reportDropped();
+		void run();
+
+		std::vector<spdlog::sink_ptr> m_sinks;
+		std::unique_ptr<Slot[]> m_slots;
+		size_t m_mask{};
+		alignas(64) std::atomic<size_t> m_enqueue_pos{};
+		alignas(64) size_t m_dequeue_pos{}; // 只由写入线程（或者停止后的调用者）访问
+		std::atomic<size_t> m_flush_target{};
+		std::atomic<size_t> m_flushed_pos{};
+		std::atomic<uint64_t> m_dropped{};
+		uint64_t m_dropped_reported{};
+		std::string m_last_logger_name;
+		std::chrono::milliseconds m_flush_interval{ default_flush_interval };
+		OverflowPolicy m_overflow_policy{ OverflowPolicy::block };
+		std::atomic_bool m_running{};
+		std::atomic_bool m_idle{};
+		bool m_wakeup{};
+		bool m_stop{};
+		std::mutex m_mutex;
+		std::condition_variable m_wakeup_cv;
+		std::condition_variable m_flushed_cv;
+		std::thread m_thread;
+	};
+}
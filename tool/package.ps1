@@ -3,7 +3,13 @@ param(
     [string]$Toolchain = "vs2026-v143",
 
     [ValidateSet("zip", "dat")]
-    [string]$ArchiveFormat = "zip"
+    [string]$ArchiveFormat = "zip",
+
+    [ValidateSet("none", "auto", "bc1", "bc3", "bc7")]
+    [string]$TextureCompression = "none",
+
+    # Ship only the baked textures, the engine can no longer fall back to the sources
+    [switch]$RemoveTextureSources
 )
 
 $ProjectRoot = [System.IO.Path]::GetFullPath([System.IO.Path]::Join($PSScriptRoot, ".."))
@@ -23,6 +29,12 @@ Write-Output "Example Root       : $ExampleRoot"
 Write-Output "Package Name       : $PackageName"
 Write-Output "Executable Name    : $ExecutableName"
 Write-Output "Archive Format     : $ArchiveFormat"
+Write-Output "Texture Compression: $TextureCompression"
+Write-Output "Remove Tex Sources : $RemoveTextureSources"
+
+if ($RemoveTextureSources -and $TextureCompression -eq "bc7") {
+    throw "BC7 textures need the sources as a fallback below feature level 11, do not use -RemoveTextureSources with bc7"
+}
 
 # build
 
@@ -44,6 +56,13 @@ if ($ArchiveFormat -eq "dat") {
     }
 }
 
+if ($TextureCompression -ne "none") {
+    cmake --build $BuildRootAMD64 --config Release --target texture-compressor
+    if ($LASTEXITCODE -ne 0) {
+        throw "Failed to build texture-compressor"
+    }
+}
+
 # read version info
 
 $ConfigFilePath = [System.IO.Path]::Join($ProjectRoot, "LuaSTG", "LuaSTG", "LConfig.h")
@@ -156,6 +175,25 @@ if ([System.IO.File]::Exists($ReadmePath)) {
     [System.IO.File]::Copy($ReadmePath, [System.IO.Path]::Join($ReleaseRoot, "使用说明.txt"), $true)
 }
 
+# compress textures
+
+if ($TextureCompression -ne "none") {
+    $TextureCompressor = [System.IO.Path]::Join($BuildRootAMD64, "tool", "texture-compressor", "Release", "texture-compressor.exe")
+    if (-not [System.IO.File]::Exists($TextureCompressor)) {
+        throw "Cannot find texture-compressor.exe: $TextureCompressor"
+    }
+    $TextureCache = [System.IO.Path]::Join($ProjectRoot, "build", "texture-cache")
+    $TextureCompressorArgs = @("--input", $ReleaseAssets, "--format", $TextureCompression, "--cache", $TextureCache)
+    if (-not $RemoveTextureSources) {
+        # LoadTexture decodes the source when the device rejects the baked texture
+        $TextureCompressorArgs += "--keep-source"
+    }
+    & $TextureCompressor @TextureCompressorArgs
+    if ($LASTEXITCODE -ne 0) {
+        throw "Failed to compress textures"
+    }
+}
+
 # archive
 
 switch ($ArchiveFormat) {
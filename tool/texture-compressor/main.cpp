@@ -0,0 +1,465 @@
+#include <objbase.h>
+#include "DirectXTex.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <mutex>
+#include <print>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+using std::string_view_literals::operator ""sv;
+
+namespace {
+
+// Bump when the output of the same input and options changes, so cached results are not reused
+constexpr uint64_t cache_version{ 1 };
+
+enum class TextureFormat : uint8_t {
+	automatic, // bc1 for opaque textures, bc3 otherwise
+	bc1,
+	bc3,
+	bc7,
+};
+
+enum class TextureQuality : uint8_t {
+	fast,
+	best,
+};
+
+struct Options {
+	std::filesystem::path input;
+	std::filesystem::path cache;
+	TextureFormat format{ TextureFormat::automatic };
+	TextureQuality quality{ TextureQuality::fast };
+	uint32_t jobs{};
+	bool keep_source{};
+};
+
+enum class Result : uint8_t {
+	compressed,
+	cached,
+	skipped,
+	failed,
+};
+
+struct Statistics {
+	std::atomic_size_t compressed;
+	std::atomic_size_t cached;
+	std::atomic_size_t skipped;
+	std::atomic_size_t failed;
+	std::atomic_uint64_t uncompressed_bytes; // RGBA8 with the same mipmaps, what the texture would take in VRAM otherwise
+	std::atomic_uint64_t compressed_bytes;
+};
+
+std::mutex print_mutex;
+
+std::u8string_view getUtf8StringView(std::string_view const& s) {
+	return { reinterpret_cast<char8_t const*>(s.data()), s.size() };
+}
+
+std::string_view getStringView(std::u8string_view const& s) {
+	return { reinterpret_cast<char const*>(s.data()), s.size() };
+}
+
+std::string getPathString(std::filesystem::path const& path) {
+	auto const s = path.generic_u8string();
+	return std::string(getStringView(s));
+}
+
+void printUsage() {
+	std::println("usage: texture-compressor --input <directory> [--format auto|bc1|bc3|bc7] [--quality fast|best]");
+	std::println("                          [--cache <directory>] [--jobs <count>] [--keep-source]");
+	std::println("");
+	std::println("Compresses every png/jpeg/bmp texture under <directory> in place to '<file>.dds',");
+	std::println("block compressed with a full mip chain, and removes the source unless --keep-source is set.");
+	std::println("BC7 needs feature level 11, keep the sources so that older devices can fall back to them.");
+	std::println("The engine loads '<file>.dds' when a script loads '<file>'.");
+	std::println("Textures whose size is not a multiple of 4 are left untouched and decoded at runtime.");
+}
+
+bool isTextureFile(std::filesystem::path const& path) {
+	auto extension = getPathString(path.extension());
+	std::ranges::transform(extension, extension.begin(), [](char const c) -> char {
+		return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+	});
+	return extension == ".png"sv || extension == ".jpg"sv || extension == ".jpeg"sv || extension == ".bmp"sv;
+}
+
+bool readFile(std::filesystem::path const& path, std::vector<uint8_t>& data) {
+	std::ifstream file(path, std::ios::binary | std::ios::ate);
+	if (!file) {
+		return false;
+	}
+	auto const size = static_cast<size_t>(file.tellg());
+	data.resize(size);
+	file.seekg(0);
+	return static_cast<bool>(file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(size)));
+}
+
+bool writeFile(std::filesystem::path const& path, void const* data, size_t const size) {
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	if (!file) {
+		return false;
+	}
+	return static_cast<bool>(file.write(static_cast<char const*>(data), static_cast<std::streamsize>(size)));
+}
+
+// FNV-1a over the source file and everything that changes the output
+std::string getCacheKey(std::vector<uint8_t> const& data, Options const& options) {
+	uint64_t hash{ 0xcbf29ce484222325ull };
+	auto const feed = [&hash](uint8_t const value) {
+		hash ^= value;
+		hash *= 0x100000001b3ull;
+	};
+	for (auto const value : data) {
+		feed(value);
+	}
+	for (uint64_t value : { cache_version, static_cast<uint64_t>(options.format), static_cast<uint64_t>(options.quality), static_cast<uint64_t>(data.size()) }) {
+		for (int i = 0; i < 8; i += 1) {
+			feed(static_cast<uint8_t>(value >> (i * 8)));
+		}
+	}
+	return std::format("{:016x}.dds", hash);
+}
+
+// Mipmaps of straight alpha textures are filtered premultiplied,
+// otherwise transparent texels bleed their (usually black) color into the smaller levels
+bool generateMipmaps(DirectX::ScratchImage const& base, bool const opaque, DirectX::ScratchImage& chain) {
+	auto const& image = *base.GetImage(0, 0, 0);
+	if (opaque) {
+		return SUCCEEDED(DirectX::GenerateMipMaps(image, DirectX::TEX_FILTER_DEFAULT, 0, chain));
+	}
+
+	DirectX::ScratchImage premultiplied;
+	if (FAILED(DirectX::PremultiplyAlpha(image, DirectX::TEX_PMALPHA_IGNORE_SRGB, premultiplied))) {
+		return false;
+	}
+	DirectX::ScratchImage premultiplied_chain;
+	if (FAILED(DirectX::GenerateMipMaps(*premultiplied.GetImage(0, 0, 0), DirectX::TEX_FILTER_DEFAULT, 0, premultiplied_chain))) {
+		return false;
+	}
+	if (FAILED(DirectX::PremultiplyAlpha(premultiplied_chain.GetImages(), premultiplied_chain.GetImageCount(), premultiplied_chain.GetMetadata(),
+		DirectX::TEX_PMALPHA_REVERSE | DirectX::TEX_PMALPHA_IGNORE_SRGB, chain))) {
+		return false;
+	}
+
+	// Undoing the premultiplication is lossy at low alpha, keep the original base level as is
+	auto const& destination = *chain.GetImage(0, 0, 0);
+	for (size_t y = 0; y < image.height; y += 1) {
+		std::memcpy(destination.pixels + y * destination.rowPitch, image.pixels + y * image.rowPitch, std::min(image.rowPitch, destination.rowPitch));
+	}
+	return true;
+}
+
+Result compressTexture(std::filesystem::path const& path, Options const& options, Statistics& statistics, std::string& message) {
+	std::vector<uint8_t> data;
+	if (!readFile(path, data)) {
+		message = "read failed";
+		return Result::failed;
+	}
+
+	auto output_path = path;
+	output_path += ".dds";
+
+	std::filesystem::path cache_path;
+	std::error_code ec;
+	if (!options.cache.empty()) {
+		cache_path = options.cache / getCacheKey(data, options);
+		if (std::filesystem::is_regular_file(cache_path, ec)) {
+			if (!std::filesystem::copy_file(cache_path, output_path, std::filesystem::copy_options::overwrite_existing, ec)) {
+				message = "copy from cache failed";
+				return Result::failed;
+			}
+			return Result::cached;
+		}
+	}
+
+	DirectX::TexMetadata metadata{};
+	DirectX::ScratchImage decoded;
+	if (FAILED(DirectX::LoadFromWICMemory(data.data(), data.size(), DirectX::WIC_FLAGS_IGNORE_SRGB | DirectX::WIC_FLAGS_FORCE_RGB, &metadata, decoded))) {
+		message = "not decodable, left for runtime decoding";
+		return Result::skipped;
+	}
+	// D3D11 requires the top level of a block compressed texture to be made of whole blocks
+	if (metadata.width % 4 != 0 || metadata.height % 4 != 0) {
+		message = std::format("{}x{} is not a multiple of 4, left for runtime decoding", metadata.width, metadata.height);
+		return Result::skipped;
+	}
+
+	DirectX::ScratchImage base;
+	if (metadata.format == DXGI_FORMAT_R8G8B8A8_UNORM) {
+		base = std::move(decoded);
+	}
+	else if (FAILED(DirectX::Convert(*decoded.GetImage(0, 0, 0), DXGI_FORMAT_R8G8B8A8_UNORM, DirectX::TEX_FILTER_DEFAULT, DirectX::TEX_THRESHOLD_DEFAULT, base))) {
+		message = "convert to R8G8B8A8 failed";
+		return Result::failed;
+	}
+	bool const opaque = base.IsAlphaAllOpaque();
+
+	DirectX::ScratchImage chain;
+	if (!generateMipmaps(base, opaque, chain)) {
+		message = "generate mipmaps failed";
+		return Result::failed;
+	}
+
+	DXGI_FORMAT format{ DXGI_FORMAT_BC3_UNORM };
+	switch (options.format) {
+	case TextureFormat::automatic: format = opaque ? DXGI_FORMAT_BC1_UNORM : DXGI_FORMAT_BC3_UNORM; break;
+	case TextureFormat::bc1: format = DXGI_FORMAT_BC1_UNORM; break;
+	case TextureFormat::bc3: format = DXGI_FORMAT_BC3_UNORM; break;
+	case TextureFormat::bc7: format = DXGI_FORMAT_BC7_UNORM; break;
+	}
+	DirectX::TEX_COMPRESS_FLAGS flags{ DirectX::TEX_COMPRESS_DEFAULT };
+	if (format == DXGI_FORMAT_BC7_UNORM) {
+		flags = options.quality == TextureQuality::best ? DirectX::TEX_COMPRESS_BC7_USE_3SUBSETS : DirectX::TEX_COMPRESS_BC7_QUICK;
+	}
+	DirectX::ScratchImage compressed;
+	if (FAILED(DirectX::Compress(chain.GetImages(), chain.GetImageCount(), chain.GetMetadata(), format, flags, DirectX::TEX_THRESHOLD_DEFAULT, compressed))) {
+		message = "compress failed";
+		return Result::failed;
+	}
+
+	DirectX::Blob blob;
+	if (FAILED(DirectX::SaveToDDSMemory(compressed.GetImages(), compressed.GetImageCount(), compressed.GetMetadata(), DirectX::DDS_FLAGS_NONE, blob))) {
+		message = "save DDS failed";
+		return Result::failed;
+	}
+	if (!writeFile(output_path, blob.GetBufferPointer(), blob.GetBufferSize())) {
+		message = std::format("write '{}' failed", getPathString(output_path));
+		return Result::failed;
+	}
+	if (!cache_path.empty()) {
+		// A broken cache only costs time
+		writeFile(cache_path, blob.GetBufferPointer(), blob.GetBufferSize());
+	}
+
+	statistics.uncompressed_bytes += chain.GetPixelsSize();
+	statistics.compressed_bytes += compressed.GetPixelsSize();
+	message = std::format("{}x{}, {} level(s), {}", metadata.width, metadata.height, compressed.GetMetadata().mipLevels,
+		format == DXGI_FORMAT_BC1_UNORM ? "BC1"sv : (format == DXGI_FORMAT_BC3_UNORM ? "BC3"sv : "BC7"sv));
+	return Result::compressed;
+}
+
+void workerMain(std::vector<std::filesystem::path> const& files, std::atomic_size_t& next, Options const& options, Statistics& statistics) {
+	// WIC decoding and the mipmap filters need COM
+	bool const com = SUCCEEDED(CoInitializeEx(nullptr, COINIT_MULTITHREADED));
+
+	for (;;) {
+		size_t const index = next.fetch_add(1);
+		if (index >= files.size()) {
+			break;
+		}
+		auto const& path = files[index];
+		std::string message;
+		auto const result = compressTexture(path, options, statistics, message);
+
+		std::error_code ec;
+		switch (result) {
+		case Result::compressed:
+			statistics.compressed += 1;
+			break;
+		case Result::cached:
+			statistics.cached += 1;
+			break;
+		case Result::skipped:
+			statistics.skipped += 1;
+			break;
+		case Result::failed:
+			statistics.failed += 1;
+			break;
+		}
+		if ((result == Result::compressed || result == Result::cached) && !options.keep_source) {
+			std::filesystem::remove(path, ec);
+		}
+
+		std::lock_guard const lock(print_mutex);
+		auto const relative = getPathString(path.lexically_relative(options.input));
+		switch (result) {
+		case Result::compressed:
+			std::println("compressed '{}' ({})", relative, message);
+			break;
+		case Result::cached:
+			std::println("cached     '{}'", relative);
+			break;
+		case Result::skipped:
+			std::println("skipped    '{}' ({})", relative, message);
+			break;
+		case Result::failed:
+			std::println("error: '{}' {}", relative, message);
+			break;
+		}
+	}
+
+	if (com) {
+		CoUninitialize();
+	}
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	Options options;
+	std::string input;
+	std::string cache;
+
+	for (int i = 1; i < argc; ++i) {
+		std::string_view const arg(argv[i]);
+		if (arg == "-h"sv || arg == "--help"sv) {
+			printUsage();
+			return 0;
+		}
+		if (arg == "-i"sv || arg == "--input"sv) {
+			if (++i >= argc) {
+				std::println("error: missing input path");
+				return 1;
+			}
+			input = argv[i];
+			continue;
+		}
+		if (arg == "-f"sv || arg == "--format"sv) {
+			if (++i >= argc) {
+				std::println("error: missing format");
+				return 1;
+			}
+			std::string_view const value(argv[i]);
+			if (value == "auto"sv) {
+				options.format = TextureFormat::automatic;
+			}
+			else if (value == "bc1"sv) {
+				options.format = TextureFormat::bc1;
+			}
+			else if (value == "bc3"sv) {
+				options.format = TextureFormat::bc3;
+			}
+			else if (value == "bc7"sv) {
+				options.format = TextureFormat::bc7;
+			}
+			else {
+				std::println("error: unknown format '{}'", value);
+				return 1;
+			}
+			continue;
+		}
+		if (arg == "-q"sv || arg == "--quality"sv) {
+			if (++i >= argc) {
+				std::println("error: missing quality");
+				return 1;
+			}
+			std::string_view const value(argv[i]);
+			if (value == "fast"sv) {
+				options.quality = TextureQuality::fast;
+			}
+			else if (value == "best"sv) {
+				options.quality = TextureQuality::best;
+			}
+			else {
+				std::println("error: unknown quality '{}'", value);
+				return 1;
+			}
+			continue;
+		}
+		if (arg == "-c"sv || arg == "--cache"sv) {
+			if (++i >= argc) {
+				std::println("error: missing cache path");
+				return 1;
+			}
+			cache = argv[i];
+			continue;
+		}
+		if (arg == "-j"sv || arg == "--jobs"sv) {
+			if (++i >= argc) {
+				std::println("error: missing job count");
+				return 1;
+			}
+			options.jobs = static_cast<uint32_t>(std::strtoul(argv[i], nullptr, 10));
+			continue;
+		}
+		if (arg == "--keep-source"sv) {
+			options.keep_source = true;
+			continue;
+		}
+		std::println("error: unknown argument '{}'", arg);
+		printUsage();
+		return 1;
+	}
+
+	if (input.empty()) {
+		printUsage();
+		return 1;
+	}
+	if (options.format == TextureFormat::bc7 && !options.keep_source) {
+		std::println("warning: BC7 textures can not be loaded below feature level 11 and the sources are removed,");
+		std::println("         pass --keep-source to let the engine fall back to them");
+	}
+
+	std::error_code ec;
+	options.input = std::filesystem::path(getUtf8StringView(input));
+	if (!std::filesystem::is_directory(options.input, ec)) {
+		std::println("error: '{}' is not a directory", input);
+		return 1;
+	}
+	if (!cache.empty()) {
+		options.cache = std::filesystem::path(getUtf8StringView(cache));
+		if (!std::filesystem::exists(options.cache, ec) && !std::filesystem::create_directories(options.cache, ec)) {
+			std::println("error: create directory '{}' failed", cache);
+			return 1;
+		}
+	}
+
+	std::vector<std::filesystem::path> files;
+	std::filesystem::recursive_directory_iterator it(options.input, ec);
+	if (ec) {
+		std::println("error: enumerate '{}' failed", input);
+		return 1;
+	}
+	std::filesystem::recursive_directory_iterator end;
+	while (it != end) {
+		auto const& entry = *it;
+		bool const isFile = entry.is_regular_file(ec);
+		if (ec) {
+			std::println("error: enumerate '{}' failed", input);
+			return 1;
+		}
+		if (isFile && isTextureFile(entry.path())) {
+			files.emplace_back(entry.path());
+		}
+
+		it.increment(ec);
+		if (ec) {
+			std::println("error: enumerate '{}' failed", input);
+			return 1;
+		}
+	}
+	std::ranges::sort(files);
+
+	uint32_t jobs = options.jobs != 0 ? options.jobs : std::max(1u, std::thread::hardware_concurrency());
+	jobs = static_cast<uint32_t>(std::min<size_t>(jobs, std::max<size_t>(1, files.size())));
+
+	Statistics statistics;
+	std::atomic_size_t next{};
+	std::vector<std::thread> workers;
+	workers.reserve(jobs);
+	for (uint32_t i = 0; i < jobs; i += 1) {
+		workers.emplace_back(&workerMain, std::cref(files), std::ref(next), std::cref(options), std::ref(statistics));
+	}
+	for (auto& worker : workers) {
+		worker.join();
+	}
+
+	std::println("{} texture(s): {} compressed, {} cached, {} skipped, {} failed",
+		files.size(), statistics.compressed.load(), statistics.cached.load(), statistics.skipped.load(), statistics.failed.load());
+	if (statistics.compressed.load() != 0) {
+		std::println("texture memory of the compressed ones: {} KiB -> {} KiB",
+			statistics.uncompressed_bytes.load() / 1024, statistics.compressed_bytes.load() / 1024);
+	}
+	return statistics.failed.load() == 0 ? 0 : 1;
+}